@@ -0,0 +1,863 @@
+#include <math.h>   // signbit()
+#include <stdint.h> // uint64_t
+#include <stdlib.h> // malloc(), realloc(), free()
+#include <string.h> // memcpy(), memset()
+#include "codegen_x86_64.h"
+#include "../optimizer/optimizer.h"
+
+/// @brief Tamanho dos textos dos operandos, como "QWORD PTR [rbp+2147483647]".
+#define OPERAND_SIZE 48
+
+/// @brief Registradores temporários para expressões inteiras. eax, ecx e edx ficam reservados para idiv.
+#define INTEGER_SCRATCH 6
+
+/// @brief Registradores temporários para expressões reais (xmm0 a xmm7).
+#define REAL_SCRATCH 8
+
+static const char *integer_variables[X86_64_INTEGER_REGISTERS] = {"ebx", "r12d", "r13d", "r14d", "r15d"};
+static const char *real_variables[X86_64_REAL_REGISTERS] = {"xmm8", "xmm9", "xmm10", "xmm11",
+                                                            "xmm12", "xmm13", "xmm14", "xmm15"};
+static const char *integer_scratch[INTEGER_SCRATCH] = {"r8d", "r9d", "r10d", "r11d", "esi", "edi"};
+static const char *integer_scratch_64[INTEGER_SCRATCH] = {"r8", "r9", "r10", "r11", "rsi", "rdi"};
+static const char *real_scratch[REAL_SCRATCH] = {"xmm0", "xmm1", "xmm2", "xmm3",
+                                                 "xmm4", "xmm5", "xmm6", "xmm7"};
+
+/// @brief Os registradores temporários livres: uma expressão deixa o seu valor nos índices
+///        indicados e pode usar os seguintes.
+typedef struct scratch
+{
+    int integer;
+    int real;
+} scratch;
+
+/// @brief O estado da geração de código.
+typedef struct generator
+{
+    FILE *output;
+    const register_allocation *allocation;
+    int next_label;
+    int statement; // O número do próximo comando, na mesma pré-ordem da alocação de registradores.
+    int *first_interval; // Por comando: o primeiro intervalo que começa nele (-1 se nenhum).
+    int *next_interval;  // Por intervalo: o próximo que começa no mesmo comando.
+    const live_interval *real_owner[X86_64_REAL_REGISTERS]; // A variável que ocupa cada xmm8..15.
+    uint64_t *constants;
+    int constant_count;
+    int constant_capacity;
+    int *zero_division_lines; // A linha de cada desvio para o erro de divisão por zero.
+    int zero_division_count;
+    int zero_division_capacity;
+    int failed;
+} generator;
+
+static int grow(generator *g, void **items, int *capacity, size_t item_size)
+{
+    int new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+    void *grown = realloc(*items, (size_t)new_capacity * item_size);
+    if (grown == NULL)
+    {
+        g->failed = 1;
+        return 0;
+    }
+    *items = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+static int new_label(generator *g)
+{
+    return g->next_label++;
+}
+
+/// @brief O rótulo de uma constante real em .rodata, reaproveitado entre constantes iguais.
+static int real_constant(generator *g, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < g->constant_count; i++)
+    {
+        if (g->constants[i] == bits)
+            return i;
+    }
+    if (g->constant_count == g->constant_capacity &&
+        !grow(g, (void **)&g->constants, &g->constant_capacity, sizeof(uint64_t)))
+        return 0;
+    g->constants[g->constant_count] = bits;
+    return g->constant_count++;
+}
+
+/// @brief O rótulo do desvio para o erro de divisão por zero na linha indicada.
+static int zero_division_stub(generator *g, int line)
+{
+    if (g->zero_division_count == g->zero_division_capacity &&
+        !grow(g, (void **)&g->zero_division_lines, &g->zero_division_capacity, sizeof(int)))
+        return 0;
+    g->zero_division_lines[g->zero_division_count] = line;
+    return g->zero_division_count++;
+}
+
+static const live_interval *register_interval(const generator *g, int address)
+{
+    const live_interval *interval = interval_at(g->allocation, address);
+    return (interval != NULL && interval->location != SPILLED) ? interval : NULL;
+}
+
+/// @brief O lugar de uma variável inteira: o seu registrador ou o seu endereço no quadro.
+static const char *integer_location(const generator *g, int address, char *buffer)
+{
+    const live_interval *interval = register_interval(g, address);
+    if (interval != NULL)
+        return integer_variables[interval->location];
+    snprintf(buffer, OPERAND_SIZE, "DWORD PTR [rbp+%d]", address);
+    return buffer;
+}
+
+/// @brief O lugar de uma variável real: o seu registrador ou o seu endereço no quadro.
+static const char *real_location(const generator *g, int address, char *buffer)
+{
+    const live_interval *interval = register_interval(g, address);
+    if (interval != NULL)
+        return real_variables[interval->location];
+    snprintf(buffer, OPERAND_SIZE, "QWORD PTR [rbp+%d]", address);
+    return buffer;
+}
+
+static int is_integer_constant(const tree_node *node)
+{
+    return node->kind.exp == CONSTANT_EXPRESSION && node->type == INTEGER;
+}
+
+/// @brief Uma constante ou variável inteira, que pode ser o operando direto de uma instrução.
+static int is_simple_integer(const tree_node *node)
+{
+    return node->type == INTEGER &&
+           (node->kind.exp == CONSTANT_EXPRESSION || node->kind.exp == IDENTIFIER_EXPRESSION);
+}
+
+static int is_simple_real(const tree_node *node)
+{
+    return node->type == REAL &&
+           (node->kind.exp == CONSTANT_EXPRESSION || node->kind.exp == IDENTIFIER_EXPRESSION);
+}
+
+/// @brief 1 se o operando simples está na memória (variável fora de registrador).
+static int is_in_memory(const generator *g, const tree_node *node)
+{
+    return node->kind.exp == IDENTIFIER_EXPRESSION && register_interval(g, node->memory_address) == NULL;
+}
+
+static const char *integer_operand(const generator *g, const tree_node *node, char *buffer)
+{
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+    {
+        snprintf(buffer, OPERAND_SIZE, "%d", node->attribute.int_value);
+        return buffer;
+    }
+    return integer_location(g, node->memory_address, buffer);
+}
+
+static const char *real_operand(generator *g, const tree_node *node, char *buffer)
+{
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+    {
+        snprintf(buffer, OPERAND_SIZE, "QWORD PTR .LC%d[rip]", real_constant(g, node->attribute.real_value));
+        return buffer;
+    }
+    return real_location(g, node->memory_address, buffer);
+}
+
+static void integer_expression(generator *g, const tree_node *node, scratch s);
+static void real_expression(generator *g, const tree_node *node, scratch s);
+static void branch(generator *g, const tree_node *node, int jump_when, int target, scratch s);
+
+/// @brief Calcula left no temporário s.integer e prepara right como operando de uma instrução.
+/// @note Se faltam temporários, left vai para a pilha enquanto right é calculado.
+/// @return Quantos bytes devem ser liberados da pilha depois da instrução.
+static int integer_pair(generator *g, const tree_node *left, const tree_node *right, scratch s, char *operand)
+{
+    const char *target = integer_scratch[s.integer];
+    char buffer[OPERAND_SIZE];
+
+    integer_expression(g, left, s);
+    if (is_simple_integer(right))
+    {
+        snprintf(operand, OPERAND_SIZE, "%s", integer_operand(g, right, buffer));
+        return 0;
+    }
+    if (s.integer + 1 < INTEGER_SCRATCH)
+    {
+        scratch next = {s.integer + 1, s.real};
+        integer_expression(g, right, next);
+        snprintf(operand, OPERAND_SIZE, "%s", integer_scratch[next.integer]);
+        return 0;
+    }
+
+    fprintf(g->output, "\tpush\t%s\n", integer_scratch_64[s.integer]);
+    integer_expression(g, right, s);
+    fprintf(g->output, "\tpush\t%s\n", integer_scratch_64[s.integer]);
+    fprintf(g->output, "\tmov\t%s, DWORD PTR [rsp+8]\n", target);
+    snprintf(operand, OPERAND_SIZE, "DWORD PTR [rsp]");
+    return 16;
+}
+
+/// @brief Calcula left em um temporário real e prepara right como operando, como integer_pair().
+static int real_pair(generator *g, const tree_node *left, const tree_node *right, scratch s, char *operand)
+{
+    const char *target = real_scratch[s.real];
+    char buffer[OPERAND_SIZE];
+
+    real_expression(g, left, s);
+    if (is_simple_real(right))
+    {
+        snprintf(operand, OPERAND_SIZE, "%s", real_operand(g, right, buffer));
+        return 0;
+    }
+    if (s.real + 1 < REAL_SCRATCH)
+    {
+        scratch next = {s.integer, s.real + 1};
+        real_expression(g, right, next);
+        snprintf(operand, OPERAND_SIZE, "%s", real_scratch[next.real]);
+        return 0;
+    }
+
+    fprintf(g->output, "\tsub\trsp, 8\n\tmovsd\tQWORD PTR [rsp], %s\n", target);
+    real_expression(g, right, s);
+    fprintf(g->output, "\tsub\trsp, 8\n\tmovsd\tQWORD PTR [rsp], %s\n", target);
+    fprintf(g->output, "\tmovsd\t%s, QWORD PTR [rsp+8]\n", target);
+    snprintf(operand, OPERAND_SIZE, "QWORD PTR [rsp]");
+    return 16;
+}
+
+static void release_stack(generator *g, int bytes)
+{
+    if (bytes > 0)
+        fprintf(g->output, "\tadd\trsp, %d\n", bytes);
+}
+
+/// @brief Divide o temporário target por divisor, com as regras do interpretador: divisão por zero é
+///        um erro de execução e x / -1 é -x (idiv falharia com o menor inteiro). A divisão por uma
+///        constante vira deslocamentos (potências de 2) ou uma multiplicação pela parte alta do produto.
+static void integer_division(generator *g, const char *target, const tree_node *right, const char *divisor, int line)
+{
+    if (is_integer_constant(right))
+    {
+        int value = right->attribute.int_value;
+        unsigned int magnitude = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+        int exponent = power_of_two_exponent(magnitude);
+        division_magic_number magic;
+        if (value == 0)
+            fprintf(g->output, "\tjmp\t.Lzero%d\n", zero_division_stub(g, line));
+        else if (value == -1)
+            fprintf(g->output, "\tneg\t%s\n", target);
+        else if (exponent > 0 && exponent < 31)
+        {
+            // Soma 2^k - 1 aos dividendos negativos, para truncar em direção a zero
+            fprintf(g->output, "\tmov\teax, %s\n\tsar\teax, 31\n\tshr\teax, %d\n", target, 32 - exponent);
+            fprintf(g->output, "\tadd\t%s, eax\n\tsar\t%s, %d\n", target, target, exponent);
+            if (value < 0)
+                fprintf(g->output, "\tneg\t%s\n", target);
+        }
+        else if (division_magic(value, &magic))
+        {
+            // A parte alta de multiplier * x, em edx, corrigida e deslocada; soma 1 se for negativa
+            fprintf(g->output, "\tmov\teax, %d\n\timul\t%s\n", magic.multiplier, target);
+            if (magic.correction != 0)
+                fprintf(g->output, "\t%s\tedx, %s\n", (magic.correction > 0) ? "add" : "sub", target);
+            if (magic.shift > 0)
+                fprintf(g->output, "\tsar\tedx, %d\n", magic.shift);
+            fprintf(g->output, "\tmov\teax, edx\n\tshr\teax, 31\n\tadd\tedx, eax\n\tmov\t%s, edx\n", target);
+        }
+        else
+            fprintf(g->output, "\tmov\teax, %s\n\tmov\tecx, %d\n\tcdq\n\tidiv\tecx\n\tmov\t%s, eax\n",
+                    target, value, target);
+        return;
+    }
+
+    int negate = new_label(g), done = new_label(g);
+    fprintf(g->output, "\tmov\tecx, %s\n", divisor);
+    fprintf(g->output, "\ttest\tecx, ecx\n\tjz\t.Lzero%d\n", zero_division_stub(g, line));
+    fprintf(g->output, "\tcmp\tecx, -1\n\tje\t.L%d\n", negate);
+    fprintf(g->output, "\tmov\teax, %s\n\tcdq\n\tidiv\tecx\n\tmov\t%s, eax\n\tjmp\t.L%d\n", target, target, done);
+    fprintf(g->output, ".L%d:\n\tneg\t%s\n.L%d:\n", negate, target, done);
+}
+
+/// @brief Deixa o valor de uma expressão inteira (ou lógica, como 0 ou 1) em integer_scratch[s.integer].
+static void integer_expression(generator *g, const tree_node *node, scratch s)
+{
+    const char *target = integer_scratch[s.integer];
+    char buffer[OPERAND_SIZE];
+
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        if (node->attribute.int_value == 0)
+            fprintf(g->output, "\txor\t%s, %s\n", target, target);
+        else
+            fprintf(g->output, "\tmov\t%s, %d\n", target, node->attribute.int_value);
+        return;
+    case IDENTIFIER_EXPRESSION:
+        fprintf(g->output, "\tmov\t%s, %s\n", target, integer_location(g, node->memory_address, buffer));
+        return;
+    case CONVERSION_EXPRESSION:
+        integer_expression(g, node->child[0], s);
+        return;
+    case OPERATION_EXPRESSION:
+        break;
+    }
+
+    if (node->type == BOOLEAN)
+    {
+        int is_false = new_label(g), end = new_label(g);
+        branch(g, node, 0, is_false, s);
+        fprintf(g->output, "\tmov\t%s, 1\n\tjmp\t.L%d\n", target, end);
+        fprintf(g->output, ".L%d:\n\txor\t%s, %s\n.L%d:\n", is_false, target, target, end);
+        return;
+    }
+
+    char operand[OPERAND_SIZE];
+    int release = integer_pair(g, node->child[0], node->child[1], s, operand);
+    switch (node->attribute.op)
+    {
+    case T_SOMA:
+        fprintf(g->output, "\tadd\t%s, %s\n", target, operand);
+        break;
+    case T_SUB:
+        fprintf(g->output, "\tsub\t%s, %s\n", target, operand);
+        break;
+    case T_MULT:
+        if (is_integer_constant(node->child[1]) &&
+            power_of_two_exponent((unsigned int)node->child[1]->attribute.int_value) > 0)
+            fprintf(g->output, "\tshl\t%s, %d\n", target,
+                    power_of_two_exponent((unsigned int)node->child[1]->attribute.int_value));
+        else if (is_integer_constant(node->child[1]))
+            fprintf(g->output, "\timul\t%s, %s, %s\n", target, target, operand);
+        else
+            fprintf(g->output, "\timul\t%s, %s\n", target, operand);
+        break;
+    case T_DIV:
+        integer_division(g, target, node->child[1], operand, node->line_number);
+        break;
+    default:
+        break;
+    }
+    release_stack(g, release);
+}
+
+/// @brief Deixa o valor de uma expressão em real_scratch[s.real], convertendo as expressões inteiras.
+static void real_expression(generator *g, const tree_node *node, scratch s)
+{
+    const char *target = real_scratch[s.real];
+    char buffer[OPERAND_SIZE];
+
+    if (node->type == INTEGER || node->kind.exp == CONVERSION_EXPRESSION)
+    {
+        const tree_node *value = (node->kind.exp == CONVERSION_EXPRESSION) ? node->child[0] : node;
+        if (is_integer_constant(value))
+        {
+            if (value->attribute.int_value == 0)
+                fprintf(g->output, "\tpxor\t%s, %s\n", target, target);
+            else
+                fprintf(g->output, "\tmovsd\t%s, QWORD PTR .LC%d[rip]\n",
+                        target, real_constant(g, (double)value->attribute.int_value));
+            return;
+        }
+
+        const char *source;
+        if (value->kind.exp == IDENTIFIER_EXPRESSION)
+            source = integer_location(g, value->memory_address, buffer);
+        else
+        {
+            integer_expression(g, value, s);
+            source = integer_scratch[s.integer];
+        }
+        // pxor desfaz a dependência de cvtsi2sd com o valor anterior do registrador
+        fprintf(g->output, "\tpxor\t%s, %s\n\tcvtsi2sd\t%s, %s\n", target, target, target, source);
+        return;
+    }
+
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        if (node->attribute.real_value == 0.0 && !signbit(node->attribute.real_value))
+            fprintf(g->output, "\tpxor\t%s, %s\n", target, target);
+        else
+            fprintf(g->output, "\tmovsd\t%s, %s\n", target, real_operand(g, node, buffer));
+        return;
+    case IDENTIFIER_EXPRESSION:
+        if (register_interval(g, node->memory_address) != NULL)
+            fprintf(g->output, "\tmovapd\t%s, %s\n", target, real_location(g, node->memory_address, buffer));
+        else
+            fprintf(g->output, "\tmovsd\t%s, %s\n", target, real_location(g, node->memory_address, buffer));
+        return;
+    default:
+        break;
+    }
+
+    static const char *instructions[] = {"addsd", "subsd", "mulsd", "divsd"};
+    int index;
+    switch (node->attribute.op)
+    {
+    case T_SOMA:
+        index = 0;
+        break;
+    case T_SUB:
+        index = 1;
+        break;
+    case T_MULT:
+        index = 2;
+        break;
+    default:
+        index = 3;
+        break;
+    }
+
+    char operand[OPERAND_SIZE];
+    int release = real_pair(g, node->child[0], node->child[1], s, operand);
+    fprintf(g->output, "\t%s\t%s, %s\n", instructions[index], target, operand);
+    release_stack(g, release);
+}
+
+/// @brief A posição de uma comparação na ordem LT, LE, GT, GE, EQ, NE.
+static int comparison_index(token_type op)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return 0;
+    case T_MENOR_IGUAL:
+        return 1;
+    case T_MAIOR:
+        return 2;
+    case T_MAIOR_IGUAL:
+        return 3;
+    case T_IGUAL:
+        return 4;
+    case T_DIFERENTE:
+        return 5;
+    default:
+        return -1;
+    }
+}
+
+/// @brief Emite o salto para target quando a comparação inteira que acabou de ser feita tem o valor jump_when.
+static void integer_jump(generator *g, int index, int jump_when, int target)
+{
+    static const char *when_true[] = {"jl", "jle", "jg", "jge", "je", "jne"};
+    static const char *when_false[] = {"jge", "jg", "jle", "jl", "jne", "je"};
+    fprintf(g->output, "\t%s\t.L%d\n", jump_when ? when_true[index] : when_false[index], target);
+}
+
+/// @brief Emite o salto depois de ucomisd left, right. Se algum dos valores é NaN, ucomisd liga PF
+///        e toda comparação, exceto !=, é falsa.
+static void real_jump(generator *g, int index, int jump_when, int target)
+{
+    // Para cada comparação: o salto com o resultado ordenado e se PF deve desviar (1), pular (2) ou nada (0)
+    static const char *when_true[] = {"jb", "jbe", "ja", "jae", "je", "jne"};
+    static const int parity_true[] = {2, 2, 0, 0, 2, 1};
+    static const char *when_false[] = {"jae", "ja", "jbe", "jb", "jne", "je"};
+    static const int parity_false[] = {1, 1, 0, 0, 1, 2};
+
+    const char *jump = jump_when ? when_true[index] : when_false[index];
+    int parity = jump_when ? parity_true[index] : parity_false[index];
+    if (parity == 1)
+        fprintf(g->output, "\tjp\t.L%d\n\t%s\t.L%d\n", target, jump, target);
+    else if (parity == 2)
+    {
+        int skip = new_label(g);
+        fprintf(g->output, "\tjp\t.L%d\n\t%s\t.L%d\n.L%d:\n", skip, jump, target, skip);
+    }
+    else
+        fprintf(g->output, "\t%s\t.L%d\n", jump, target);
+}
+
+/// @brief Emite um salto para target quando a condição tiver o valor jump_when.
+/// @note e/ou são compilados em curto-circuito, como na máquina virtual.
+static void branch(generator *g, const tree_node *node, int jump_when, int target, scratch s)
+{
+    // Condição avaliada pelo compilador: o salto é incondicional ou desaparece
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+    {
+        if ((node->attribute.int_value != 0) == jump_when)
+            fprintf(g->output, "\tjmp\t.L%d\n", target);
+        return;
+    }
+
+    if (node->kind.exp == OPERATION_EXPRESSION && (node->attribute.op == T_E || node->attribute.op == T_OU))
+    {
+        int shortcut = (node->attribute.op == T_OU);
+        if (jump_when == shortcut)
+        {
+            branch(g, node->child[0], jump_when, target, s);
+            branch(g, node->child[1], jump_when, target, s);
+        }
+        else
+        {
+            int skip = new_label(g);
+            branch(g, node->child[0], shortcut, skip, s);
+            branch(g, node->child[1], jump_when, target, s);
+            fprintf(g->output, ".L%d:\n", skip);
+        }
+        return;
+    }
+
+    int index = (node->kind.exp == OPERATION_EXPRESSION) ? comparison_index(node->attribute.op) : -1;
+    if (index < 0)
+    {
+        integer_expression(g, node, s);
+        fprintf(g->output, "\ttest\t%s, %s\n\t%s\t.L%d\n", integer_scratch[s.integer], integer_scratch[s.integer],
+                jump_when ? "jnz" : "jz", target);
+        return;
+    }
+
+    const tree_node *left = node->child[0];
+    const tree_node *right = node->child[1];
+    char operand[OPERAND_SIZE], buffer[OPERAND_SIZE];
+
+    if (left->type == INTEGER && right->type == INTEGER)
+    {
+        // Variável comparada a uma constante ou a outra variável: sem passar por um temporário
+        if (is_integer_constant(left) && right->kind.exp == IDENTIFIER_EXPRESSION)
+        {
+            static const int mirrored[] = {2, 3, 0, 1, 4, 5};
+            const tree_node *swap = left;
+            left = right;
+            right = swap;
+            index = mirrored[index];
+        }
+        if (left->kind.exp == IDENTIFIER_EXPRESSION && is_simple_integer(right) &&
+            !(is_in_memory(g, left) && is_in_memory(g, right)))
+        {
+            fprintf(g->output, "\tcmp\t%s, ", integer_operand(g, left, buffer));
+            fprintf(g->output, "%s\n", integer_operand(g, right, buffer));
+            integer_jump(g, index, jump_when, target);
+            return;
+        }
+
+        int release = integer_pair(g, left, right, s, operand);
+        fprintf(g->output, "\tcmp\t%s, %s\n", integer_scratch[s.integer], operand);
+        release_stack(g, release);
+        integer_jump(g, index, jump_when, target);
+        return;
+    }
+
+    if (left->kind.exp == IDENTIFIER_EXPRESSION && left->type == REAL &&
+        register_interval(g, left->memory_address) != NULL && is_simple_real(right))
+    {
+        fprintf(g->output, "\tucomisd\t%s, ", real_location(g, left->memory_address, buffer));
+        fprintf(g->output, "%s\n", real_operand(g, right, buffer));
+        real_jump(g, index, jump_when, target);
+        return;
+    }
+
+    int release = real_pair(g, left, right, s, operand);
+    fprintf(g->output, "\tucomisd\t%s, %s\n", real_scratch[s.real], operand);
+    release_stack(g, release);
+    real_jump(g, index, jump_when, target);
+}
+
+/// @brief Antes de uma chamada ao runtime, guarda no quadro as variáveis vivas em xmm8 a xmm15,
+///        que a convenção de chamada não preserva. Com restore, as traz de volta depois da chamada.
+static void preserve_reals(generator *g, int restore)
+{
+    for (int r = 0; r < X86_64_REAL_REGISTERS; r++)
+    {
+        const live_interval *owner = g->real_owner[r];
+        if (owner == NULL || owner->end < g->statement - 1)
+            continue;
+        if (restore)
+            fprintf(g->output, "\tmovsd\t%s, QWORD PTR [rbp+%d]\n", real_variables[r], owner->memory_address);
+        else
+            fprintf(g->output, "\tmovsd\tQWORD PTR [rbp+%d], %s\n", owner->memory_address, real_variables[r]);
+    }
+}
+
+static int reads_address(const tree_node *node, int address)
+{
+    if (node == NULL)
+        return 0;
+    if (node->kind.exp == IDENTIFIER_EXPRESSION && node->memory_address == address)
+        return 1;
+    for (int i = 0; i < MAXCHILDREN; i++)
+    {
+        if (reads_address(node->child[i], address))
+            return 1;
+    }
+    return 0;
+}
+
+/// @brief 1 se o comando é uma atribuição ou leitura da variável que não lê o seu valor anterior.
+static int defines_without_reading(const tree_node *node, int address)
+{
+    if (node->memory_address != address)
+        return 0;
+    if (node->kind.stmt == READ_STATEMENT)
+        return 1;
+    return node->kind.stmt == ASSIGNMENT_STATEMENT && !reads_address(node->child[0], address);
+}
+
+/// @brief Zera os registradores das variáveis cujo intervalo começa no comando index, como o quadro
+///        zerado de onde os outros motores leem as variáveis ainda não atribuídas.
+static void start_intervals(generator *g, int index, const tree_node *node)
+{
+    for (int i = g->first_interval[index]; i >= 0; i = g->next_interval[i])
+    {
+        const live_interval *interval = &g->allocation->intervals[i];
+        if (interval->location == SPILLED)
+            continue;
+        if (interval->type == REAL)
+            g->real_owner[interval->location] = interval;
+        if (defines_without_reading(node, interval->memory_address))
+            continue;
+        if (interval->type == REAL)
+            fprintf(g->output, "\tpxor\t%s, %s\n", real_variables[interval->location], real_variables[interval->location]);
+        else
+            fprintf(g->output, "\txor\t%s, %s\n", integer_variables[interval->location], integer_variables[interval->location]);
+    }
+}
+
+/// @brief Reconhece x = x + e, x = x - e, x = x * e e as formas comutadas quando a instrução pode
+///        alterar x no lugar (imul só escreve em registrador).
+static int update_in_place(generator *g, const tree_node *node, const char *location)
+{
+    const tree_node *value = node->child[0];
+    if (value->kind.exp != OPERATION_EXPRESSION ||
+        (value->attribute.op != T_SOMA && value->attribute.op != T_SUB && value->attribute.op != T_MULT))
+        return 0;
+
+    const tree_node *left = value->child[0];
+    const tree_node *right = value->child[1];
+    if (value->attribute.op != T_SUB && right->kind.exp == IDENTIFIER_EXPRESSION &&
+        right->memory_address == node->memory_address)
+    {
+        right = value->child[0];
+        left = value->child[1];
+    }
+    if (left->kind.exp != IDENTIFIER_EXPRESSION || left->memory_address != node->memory_address ||
+        !is_simple_integer(right) || (is_in_memory(g, left) && is_in_memory(g, right)))
+        return 0;
+
+    char buffer[OPERAND_SIZE];
+    const char *operand = integer_operand(g, right, buffer);
+    switch (value->attribute.op)
+    {
+    case T_SOMA:
+    case T_SUB:
+        if (is_integer_constant(right) && right->attribute.int_value == 1)
+            fprintf(g->output, "\t%s\t%s\n", (value->attribute.op == T_SOMA) ? "inc" : "dec", location);
+        else
+            fprintf(g->output, "\t%s\t%s, %s\n", (value->attribute.op == T_SOMA) ? "add" : "sub", location, operand);
+        return 1;
+    default:
+        if (is_integer_constant(right) && power_of_two_exponent((unsigned int)right->attribute.int_value) > 0)
+        {
+            fprintf(g->output, "\tshl\t%s, %d\n", location,
+                    power_of_two_exponent((unsigned int)right->attribute.int_value));
+            return 1;
+        }
+        if (is_in_memory(g, left))
+            return 0;
+        if (is_integer_constant(right))
+            fprintf(g->output, "\timul\t%s, %s, %s\n", location, location, operand);
+        else
+            fprintf(g->output, "\timul\t%s, %s\n", location, operand);
+        return 1;
+    }
+}
+
+static void assignment(generator *g, const tree_node *node)
+{
+    scratch s = {0, 0};
+    const tree_node *value = node->child[0];
+    char location_buffer[OPERAND_SIZE], buffer[OPERAND_SIZE];
+
+    if (node->type == REAL)
+    {
+        const char *location = real_location(g, node->memory_address, location_buffer);
+        real_expression(g, value, s);
+        if (register_interval(g, node->memory_address) != NULL)
+            fprintf(g->output, "\tmovapd\t%s, xmm0\n", location);
+        else
+            fprintf(g->output, "\tmovsd\t%s, xmm0\n", location);
+        return;
+    }
+
+    const char *location = integer_location(g, node->memory_address, location_buffer);
+    int in_memory = (register_interval(g, node->memory_address) == NULL);
+    if (update_in_place(g, node, location))
+        return;
+    if (is_simple_integer(value) && !(in_memory && is_in_memory(g, value)))
+    {
+        if (!in_memory && is_integer_constant(value) && value->attribute.int_value == 0)
+            fprintf(g->output, "\txor\t%s, %s\n", location, location);
+        else
+            fprintf(g->output, "\tmov\t%s, %s\n", location, integer_operand(g, value, buffer));
+        return;
+    }
+    integer_expression(g, value, s);
+    fprintf(g->output, "\tmov\t%s, %s\n", location, integer_scratch[0]);
+}
+
+static void statements(generator *g, const tree_node *node, int top_level)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind != STATEMENT_KIND)
+            continue;
+
+        int index = g->statement++;
+        if (top_level)
+            start_intervals(g, index, node);
+
+        scratch s = {0, 0};
+        char buffer[OPERAND_SIZE];
+        if (node->kind.stmt != DECLARATION_STATEMENT)
+            fprintf(g->output, "\t# linha %d\n", node->line_number);
+        switch (node->kind.stmt)
+        {
+        case ASSIGNMENT_STATEMENT:
+            assignment(g, node);
+            break;
+        case READ_STATEMENT:
+            preserve_reals(g, 0);
+            fprintf(g->output, "\tmov\tedi, %d\n", node->line_number);
+            if (node->type == REAL)
+            {
+                fprintf(g->output, "\tcall\tpminus_read_real\n");
+                preserve_reals(g, 1);
+                fprintf(g->output, "\tmovsd\t%s, xmm0\n", real_location(g, node->memory_address, buffer));
+            }
+            else
+            {
+                fprintf(g->output, "\tcall\tpminus_read_integer\n");
+                preserve_reals(g, 1);
+                fprintf(g->output, "\tmov\t%s, eax\n", integer_location(g, node->memory_address, buffer));
+            }
+            break;
+        case WRITE_STATEMENT:
+            if (node->child[0]->type == REAL)
+            {
+                real_expression(g, node->child[0], s);
+                preserve_reals(g, 0);
+                fprintf(g->output, "\tcall\tpminus_write_real\n");
+            }
+            else
+            {
+                integer_expression(g, node->child[0], s);
+                preserve_reals(g, 0);
+                fprintf(g->output, "\tmov\tedi, %s\n\tcall\tpminus_write_integer\n", integer_scratch[0]);
+            }
+            preserve_reals(g, 1);
+            break;
+        case IF_STATEMENT:
+        {
+            int otherwise = new_label(g), end = new_label(g);
+            branch(g, node->child[0], 0, otherwise, s);
+            statements(g, node->child[1], 0);
+            if (node->child[2] != NULL)
+                fprintf(g->output, "\tjmp\t.L%d\n", end);
+            fprintf(g->output, ".L%d:\n", otherwise);
+            statements(g, node->child[2], 0);
+            fprintf(g->output, ".L%d:\n", end);
+            break;
+        }
+        case WHILE_STATEMENT:
+        {
+            // A condição fica depois do corpo: cada volta do laço executa um único salto
+            int condition = new_label(g), body = new_label(g);
+            fprintf(g->output, "\tjmp\t.L%d\n\t.p2align 4\n.L%d:\n", condition, body);
+            statements(g, node->child[1], 0);
+            fprintf(g->output, ".L%d:\n", condition);
+            branch(g, node->child[0], 1, body, s);
+            break;
+        }
+        case REPEAT_STATEMENT:
+        {
+            int body = new_label(g);
+            fprintf(g->output, "\t.p2align 4\n.L%d:\n", body);
+            statements(g, node->child[0], 0);
+            branch(g, node->child[1], 0, body, s);
+            break;
+        }
+        case DECLARATION_STATEMENT:
+            break;
+        }
+    }
+}
+
+/// @brief Lista, em comentários, onde cada variável ficou.
+static void describe_allocation(generator *g)
+{
+    const register_allocation *allocation = g->allocation;
+    for (int i = 0; i < allocation->count; i++)
+    {
+        const live_interval *interval = &allocation->intervals[i];
+        if (interval->end < 0)
+            fprintf(g->output, "# %s: nao usada\n", interval->name);
+        else if (interval->location == SPILLED)
+            fprintf(g->output, "# %s: [rbp+%d], comandos %d a %d\n",
+                    interval->name, interval->memory_address, interval->start, interval->end);
+        else
+            fprintf(g->output, "# %s: %s, comandos %d a %d\n", interval->name,
+                    interval->type == REAL ? real_variables[interval->location] : integer_variables[interval->location],
+                    interval->start, interval->end);
+    }
+}
+
+int generate_x86_64(tree_node *tree, const register_allocation *allocation, FILE *output)
+{
+    generator g;
+    memset(&g, 0, sizeof(g));
+    g.output = output;
+    g.allocation = allocation;
+    g.first_interval = (int *)malloc(((size_t)allocation->statement_count + 1) * sizeof(int));
+    g.next_interval = (int *)malloc(((size_t)allocation->count + 1) * sizeof(int));
+    if (g.first_interval == NULL || g.next_interval == NULL)
+    {
+        free(g.first_interval);
+        free(g.next_interval);
+        return 0;
+    }
+
+    // Os intervalos agrupados pelo comando onde começam, na ordem da tabela de símbolos
+    for (int k = 0; k <= allocation->statement_count; k++)
+        g.first_interval[k] = -1;
+    for (int i = allocation->count - 1; i >= 0; i--)
+    {
+        const live_interval *interval = &allocation->intervals[i];
+        if (interval->end < 0)
+            continue;
+        g.next_interval[i] = g.first_interval[interval->start];
+        g.first_interval[interval->start] = i;
+    }
+
+    fprintf(output, "# Gerado pelo compilador P-\n");
+    describe_allocation(&g);
+    fprintf(output, "\t.intel_syntax noprefix\n\t.text\n");
+    fprintf(output, "\t.globl\tpminus_program\n\t.type\tpminus_program, @function\n");
+    fprintf(output, "pminus_program:\n");
+    fprintf(output, "\tpush\trbp\n\tpush\trbx\n\tpush\tr12\n\tpush\tr13\n\tpush\tr14\n\tpush\tr15\n");
+    fprintf(output, "\tsub\trsp, 8\n"); // Alinha a pilha em 16 bytes para as chamadas ao runtime
+    fprintf(output, "\tmov\trbp, rdi\n");
+
+    statements(&g, tree, 1);
+
+    fprintf(output, "\tadd\trsp, 8\n\tpop\tr15\n\tpop\tr14\n\tpop\tr13\n\tpop\tr12\n\tpop\trbx\n\tpop\trbp\n\tret\n");
+    for (int i = 0; i < g.zero_division_count; i++)
+    {
+        // Não retorna: o runtime mostra o erro e encerra o programa
+        fprintf(output, ".Lzero%d:\n\tand\trsp, -16\n\tmov\tedi, %d\n\tcall\tpminus_division_by_zero\n",
+                i, g.zero_division_lines[i]);
+    }
+    fprintf(output, "\t.size\tpminus_program, .-pminus_program\n");
+
+    fprintf(output, "\t.section\t.rodata\n\t.align 8\n");
+    for (int i = 0; i < g.constant_count; i++)
+        fprintf(output, ".LC%d:\n\t.quad\t%llu\n", i, (unsigned long long)g.constants[i]);
+    fprintf(output, "\t.globl\tpminus_frame_size\npminus_frame_size:\n\t.long\t%d\n", allocation->frame_size);
+    fprintf(output, "\t.section\t.note.GNU-stack,\"\",@progbits\n");
+
+    free(g.first_interval);
+    free(g.next_interval);
+    free(g.constants);
+    free(g.zero_division_lines);
+    return !g.failed && !ferror(output);
+}
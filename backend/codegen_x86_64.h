@@ -0,0 +1,25 @@
+#ifndef CODEGEN_X86_64_H
+#define CODEGEN_X86_64_H
+
+#include <stdio.h>
+#include "../parser/parser.h"
+#include "regalloc.h"
+
+/// @brief Quantidade de registradores para variáveis inteiras (rbx, r12 a r15, preservados nas chamadas).
+#define X86_64_INTEGER_REGISTERS 5
+
+/// @brief Quantidade de registradores para variáveis reais (xmm8 a xmm15).
+#define X86_64_REAL_REGISTERS 8
+
+/// @brief Gera o programa em assembly x86-64 do GNU as (sintaxe Intel, System V).
+/// @note O código gerado define a função pminus_program(unsigned char *frame) e a constante
+///       pminus_frame_size, e chama as funções do runtime (backend/native_runtime.c) para ler(),
+///       mostrar() e os erros de execução. As variáveis sem registrador ficam no quadro recebido,
+///       nos endereços da tabela de símbolos.
+/// @param tree A árvore ajustada e resolvida.
+/// @param allocation A alocação de registradores da árvore.
+/// @param output O arquivo onde o assembly é escrito.
+/// @return 1 em caso de sucesso, 0 se não houver memória.
+int generate_x86_64(tree_node *tree, const register_allocation *allocation, FILE *output);
+
+#endif // CODEGEN_X86_64_H
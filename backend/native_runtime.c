@@ -0,0 +1,71 @@
+#include <stdio.h>  // fprintf()
+#include <stdlib.h> // calloc(), free(), exit()
+#include <unistd.h> // STDIN_FILENO, STDOUT_FILENO
+#include "../runtime/program_io.h"
+
+// O runtime dos executáveis gerados por backend/codegen_x86_64.c: é ligado ao assembly do programa
+// e fornece a função main(), o quadro das variáveis e as funções chamadas por ler() e mostrar().
+
+/// @brief O programa compilado. frame é o quadro das variáveis, zerado, com pminus_frame_size bytes.
+extern void pminus_program(unsigned char *frame);
+
+/// @brief O tamanho do quadro, tirado da tabela de símbolos.
+extern const int pminus_frame_size;
+
+static program_io *io;
+
+/// @brief Encerra o programa com um erro de execução, depois de enviar a saída pendente.
+static void runtime_error(int line, const char *message)
+{
+    destroy_program_io(io);
+    fprintf(stderr, "Erro de execucao na linha %d: %s\n", line, message);
+    exit(1);
+}
+
+int pminus_read_integer(int line)
+{
+    int value;
+    if (!read_integer(io, &value))
+        runtime_error(line, "entrada invalida ou encerrada");
+    return value;
+}
+
+double pminus_read_real(int line)
+{
+    double value;
+    if (!read_real(io, &value))
+        runtime_error(line, "entrada invalida ou encerrada");
+    return value;
+}
+
+void pminus_write_integer(int value)
+{
+    write_integer(io, value);
+}
+
+void pminus_write_real(double value)
+{
+    write_real(io, value);
+}
+
+void pminus_division_by_zero(int line)
+{
+    runtime_error(line, "divisao por zero");
+}
+
+int main(void)
+{
+    io = create_program_io(STDIN_FILENO, STDOUT_FILENO);
+    unsigned char *frame = (unsigned char *)calloc(1, (size_t)pminus_frame_size + 8);
+    if (io == NULL || frame == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+
+    pminus_program(frame);
+
+    destroy_program_io(io);
+    free(frame);
+    return 0;
+}
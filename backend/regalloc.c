@@ -0,0 +1,297 @@
+#include <stdlib.h> // malloc(), calloc(), realloc(), free(), qsort()
+#include "regalloc.h"
+
+/// @brief O trecho de comandos de um laço, do próprio laço ao último comando do corpo.
+typedef struct loop_range
+{
+    int start;
+    int end;
+} loop_range;
+
+/// @brief O estado da numeração dos comandos.
+typedef struct numbering
+{
+    register_allocation *allocation;
+    int next;      // O número do próximo comando.
+    int top_level; // O número do comando de nível mais externo que está sendo visitado.
+    loop_range *loops;
+    int loop_count;
+    int loop_capacity;
+    int failed;
+} numbering;
+
+const live_interval *interval_at(const register_allocation *allocation, int memory_address)
+{
+    if (memory_address < 0 || memory_address >= allocation->frame_size)
+        return NULL;
+    int index = allocation->by_address[memory_address];
+    return (index >= 0) ? &allocation->intervals[index] : NULL;
+}
+
+/// @brief Registra um uso (leitura ou escrita) da variável em um endereço no comando index.
+static void touch(numbering *state, int memory_address, int index)
+{
+    live_interval *interval = (live_interval *)interval_at(state->allocation, memory_address);
+    if (interval == NULL)
+        return;
+
+    if (interval->end < 0)
+        interval->start = state->top_level;
+    if (index > interval->end)
+        interval->end = index;
+}
+
+static void visit_expression(numbering *state, const tree_node *node, int index)
+{
+    if (node == NULL)
+        return;
+    if (node->kind.exp == IDENTIFIER_EXPRESSION)
+        touch(state, node->memory_address, index);
+    for (int i = 0; i < MAXCHILDREN; i++)
+        visit_expression(state, node->child[i], index);
+}
+
+static void add_loop(numbering *state, int start, int end)
+{
+    if (state->loop_count == state->loop_capacity)
+    {
+        int capacity = (state->loop_capacity == 0) ? 16 : state->loop_capacity * 2;
+        loop_range *loops = (loop_range *)realloc(state->loops, (size_t)capacity * sizeof(loop_range));
+        if (loops == NULL)
+        {
+            state->failed = 1;
+            return;
+        }
+        state->loops = loops;
+        state->loop_capacity = capacity;
+    }
+    state->loops[state->loop_count].start = start;
+    state->loops[state->loop_count].end = end;
+    state->loop_count++;
+}
+
+static void visit_statements(numbering *state, const tree_node *node, int top_level)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind != STATEMENT_KIND)
+            continue;
+
+        int index = state->next++;
+        if (top_level)
+            state->top_level = index;
+
+        switch (node->kind.stmt)
+        {
+        case ASSIGNMENT_STATEMENT:
+        case READ_STATEMENT:
+            visit_expression(state, node->child[0], index);
+            touch(state, node->memory_address, index);
+            break;
+        case WRITE_STATEMENT:
+            visit_expression(state, node->child[0], index);
+            break;
+        case IF_STATEMENT:
+            visit_expression(state, node->child[0], index);
+            visit_statements(state, node->child[1], 0);
+            visit_statements(state, node->child[2], 0);
+            break;
+        case WHILE_STATEMENT:
+            visit_expression(state, node->child[0], index);
+            visit_statements(state, node->child[1], 0);
+            add_loop(state, index, state->next - 1);
+            break;
+        case REPEAT_STATEMENT:
+            visit_statements(state, node->child[0], 0);
+            visit_expression(state, node->child[1], state->next - 1); // A condição é avaliada depois do corpo
+            add_loop(state, index, state->next - 1);
+            break;
+        case DECLARATION_STATEMENT:
+            break;
+        }
+    }
+}
+
+/// @brief Estende até o fim do laço todo intervalo que o alcança: o valor precisa sobreviver à volta do laço.
+/// @note Repete até estabilizar, pois a extensão em um laço interno pode alcançar um laço externo.
+static void extend_over_loops(numbering *state)
+{
+    register_allocation *allocation = state->allocation;
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int l = 0; l < state->loop_count; l++)
+        {
+            for (int i = 0; i < allocation->count; i++)
+            {
+                live_interval *interval = &allocation->intervals[i];
+                if (interval->end < 0 || interval->start > state->loops[l].end || interval->end < state->loops[l].start)
+                    continue;
+                if (interval->end < state->loops[l].end)
+                {
+                    interval->end = state->loops[l].end;
+                    changed = 1;
+                }
+            }
+        }
+    }
+}
+
+/// @brief A chave de ordenação dos intervalos: o início e, nos empates, a ordem de declaração.
+typedef struct interval_key
+{
+    int start;
+    int index;
+} interval_key;
+
+static int compare_keys(const void *a, const void *b)
+{
+    const interval_key *x = (const interval_key *)a;
+    const interval_key *y = (const interval_key *)b;
+    if (x->start != y->start)
+        return (x->start > y->start) - (x->start < y->start);
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+/// @brief A varredura linear de uma classe de registradores.
+/// @param order Os índices dos intervalos da classe, já ordenados pelo início.
+static void linear_scan(live_interval *intervals, const int *order, int count, int register_count, int *active)
+{
+    int active_count = 0; // active fica ordenado pelo fim do intervalo
+    int in_use[64] = {0};
+
+    for (int k = 0; k < count; k++)
+    {
+        live_interval *current = &intervals[order[k]];
+
+        // Libera os registradores dos intervalos que terminaram antes deste começar
+        int kept = 0;
+        for (int a = 0; a < active_count; a++)
+        {
+            if (intervals[active[a]].end < current->start)
+                in_use[intervals[active[a]].location] = 0;
+            else
+                active[kept++] = active[a];
+        }
+        active_count = kept;
+
+        int chosen = -1;
+        for (int r = 0; r < register_count && chosen < 0; r++)
+        {
+            if (!in_use[r])
+                chosen = r;
+        }
+
+        if (chosen < 0)
+        {
+            // Sem registrador livre: fica no quadro quem termina mais tarde
+            live_interval *last = (active_count > 0) ? &intervals[active[active_count - 1]] : NULL;
+            if (last == NULL || last->end <= current->end)
+            {
+                current->location = SPILLED;
+                continue;
+            }
+            chosen = last->location;
+            last->location = SPILLED;
+            active_count--;
+        }
+
+        current->location = chosen;
+        in_use[chosen] = 1;
+
+        int position = active_count++;
+        while (position > 0 && intervals[active[position - 1]].end > current->end)
+        {
+            active[position] = active[position - 1];
+            position--;
+        }
+        active[position] = order[k];
+    }
+}
+
+register_allocation *allocate_registers(tree_node *tree, const symbol_table *symbols, int integer_registers, int real_registers)
+{
+    register_allocation *allocation = (register_allocation *)calloc(1, sizeof(register_allocation));
+    if (allocation == NULL)
+        return NULL;
+
+    allocation->count = symbols->count;
+    allocation->frame_size = symbols->next_address;
+    allocation->intervals = (live_interval *)calloc((size_t)symbols->count + 1, sizeof(live_interval));
+    allocation->by_address = (int *)malloc(((size_t)symbols->next_address + 1) * sizeof(int));
+    interval_key *keys = (interval_key *)malloc(((size_t)symbols->count + 1) * sizeof(interval_key));
+    int *order = (int *)malloc(((size_t)symbols->count + 1) * sizeof(int));
+    int *active = (int *)malloc(((size_t)symbols->count + 1) * sizeof(int));
+    if (allocation->intervals == NULL || allocation->by_address == NULL || keys == NULL || order == NULL || active == NULL)
+    {
+        free(keys);
+        free(order);
+        free(active);
+        destroy_register_allocation(allocation);
+        return NULL;
+    }
+
+    for (int a = 0; a < symbols->next_address; a++)
+        allocation->by_address[a] = -1;
+    for (int i = 0; i < symbols->count; i++)
+    {
+        const symbol *sym = &symbols->symbols[i];
+        live_interval *interval = &allocation->intervals[i];
+        interval->name = sym->name;
+        interval->memory_address = sym->memory_address;
+        interval->type = (sym->type == DT_REAL) ? REAL : INTEGER;
+        interval->start = 0;
+        interval->end = -1;
+        interval->location = SPILLED;
+        if (sym->memory_address >= 0) // -1: a variável foi removida do quadro pelas otimizações
+            allocation->by_address[sym->memory_address] = i;
+    }
+
+    numbering state = {allocation, 0, 0, NULL, 0, 0, 0};
+    visit_statements(&state, tree, 1);
+    extend_over_loops(&state);
+    allocation->statement_count = state.next;
+    free(state.loops);
+
+    // Uma varredura por classe de registradores
+    for (int pass = 0; pass < 2; pass++)
+    {
+        exp_type type = (pass == 0) ? INTEGER : REAL;
+        int register_count = (pass == 0) ? integer_registers : real_registers;
+        int count = 0;
+        for (int i = 0; i < allocation->count; i++)
+        {
+            if (allocation->intervals[i].type == type && allocation->intervals[i].end >= 0)
+            {
+                keys[count].start = allocation->intervals[i].start;
+                keys[count].index = i;
+                count++;
+            }
+        }
+
+        qsort(keys, (size_t)count, sizeof(interval_key), compare_keys);
+        for (int k = 0; k < count; k++)
+            order[k] = keys[k].index;
+        linear_scan(allocation->intervals, order, count, register_count < 64 ? register_count : 64, active);
+    }
+
+    free(keys);
+    free(order);
+    free(active);
+    if (state.failed)
+    {
+        destroy_register_allocation(allocation);
+        return NULL;
+    }
+    return allocation;
+}
+
+void destroy_register_allocation(register_allocation *allocation)
+{
+    if (allocation == NULL)
+        return;
+    free(allocation->intervals);
+    free(allocation->by_address);
+    free(allocation);
+}
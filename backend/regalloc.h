@@ -0,0 +1,52 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "../parser/parser.h"
+#include "../semantic/semantic.h"
+
+/// @brief Indica que a variável ficou no quadro, no endereço da tabela de símbolos.
+#define SPILLED (-1)
+
+/// @brief O intervalo de vida de uma variável e o registrador que recebeu.
+/// @note Os comandos são numerados em pré-ordem (o comando, depois os comandos do seu corpo).
+///       O intervalo começa no comando de nível mais externo onde a variável aparece pela primeira vez,
+///       de modo que a inicialização do registrador sempre executa antes de qualquer uso, e termina
+///       no último uso. Um intervalo que alcança um laço cobre o laço inteiro.
+typedef struct live_interval
+{
+    const char *name;
+    int memory_address;
+    exp_type type;
+    int start;
+    int end;      // -1 se a variável não é usada
+    int location; // O índice do registrador na sua classe, ou SPILLED.
+} live_interval;
+
+/// @brief O resultado da alocação de registradores de um programa.
+typedef struct register_allocation
+{
+    live_interval *intervals; // Um por símbolo, na ordem da tabela de símbolos.
+    int count;
+    int *by_address; // O índice do intervalo de cada endereço do quadro (-1 nos bytes que não iniciam variáveis).
+    int frame_size;
+    int statement_count;
+} register_allocation;
+
+/// @brief Aloca registradores às variáveis por varredura linear (linear scan).
+/// @note Variáveis inteiras e reais disputam classes diferentes. Quando faltam registradores,
+///       fica no quadro a variável cujo intervalo termina mais tarde.
+/// @param tree A árvore ajustada e resolvida.
+/// @param symbols A tabela de símbolos.
+/// @param integer_registers A quantidade de registradores disponíveis para variáveis inteiras.
+/// @param real_registers A quantidade de registradores disponíveis para variáveis reais.
+/// @return A alocação, ou NULL se não houver memória.
+register_allocation *allocate_registers(tree_node *tree, const symbol_table *symbols, int integer_registers, int real_registers);
+
+/// @brief O intervalo da variável em um endereço do quadro.
+/// @return O intervalo, ou NULL se o endereço não inicia uma variável.
+const live_interval *interval_at(const register_allocation *allocation, int memory_address);
+
+/// @brief Libera uma alocação.
+void destroy_register_allocation(register_allocation *allocation);
+
+#endif // REGALLOC_H
@@ -0,0 +1,54 @@
+#include <errno.h>    // errno, EINTR
+#include <stdio.h>    // snprintf()
+#include <stdlib.h>   // getenv()
+#include <string.h>   // strerror()
+#include <sys/wait.h> // waitpid(), WIFEXITED(), WEXITSTATUS()
+#include <unistd.h>   // fork(), execvp(), _exit()
+#include "toolchain.h"
+
+int link_executable(const char *assembly_path, const char *executable_path, const char *root,
+                    char *error, size_t error_size)
+{
+    const char *c_compiler = getenv("CC");
+    if (c_compiler == NULL || c_compiler[0] == '\0')
+        c_compiler = DEFAULT_C_COMPILER;
+
+    char runtime_path[4096], io_path[4096];
+    snprintf(runtime_path, sizeof(runtime_path), "%s/backend/native_runtime.c", root);
+    snprintf(io_path, sizeof(io_path), "%s/runtime/program_io.c", root);
+
+    char *arguments[] = {(char *)c_compiler, "-O2", "-o", (char *)executable_path, (char *)assembly_path,
+                         runtime_path, io_path, NULL};
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        snprintf(error, error_size, "fork: %s", strerror(errno));
+        return 0;
+    }
+    if (child == 0)
+    {
+        execvp(c_compiler, arguments);
+        _exit(127);
+    }
+
+    int status;
+    while (waitpid(child, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            snprintf(error, error_size, "waitpid: %s", strerror(errno));
+            return 0;
+        }
+    }
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+            snprintf(error, error_size, "nao foi possivel executar %s", c_compiler);
+        else
+            snprintf(error, error_size, "%s terminou com erro", c_compiler);
+        return 0;
+    }
+    return 1;
+}
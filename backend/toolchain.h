@@ -0,0 +1,20 @@
+#ifndef TOOLCHAIN_H
+#define TOOLCHAIN_H
+
+#include <stddef.h>
+
+/// @brief O compilador C usado para montar e ligar quando a variável de ambiente CC não está definida.
+#define DEFAULT_C_COMPILER "cc"
+
+/// @brief Monta o assembly gerado e o liga ao runtime, produzindo um executável.
+/// @note Executa "$CC -O2 -o executavel programa.s <raiz>/backend/native_runtime.c <raiz>/runtime/program_io.c".
+/// @param assembly_path O arquivo .s do programa.
+/// @param executable_path O executável a ser criado.
+/// @param root O diretório do compilador, onde ficam as fontes do runtime.
+/// @param error Recebe a descrição da falha, se houver.
+/// @param error_size O tamanho de error.
+/// @return 1 se o executável foi criado, 0 caso contrário.
+int link_executable(const char *assembly_path, const char *executable_path, const char *root,
+                    char *error, size_t error_size);
+
+#endif // TOOLCHAIN_H
@@ -0,0 +1,175 @@
+#include <stdio.h>  // printf(), fprintf(), fopen(), fdopen()
+#include <stdlib.h> // atol(), mkstemp(), mkdtemp(), malloc(), free()
+#include <string.h> // memcpy()
+#include <unistd.h> // unlink()
+#include <time.h>   // clock_gettime()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "semantic/semantic.h"
+#include "semantic/report.h"
+#include "cache/cache.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantas compilações com o cache já preenchido são medidas para cada programa.
+#define WARM_RUNS 20
+
+/// @brief Retorna o tempo decorrido entre dois instantes, em segundos.
+static double elapsed(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/// @brief Escreve um programa P- com a quantidade de comandos dada, com laços, condições e expressões
+///        que as otimizações transformam.
+static char *generate_program(long statements, size_t *length)
+{
+    char *text = NULL;
+    FILE *file = open_memstream(&text, length);
+    if (file == NULL)
+        return NULL;
+    fprintf(file, "{\n  inteiro a, b, i, n;\n  real x;\n  ler(n);\n  a = 1;\n  b = 2;\n  x = 0.5;\n");
+    for (long written = 0; written < statements; written++)
+    {
+        switch (written % 4)
+        {
+        case 0:
+            fprintf(file, "  a = a * 3 + b * n - 1;\n");
+            break;
+        case 1:
+            fprintf(file, "  x = x * 2.5 + a / 2;\n");
+            break;
+        case 2:
+            fprintf(file, "  se (a > n) entao b = a - n; senao b = n * 2;\n");
+            break;
+        default:
+            fprintf(file, "  i = 0;\n  enquanto (i < n) {\n    a = a + i * 4;\n    i = i + 1;\n  }\n");
+            written++;
+            break;
+        }
+    }
+    fprintf(file, "  mostrar(a);\n  mostrar(x);\n}\n");
+    if (fclose(file) != 0)
+        return NULL;
+
+    // open_source_buffer() precisa de dois bytes graváveis depois do texto
+    char *source = (char *)malloc(*length + 2);
+    if (source != NULL)
+        memcpy(source, text, *length);
+    free(text);
+    return source;
+}
+
+/// @brief Uma compilação sem cache, como main_semantic.c: a consulta que falha, análise léxica, sintática e
+///        semântica, relatório e gravação no cache.
+/// @return 1 se o programa foi compilado e guardado, 0 caso contrário.
+static int compile_cold(program_cache *cache, char *source, size_t length, FILE *sink)
+{
+    cache_key key = compute_cache_key(source, length);
+    cached_program program;
+    if (lookup_program(cache, key, &program))
+    {
+        release_cached_program(&program);
+        return 0;
+    }
+    parse_context *context = create_parse_context();
+    if (context == NULL || !open_source_buffer(context->scanner, source, length))
+    {
+        destroy_parse_context(context);
+        return 0;
+    }
+    tree_node *tree = parse(context);
+    semantic_analyzer *analyzer = (tree != NULL) ? create_semantic_analyzer(tree, context->arena) : NULL;
+    int ok = analyzer != NULL;
+    if (ok)
+    {
+        analyze_semantics(analyzer);
+        write_report(analyzer, sink);
+        ok = store_program(cache, key, analyzer);
+    }
+    destroy_semantic_analyzer(analyzer);
+    destroy_parse_context(context);
+    return ok;
+}
+
+/// @brief Uma compilação com o cache preenchido: a chave, o mapeamento da entrada e o relatório.
+static int compile_warm(program_cache *cache, const char *source, size_t length, FILE *sink)
+{
+    cached_program program;
+    if (!lookup_program(cache, compute_cache_key(source, length), &program))
+        return 0;
+    report_contents contents = {&program.original_tree, &program.adjusted_tree, program.symbols,
+                                program.symbol_count,   program.errors,         program.error_count,
+                                &program.details};
+    report_options options = default_report_options();
+    report_buffer buffer = {NULL, 0, 0, 0};
+    int ok = render_report(&contents, &options, &buffer) && write_report_buffer(sink, &buffer);
+    release_report_buffer(&buffer);
+    release_cached_program(&program);
+    return ok;
+}
+
+/// @brief Mede a compilação de um programa sem e com o cache.
+/// @return Quantas vezes a compilação com o cache foi mais rápida, ou -1 em caso de erro.
+static double run(program_cache *cache, long statements, FILE *sink)
+{
+    size_t length = 0;
+    char *source = generate_program(statements, &length);
+    if (source == NULL)
+        return -1;
+
+    struct timespec start, middle, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int ok = compile_cold(cache, source, length, sink);
+    clock_gettime(CLOCK_MONOTONIC, &middle);
+    for (int i = 0; ok && i < WARM_RUNS; i++)
+        ok = compile_warm(cache, source, length, sink);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    free(source);
+    if (!ok)
+        return -1;
+
+    double cold = elapsed(start, middle);
+    double warm = elapsed(middle, end) / WARM_RUNS;
+    printf("%-10ld %-12zu %-12.4f %-12.4f %-10.1f\n", statements, length, cold, warm, cold / warm);
+    return cold / warm;
+}
+
+/// @brief Compara a compilação sem cache (fria) e com cache (quente) de programas de 10^3 a 10^5 comandos,
+///        com o relatório escrito em /dev/null, e mostra os acertos e as falhas do cache.
+/// @return 0 se a compilação quente foi mais rápida em todos os tamanhos, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    static const long sizes[] = {1000, 10000, 100000};
+    long largest = (argc > 1) ? atol(argv[1]) : 100000;
+    yydebug = 0;
+
+    char directory[] = "/tmp/bench_cache_XXXXXX";
+    program_cache cache;
+    FILE *sink = fopen("/dev/null", "w");
+    if (mkdtemp(directory) == NULL || !open_program_cache(&cache, directory) || sink == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel criar o diretorio de cache\n");
+        return 1;
+    }
+
+    printf("%-10s %-12s %-12s %-12s %-10s\n", "Comandos", "Fonte (B)", "Fria (s)", "Quente (s)", "Ganho");
+    int faster = 1;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= largest; i++)
+    {
+        double speedup = run(&cache, sizes[i], sink);
+        if (speedup < 0)
+        {
+            fprintf(stderr, "A compilacao de %ld comandos falhou\n", sizes[i]);
+            return 1;
+        }
+        faster = faster && speedup > 1;
+    }
+    fclose(sink);
+
+    printf("Cache: %d acertos, %d falhas, %d gravacoes, %zu bytes gravados, %zu bytes lidos\n", cache.stats.hits,
+           cache.stats.misses, cache.stats.stores, cache.stats.bytes_written, cache.stats.bytes_read);
+    printf("Entradas em %s\n", directory);
+    return faster ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>  // printf(), fprintf()
+#include <stdlib.h> // atol()
+#include <string.h> // strlen()
+#include <time.h>   // clock_gettime()
+#include "compiler/compiler.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Um programa pequeno, do tamanho típico de um trecho enviado por um editor ou por um teste.
+static const char *snippet =
+    "{\n"
+    "  inteiro numero, fatorial, acumulador;\n"
+    "  real media;\n"
+    "  ler(numero);\n"
+    "  fatorial = 1;\n"
+    "  acumulador = 1;\n"
+    "  enquanto (acumulador <= numero) {\n"
+    "    fatorial = fatorial * acumulador;\n"
+    "    acumulador = acumulador + 1;\n"
+    "  }\n"
+    "  media = fatorial / 2;\n"
+    "  mostrar(media);\n"
+    "}\n";
+
+/// @brief Retorna o tempo decorrido, em segundos, desde start.
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/// @brief Mede compilações por segundo de um programa em memória: reaproveitando um único compilador
+///        e criando um compilador novo a cada compilação.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    long iterations = (argc > 1) ? atol(argv[1]) : 100000;
+    size_t length = strlen(snippet);
+    struct timespec start;
+
+    compiler *reused = create_compiler();
+    if (reused == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < iterations; i++)
+    {
+        const compile_result *result = compile_source(reused, snippet, length);
+        if (result == NULL || result->has_errors)
+        {
+            fprintf(stderr, "Falha ao compilar o programa de teste\n");
+            return 1;
+        }
+    }
+    double reused_seconds = elapsed_since(&start);
+    destroy_compiler(reused);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < iterations; i++)
+    {
+        compiler *fresh = create_compiler();
+        if (fresh == NULL || compile_source(fresh, snippet, length) == NULL)
+        {
+            fprintf(stderr, "Falha ao compilar o programa de teste\n");
+            return 1;
+        }
+        destroy_compiler(fresh);
+    }
+    double fresh_seconds = elapsed_since(&start);
+
+    printf("Compilacoes:            %ld\n", iterations);
+    printf("Contexto reaproveitado: %.3f s (%.0f compilacoes/s, %.2f us cada)\n",
+           reused_seconds, iterations / reused_seconds, reused_seconds * 1e6 / iterations);
+    printf("Contexto novo:          %.3f s (%.0f compilacoes/s, %.2f us cada)\n",
+           fresh_seconds, iterations / fresh_seconds, fresh_seconds * 1e6 / iterations);
+    printf("Ganho:                  %.2fx\n", fresh_seconds / reused_seconds);
+    return 0;
+}
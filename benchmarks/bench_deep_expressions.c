@@ -0,0 +1,112 @@
+#include <stdio.h>  // printf(), fprintf()
+#include <stdlib.h> // atol()
+#include <unistd.h> // unlink()
+#include <time.h>   // clock_gettime()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "semantic/semantic.h"
+#include "optimizer/optimizer.h"
+#include "scaling.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantas vezes o custo por operação da expressão mais profunda pode passar o da menor para os
+///        ajustes ainda serem considerados lineares.
+#define MAX_COST_RATIO 3.0
+
+/// @brief Escreve um programa P- com uma atribuição inteira e uma real cujas expressões têm a
+///        profundidade dada: a + b * 2 - a + 1 / 3 ..., que a gramática aninha à esquerda. Na real, os
+///        operandos inteiros recebem conversões.
+static void generate_program(FILE *file, long depth)
+{
+    static const char *integer_operations[] = {"+ b", "* 2", "- a", "+ 1", "/ 3"};
+    static const char *real_operations[] = {"+ b", "* x", "- 1.5", "+ a", "/ 2.0"};
+
+    fprintf(file, "{\n  inteiro a, b;\n  real x;\n  a = 1;\n  b = 2;\n  x = 0.5;\n  a = a");
+    for (long i = 0; i < depth; i++)
+        fprintf(file, " %s", integer_operations[i % 5]);
+    fprintf(file, ";\n  x = x");
+    for (long i = 0; i < depth; i++)
+        fprintf(file, " %s", real_operations[i % 5]);
+    fprintf(file, ";\n  mostrar(a);\n  mostrar(x);\n}\n");
+}
+
+/// @brief Analisa um programa com expressões da profundidade dada e imprime os tempos dos ajustes
+///        semânticos (tipos e conversões) e das otimizações.
+/// @return O custo dos ajustes por operação, em nanossegundos, ou -1 se o programa não pôde ser analisado.
+static double run(long depth)
+{
+    char path[] = "/tmp/bench_deep_expressions_XXXXXX";
+    if (!write_generated_program(path, generate_program, depth))
+        return -1;
+
+    parse_context *context = create_parse_context();
+    if (context == NULL || !open_source_file(context->scanner, path))
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        destroy_parse_context(context);
+        unlink(path);
+        return -1;
+    }
+    tree_node *tree = parse(context);
+    unlink(path);
+    semantic_analyzer *analyzer = (tree != NULL) ? create_semantic_analyzer(tree, context->arena) : NULL;
+    if (analyzer == NULL)
+    {
+        destroy_parse_context(context);
+        return -1;
+    }
+
+    // As mesmas etapas de analyze_semantics(), medidas em separado
+    struct timespec start, middle, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    process_declarations(analyzer, analyzer->original_tree);
+    analyzer->adjusted_tree = adjust_tree_sequential(analyzer, analyzer->original_tree);
+    clock_gettime(CLOCK_MONOTONIC, &middle);
+    if (analyzer->error_count == 0)
+        optimize_tree(analyzer);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long operations = 2 * depth;
+    double cost = (analyzer->error_count > 0) ? -1 : elapsed_seconds(start, middle) * 1e9 / operations;
+    printf("%-12ld %-14.4f %-14.1f %-14.4f %-10d\n", depth, elapsed_seconds(start, middle), cost,
+           elapsed_seconds(middle, end), analyzer->error_count);
+
+    destroy_semantic_analyzer(analyzer);
+    destroy_parse_context(context);
+    return cost;
+}
+
+/// @brief Mede os ajustes semânticos de expressões com profundidade de 10^3 a 3,2 * 10^4 e verifica que o
+///        custo por operação não cresce com a profundidade.
+/// @return 0 se o crescimento foi linear, 1 se não foi ou se algum programa não pôde ser analisado.
+int main(int argc, char **argv)
+{
+    static const long depths[] = {1000, 2000, 4000, 8000, 16000, 32000};
+    long deepest = (argc > 1) ? atol(argv[1]) : 32000;
+    yydebug = 0;
+
+    printf("%-12s %-14s %-14s %-14s %-10s\n", "Profundidade", "Ajustes (s)", "ns/operacao", "Otimizacao (s)",
+           "Erros");
+    long reference_depth = 0, depth = 0;
+    double reference = -1, cost = -1;
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]) && depths[i] <= deepest; i++)
+    {
+        depth = depths[i];
+        cost = run(depth);
+        if (cost < 0)
+            return 1;
+
+        // As menores expressões levam microssegundos: a referência é a de 2000, quando medida
+        if (i <= 1)
+        {
+            reference = cost;
+            reference_depth = depths[i];
+        }
+    }
+
+    if (reference <= 0)
+        return 0;
+    return check_cost_ratio("operacao", depth, cost, reference_depth, reference, MAX_COST_RATIO) ? 0 : 1;
+}
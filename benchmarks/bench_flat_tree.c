@@ -0,0 +1,177 @@
+#include <stdio.h>  // printf(), fprintf(), fdopen()
+#include <stdlib.h> // atol(), mkstemp()
+#include <string.h> // memset()
+#include <unistd.h> // unlink()
+#include <time.h>   // clock_gettime()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "parser/flat_tree.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantas vezes cada árvore é percorrida, para que o tempo medido não seja só o da primeira visita.
+#define TRAVERSALS 10
+
+/// @brief Quantas vezes a árvore de nós deve ocupar a memória da árvore compacta, no mínimo.
+#define MIN_MEMORY_RATIO 2.0
+
+/// @brief Retorna o tempo decorrido entre dois instantes, em segundos.
+static double elapsed(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/// @brief Escreve um programa P- com a quantidade de comandos dada: atribuições com expressões de
+///        alguns operadores, escritas e laços com o corpo em bloco.
+static void generate_program(FILE *file, long statements)
+{
+    fprintf(file, "{\n  inteiro a, b, i;\n  real x;\n  a = 1;\n  b = 2;\n  x = 0.5;\n");
+    for (long written = 0; written < statements; written++)
+    {
+        switch (written % 4)
+        {
+        case 0:
+            fprintf(file, "  a = a * 3 + b - 1;\n");
+            break;
+        case 1:
+            fprintf(file, "  x = x * 2.5 + a / 2;\n");
+            break;
+        case 2:
+            fprintf(file, "  mostrar(a + b);\n");
+            break;
+        default:
+            fprintf(file, "  i = 0;\n  enquanto (i < 3 && a > 0) {\n    i = i + 1;\n  }\n");
+            written++;
+            break;
+        }
+    }
+    fprintf(file, "  mostrar(x);\n}\n");
+}
+
+/// @brief Conta os nós de uma lista da árvore de nós, com os descendentes.
+static long count_nodes(const tree_node *node)
+{
+    long count = 0;
+    for (; node != NULL; node = node->sibling)
+    {
+        count++;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            count += count_nodes(node->child[i]);
+    }
+    return count;
+}
+
+/// @brief Percorre a árvore de nós seguindo os ponteiros e soma as linhas dos identificadores.
+static long sum_identifier_lines(const tree_node *node)
+{
+    long sum = 0;
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind == EXPRESSION_KIND && node->kind.exp == IDENTIFIER_EXPRESSION)
+            sum += node->line_number;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            sum += sum_identifier_lines(node->child[i]);
+    }
+    return sum;
+}
+
+/// @brief Faz a mesma soma na árvore compacta, varrendo as colunas de tipos e de linhas em ordem.
+static long sum_flat_identifier_lines(const flat_tree *flat)
+{
+    long sum = 0;
+    for (node_id node = 0; node < flat->count; node++)
+    {
+        if (flat->kinds[node] == FLAT_IDENTIFIER)
+            sum += flat->lines[node];
+    }
+    return sum;
+}
+
+/// @brief Analisa um programa com a quantidade de comandos dada, converte a árvore e imprime a memória das
+///        duas formas e o tempo de percorrê-las.
+/// @return A razão entre a memória da árvore de nós e a da árvore compacta, ou -1 em caso de erro.
+static double run(long statements)
+{
+    char path[] = "/tmp/bench_flat_tree_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    if (file == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel criar o arquivo temporario\n");
+        return -1;
+    }
+    generate_program(file, statements);
+    fclose(file);
+
+    parse_context *context = create_parse_context();
+    if (context == NULL || !open_source_file(context->scanner, path))
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        destroy_parse_context(context);
+        unlink(path);
+        return -1;
+    }
+    tree_node *tree = parse(context);
+    unlink(path);
+    flat_tree flat;
+    memset(&flat, 0, sizeof(flat));
+    if (tree == NULL || context->is_error || !flatten_tree(&flat, tree))
+    {
+        release_flat_tree(&flat);
+        destroy_parse_context(context);
+        return -1;
+    }
+
+    long nodes = count_nodes(tree);
+    double pointer_bytes = (double)nodes * sizeof(tree_node);
+    double flat_bytes = (double)flat_tree_size(&flat);
+
+    struct timespec start, middle, end;
+    long pointer_sum = 0, flat_sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < TRAVERSALS; i++)
+        pointer_sum += sum_identifier_lines(tree);
+    clock_gettime(CLOCK_MONOTONIC, &middle);
+    for (int i = 0; i < TRAVERSALS; i++)
+        flat_sum += sum_flat_identifier_lines(&flat);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("%-10ld %-10ld %-14.1f %-14.1f %-10.4f %-10.4f\n", statements, nodes, pointer_bytes / nodes,
+           flat_bytes / nodes, elapsed(start, middle), elapsed(middle, end));
+
+    release_flat_tree(&flat);
+    destroy_parse_context(context);
+    if (pointer_sum != flat_sum)
+    {
+        fprintf(stderr, "As duas arvores deram somas diferentes: %ld e %ld\n", pointer_sum, flat_sum);
+        return -1;
+    }
+    return pointer_bytes / flat_bytes;
+}
+
+/// @brief Compara a árvore de nós com a árvore compacta em programas de 10^4 a 10^6 comandos: a memória
+///        por nó e o tempo de percorrer todos os nós.
+/// @return 0 se a árvore compacta ocupou no máximo metade da memória, 1 se não ou em caso de erro.
+int main(int argc, char **argv)
+{
+    static const long sizes[] = {10000, 100000, 1000000};
+    long largest = (argc > 1) ? atol(argv[1]) : 1000000;
+    yydebug = 0;
+
+    printf("%-10s %-10s %-14s %-14s %-10s %-10s\n", "Comandos", "Nos", "Bytes/no", "Bytes/no comp.",
+           "Nos (s)", "Comp. (s)");
+    double ratio = -1;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= largest; i++)
+    {
+        ratio = run(sizes[i]);
+        if (ratio < 0)
+            return 1;
+    }
+
+    if (ratio < 0)
+        return 0;
+    printf("Memoria da arvore de nos em relacao a compacta: %.2fx (minimo %.1fx): %s\n", ratio, MIN_MEMORY_RATIO,
+           (ratio >= MIN_MEMORY_RATIO) ? "ok" : "INSUFICIENTE");
+    return (ratio >= MIN_MEMORY_RATIO) ? 0 : 1;
+}
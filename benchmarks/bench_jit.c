@@ -0,0 +1,225 @@
+#include <fcntl.h>  // open()
+#include <stdio.h>  // printf(), fprintf(), snprintf()
+#include <stdlib.h> // atol(), qsort(), malloc(), free()
+#include <string.h> // strlen()
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // close()
+#include "compiler/compiler.h"
+#include "interpreter/interpreter.h"
+#include "jit/jit.h"
+#include "runtime/program_io.h"
+#include "vm/bytecode.h"
+#include "vm/vm.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantas vezes cada programa é compilado para medir a latência da compilação.
+#define LATENCY_SAMPLES 2000
+
+/// @brief test.factorial.p ampliado: calcula 12! repetidas vezes, sem ler da entrada.
+static const char *factorial_program =
+    "{\n"
+    "  inteiro n, i, fatorial, acumulador, soma;\n"
+    "  n = %ld;\n"
+    "  i = 0;\n"
+    "  soma = 0;\n"
+    "  enquanto (i < n) {\n"
+    "    fatorial = 1;\n"
+    "    acumulador = 1;\n"
+    "    enquanto (acumulador <= 12) {\n"
+    "      fatorial = fatorial * acumulador;\n"
+    "      acumulador = acumulador + 1;\n"
+    "    }\n"
+    "    soma = soma + fatorial;\n"
+    "    i = i + 1;\n"
+    "  }\n"
+    "  mostrar(soma);\n"
+    "}\n";
+
+/// @brief No estilo de test.conditions.p: condições compostas, se/senao e repita dentro de um laço.
+static const char *conditions_program =
+    "{\n"
+    "  inteiro n, i, a, b, c;\n"
+    "  real r;\n"
+    "  n = %ld;\n"
+    "  i = 0; a = 0; b = 0; c = 0;\n"
+    "  r = 0.0;\n"
+    "  enquanto (i < n) {\n"
+    "    se (i - (i / 3) * 3 == 0 && a < b || c > 10) entao a = a + 1; senao b = b + 2;\n"
+    "    se (a > b) entao c = c - 1; senao c = c + 3;\n"
+    "    r = r + 0.5;\n"
+    "    repita { c = c - 1; } ate c < 5;\n"
+    "    i = i + 1;\n"
+    "  }\n"
+    "  mostrar(a);\n"
+    "  mostrar(b);\n"
+    "  mostrar(r);\n"
+    "}\n";
+
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/// @brief Compila o programa com n voltas; o compiler precisa continuar vivo enquanto a árvore for usada.
+static compiler *prepare(const char *name, const char *source_format, long iterations)
+{
+    char source[2048];
+    snprintf(source, sizeof(source), source_format, iterations);
+
+    compiler *compiler = create_compiler();
+    const compile_result *result = (compiler != NULL) ? compile_source(compiler, source, strlen(source)) : NULL;
+    if (result == NULL || result->has_errors)
+    {
+        fprintf(stderr, "Falha ao compilar o programa %s\n", name);
+        destroy_compiler(compiler);
+        return NULL;
+    }
+    resolve_tree(compiler->analyzer);
+    return compiler;
+}
+
+/// @brief Mede, com o programa de zero voltas, o tempo da chamada de compile_jit() até a primeira
+///        instrução gerada executar, e o da mesma tradução para bytecode.
+static int measure_latency(compiler *compiler, int output_fd, double *jit_median, double *jit_p99,
+                           double *bytecode_median, size_t *code_bytes)
+{
+    tree_node *tree = compiler->result.adjusted_tree;
+    int frame_size = compiler->analyzer->table.next_address;
+    double *jit = (double *)malloc(LATENCY_SAMPLES * sizeof(double));
+    double *vm = (double *)malloc(LATENCY_SAMPLES * sizeof(double));
+    program_io *io = create_program_io(-1, output_fd);
+    int ok = (jit != NULL && vm != NULL && io != NULL);
+
+    for (int i = 0; i < LATENCY_SAMPLES && ok; i++)
+    {
+        execution_error error;
+        jit_program *program = compile_jit(tree, frame_size);
+        ok = (program != NULL) && run_jit(program, io, &error);
+        if (ok)
+        {
+            jit[i] = program->first_instruction_seconds;
+            *code_bytes = program->length;
+        }
+        destroy_jit(program);
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bytecode *code = compile_bytecode(tree, frame_size, 1);
+        vm[i] = elapsed_since(&start);
+        ok = ok && (code != NULL);
+        destroy_bytecode(code);
+    }
+
+    if (ok)
+    {
+        qsort(jit, LATENCY_SAMPLES, sizeof(double), compare_doubles);
+        qsort(vm, LATENCY_SAMPLES, sizeof(double), compare_doubles);
+        *jit_median = jit[LATENCY_SAMPLES / 2];
+        *jit_p99 = jit[LATENCY_SAMPLES * 99 / 100];
+        *bytecode_median = vm[LATENCY_SAMPLES / 2];
+    }
+    free(jit);
+    free(vm);
+    destroy_program_io(io);
+    return ok;
+}
+
+/// @brief Executa o programa com um motor e retorna o tempo gasto (incluindo a compilação), ou -1 em caso de erro.
+/// @param engine 0 para o interpretador da árvore, 1 para a máquina virtual e 2 para o JIT.
+static double measure(compiler *compiler, int engine, int output_fd)
+{
+    tree_node *tree = compiler->result.adjusted_tree;
+    int frame_size = compiler->analyzer->table.next_address;
+    program_io *io = create_program_io(-1, output_fd);
+    execution_error error;
+    int finished = 0;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (engine == 0)
+        finished = interpret_program(tree, frame_size, io, &error);
+    else if (engine == 1)
+    {
+        bytecode *program = compile_bytecode(tree, frame_size, 1);
+        finished = (program != NULL) && run_bytecode(program, THREADED_DISPATCH, io, &error);
+        destroy_bytecode(program);
+    }
+    else
+    {
+        jit_program *program = compile_jit(tree, frame_size);
+        finished = (program != NULL) && run_jit(program, io, &error);
+        destroy_jit(program);
+    }
+    double seconds = elapsed_since(&start);
+
+    destroy_program_io(io);
+    return finished ? seconds : -1;
+}
+
+static int benchmark(const char *name, const char *source_format, long iterations, int output_fd)
+{
+    compiler *empty = prepare(name, source_format, 0);
+    compiler *full = prepare(name, source_format, iterations);
+    double jit_median = 0, jit_p99 = 0, bytecode_median = 0;
+    size_t code_bytes = 0;
+    int ok = (empty != NULL && full != NULL) &&
+             measure_latency(empty, output_fd, &jit_median, &jit_p99, &bytecode_median, &code_bytes);
+
+    double tree = ok ? measure(full, 0, output_fd) : -1;
+    double vm = ok ? measure(full, 1, output_fd) : -1;
+    double jit = ok ? measure(full, 2, output_fd) : -1;
+    destroy_compiler(empty);
+    destroy_compiler(full);
+    if (tree < 0 || vm < 0 || jit < 0)
+    {
+        fprintf(stderr, "Falha ao executar o programa %s\n", name);
+        return 0;
+    }
+
+    printf("%s (%ld voltas)\n", name, iterations);
+    printf("  Latencia ate a primeira instrucao: mediana %.1f us, p99 %.1f us (%zu bytes de codigo)\n",
+           jit_median * 1e6, jit_p99 * 1e6, code_bytes);
+    printf("  Traducao para bytecode:            mediana %.1f us\n", bytecode_median * 1e6);
+    printf("  Arvore:  %.3f s, %7.1f milhoes de voltas/s\n", tree, iterations / tree / 1e6);
+    printf("  VM:      %.3f s, %7.1f milhoes de voltas/s (%.2fx)\n", vm, iterations / vm / 1e6, tree / vm);
+    printf("  JIT:     %.3f s, %7.1f milhoes de voltas/s (%.2fx)\n", jit, iterations / jit / 1e6, tree / jit);
+    return 1;
+}
+
+/// @brief Mede a latência do JIT, da chamada de compile_jit() até a primeira instrução gerada, e a vazão
+///        do código gerado, comparada ao interpretador da árvore e à máquina virtual.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    long iterations = (argc > 1) ? atol(argv[1]) : 1000000;
+
+    if (!jit_supported())
+    {
+        fprintf(stderr, "JIT indisponivel nesta plataforma\n");
+        return 1;
+    }
+
+    // A saída dos programas é descartada
+    int output_fd = open("/dev/null", O_WRONLY);
+    if (output_fd < 0)
+    {
+        fprintf(stderr, "Nao foi possivel abrir /dev/null\n");
+        return 1;
+    }
+
+    int ok = benchmark("fatorial", factorial_program, iterations, output_fd) &&
+             benchmark("condicoes", conditions_program, iterations, output_fd);
+
+    close(output_fd);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+#include <stdio.h>  // printf(), fprintf(), fopen(), open_memstream()
+#include <stdlib.h> // atol(), malloc(), free(), qsort()
+#include <string.h> // strcmp(), strlen(), strstr()
+#include "language_server/json.h"
+#include "language_server/language_server.h"
+#include "compiler/compiler.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief O endereço do documento aberto no servidor.
+#define DOCUMENT_URI "file:///bench.p"
+
+/// @brief O limite para o percentil 99 da latência de uma mudança, em microssegundos.
+#define P99_LIMIT 5000.0
+
+/// @brief A cada quantas edições uma variável não declarada fica no texto, para que o documento final
+///        tenha erros semânticos a comparar.
+#define KEPT_TYPO_PERIOD 97
+
+/// @brief Um programa com um identificador acentuado: o analisador léxico acusa cada byte de "ç" como
+///        um caractere inesperado, e os erros publicados não podem levar esses bytes soltos.
+#define NON_ASCII_PROGRAM "{\n  inteiro pre\xc3\xa7o;\n  pre\xc3\xa7o = 1;\n}\n"
+
+/// @brief Um erro, com a linha no documento, para a comparação entre as análises.
+typedef struct bench_diagnostic
+{
+    int line;
+    int kind;
+    const char *message;
+} bench_diagnostic;
+
+static unsigned long long random_state = 42;
+
+/// @brief Um gerador congruente linear, para que as edições sejam as mesmas em todas as execuções.
+static unsigned int next_random(void)
+{
+    random_state = random_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned int)(random_state >> 33);
+}
+
+/// @brief Escreve um programa P- com cerca da quantidade de linhas dada, com laços, condições e expressões.
+static char *generate_program(long lines, size_t *length)
+{
+    char *text = NULL;
+    FILE *file = open_memstream(&text, length);
+    if (file == NULL)
+        return NULL;
+    fprintf(file, "{\n  inteiro a, b, i, n;\n  real x;\n  ler(n);\n  a = 1;\n  b = 2;\n  x = 0.5;\n");
+    for (long written = 7; written < lines - 3;)
+    {
+        switch (written % 4)
+        {
+        case 0:
+            fprintf(file, "  a = a * 3 + b * n - 1;\n");
+            written++;
+            break;
+        case 1:
+            fprintf(file, "  x = x * 2.5 + a / 2;\n");
+            written++;
+            break;
+        case 2:
+            fprintf(file, "  se (a > n) entao b = a - n; senao b = n * 2;\n");
+            written++;
+            break;
+        default:
+            fprintf(file, "  i = 0;\n  enquanto (i < n) {\n    a = a + i * 4;\n    i = i + 1;\n  }\n");
+            written += 5;
+            break;
+        }
+    }
+    fprintf(file, "  mostrar(a);\n  mostrar(x);\n}\n");
+    return (fclose(file) == 0) ? text : NULL;
+}
+
+/// @brief Entrega uma mensagem ao servidor, como se tivesse chegado pela entrada padrão.
+static int deliver(language_server *server, char *text, size_t length)
+{
+    int ok = text != NULL && handle_message(server, text, length);
+    free(text);
+    return ok;
+}
+
+static int open_text(language_server *server, const char *source, size_t source_length)
+{
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = open_memstream(&text, &length);
+    if (body == NULL)
+        return 0;
+    fputs("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didOpen\","
+          "\"params\":{\"textDocument\":{\"uri\":\"" DOCUMENT_URI "\",\"languageId\":\"p-\",\"version\":1,\"text\":",
+          body);
+    write_json_string(body, source, source_length);
+    fputs("}}}", body);
+    return fclose(body) == 0 && deliver(server, text, length);
+}
+
+/// @brief Envia uma mudança que troca o trecho entre duas posições (linha e caractere) pelo texto dado.
+static int change_text(language_server *server, int version, int start_line, int start_character, int end_line,
+                       int end_character, const char *replacement)
+{
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = open_memstream(&text, &length);
+    if (body == NULL)
+        return 0;
+    fprintf(body,
+            "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\","
+            "\"params\":{\"textDocument\":{\"uri\":\"" DOCUMENT_URI "\",\"version\":%d},"
+            "\"contentChanges\":[{\"range\":{\"start\":{\"line\":%d,\"character\":%d},"
+            "\"end\":{\"line\":%d,\"character\":%d}},\"text\":",
+            version, start_line, start_character, end_line, end_character);
+    write_json_string(body, replacement, strlen(replacement));
+    fputs("}]}}", body);
+    return fclose(body) == 0 && deliver(server, text, length);
+}
+
+/// @brief Aplica as edições de um editor: digitar e apagar um caractere no início de uma variável,
+///        inserir e apagar uma linha, e acrescentar e retirar uma variável na declaração.
+/// @return 1 se todas as mensagens foram atendidas, 0 caso contrário.
+static int edit(language_server *server, document *document, long edits)
+{
+    int version = 2;
+    for (long done = 0; done < edits;)
+    {
+        int lines = document_line_count(document);
+        int line = 4 + (int)(next_random() % (unsigned int)(lines - 8)); // Entre os comandos, a partir de 0
+        document_token token;
+        switch (next_random() % 3)
+        {
+        case 0:
+            // Uma letra antes de uma variável cria um nome não declarado, que é apagado em seguida
+            if (!document_token_at(document, document_offset(document, line, 2), &token) || token.type != T_ID)
+                continue;
+            if (!change_text(server, version++, line, 2, line, 2, "q"))
+                return 0;
+            if (++done % KEPT_TYPO_PERIOD != 0 && !change_text(server, version++, line, 2, line, 3, ""))
+                return 0;
+            break;
+        case 1:
+            if (!change_text(server, version++, line, 0, line, 0, "  n = n + 1;\n") ||
+                !change_text(server, version++, line, 0, line + 1, 0, ""))
+                return 0;
+            done++;
+            break;
+        default:
+            // Uma declaração nova refaz a tabela de símbolos, mas nenhum uso depende dela
+            if (!change_text(server, version++, 1, 20, 1, 20, ", z") ||
+                !change_text(server, version++, 1, 20, 1, 23, ""))
+                return 0;
+            done++;
+            break;
+        }
+    }
+    return 1;
+}
+
+static int compare_diagnostics(const void *a, const void *b)
+{
+    const bench_diagnostic *x = (const bench_diagnostic *)a, *y = (const bench_diagnostic *)b;
+    if (x->line != y->line)
+        return x->line - y->line;
+    if (x->kind != y->kind)
+        return x->kind - y->kind;
+    return strcmp(x->message, y->message);
+}
+
+/// @brief Reúne os erros de todas as unidades de um documento, em ordem.
+static bench_diagnostic *collect_document(const document *document, int *count)
+{
+    size_t size = (size_t)(document->diagnostic_count + 1) * sizeof(bench_diagnostic);
+    bench_diagnostic *list = (bench_diagnostic *)malloc(size);
+    if (list == NULL)
+        return NULL;
+    *count = 0;
+    for (int i = 0; i < document->unit_count; i++)
+    {
+        const document_unit *unit = document->units[i];
+        for (int j = 0; j < unit->syntax.count; j++)
+            list[(*count)++] = (bench_diagnostic){unit->first_line + unit->syntax.items[j].line - 1,
+                                                  unit->syntax.items[j].kind, unit->syntax.items[j].message};
+        for (int j = 0; j < unit->semantic.count; j++)
+            list[(*count)++] = (bench_diagnostic){unit->first_line + unit->semantic.items[j].line - 1,
+                                                  unit->semantic.items[j].kind, unit->semantic.items[j].message};
+    }
+    qsort(list, (size_t)*count, sizeof(bench_diagnostic), compare_diagnostics);
+    return list;
+}
+
+static int same_diagnostics(const bench_diagnostic *a, int a_count, const bench_diagnostic *b, int b_count)
+{
+    if (a_count != b_count)
+        return 0;
+    for (int i = 0; i < a_count; i++)
+    {
+        if (compare_diagnostics(&a[i], &b[i]) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+/// @brief Compara os erros do documento editado com os de uma análise nova do mesmo texto e com os do
+///        compilador inteiro.
+/// @return 1 se as três análises encontraram os mesmos erros, 0 caso contrário.
+static int verify(const document *edited)
+{
+    int incremental_count = 0, fresh_count = 0;
+    bench_diagnostic *incremental = collect_document(edited, &incremental_count);
+    document *fresh = create_document();
+    bench_diagnostic *from_fresh = NULL;
+    if (fresh != NULL && set_document_text(fresh, edited->text, edited->length))
+        from_fresh = collect_document(fresh, &fresh_count);
+
+    compiler *full = create_compiler();
+    const compile_result *result = (full != NULL) ? compile_source(full, edited->text, edited->length) : NULL;
+    bench_diagnostic *from_compiler = NULL;
+    int compiler_count = 0;
+    if (result != NULL)
+    {
+        size_t size = (size_t)(result->diagnostic_count + 1) * sizeof(bench_diagnostic);
+        from_compiler = (bench_diagnostic *)malloc(size);
+        for (int i = 0; from_compiler != NULL && i < result->diagnostic_count; i++)
+        {
+            const diagnostic *found = &result->diagnostics[i];
+            from_compiler[compiler_count++] = (bench_diagnostic){found->line, found->kind, found->message};
+        }
+        if (from_compiler != NULL)
+            qsort(from_compiler, (size_t)compiler_count, sizeof(bench_diagnostic), compare_diagnostics);
+    }
+
+    int ok = incremental != NULL && from_fresh != NULL && from_compiler != NULL;
+    if (ok)
+    {
+        printf("Erros no documento final: %d (incremental), %d (analise nova), %d (compilador)\n", incremental_count,
+               fresh_count, compiler_count);
+        ok = same_diagnostics(incremental, incremental_count, from_fresh, fresh_count) &&
+             same_diagnostics(incremental, incremental_count, from_compiler, compiler_count);
+    }
+    free(incremental);
+    free(from_fresh);
+    free(from_compiler);
+    destroy_document(fresh);
+    destroy_compiler(full);
+    return ok;
+}
+
+/// @brief Indica se o texto é UTF-8 válido.
+static int is_valid_utf8(const char *text, size_t length)
+{
+    for (size_t i = 0; i < length;)
+    {
+        size_t character = utf8_character_length(text + i, length - i);
+        if (character == 0)
+            return 0;
+        i += character;
+    }
+    return 1;
+}
+
+/// @brief Abre um programa com um identificador acentuado num servidor próprio e verifica que as mensagens
+///        escritas são UTF-8 válido, com os bytes soltos trocados por U+FFFD, e que os cortes das mensagens
+///        longas não separam os bytes de um caractere.
+/// @return 1 se as mensagens e os cortes estão corretos, 0 caso contrário.
+static int verify_non_ascii(void)
+{
+    char *output = NULL;
+    size_t output_length = 0;
+    FILE *sink = open_memstream(&output, &output_length);
+    language_server *server = (sink != NULL) ? create_language_server(sink) : NULL;
+    int opened = server != NULL && open_text(server, NON_ASCII_PROGRAM, strlen(NON_ASCII_PROGRAM));
+    destroy_language_server(server);
+    if (sink == NULL || fclose(sink) != 0)
+        return 0;
+
+    // Em "ação", o corte em 2 bytes não pode ficar com metade de "ç"; um byte solto conta sozinho
+    static const char accented[] = "a\xc3\xa7\xc3\xa3o", stray[] = "\xc3'x";
+    int cuts = utf8_prefix_length(accented, 6, 2) == 1 && utf8_prefix_length(accented, 6, 3) == 3 &&
+               utf8_prefix_length(stray, 3, 2) == 2;
+    int ok = opened && cuts && is_valid_utf8(output, output_length) && strstr(output, "\\ufffd") != NULL &&
+             strstr(output, "publishDiagnostics") != NULL;
+    printf("Identificador acentuado: mensagens em UTF-8 %s\n", ok ? "validas" : "INVALIDAS");
+    free(output);
+    return ok;
+}
+
+/// @brief Abre no servidor de linguagem um programa de 10^5 linhas e aplica milhares de edições pequenas,
+///        como um editor, com as respostas escritas em /dev/null. Mostra a latência entre cada mudança e a
+///        publicação dos erros e compara os erros finais com os de uma análise completa.
+/// @return 0 se o percentil 99 ficou abaixo de 5 ms e os erros coincidem, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    long lines = (argc > 1) ? atol(argv[1]) : 100000;
+    long edits = (argc > 2) ? atol(argv[2]) : 5000;
+    yydebug = 0;
+
+    size_t length = 0;
+    char *source = generate_program(lines, &length);
+    FILE *sink = fopen("/dev/null", "w");
+    language_server *server = (sink != NULL) ? create_language_server(sink) : NULL;
+    if (source == NULL || server == NULL || !open_text(server, source, length) || server->document_count != 1)
+    {
+        fprintf(stderr, "Nao foi possivel abrir o documento\n");
+        return 1;
+    }
+    free(source);
+
+    document *document = server->documents[0].document;
+    printf("Documento: %d linhas, %zu bytes, %d unidades\n", document_line_count(document), document->length,
+           document->unit_count);
+    if (!edit(server, document, edits))
+    {
+        fprintf(stderr, "O servidor encerrou durante as edicoes\n");
+        return 1;
+    }
+
+    latency_summary summary = summarize_latencies(server->latencies);
+    printf("Mudancas: %ld, latencia ate os erros (us): media %.1f, p50 %.1f, p99 %.1f, max %.1f\n", summary.count,
+           summary.mean, summary.p50, summary.p99, summary.max);
+
+    int same = verify(document);
+    if (!same)
+        fprintf(stderr, "Os erros do documento editado diferem dos de uma analise completa\n");
+    int valid = verify_non_ascii();
+    if (summary.p99 > P99_LIMIT)
+        fprintf(stderr, "O percentil 99 passou de %.0f us\n", P99_LIMIT);
+
+    destroy_language_server(server);
+    fclose(sink);
+    return (same && valid && summary.p99 <= P99_LIMIT) ? 0 : 1;
+}
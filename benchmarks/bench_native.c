@@ -0,0 +1,185 @@
+#include <fcntl.h>    // open()
+#include <stdio.h>    // printf(), fprintf(), snprintf(), fdopen(), fclose()
+#include <stdlib.h>   // atol()
+#include <string.h>   // strlen()
+#include <sys/wait.h> // waitpid()
+#include <time.h>     // clock_gettime()
+#include <unistd.h>   // fork(), execl(), dup2(), close(), unlink(), mkstemps()
+#include "backend/codegen_x86_64.h"
+#include "backend/regalloc.h"
+#include "backend/toolchain.h"
+#include "compiler/compiler.h"
+#include "interpreter/interpreter.h"
+#include "runtime/program_io.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief test.factorial.p ampliado: calcula 12! repetidas vezes, sem ler da entrada.
+static const char *factorial_program =
+    "{\n"
+    "  inteiro n, i, fatorial, acumulador, soma;\n"
+    "  n = %ld;\n"
+    "  i = 0;\n"
+    "  soma = 0;\n"
+    "  enquanto (i < n) {\n"
+    "    fatorial = 1;\n"
+    "    acumulador = 1;\n"
+    "    enquanto (acumulador <= 12) {\n"
+    "      fatorial = fatorial * acumulador;\n"
+    "      acumulador = acumulador + 1;\n"
+    "    }\n"
+    "    soma = soma + fatorial;\n"
+    "    i = i + 1;\n"
+    "  }\n"
+    "  mostrar(soma);\n"
+    "}\n";
+
+/// @brief No estilo de test.conditions.p: condições compostas, se/senao e repita dentro de um laço.
+static const char *conditions_program =
+    "{\n"
+    "  inteiro n, i, a, b, c;\n"
+    "  real r;\n"
+    "  n = %ld;\n"
+    "  i = 0; a = 0; b = 0; c = 0;\n"
+    "  r = 0.0;\n"
+    "  enquanto (i < n) {\n"
+    "    se (i - (i / 3) * 3 == 0 && a < b || c > 10) entao a = a + 1; senao b = b + 2;\n"
+    "    se (a > b) entao c = c - 1; senao c = c + 3;\n"
+    "    r = r + 0.5;\n"
+    "    repita { c = c - 1; } ate c < 5;\n"
+    "    i = i + 1;\n"
+    "  }\n"
+    "  mostrar(a);\n"
+    "  mostrar(b);\n"
+    "  mostrar(r);\n"
+    "}\n";
+
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/// @brief Executa a árvore ajustada com o interpretador e retorna o tempo gasto, ou -1 em caso de erro.
+static double measure_tree(compiler *compiler, int output_fd)
+{
+    program_io *io = create_program_io(-1, output_fd);
+    execution_error error;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int finished = interpret_program(compiler->result.adjusted_tree, compiler->analyzer->table.next_address, io, &error);
+    double seconds = elapsed_since(&start);
+
+    destroy_program_io(io);
+    return finished ? seconds : -1;
+}
+
+/// @brief Gera o executável nativo, o executa e retorna o tempo gasto (incluindo a criação do processo),
+///        ou -1 em caso de erro.
+/// @param use_registers 0 deixa todas as variáveis no quadro, para medir o ganho da alocação.
+static double measure_native(compiler *compiler, int use_registers, const char *root, int output_fd)
+{
+    register_allocation *allocation = allocate_registers(compiler->result.adjusted_tree, compiler->result.symbols,
+                                                         use_registers ? X86_64_INTEGER_REGISTERS : 0,
+                                                         use_registers ? X86_64_REAL_REGISTERS : 0);
+    char assembly_path[] = "/tmp/pminus-bench-XXXXXX.s";
+    char executable_path[] = "/tmp/pminus-bench-XXXXXX";
+    int assembly_fd = mkstemps(assembly_path, 2);
+    int executable_fd = mkstemp(executable_path);
+    FILE *assembly = (assembly_fd >= 0) ? fdopen(assembly_fd, "w") : NULL;
+    char error[256];
+    int ok = (allocation != NULL && assembly != NULL && executable_fd >= 0);
+
+    if (ok)
+        ok = generate_x86_64(compiler->result.adjusted_tree, allocation, assembly);
+    if (assembly != NULL)
+        ok = (fclose(assembly) == 0) && ok;
+    if (executable_fd >= 0)
+        close(executable_fd);
+    if (ok && !link_executable(assembly_path, executable_path, root, error, sizeof(error)))
+    {
+        fprintf(stderr, "Falha ao gerar o executavel: %s\n", error);
+        ok = 0;
+    }
+
+    double seconds = -1;
+    if (ok)
+    {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pid_t child = fork();
+        if (child == 0)
+        {
+            dup2(output_fd, STDOUT_FILENO);
+            execl(executable_path, executable_path, (char *)NULL);
+            _exit(127);
+        }
+        int status;
+        if (child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            seconds = elapsed_since(&start);
+    }
+
+    unlink(assembly_path);
+    unlink(executable_path);
+    destroy_register_allocation(allocation);
+    return seconds;
+}
+
+static int benchmark(const char *name, const char *source_format, long iterations, const char *root, int output_fd)
+{
+    char source[2048];
+    snprintf(source, sizeof(source), source_format, iterations);
+
+    compiler *compiler = create_compiler();
+    const compile_result *result = (compiler != NULL) ? compile_source(compiler, source, strlen(source)) : NULL;
+    if (result == NULL || result->has_errors)
+    {
+        fprintf(stderr, "Falha ao compilar o programa %s\n", name);
+        destroy_compiler(compiler);
+        return 0;
+    }
+    resolve_tree(compiler->analyzer);
+
+    double tree = measure_tree(compiler, output_fd);
+    double frame_only = measure_native(compiler, 0, root, output_fd);
+    double registers = measure_native(compiler, 1, root, output_fd);
+    destroy_compiler(compiler);
+    if (tree < 0 || frame_only < 0 || registers < 0)
+    {
+        fprintf(stderr, "Falha ao executar o programa %s\n", name);
+        return 0;
+    }
+
+    printf("%s (%ld voltas)\n", name, iterations);
+    printf("  Arvore:                          %.3f s\n", tree);
+    printf("  Nativo, variaveis no quadro:     %.3f s (%.2fx)\n", frame_only, tree / frame_only);
+    printf("  Nativo, variaveis em registros:  %.3f s (%.2fx)\n", registers, tree / registers);
+    return 1;
+}
+
+/// @brief Compara o interpretador da árvore com o código nativo gerado pelo backend x86-64, com e sem
+///        alocação de registradores, nos mesmos programas do benchmark da máquina virtual.
+/// @note O segundo argumento é o diretório do compilador, onde ficam as fontes do runtime (padrão ".").
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    long iterations = (argc > 1) ? atol(argv[1]) : 1000000;
+    const char *root = (argc > 2) ? argv[2] : ".";
+
+    // A saída dos programas é descartada
+    int output_fd = open("/dev/null", O_WRONLY);
+    if (output_fd < 0)
+    {
+        fprintf(stderr, "Nao foi possivel abrir /dev/null\n");
+        return 1;
+    }
+
+    int ok = benchmark("fatorial", factorial_program, iterations, root, output_fd) &&
+             benchmark("condicoes", conditions_program, iterations, root, output_fd);
+
+    close(output_fd);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>  // printf(), fprintf()
+#include <stdlib.h> // atol()
+#include <unistd.h> // unlink()
+#include <time.h>   // clock_gettime()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "semantic/semantic.h"
+#include "scaling.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantas vezes o custo por comando pode crescer de um tamanho para o seguinte, 10 vezes maior.
+///        Com consultas de tamanho constante às tabelas, o custo não muda (medido: até 1,5x, pela
+///        paginação dos programas maiores); com consultas que percorrem as expressões registradas, ele
+///        cresce 10x. O limite é a média geométrica dos dois, raiz de 10.
+#define MAX_STEP_RATIO 3.2
+
+/// @brief Escreve um programa P- com a quantidade de comandos dada, no pior caso das tabelas das
+///        subexpressões comuns e do compartilhamento: a mesma expressão registrada de novo a cada
+///        atribuição de a, repetições que viram temporárias e expressões repetidas na mesma linha.
+static void generate_program(FILE *file, long statements)
+{
+    fprintf(file, "{\n  inteiro a, b, c, d;\n  ler(a);\n  ler(b);\n");
+    for (long written = 0; written < statements; written++)
+    {
+        switch (written % 3)
+        {
+        case 0:
+            fprintf(file, "  a = a * 3 + b;\n");
+            break;
+        case 1:
+            fprintf(file, "  c = a * 3 + b;\n");
+            break;
+        default:
+            fprintf(file, "  d = (a + c) * (a + c) - d;\n");
+            break;
+        }
+    }
+    fprintf(file, "  mostrar(c);\n  mostrar(d);\n}\n");
+}
+
+/// @brief Analisa e otimiza um programa gerado com a quantidade de comandos dada e imprime o tempo medido.
+/// @return O custo por comando, em nanossegundos, ou -1 se o programa não pôde ser analisado.
+static double run(long statements)
+{
+    char path[] = "/tmp/bench_optimizer_scaling_XXXXXX";
+    if (!write_generated_program(path, generate_program, statements))
+        return -1;
+
+    parse_context *context = create_parse_context();
+    tree_node *tree = NULL;
+    if (context == NULL || !open_source_file(context->scanner, path) || (tree = parse(context)) == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel analisar o arquivo %s\n", path);
+        destroy_parse_context(context);
+        unlink(path);
+        return -1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    semantic_analyzer *analyzer = create_semantic_analyzer(tree, context->arena);
+    if (analyzer != NULL)
+        analyze_semantics(analyzer);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = elapsed_seconds(start, end);
+    double cost = (analyzer == NULL || analyzer->error_count > 0) ? -1 : seconds * 1e9 / statements;
+    if (analyzer != NULL)
+        printf("%-10ld %-12d %-12d %-12.4f %-12.1f\n", statements, analyzer->optimizations.reused_expressions,
+               analyzer->optimizations.shared_nodes, seconds, cost);
+
+    destroy_semantic_analyzer(analyzer);
+    destroy_parse_context(context);
+    unlink(path);
+    return cost;
+}
+
+/// @brief Mede a análise semântica e as otimizações de programas de 10^3 a 10^5 comandos e verifica que o
+///        custo por comando não cresce de um tamanho para o seguinte, isto é, que as consultas às tabelas
+///        das subexpressões comuns e do compartilhamento não ficam mais longas.
+/// @return 0 se o crescimento foi linear, 1 se não foi ou se algum programa não pôde ser analisado.
+int main(int argc, char **argv)
+{
+    static const long sizes[] = {1000, 10000, 100000};
+    long largest = (argc > 1) ? atol(argv[1]) : 100000;
+    yydebug = 0;
+
+    printf("%-10s %-12s %-12s %-12s %-12s\n", "Comandos", "Reusadas", "Compartilh.", "Tempo (s)", "ns/comando");
+    double previous = -1;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= largest; i++)
+    {
+        double cost = run(sizes[i]);
+        if (cost < 0)
+            return 1;
+
+        // Um crescimento quadrático já aparece em 10^4 comandos; os tamanhos seguintes levariam minutos
+        if (i > 0 && !check_cost_ratio("comando", sizes[i], cost, sizes[i - 1], previous, MAX_STEP_RATIO))
+            return 1;
+        previous = cost;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>        // printf(), fprintf(), fdopen()
+#include <stdlib.h>       // atol(), mkstemp()
+#include <unistd.h>       // unlink()
+#include <time.h>         // clock_gettime()
+#include <sys/resource.h> // getrusage()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantidade de operandos em cada expressão gerada.
+#define OPERANDS_PER_STATEMENT 50
+
+/// @brief Escreve um programa P- sintético com muitas expressões longas.
+/// @param file O arquivo de destino.
+/// @param statements A quantidade de atribuições geradas.
+static void generate_program(FILE *file, long statements)
+{
+    static const char *operators[] = {"+", "-", "*", "/"};
+
+    fprintf(file, "{\n  inteiro a, b, c, d;\n");
+    for (long i = 0; i < statements; i++)
+    {
+        fprintf(file, "  a = b");
+        for (int j = 1; j < OPERANDS_PER_STATEMENT; j++)
+            fprintf(file, " %s %c", operators[j % 4], "bcd"[j % 3]);
+        fprintf(file, ";\n");
+    }
+    fprintf(file, "}\n");
+}
+
+/// @brief Conta os nós de uma árvore sintática.
+/// @param tree A raiz da árvore.
+/// @return A quantidade de nós.
+static long count_nodes(tree_node *tree)
+{
+    long count = 0;
+    while (tree != NULL)
+    {
+        count++;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            count += count_nodes(tree->child[i]);
+        tree = tree->sibling;
+    }
+    return count;
+}
+
+/// @brief Mede a construção da árvore sintática: nós por segundo e pico de memória residente.
+/// @note Compile com -DARENA_USE_MALLOC para medir o comportamento anterior (um malloc por nó).
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    long statements = (argc > 1) ? atol(argv[1]) : 20000;
+
+    // O programa é gerado em um arquivo temporário, que o analisador léxico mapeia em memória
+    char path[] = "/tmp/bench_parser_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    if (file == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel criar o arquivo temporario\n");
+        return 1;
+    }
+    generate_program(file, statements);
+    fclose(file);
+
+    parse_context *context = create_parse_context();
+    if (context == NULL || !open_source_file(context->scanner, path))
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        unlink(path);
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    tree_node *tree = parse(context);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    long nodes = count_nodes(tree);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef ARENA_USE_MALLOC
+    printf("Alocador:          malloc por no\n");
+#else
+    printf("Alocador:          arena\n");
+#endif
+    printf("Atribuicoes:       %ld\n", statements);
+    printf("Nos:               %ld\n", nodes);
+    printf("Tempo de analise:  %.3f s\n", seconds);
+    printf("Nos por segundo:   %.0f\n", nodes / seconds);
+    printf("Memoria reservada: %zu bytes\n", context->arena->reserved);
+    printf("Pico de RSS:       %ld KiB\n", usage.ru_maxrss);
+
+    destroy_parse_context(context);
+    unlink(path);
+    return 0;
+}
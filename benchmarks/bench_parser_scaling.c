@@ -0,0 +1,137 @@
+#include <stdio.h>  // printf(), fprintf()
+#include <stdlib.h> // atol()
+#include <unistd.h> // unlink()
+#include <time.h>   // clock_gettime()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "scaling.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Comandos em cada bloco { ... } e em cada corpo de se gerados.
+#define STATEMENTS_PER_BLOCK 20
+
+/// @brief Quantas vezes o custo por comando do maior programa pode passar o do menor para a construção
+///        ainda ser considerada linear (a folga cobre as caches e a paginação dos programas grandes).
+#define MAX_COST_RATIO 3.0
+
+/// @brief Escreve um programa P- com as três listas da gramática crescendo com o programa: uma
+///        declaração com statements / 10 identificadores, statements / 10 declarações de uma variável e
+///        statements comandos, parte deles em blocos e corpos de se.
+static void generate_program(FILE *file, long statements)
+{
+    long variables = (statements >= 10) ? statements / 10 : 1;
+
+    fprintf(file, "{\n  inteiro a");
+    for (long i = 0; i < variables; i++)
+        fprintf(file, ", v%ld", i);
+    fprintf(file, ";\n");
+    for (long i = 0; i < variables; i++)
+        fprintf(file, "  real r%ld;\n", i);
+
+    long written = 0;
+    while (written < statements)
+    {
+        switch ((written / STATEMENTS_PER_BLOCK) % 3)
+        {
+        case 0:
+            fprintf(file, "  a = a + 1;\n");
+            written++;
+            break;
+        case 1:
+            fprintf(file, "  {\n");
+            for (int i = 0; i < STATEMENTS_PER_BLOCK && written < statements; i++, written++)
+                fprintf(file, "    v%ld = a * 2;\n", written % variables);
+            fprintf(file, "  }\n");
+            break;
+        default:
+            fprintf(file, "  se a > 0 entao {\n");
+            for (int i = 0; i < STATEMENTS_PER_BLOCK && written < statements; i++, written++)
+                fprintf(file, "    r%ld = a / 2.0;\n", written % variables);
+            fprintf(file, "  }\n");
+            break;
+        }
+    }
+    fprintf(file, "}\n");
+}
+
+/// @brief Conta os comandos e declarações de uma lista, incluindo os corpos.
+static long count_statements(const tree_node *node)
+{
+    long count = 0;
+    for (; node != NULL; node = node->sibling)
+    {
+        count++;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                count += count_statements(node->child[i]);
+        }
+    }
+    return count;
+}
+
+/// @brief Analisa um programa gerado com a quantidade de comandos dada e imprime o tempo medido.
+/// @return O custo por comando, em nanossegundos, ou -1 se o programa não pôde ser analisado.
+static double run(long statements)
+{
+    char path[] = "/tmp/bench_parser_scaling_XXXXXX";
+    if (!write_generated_program(path, generate_program, statements))
+        return -1;
+
+    parse_context *context = create_parse_context();
+    if (context == NULL || !open_source_file(context->scanner, path))
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        destroy_parse_context(context);
+        unlink(path);
+        return -1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    tree_node *tree = parse(context);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = elapsed_seconds(start, end);
+    long nodes = count_statements(tree);
+    double cost = (context->is_error || tree == NULL) ? -1 : seconds * 1e9 / statements;
+    printf("%-10ld %-12ld %-12.4f %-12.1f\n", statements, nodes, seconds, cost);
+
+    destroy_parse_context(context);
+    unlink(path);
+    return cost;
+}
+
+/// @brief Mede a análise sintática de programas de 10^3 a 10^6 comandos e verifica que o custo por
+///        comando não cresce com o programa, isto é, que a construção das listas é linear.
+/// @return 0 se o crescimento foi linear, 1 se não foi ou se algum programa não pôde ser analisado.
+int main(int argc, char **argv)
+{
+    static const long sizes[] = {1000, 10000, 100000, 1000000};
+    long largest = (argc > 1) ? atol(argv[1]) : 1000000;
+    yydebug = 0;
+
+    printf("%-10s %-12s %-12s %-12s\n", "Comandos", "Nos", "Tempo (s)", "ns/comando");
+    long reference_size = 0, size = 0;
+    double reference = -1, cost = -1;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= largest; i++)
+    {
+        size = sizes[i];
+        cost = run(size);
+        if (cost < 0)
+            return 1;
+
+        // 10^3 comandos levam microssegundos: a referência é o tamanho seguinte, quando medido
+        if (i <= 1)
+        {
+            reference = cost;
+            reference_size = sizes[i];
+        }
+    }
+
+    if (reference <= 0)
+        return 0;
+    return check_cost_ratio("comando", size, cost, reference_size, reference, MAX_COST_RATIO) ? 0 : 1;
+}
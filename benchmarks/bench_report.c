@@ -0,0 +1,171 @@
+#include <stdio.h>    // printf(), fprintf(), open_memstream()
+#include <stdlib.h>   // atol(), mkstemp(), malloc(), free()
+#include <string.h>   // memcpy()
+#include <unistd.h>   // close(), unlink()
+#include <time.h>     // clock_gettime()
+#include <sys/stat.h> // stat()
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "semantic/semantic.h"
+#include "semantic/report.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Quantas vezes cada relatório é escrito, para que o tempo medido não seja só o da primeira escrita.
+#define REPORT_RUNS 5
+
+/// @brief Um formato e um conjunto de seções medidos.
+typedef struct report_case
+{
+    const char *name;
+    report_format format;
+    unsigned int sections;
+} report_case;
+
+/// @brief Os relatórios medidos; o primeiro, completo em texto, é a referência dos demais.
+static const report_case cases[] = {
+    {"texto", REPORT_TEXT, REPORT_ALL_SECTIONS},
+    {"texto -x arvores", REPORT_TEXT, REPORT_ALL_SECTIONS & ~REPORT_TREES},
+    {"json", REPORT_JSON, REPORT_ALL_SECTIONS},
+    {"binario", REPORT_BINARY, REPORT_ALL_SECTIONS},
+    {"binario -x arvores", REPORT_BINARY, REPORT_ALL_SECTIONS & ~REPORT_TREES},
+};
+
+/// @brief Retorna o tempo decorrido entre dois instantes, em segundos.
+static double elapsed(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/// @brief Escreve um programa P- com a quantidade de comandos dada, com laços, condições e expressões.
+static char *generate_program(long statements, size_t *length)
+{
+    char *text = NULL;
+    FILE *file = open_memstream(&text, length);
+    if (file == NULL)
+        return NULL;
+    fprintf(file, "{\n  inteiro a, b, i, n;\n  real x;\n  ler(n);\n  a = 1;\n  b = 2;\n  x = 0.5;\n");
+    for (long written = 0; written < statements; written++)
+    {
+        switch (written % 4)
+        {
+        case 0:
+            fprintf(file, "  a = a * 3 + b * n - 1;\n");
+            break;
+        case 1:
+            fprintf(file, "  x = x * 2.5 + a / 2;\n");
+            break;
+        case 2:
+            fprintf(file, "  se (a > n) entao b = a - n; senao b = n * 2;\n");
+            break;
+        default:
+            fprintf(file, "  i = 0;\n  enquanto (i < n) {\n    a = a + i * 4;\n    i = i + 1;\n  }\n");
+            written++;
+            break;
+        }
+    }
+    fprintf(file, "  mostrar(a);\n  mostrar(x);\n}\n");
+    if (fclose(file) != 0)
+        return NULL;
+
+    // open_source_buffer() precisa de dois bytes graváveis depois do texto
+    char *source = (char *)malloc(*length + 2);
+    if (source != NULL)
+        memcpy(source, text, *length);
+    free(text);
+    return source;
+}
+
+/// @brief Escreve o relatório de um programa já analisado em cada formato e mostra o tempo e o tamanho de
+///        cada um, ao lado do tempo da análise.
+/// @return 1 se os relatórios sem as árvores e em binário foram menores e mais rápidos que o relatório
+///         completo em texto, 0 caso contrário ou em caso de erro.
+static int run(long statements, const char *path)
+{
+    size_t length = 0;
+    char *source = generate_program(statements, &length);
+    parse_context *context = (source != NULL) ? create_parse_context() : NULL;
+    if (context == NULL || !open_source_buffer(context->scanner, source, length))
+    {
+        destroy_parse_context(context);
+        free(source);
+        return 0;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    tree_node *tree = parse(context);
+    semantic_analyzer *analyzer = (tree != NULL) ? create_semantic_analyzer(tree, context->arena) : NULL;
+    if (analyzer != NULL)
+        analyze_semantics(analyzer);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (analyzer == NULL)
+    {
+        destroy_parse_context(context);
+        free(source);
+        return 0;
+    }
+    printf("%ld comandos: analise em %.4f s\n", statements, elapsed(start, end));
+
+    double seconds[sizeof(cases) / sizeof(cases[0])];
+    long long bytes[sizeof(cases) / sizeof(cases[0])];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        report_options options = {cases[i].format, cases[i].sections, 0};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int run = 0; run < REPORT_RUNS; run++)
+            generate_report(analyzer, path, &options);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        struct stat info;
+        seconds[i] = elapsed(start, end) / REPORT_RUNS;
+        bytes[i] = (stat(path, &info) == 0) ? (long long)info.st_size : -1;
+        printf("  %-20s %-12.4f %-14lld %-10.2f\n", cases[i].name, seconds[i], bytes[i], seconds[0] / seconds[i]);
+    }
+
+    destroy_semantic_analyzer(analyzer);
+    destroy_parse_context(context);
+    free(source);
+
+    int smaller = 1;
+    for (size_t i = 1; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        if (cases[i].format == REPORT_JSON)
+            continue;
+        smaller = smaller && bytes[i] >= 0 && bytes[i] < bytes[0] && seconds[i] < seconds[0];
+    }
+    return smaller;
+}
+
+/// @brief Escreve o relatório de programas de 10^3 a 10^5 comandos em texto, em JSON e em binário, com e
+///        sem as árvores, num arquivo temporário.
+/// @return 0 se, em todos os tamanhos, os relatórios sem as árvores e em binário foram menores e mais
+///         rápidos que o relatório completo em texto, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    static const long sizes[] = {1000, 10000, 100000};
+    long largest = (argc > 1) ? atol(argv[1]) : 100000;
+    yydebug = 0;
+
+    char path[] = "/tmp/bench_report_XXXXXX";
+    int descriptor = mkstemp(path);
+    if (descriptor < 0)
+    {
+        fprintf(stderr, "Nao foi possivel criar o arquivo de relatorio\n");
+        return 1;
+    }
+    close(descriptor);
+
+    printf("  %-20s %-12s %-14s %-10s\n", "Relatorio", "Tempo (s)", "Tamanho (B)", "Ganho");
+    int faster = 1;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= largest; i++)
+    {
+        int ok = run(sizes[i], path);
+        if (!ok)
+            fprintf(stderr, "Os relatorios de %ld comandos nao ficaram menores e mais rapidos\n", sizes[i]);
+        faster = faster && ok;
+    }
+    unlink(path);
+    return faster ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include <stdio.h>  // printf(), snprintf()
+#include <stdlib.h> // atoi()
+#include <time.h>   // clock_gettime()
+#include "semantic/semantic.h"
+
+/// @brief Quantidade de consultas feitas para cada variável declarada.
+#define LOOKUPS_PER_SYMBOL 10
+
+/// @brief Retorna o tempo decorrido entre dois instantes, em segundos.
+static double elapsed(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/// @brief Declara e consulta uma quantidade de variáveis e imprime os tempos medidos.
+/// @param symbols A quantidade de variáveis declaradas.
+static void run(int symbols)
+{
+    arena *names = arena_create(ARENA_DEFAULT_BLOCK_SIZE);
+    semantic_analyzer *analyzer = create_semantic_analyzer(NULL, names);
+    char name[32];
+    struct timespec start, middle, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < symbols; i++)
+    {
+        snprintf(name, sizeof(name), "variavel_%d", i);
+        add_symbol(analyzer, name, (i % 2) ? DT_REAL : DT_INTEGER, i + 1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &middle);
+
+    long found = 0;
+    for (int round = 0; round < LOOKUPS_PER_SYMBOL; round++)
+    {
+        for (int i = 0; i < symbols; i++)
+        {
+            // Metade das consultas procura nomes que não existem
+            snprintf(name, sizeof(name), (i % 2) ? "variavel_%d" : "ausente_%d", i);
+            found += find_symbol(analyzer, name) != NULL;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long lookups = (long)symbols * LOOKUPS_PER_SYMBOL;
+    printf("%-10d %-14.1f %-14.1f %-12ld %-10d\n",
+           symbols,
+           elapsed(start, middle) * 1e9 / symbols,
+           elapsed(middle, end) * 1e9 / lookups,
+           found,
+           analyzer->error_count);
+
+    destroy_semantic_analyzer(analyzer);
+    arena_release(names);
+}
+
+/// @brief Mede a declaração e a consulta de 10^5 a 10^6 variáveis na tabela de símbolos.
+int main(int argc, char **argv)
+{
+    static const int sizes[] = {100000, 200000, 500000, 1000000};
+    int largest = (argc > 1) ? atoi(argv[1]) : 1000000;
+
+    printf("%-10s %-14s %-14s %-12s %-10s\n", "Simbolos", "ns/declaracao", "ns/consulta", "Encontrados", "Erros");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= largest; i++)
+        run(sizes[i]);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <fcntl.h>  // open()
+#include <stdio.h>  // printf(), fprintf(), snprintf()
+#include <stdlib.h> // atol()
+#include <string.h> // strlen()
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // close()
+#include "compiler/compiler.h"
+#include "interpreter/interpreter.h"
+#include "runtime/program_io.h"
+#include "vm/bytecode.h"
+#include "vm/vm.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief test.factorial.p ampliado: calcula 12! repetidas vezes, sem ler da entrada.
+static const char *factorial_program =
+    "{\n"
+    "  inteiro n, i, fatorial, acumulador, soma;\n"
+    "  n = %ld;\n"
+    "  i = 0;\n"
+    "  soma = 0;\n"
+    "  enquanto (i < n) {\n"
+    "    fatorial = 1;\n"
+    "    acumulador = 1;\n"
+    "    enquanto (acumulador <= 12) {\n"
+    "      fatorial = fatorial * acumulador;\n"
+    "      acumulador = acumulador + 1;\n"
+    "    }\n"
+    "    soma = soma + fatorial;\n"
+    "    i = i + 1;\n"
+    "  }\n"
+    "  mostrar(soma);\n"
+    "}\n";
+
+/// @brief No estilo de test.conditions.p: condições compostas, se/senao e repita dentro de um laço.
+static const char *conditions_program =
+    "{\n"
+    "  inteiro n, i, a, b, c;\n"
+    "  real r;\n"
+    "  n = %ld;\n"
+    "  i = 0; a = 0; b = 0; c = 0;\n"
+    "  r = 0.0;\n"
+    "  enquanto (i < n) {\n"
+    "    se (i - (i / 3) * 3 == 0 && a < b || c > 10) entao a = a + 1; senao b = b + 2;\n"
+    "    se (a > b) entao c = c - 1; senao c = c + 3;\n"
+    "    r = r + 0.5;\n"
+    "    repita { c = c - 1; } ate c < 5;\n"
+    "    i = i + 1;\n"
+    "  }\n"
+    "  mostrar(a);\n"
+    "  mostrar(b);\n"
+    "  mostrar(r);\n"
+    "}\n";
+
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/// @brief Executa o programa com um motor e retorna o tempo gasto, ou -1 em caso de erro.
+/// @param superinstructions -1 para o interpretador da árvore; 0 ou 1 para a máquina virtual.
+static double measure(compiler *compiler, int superinstructions, dispatch_mode mode, int output_fd)
+{
+    tree_node *tree = compiler->result.adjusted_tree;
+    int frame_size = compiler->analyzer->table.next_address;
+    program_io *io = create_program_io(-1, output_fd);
+    bytecode *program = (superinstructions >= 0) ? compile_bytecode(tree, frame_size, superinstructions) : NULL;
+    execution_error error;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int finished = (program != NULL) ? run_bytecode(program, mode, io, &error)
+                                     : interpret_program(tree, frame_size, io, &error);
+    double seconds = elapsed_since(&start);
+
+    destroy_bytecode(program);
+    destroy_program_io(io);
+    return finished ? seconds : -1;
+}
+
+static int benchmark(const char *name, const char *source_format, long iterations, int output_fd)
+{
+    char source[2048];
+    snprintf(source, sizeof(source), source_format, iterations);
+
+    compiler *compiler = create_compiler();
+    const compile_result *result = (compiler != NULL) ? compile_source(compiler, source, strlen(source)) : NULL;
+    if (result == NULL || result->has_errors)
+    {
+        fprintf(stderr, "Falha ao compilar o programa %s\n", name);
+        destroy_compiler(compiler);
+        return 0;
+    }
+    resolve_tree(compiler->analyzer);
+
+    double tree = measure(compiler, -1, SWITCH_DISPATCH, output_fd);
+    double switch_basic = measure(compiler, 0, SWITCH_DISPATCH, output_fd);
+    double switch_super = measure(compiler, 1, SWITCH_DISPATCH, output_fd);
+    double threaded_basic = measure(compiler, 0, THREADED_DISPATCH, output_fd);
+    double threaded_super = measure(compiler, 1, THREADED_DISPATCH, output_fd);
+
+    printf("%s (%ld voltas)\n", name, iterations);
+    printf("  Arvore:                           %.3f s\n", tree);
+    printf("  VM switch:                        %.3f s (%.2fx)\n", switch_basic, tree / switch_basic);
+    printf("  VM switch + superinstrucoes:      %.3f s (%.2fx)\n", switch_super, tree / switch_super);
+    printf("  VM goto calculado:                %.3f s (%.2fx)\n", threaded_basic, tree / threaded_basic);
+    printf("  VM goto calc. + superinstrucoes:  %.3f s (%.2fx)\n", threaded_super, tree / threaded_super);
+
+    destroy_compiler(compiler);
+    return 1;
+}
+
+/// @brief Compara o interpretador da árvore com a máquina virtual, com despacho por switch e por goto
+///        calculado, com e sem superinstruções, em programas dominados por laços.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    long iterations = (argc > 1) ? atol(argv[1]) : 1000000;
+
+    // A saída dos programas é descartada
+    int output_fd = open("/dev/null", O_WRONLY);
+    if (output_fd < 0)
+    {
+        fprintf(stderr, "Nao foi possivel abrir /dev/null\n");
+        return 1;
+    }
+
+    int ok = benchmark("fatorial", factorial_program, iterations, output_fd) &&
+             benchmark("condicoes", conditions_program, iterations, output_fd);
+
+    close(output_fd);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#include <stdio.h>  // printf(), fprintf(), fdopen(), fclose()
+#include <stdlib.h> // mkstemp()
+#include <unistd.h> // unlink()
+#include "scaling.h"
+
+double elapsed_seconds(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int write_generated_program(char *path, program_generator generate, long size)
+{
+    int fd = mkstemp(path);
+    FILE *file = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    if (file == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel criar o arquivo temporario\n");
+        return 0;
+    }
+    generate(file, size);
+    if (fclose(file) != 0)
+    {
+        fprintf(stderr, "Nao foi possivel escrever o arquivo %s\n", path);
+        unlink(path);
+        return 0;
+    }
+    return 1;
+}
+
+int check_cost_ratio(const char *item, long size, double cost, long reference_size, double reference, double limit)
+{
+    double ratio = cost / reference;
+    printf("Custo por %s com %ld em relacao a %ld: %.2fx (limite %.1fx): %s\n", item, size, reference_size, ratio,
+           limit, (ratio <= limit) ? "linear" : "NAO LINEAR");
+    return ratio <= limit;
+}
@@ -0,0 +1,29 @@
+#ifndef SCALING_H
+#define SCALING_H
+
+#include <stdio.h> // FILE
+#include <time.h>  // struct timespec
+
+/*
+ * O que os benchmarks de escala têm em comum: cada um gera programas P- de tamanhos crescentes, mede
+ * o custo por item (comando ou operação) e compara o custo de um tamanho com o de um tamanho menor. O
+ * limite da comparação é de cada benchmark, que o justifica.
+ */
+
+/// @brief Escreve um programa P- com o tamanho dado no arquivo.
+typedef void (*program_generator)(FILE *file, long size);
+
+/// @brief Retorna o tempo decorrido entre dois instantes, em segundos.
+double elapsed_seconds(struct timespec start, struct timespec end);
+
+/// @brief Escreve o programa gerado num arquivo temporário.
+/// @param path Um modelo de mkstemp(), terminado em XXXXXX, que recebe o nome do arquivo, a remover com unlink().
+/// @return 1 se o arquivo foi escrito, 0 caso contrário (o erro já foi impresso).
+int write_generated_program(char *path, program_generator generate, long size);
+
+/// @brief Compara o custo por item de um tamanho com o de um tamanho menor e imprime a razão.
+/// @param item O que o custo mede, como "comando", para a mensagem.
+/// @return 1 se a razão não passa do limite, 0 caso contrário.
+int check_cost_ratio(const char *item, long size, double cost, long reference_size, double reference, double limit);
+
+#endif // SCALING_H
@@ -0,0 +1,618 @@
+#include <stdio.h>     // fopen(), fwrite(), rename(), snprintf()
+#include <stdlib.h>    // malloc(), realloc(), free()
+#include <string.h>    // memcpy(), memcmp(), memchr(), memset(), strlen()
+#include <errno.h>     // errno, EEXIST
+#include <fcntl.h>     // open()
+#include <unistd.h>    // close(), getpid(), unlink()
+#include <sys/mman.h>  // mmap(), munmap()
+#include <sys/stat.h>  // fstat(), mkdir(), stat()
+#include "cache.h"
+
+/// @brief Os primeiros bytes de toda entrada do cache.
+#define CACHE_MAGIC "PMCACHE"
+
+/// @brief A versão do formato das entradas; entradas de outro formato são ignoradas.
+#define CACHE_FORMAT_VERSION 4
+
+/// @brief Quantos vetores de cada árvore compacta são gravados.
+#define CACHE_TREE_COLUMNS 11
+
+/// @brief Os vetores de uma árvore compacta dentro da entrada, na ordem de CACHE_TREE_COLUMNS.
+enum tree_column
+{
+    COLUMN_KINDS,
+    COLUMN_TYPES,
+    COLUMN_CHILD_COUNTS,
+    COLUMN_OPS,
+    COLUMN_LINES,
+    COLUMN_VALUES,
+    COLUMN_NEXT,
+    COLUMN_FIRST_CHILD,
+    COLUMN_CHILDREN,
+    COLUMN_NAMES, // A posição de cada nome no bloco de textos
+    COLUMN_REALS
+};
+
+/// @brief Uma árvore compacta dentro da entrada: os tamanhos e a posição de cada vetor no arquivo.
+typedef struct cached_tree_layout
+{
+    uint32_t count;
+    uint32_t child_total;
+    uint32_t name_count;
+    uint32_t real_count;
+    uint32_t root;
+    uint32_t reserved;
+    uint64_t columns[CACHE_TREE_COLUMNS];
+} cached_tree_layout;
+
+/// @brief O cabeçalho de uma entrada, no início do arquivo. As posições são contadas do início do arquivo.
+typedef struct cache_header
+{
+    char magic[8];
+    uint32_t format_version;
+    uint32_t header_size;
+    uint64_t key[2];
+    uint64_t checksum; // Hash de tudo o que vem depois do cabeçalho
+    uint64_t file_size;
+    cached_tree_layout trees[2]; // A árvore original e a ajustada
+    uint32_t symbol_count;
+    uint32_t error_count;
+    uint64_t symbols;
+    uint64_t errors;
+    uint64_t strings;
+    uint64_t strings_size;
+    uint64_t details;     // Um cached_details, com os contadores das seções 5 e 6
+    uint64_t loops;       // Um cached_loop por laço
+    uint32_t loop_count;
+    uint32_t reserved;
+    uint64_t listing;     // A listagem da representação intermediária
+    uint64_t listing_length;
+    uint64_t source;               // A fonte do programa, conferida byte a byte na consulta
+    uint64_t source_length;
+} cache_header;
+
+/// @brief Um símbolo dentro da entrada, com o nome no bloco de textos.
+typedef struct cached_symbol
+{
+    uint32_t name;
+    int32_t type;
+    int32_t declared_line;
+    int32_t memory_address;
+    int32_t size;
+    int32_t is_initialized;
+} cached_symbol;
+
+/// @brief Os contadores das seções 5 e 6 dentro da entrada.
+typedef struct cached_details
+{
+    optimization_stats optimizations;
+    int32_t frame_size;
+    int32_t ir_status;
+    int32_t block_count;
+    int32_t unreachable_blocks;
+    int32_t constant_values;
+    int32_t redundant_values;
+    int32_t complete;
+} cached_details;
+
+/// @brief Um laço dentro da entrada, com o nome da variável de indução no bloco de textos.
+typedef struct cached_loop
+{
+    int32_t kind;
+    int32_t line;
+    uint32_t induction_variable; // UINT32_MAX se o laço não tem variável de indução
+    int32_t step;
+    int32_t trip_count;
+    int32_t derived_variables;
+    int32_t unroll_factor;
+} cached_loop;
+
+/// @brief Um vetor de bytes que cresce conforme o conteúdo da entrada é acrescentado.
+typedef struct byte_buffer
+{
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    int failed;
+} byte_buffer;
+
+/// @brief Um hash de 64 bits de um bloco de bytes, lido de 8 em 8 bytes.
+static uint64_t hash_bytes(const void *data, size_t length, uint64_t seed)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t hash = seed ^ ((uint64_t)length * 0x9E3779B97F4A7C15ull);
+    while (length >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+        bytes += 8;
+        length -= 8;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, bytes, length);
+    hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    return hash ^ (hash >> 29);
+}
+
+cache_key compute_cache_key(const char *source, size_t length)
+{
+    static const uint64_t seeds[2] = {0x243F6A8885A308D3ull, 0x13198A2E03707344ull};
+    const uint32_t format = CACHE_FORMAT_VERSION;
+    cache_key key;
+    for (int i = 0; i < 2; i++)
+    {
+        uint64_t seed = hash_bytes(COMPILER_SOURCE_HASH, strlen(COMPILER_SOURCE_HASH), seeds[i]);
+        seed = hash_bytes(&format, sizeof(format), seed);
+        key.hash[i] = hash_bytes(source, length, seed);
+    }
+    key.source = source;
+    key.length = length;
+    return key;
+}
+
+int open_program_cache(program_cache *cache, const char *directory)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->directory = directory;
+
+    struct stat info;
+    if (mkdir(directory, 0777) != 0 && errno != EEXIST)
+        return 0;
+    return stat(directory, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static void entry_path(const program_cache *cache, cache_key key, char *buffer, size_t size)
+{
+    snprintf(buffer, size, "%s/%016llx%016llx.pmc", cache->directory, (unsigned long long)key.hash[0],
+             (unsigned long long)key.hash[1]);
+}
+
+/// @brief Acrescenta bytes ao conteúdo, alinhados em 8 bytes.
+/// @return A posição dos bytes no conteúdo.
+static uint64_t append(byte_buffer *buffer, const void *data, size_t size)
+{
+    size_t offset = (buffer->size + 7) & ~(size_t)7;
+    if (offset + size > buffer->capacity)
+    {
+        size_t capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity;
+        while (capacity < offset + size)
+            capacity *= 2;
+        unsigned char *grown = (unsigned char *)realloc(buffer->data, capacity);
+        if (grown == NULL)
+        {
+            buffer->failed = 1;
+            return 0;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memset(buffer->data + buffer->size, 0, offset - buffer->size);
+    if (size > 0)
+        memcpy(buffer->data + offset, data, size);
+    buffer->size = offset + size;
+    return offset;
+}
+
+/// @brief Acrescenta um nome ao bloco de textos.
+/// @return A posição do nome no bloco.
+static uint32_t append_string(byte_buffer *strings, const char *text)
+{
+    size_t length = strlen(text) + 1;
+    if (strings->size + length > strings->capacity)
+    {
+        size_t capacity = (strings->capacity == 0) ? 4096 : strings->capacity;
+        while (capacity < strings->size + length)
+            capacity *= 2;
+        unsigned char *grown = (unsigned char *)realloc(strings->data, capacity);
+        if (grown == NULL)
+        {
+            strings->failed = 1;
+            return 0;
+        }
+        strings->data = grown;
+        strings->capacity = capacity;
+    }
+    memcpy(strings->data + strings->size, text, length);
+    strings->size += length;
+    return (uint32_t)(strings->size - length);
+}
+
+/// @brief Acrescenta os vetores de uma árvore compacta ao conteúdo.
+static void append_tree(byte_buffer *buffer, byte_buffer *strings, const flat_tree *flat, cached_tree_layout *layout)
+{
+    memset(layout, 0, sizeof(*layout));
+    layout->count = flat->count;
+    layout->child_total = flat->child_total;
+    layout->name_count = flat->name_count;
+    layout->real_count = flat->real_count;
+    layout->root = flat->root;
+
+    uint32_t *names = (uint32_t *)malloc(((size_t)flat->name_count + 1) * sizeof(uint32_t));
+    if (names == NULL)
+    {
+        buffer->failed = 1;
+        return;
+    }
+    for (uint32_t i = 0; i < flat->name_count; i++)
+        names[i] = append_string(strings, flat->names[i]);
+
+    layout->columns[COLUMN_KINDS] = append(buffer, flat->kinds, flat->count * sizeof(uint8_t));
+    layout->columns[COLUMN_TYPES] = append(buffer, flat->types, flat->count * sizeof(uint8_t));
+    layout->columns[COLUMN_CHILD_COUNTS] = append(buffer, flat->child_counts, flat->count * sizeof(uint8_t));
+    layout->columns[COLUMN_OPS] = append(buffer, flat->ops, flat->count * sizeof(uint16_t));
+    layout->columns[COLUMN_LINES] = append(buffer, flat->lines, flat->count * sizeof(int32_t));
+    layout->columns[COLUMN_VALUES] = append(buffer, flat->values, flat->count * sizeof(int32_t));
+    layout->columns[COLUMN_NEXT] = append(buffer, flat->next, flat->count * sizeof(node_id));
+    layout->columns[COLUMN_FIRST_CHILD] = append(buffer, flat->first_child, flat->count * sizeof(node_id));
+    layout->columns[COLUMN_CHILDREN] = append(buffer, flat->children, flat->child_total * sizeof(node_id));
+    layout->columns[COLUMN_NAMES] = append(buffer, names, flat->name_count * sizeof(uint32_t));
+    layout->columns[COLUMN_REALS] = append(buffer, flat->reals, flat->real_count * sizeof(double));
+    free(names);
+}
+
+/// @brief Grava o conteúdo num arquivo temporário do diretório e o renomeia para o nome da entrada.
+static int write_entry(const program_cache *cache, cache_key key, const byte_buffer *buffer)
+{
+    char path[4096], temporary[4200];
+    entry_path(cache, key, path, sizeof(path));
+    snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE *file = fopen(temporary, "wb");
+    if (file == NULL)
+        return 0;
+    int ok = fwrite(buffer->data, 1, buffer->size, file) == buffer->size;
+    ok = (fclose(file) == 0) && ok;
+    if (ok && rename(temporary, path) == 0)
+        return 1;
+    unlink(temporary);
+    return 0;
+}
+
+int store_program(program_cache *cache, cache_key key, semantic_analyzer *analyzer)
+{
+    const flat_tree *original = get_flat_tree(analyzer, analyzer->original_tree);
+    const flat_tree *adjusted = get_flat_tree(analyzer, analyzer->adjusted_tree);
+    report_details details;
+    if (original == NULL || adjusted == NULL || !collect_report_details(analyzer, REPORT_ALL_SECTIONS, &details))
+    {
+        cache->stats.store_errors++;
+        return 0;
+    }
+
+    byte_buffer buffer, strings;
+    memset(&buffer, 0, sizeof(buffer));
+    memset(&strings, 0, sizeof(strings));
+    cache_header header;
+    memset(&header, 0, sizeof(header));
+    append(&buffer, &header, sizeof(header));
+
+    append_tree(&buffer, &strings, original, &header.trees[0]);
+    if (adjusted == original)
+        header.trees[1] = header.trees[0];
+    else
+        append_tree(&buffer, &strings, adjusted, &header.trees[1]);
+
+    const symbol_table *table = &analyzer->table;
+    cached_symbol *symbols = (cached_symbol *)calloc((size_t)table->count + 1, sizeof(cached_symbol));
+    if (symbols == NULL)
+        buffer.failed = 1;
+    else
+    {
+        for (int i = 0; i < table->count; i++)
+        {
+            symbols[i].name = append_string(&strings, table->symbols[i].name);
+            symbols[i].type = table->symbols[i].type;
+            symbols[i].declared_line = table->symbols[i].declared_line;
+            symbols[i].memory_address = table->symbols[i].memory_address;
+            symbols[i].size = table->symbols[i].size;
+            symbols[i].is_initialized = table->symbols[i].is_initialized;
+        }
+        header.symbols = append(&buffer, symbols, (size_t)table->count * sizeof(cached_symbol));
+        free(symbols);
+    }
+    header.symbol_count = (uint32_t)table->count;
+    header.error_count = (uint32_t)analyzer->error_count;
+    header.errors = append(&buffer, analyzer->errors, (size_t)analyzer->error_count * sizeof(semantic_error));
+    cached_details counters = {details.optimizations, details.frame_size,         details.ir_status,
+                               details.block_count,  details.unreachable_blocks, details.constant_values,
+                               details.redundant_values, details.complete};
+    header.details = append(&buffer, &counters, sizeof(counters));
+    cached_loop *loops = (cached_loop *)calloc((size_t)details.loop_count + 1, sizeof(cached_loop));
+    if (loops == NULL)
+        buffer.failed = 1;
+    else
+    {
+        for (int i = 0; i < details.loop_count; i++)
+        {
+            const report_loop *loop = &details.loops[i];
+            loops[i].kind = loop->kind;
+            loops[i].line = loop->line;
+            loops[i].induction_variable =
+                (loop->induction_variable != NULL) ? append_string(&strings, loop->induction_variable) : UINT32_MAX;
+            loops[i].step = loop->step;
+            loops[i].trip_count = loop->trip_count;
+            loops[i].derived_variables = loop->derived_variables;
+            loops[i].unroll_factor = loop->unroll_factor;
+        }
+        header.loops = append(&buffer, loops, (size_t)details.loop_count * sizeof(cached_loop));
+        free(loops);
+    }
+    header.loop_count = (uint32_t)details.loop_count;
+    header.listing = append(&buffer, details.listing, details.listing_length);
+    header.listing_length = details.listing_length;
+    header.strings = append(&buffer, strings.data, strings.size);
+    header.strings_size = strings.size;
+    header.source = append(&buffer, key.source, key.length);
+    header.source_length = key.length;
+    release_report_details(&details);
+    free(strings.data);
+
+    int ok = !buffer.failed && !strings.failed;
+    if (ok)
+    {
+        memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+        header.format_version = CACHE_FORMAT_VERSION;
+        header.header_size = sizeof(header);
+        header.key[0] = key.hash[0];
+        header.key[1] = key.hash[1];
+        header.file_size = buffer.size;
+        header.checksum = hash_bytes(buffer.data + sizeof(header), buffer.size - sizeof(header), 0);
+        memcpy(buffer.data, &header, sizeof(header));
+        ok = write_entry(cache, key, &buffer);
+    }
+    if (ok)
+    {
+        cache->stats.stores++;
+        cache->stats.bytes_written += buffer.size;
+    }
+    else
+        cache->stats.store_errors++;
+    free(buffer.data);
+    return ok;
+}
+
+/// @brief Indica se count elementos de size bytes a partir de offset cabem no arquivo.
+static int fits(const cache_header *header, uint64_t offset, uint64_t count, size_t size)
+{
+    return offset >= header->header_size && offset <= header->file_size &&
+           count <= (header->file_size - offset) / size;
+}
+
+/// @brief Monta uma árvore compacta sobre os vetores do arquivo mapeado.
+/// @return 1 se os vetores cabem no arquivo, 0 caso contrário.
+static int map_tree(const cache_header *header, unsigned char *base, const cached_tree_layout *layout,
+                    flat_tree *flat)
+{
+    static const size_t column_sizes[CACHE_TREE_COLUMNS] = {
+        sizeof(uint8_t), sizeof(uint8_t), sizeof(uint8_t), sizeof(uint16_t), sizeof(int32_t), sizeof(int32_t),
+        sizeof(node_id), sizeof(node_id), sizeof(node_id), sizeof(uint32_t), sizeof(double)};
+    for (int i = 0; i < CACHE_TREE_COLUMNS; i++)
+    {
+        uint64_t count = (i == COLUMN_CHILDREN) ? layout->child_total
+                         : (i == COLUMN_NAMES)  ? layout->name_count
+                         : (i == COLUMN_REALS)  ? layout->real_count
+                                                : layout->count;
+        if (!fits(header, layout->columns[i], count, column_sizes[i]) || layout->columns[i] % 8 != 0)
+            return 0;
+    }
+    if (layout->root != FLAT_NONE && layout->root >= layout->count)
+        return 0;
+
+    memset(flat, 0, sizeof(*flat));
+    flat->kinds = base + layout->columns[COLUMN_KINDS];
+    flat->types = base + layout->columns[COLUMN_TYPES];
+    flat->child_counts = base + layout->columns[COLUMN_CHILD_COUNTS];
+    flat->ops = (uint16_t *)(base + layout->columns[COLUMN_OPS]);
+    flat->lines = (int32_t *)(base + layout->columns[COLUMN_LINES]);
+    flat->values = (int32_t *)(base + layout->columns[COLUMN_VALUES]);
+    flat->next = (node_id *)(base + layout->columns[COLUMN_NEXT]);
+    flat->first_child = (node_id *)(base + layout->columns[COLUMN_FIRST_CHILD]);
+    flat->children = (node_id *)(base + layout->columns[COLUMN_CHILDREN]);
+    flat->reals = (double *)(base + layout->columns[COLUMN_REALS]);
+    flat->count = layout->count;
+    flat->child_total = layout->child_total;
+    flat->real_count = layout->real_count;
+    flat->root = layout->root;
+
+    // Os nomes são os únicos ponteiros: cada um vira um endereço dentro do bloco de textos
+    const uint32_t *offsets = (const uint32_t *)(base + layout->columns[COLUMN_NAMES]);
+    flat->names = (const char **)malloc(((size_t)layout->name_count + 1) * sizeof(const char *));
+    if (flat->names == NULL)
+        return 0;
+    flat->name_count = layout->name_count;
+    for (uint32_t i = 0; i < layout->name_count; i++)
+    {
+        if (offsets[i] >= header->strings_size)
+            return 0;
+        flat->names[i] = (const char *)(base + header->strings + offsets[i]);
+    }
+    return 1;
+}
+
+/// @brief Monta o programa sobre o arquivo mapeado, conferindo o cabeçalho e os limites de cada parte.
+static int map_program(cached_program *program, cache_key key)
+{
+    unsigned char *base = (unsigned char *)program->mapping;
+    cache_header header;
+    if (program->mapping_size < sizeof(header))
+        return 0;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.format_version != CACHE_FORMAT_VERSION || header.header_size != sizeof(header) ||
+        header.key[0] != key.hash[0] || header.key[1] != key.hash[1] || header.file_size != program->mapping_size)
+        return 0;
+    if (hash_bytes(base + sizeof(header), header.file_size - sizeof(header), 0) != header.checksum)
+        return 0;
+
+    // O hash da chave não é criptográfico: duas fontes com a mesma chave só são distinguidas pelos bytes
+    if (header.source_length != key.length || !fits(&header, header.source, header.source_length, 1) ||
+        (key.length > 0 && memcmp(base + header.source, key.source, key.length) != 0))
+        return 0;
+
+    if (!fits(&header, header.strings, header.strings_size, 1) ||
+        (header.strings_size > 0 && base[header.strings + header.strings_size - 1] != '\0') ||
+        !fits(&header, header.symbols, header.symbol_count, sizeof(cached_symbol)) ||
+        !fits(&header, header.errors, header.error_count, sizeof(semantic_error)) ||
+        !fits(&header, header.details, 1, sizeof(cached_details)) ||
+        !fits(&header, header.loops, header.loop_count, sizeof(cached_loop)) ||
+        !fits(&header, header.listing, header.listing_length, 1) || header.error_count > MAX_ERRORS ||
+        header.symbols % 8 != 0 || header.errors % 8 != 0 || header.details % 8 != 0 || header.loops % 8 != 0)
+        return 0;
+
+    if (!map_tree(&header, base, &header.trees[0], &program->original_tree) ||
+        !map_tree(&header, base, &header.trees[1], &program->adjusted_tree))
+        return 0;
+
+    const cached_symbol *symbols = (const cached_symbol *)(base + header.symbols);
+    program->symbols = (symbol *)calloc((size_t)header.symbol_count + 1, sizeof(symbol));
+    if (program->symbols == NULL)
+        return 0;
+    program->symbol_count = (int)header.symbol_count;
+    for (uint32_t i = 0; i < header.symbol_count; i++)
+    {
+        if (symbols[i].name >= header.strings_size)
+            return 0;
+        symbol *sym = &program->symbols[i];
+        sym->name = (char *)(base + header.strings + symbols[i].name);
+        sym->type = (data_type)symbols[i].type;
+        sym->declared_line = symbols[i].declared_line;
+        sym->memory_address = symbols[i].memory_address;
+        sym->size = symbols[i].size;
+        sym->is_initialized = symbols[i].is_initialized;
+    }
+
+    program->errors = (const semantic_error *)(base + header.errors);
+    program->error_count = (int)header.error_count;
+    for (int i = 0; i < program->error_count; i++)
+    {
+        if (memchr(program->errors[i].message, '\0', sizeof(program->errors[i].message)) == NULL)
+            return 0;
+    }
+    const cached_details *counters = (const cached_details *)(base + header.details);
+    if (counters->ir_status < REPORT_IR_BUILT || counters->ir_status > REPORT_IR_OUT_OF_MEMORY)
+        return 0;
+    report_details *details = &program->details;
+    details->optimizations = counters->optimizations;
+    details->frame_size = counters->frame_size;
+    details->ir_status = (report_ir_status)counters->ir_status;
+    details->block_count = counters->block_count;
+    details->unreachable_blocks = counters->unreachable_blocks;
+    details->constant_values = counters->constant_values;
+    details->redundant_values = counters->redundant_values;
+    details->complete = counters->complete;
+    details->listing = (const char *)(base + header.listing);
+    details->listing_length = header.listing_length;
+
+    // Como os símbolos, os laços são copiados para que o nome da variável de indução vire um endereço
+    const cached_loop *loops = (const cached_loop *)(base + header.loops);
+    program->loops = (report_loop *)calloc((size_t)header.loop_count + 1, sizeof(report_loop));
+    if (program->loops == NULL)
+        return 0;
+    for (uint32_t i = 0; i < header.loop_count; i++)
+    {
+        if (loops[i].induction_variable != UINT32_MAX && loops[i].induction_variable >= header.strings_size)
+            return 0;
+        report_loop *loop = &program->loops[i];
+        loop->kind = loops[i].kind;
+        loop->line = loops[i].line;
+        loop->induction_variable = (loops[i].induction_variable != UINT32_MAX)
+                                       ? (const char *)(base + header.strings + loops[i].induction_variable)
+                                       : NULL;
+        loop->step = loops[i].step;
+        loop->trip_count = loops[i].trip_count;
+        loop->derived_variables = loops[i].derived_variables;
+        loop->unroll_factor = loops[i].unroll_factor;
+    }
+    details->loops = program->loops;
+    details->loop_count = (int)header.loop_count;
+    return 1;
+}
+
+int lookup_program(program_cache *cache, cache_key key, cached_program *program)
+{
+    memset(program, 0, sizeof(*program));
+    char path[4096];
+    entry_path(cache, key, path, sizeof(path));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        cache->stats.misses++;
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void *mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            program->mapping = mapping;
+            program->mapping_size = (size_t)info.st_size;
+        }
+    }
+    close(fd);
+
+    if (program->mapping == NULL || !map_program(program, key))
+    {
+        release_cached_program(program);
+        cache->stats.invalid++;
+        cache->stats.misses++;
+        return 0;
+    }
+    cache->stats.hits++;
+    cache->stats.bytes_read += program->mapping_size;
+    return 1;
+}
+
+void release_cached_program(cached_program *program)
+{
+    free(program->original_tree.names);
+    free(program->adjusted_tree.names);
+    free(program->symbols);
+    free(program->loops);
+    if (program->mapping != NULL)
+        munmap(program->mapping, program->mapping_size);
+    memset(program, 0, sizeof(*program));
+}
+
+void generate_cached_report(const cached_program *program, const char *filename, const report_options *options)
+{
+    report_options defaults = default_report_options();
+    if (options == NULL)
+        options = &defaults;
+
+    report_contents contents;
+    contents.original_tree = &program->original_tree;
+    contents.adjusted_tree = &program->adjusted_tree;
+    contents.symbols = program->symbols;
+    contents.symbol_count = program->symbol_count;
+    contents.errors = program->errors;
+    contents.error_count = program->error_count;
+    contents.details = &program->details;
+
+    report_buffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    if (!render_report(&contents, options, &buffer))
+    {
+        fprintf(stderr, "Memoria insuficiente para montar o relatorio\n");
+        release_report_buffer(&buffer);
+        return;
+    }
+
+    // O console e o arquivo recebem os mesmos bytes, montados uma única vez
+    if (options->console)
+        write_report_buffer(stdout, &buffer);
+
+    FILE *report = fopen(filename, "wb");
+    if (!report)
+        fprintf(stderr, "Erro ao criar arquivo de relatorio: %s\n", filename);
+    else
+    {
+        if (!write_report_buffer(report, &buffer))
+            fprintf(stderr, "Erro ao escrever o relatorio: %s\n", filename);
+        fclose(report);
+    }
+    release_report_buffer(&buffer);
+}
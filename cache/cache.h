@@ -0,0 +1,105 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+#include "../semantic/semantic.h"
+#include "../semantic/report.h"
+
+/*
+ * O cache em disco dos programas já analisados. Cada entrada é um arquivo binário no diretório do cache,
+ * com nome igual à chave: um hash de 128 bits do hash das fontes do compilador (COMPILER_SOURCE_HASH), da
+ * versão do formato e dos bytes da fonte. O hash só escolhe o arquivo: a entrada guarda também a fonte, que
+ * a consulta compara byte a byte com a procurada, de modo que uma colisão nunca devolve o resultado de
+ * outro programa. A entrada guarda
+ * ainda o que o relatório mostra: as duas árvores na forma compacta (os vetores de flat_tree, copiados
+ * como estão), a tabela de símbolos, os erros semânticos, os contadores e os laços da seção de
+ * otimizações e a listagem da representação intermediária. Na leitura, o arquivo é mapeado com mmap e
+ * os vetores são usados diretamente do mapeamento, sem cópia.
+ *
+ * As entradas são gravadas num arquivo temporário e renomeadas, de modo que compilações simultâneas
+ * nunca leem uma entrada pela metade. Um cabeçalho com o formato, a chave e um hash do conteúdo faz
+ * entradas de outras versões, truncadas ou corrompidas serem tratadas como ausentes.
+ */
+
+/*
+ * COMPILER_SOURCE_HASH identifica o código do compilador na chave do cache. É um hash das fontes, calculado
+ * na compilação e passado com -DCOMPILER_SOURCE_HASH (veja o README), de modo que muda sempre que a
+ * análise, as otimizações ou o relatório mudam, sem que alguém precise lembrar de trocar uma versão. Sem
+ * ele, cache.c não compila: um compilador modificado nunca lê as entradas gravadas por outro.
+ */
+#ifndef COMPILER_SOURCE_HASH
+#error "Compile com -DCOMPILER_SOURCE_HASH=\"<hash das fontes>\" (veja o README)"
+#endif
+
+/// @brief A chave de uma entrada do cache.
+typedef struct cache_key
+{
+    uint64_t hash[2];
+    const char *source; // A fonte da chave, que deve existir enquanto a chave for usada
+    size_t length;
+} cache_key;
+
+/// @brief Quantas consultas e gravações o cache atendeu.
+typedef struct cache_stats
+{
+    int hits;          // Consultas que encontraram uma entrada válida
+    int misses;        // Consultas sem entrada
+    int invalid;       // Entradas de outra versão ou fonte, truncadas ou corrompidas (contadas também em misses)
+    int stores;        // Entradas gravadas
+    int store_errors;  // Gravações que falharam
+    size_t bytes_read; // Tamanho das entradas mapeadas
+    size_t bytes_written;
+} cache_stats;
+
+/// @brief Um diretório de cache.
+typedef struct program_cache
+{
+    const char *directory;
+    cache_stats stats;
+} program_cache;
+
+/// @brief Um programa lido do cache. Os vetores das árvores, os erros e a listagem da representação
+///        intermediária apontam para o arquivo mapeado.
+typedef struct cached_program
+{
+    void *mapping;
+    size_t mapping_size;
+    flat_tree original_tree;
+    flat_tree adjusted_tree;
+    symbol *symbols;
+    int symbol_count;
+    const semantic_error *errors;
+    int error_count;
+    report_loop *loops;     // Os laços das seções finais, com os nomes apontando para o arquivo mapeado
+    report_details details; // As seções 5 e 6; a listagem aponta para o arquivo mapeado
+} cached_program;
+
+/// @brief Prepara um diretório de cache, criando-o se não existir.
+/// @return 1 se o diretório pode ser usado, 0 caso contrário.
+int open_program_cache(program_cache *cache, const char *directory);
+
+/// @brief Calcula a chave de uma fonte: o hash da versão do compilador, da versão do formato e dos bytes
+///        da fonte, e a própria fonte, que não é copiada.
+cache_key compute_cache_key(const char *source, size_t length);
+
+/// @brief Procura um programa no cache e o mapeia na memória.
+/// @param program Recebe o programa, a liberar com release_cached_program().
+/// @return 1 se a entrada foi encontrada e é válida, 0 caso contrário.
+int lookup_program(program_cache *cache, cache_key key, cached_program *program);
+
+/// @brief Grava no cache o resultado de uma análise.
+/// @note Só devem ser gravados programas sem erros léxicos ou sintáticos, cujo resultado depende
+///       apenas da fonte; os erros semânticos são gravados com o programa.
+/// @param analyzer O analisador, após analyze_semantics().
+/// @return 1 se a entrada foi gravada, 0 caso contrário.
+int store_program(program_cache *cache, cache_key key, semantic_analyzer *analyzer);
+
+/// @brief Libera o mapeamento e os vetores de um programa lido do cache.
+void release_cached_program(cached_program *program);
+
+/// @brief Escreve o relatório de um programa lido do cache, como generate_report().
+/// @param options As opções do relatório, ou NULL para as padrão.
+void generate_cached_report(const cached_program *program, const char *filename, const report_options *options);
+
+#endif // CACHE_H
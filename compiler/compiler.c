@@ -0,0 +1,107 @@
+#include <stdlib.h> // malloc(), calloc(), free()
+#include <string.h> // memcpy()
+#include "compiler.h"
+
+compiler *create_compiler(void)
+{
+    compiler *instance = (compiler *)calloc(1, sizeof(*instance));
+    if (instance == NULL)
+        return NULL;
+
+    instance->context = create_parse_context();
+    instance->analyzer = (instance->context != NULL) ? create_semantic_analyzer(NULL, instance->context->arena) : NULL;
+    if (instance->analyzer == NULL)
+    {
+        destroy_compiler(instance);
+        return NULL;
+    }
+
+    // Quem embute o compilador decide o que fazer com os erros
+    instance->context->print_errors = 0;
+    return instance;
+}
+
+/// @brief Analisa a entrada já aberta no analisador léxico e monta o resultado.
+static const compile_result *run_compilation(compiler *compiler)
+{
+    parse_context *context = compiler->context;
+    compile_result *result = &compiler->result;
+
+    tree_node *syntax_tree = parse(context);
+    close_source_file(context->scanner); // Os nomes já foram copiados para a arena
+
+    memset(result, 0, sizeof(*result));
+    for (int i = 0; i < context->error_count; i++)
+    {
+        diagnostic *entry = &compiler->diagnostics[result->diagnostic_count++];
+        entry->kind = context->errors[i].is_lexical ? LEXICAL_DIAGNOSTIC : SYNTAX_DIAGNOSTIC;
+        entry->line = context->errors[i].line;
+        entry->message = context->errors[i].message;
+    }
+
+    if (syntax_tree != NULL)
+    {
+        semantic_analyzer *analyzer = compiler->analyzer;
+        reset_semantic_analyzer(analyzer, syntax_tree, context->arena);
+        analyze_semantics(analyzer);
+
+        for (int i = 0; i < analyzer->error_count; i++)
+        {
+            diagnostic *entry = &compiler->diagnostics[result->diagnostic_count++];
+            entry->kind = SEMANTIC_DIAGNOSTIC;
+            entry->line = analyzer->errors[i].line;
+            entry->message = analyzer->errors[i].message;
+        }
+
+        result->syntax_tree = analyzer->original_tree;
+        result->adjusted_tree = analyzer->adjusted_tree;
+        result->symbols = &analyzer->table;
+    }
+
+    result->diagnostics = compiler->diagnostics;
+    result->has_errors = context->is_error || result->diagnostic_count > 0;
+    return result;
+}
+
+const compile_result *compile_source(compiler *compiler, const char *source, size_t length)
+{
+    // O Flex exige dois '\0' após o texto; a cópia também protege a fonte de quem chama
+    if (length + 2 > compiler->source_capacity)
+    {
+        size_t capacity = (compiler->source_capacity == 0) ? 4096 : compiler->source_capacity;
+        while (capacity < length + 2)
+            capacity *= 2;
+
+        char *buffer = (char *)malloc(capacity);
+        if (buffer == NULL)
+            return NULL;
+        free(compiler->source);
+        compiler->source = buffer;
+        compiler->source_capacity = capacity;
+    }
+    memcpy(compiler->source, source, length);
+
+    arena_reset(compiler->context->arena);
+    if (!open_source_buffer(compiler->context->scanner, compiler->source, length))
+        return NULL;
+    return run_compilation(compiler);
+}
+
+const compile_result *compile_file(compiler *compiler, const char *path)
+{
+    arena_reset(compiler->context->arena);
+    if (!open_source_file(compiler->context->scanner, path))
+        return NULL;
+    return run_compilation(compiler);
+}
+
+void destroy_compiler(compiler *compiler)
+{
+    if (compiler == NULL)
+        return;
+
+    destroy_semantic_analyzer(compiler->analyzer);
+    destroy_parse_context(compiler->context);
+    free(compiler->source);
+    free(compiler);
+}
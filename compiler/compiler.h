@@ -0,0 +1,74 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stddef.h>
+#include "../parser/parser.h"
+#include "../semantic/semantic.h"
+
+/// @brief A origem de um diagnóstico.
+typedef enum diagnostic_kind
+{
+    LEXICAL_DIAGNOSTIC,
+    SYNTAX_DIAGNOSTIC,
+    SEMANTIC_DIAGNOSTIC
+} diagnostic_kind;
+
+/// @brief Um erro encontrado durante a compilação.
+typedef struct diagnostic
+{
+    diagnostic_kind kind;
+    int line;
+    const char *message; // Pertence ao compilador e é válida até a próxima compilação.
+} diagnostic;
+
+/// @brief O resultado de uma compilação.
+/// @note Todos os ponteiros pertencem ao compilador e só são válidos até a próxima chamada
+///       de compile_source() ou compile_file(), ou até destroy_compiler().
+typedef struct compile_result
+{
+    tree_node *syntax_tree;      // A árvore sintática, ou NULL se houve erro de sintaxe.
+    tree_node *adjusted_tree;    // A árvore após os ajustes semânticos, ou NULL se houve erro de sintaxe.
+    const symbol_table *symbols; // A tabela de símbolos, ou NULL se houve erro de sintaxe.
+    const diagnostic *diagnostics;
+    int diagnostic_count;
+    int has_errors; // 1 se houve qualquer erro léxico, sintático ou semântico.
+} compile_result;
+
+/// @brief Um compilador reutilizável, para embutir a análise de programas P- em outras aplicações.
+/// @note O analisador léxico, a arena, a tabela de símbolos e o buffer da fonte são criados uma única vez
+///       e reaproveitados a cada compilação, de modo que compilações seguidas não pedem memória ao sistema.
+///       Um compilador não deve ser usado por duas threads ao mesmo tempo; threads diferentes usam
+///       compiladores diferentes. Nenhum erro é impresso: todos ficam no resultado.
+typedef struct compiler
+{
+    parse_context *context;
+    semantic_analyzer *analyzer;
+    char *source;           // Cópia da última fonte compilada, com os dois '\0' exigidos pelo Flex.
+    size_t source_capacity;
+    diagnostic diagnostics[MAX_SYNTAX_ERRORS + MAX_ERRORS];
+    compile_result result;
+} compiler;
+
+/// @brief Cria um compilador.
+/// @return O compilador criado, ou NULL se não houver memória.
+compiler *create_compiler(void);
+
+/// @brief Compila um programa que está na memória.
+/// @param compiler O compilador.
+/// @param source O texto do programa. Não precisa terminar em '\0' e não é modificado.
+/// @param length O tamanho do texto.
+/// @return O resultado da compilação, ou NULL se não houver memória.
+const compile_result *compile_source(compiler *compiler, const char *source, size_t length);
+
+/// @brief Compila um arquivo.
+/// @note O arquivo é lido por open_source_file(), isto é, mapeado na memória quando possível.
+/// @param compiler O compilador.
+/// @param path O caminho do arquivo, ou "-" para a entrada padrão.
+/// @return O resultado da compilação, ou NULL se o arquivo não pôde ser aberto.
+const compile_result *compile_file(compiler *compiler, const char *path);
+
+/// @brief Libera o compilador e toda a memória das suas compilações.
+/// @param compiler O compilador.
+void destroy_compiler(compiler *compiler);
+
+#endif // COMPILER_H
@@ -0,0 +1,174 @@
+#include <stdlib.h> // malloc(), calloc(), realloc(), free()
+#include <unistd.h> // sysconf()
+#include "thread_pool.h"
+
+/// @brief O argumento de cada thread do conjunto.
+typedef struct worker_argument
+{
+    thread_pool *pool;
+    int worker;
+} worker_argument;
+
+/// @brief Retira a última tarefa da fila da própria thread.
+/// @return 1 se uma tarefa foi retirada, 0 se a fila está vazia.
+static int pop_task(task_queue *queue, task *result)
+{
+    int found = 0;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail > queue->head)
+    {
+        *result = queue->tasks[--queue->tail];
+        found = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+/// @brief Rouba a primeira tarefa da fila de outra thread.
+/// @return 1 se uma tarefa foi roubada, 0 se a fila está vazia.
+static int steal_task(task_queue *queue, task *result)
+{
+    int found = 0;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail > queue->head)
+    {
+        *result = queue->tasks[queue->head++];
+        found = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+/// @brief O laço de cada thread: esvazia a própria fila e depois rouba das outras até não haver tarefas.
+static void *run_worker(void *argument)
+{
+    worker_argument *self = (worker_argument *)argument;
+    thread_pool *pool = self->pool;
+    long stolen = 0;
+    task current;
+
+    for (;;)
+    {
+        if (pop_task(&pool->queues[self->worker], &current))
+        {
+            current.function(current.argument, self->worker);
+            continue;
+        }
+
+        int found = 0;
+        for (int offset = 1; offset < pool->worker_count && !found; offset++)
+        {
+            int victim = (self->worker + offset) % pool->worker_count;
+            found = steal_task(&pool->queues[victim], &current);
+        }
+
+        // Nenhuma tarefa nova é criada durante a execução: filas vazias significam fim do trabalho
+        if (!found)
+            break;
+
+        stolen++;
+        current.function(current.argument, self->worker);
+    }
+
+    pthread_mutex_lock(&pool->stats_lock);
+    pool->stolen += stolen;
+    pthread_mutex_unlock(&pool->stats_lock);
+    return NULL;
+}
+
+thread_pool *create_thread_pool(int worker_count)
+{
+    if (worker_count < 1)
+    {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = (processors > 0) ? (int)processors : 1;
+    }
+
+    thread_pool *pool = (thread_pool *)calloc(1, sizeof(thread_pool));
+    if (pool == NULL)
+        return NULL;
+
+    pool->queues = (task_queue *)calloc((size_t)worker_count, sizeof(task_queue));
+    if (pool->queues == NULL)
+    {
+        free(pool);
+        return NULL;
+    }
+
+    pool->worker_count = worker_count;
+    for (int i = 0; i < worker_count; i++)
+        pthread_mutex_init(&pool->queues[i].lock, NULL);
+    pthread_mutex_init(&pool->stats_lock, NULL);
+    return pool;
+}
+
+int submit_task(thread_pool *pool, task_function function, void *argument)
+{
+    task_queue *queue = &pool->queues[pool->next_queue];
+    pool->next_queue = (pool->next_queue + 1) % pool->worker_count;
+
+    if (queue->tail == queue->capacity)
+    {
+        int capacity = (queue->capacity == 0) ? 64 : queue->capacity * 2;
+        task *tasks = (task *)realloc(queue->tasks, (size_t)capacity * sizeof(task));
+        if (tasks == NULL)
+            return 0;
+        queue->tasks = tasks;
+        queue->capacity = capacity;
+    }
+
+    queue->tasks[queue->tail].function = function;
+    queue->tasks[queue->tail].argument = argument;
+    queue->tail++;
+    return 1;
+}
+
+void run_thread_pool(thread_pool *pool)
+{
+    pthread_t *threads = (pthread_t *)malloc((size_t)pool->worker_count * sizeof(pthread_t));
+    worker_argument *arguments = (worker_argument *)malloc((size_t)pool->worker_count * sizeof(worker_argument));
+    int started = 0;
+
+    pool->stolen = 0;
+    if (threads != NULL && arguments != NULL)
+    {
+        for (; started < pool->worker_count; started++)
+        {
+            arguments[started].pool = pool;
+            arguments[started].worker = started;
+            if (pthread_create(&threads[started], NULL, run_worker, &arguments[started]) != 0)
+                break;
+        }
+    }
+
+    // Sem threads disponíveis, a própria thread chamadora executa (e rouba) todas as tarefas
+    if (started == 0)
+    {
+        worker_argument self = {pool, 0};
+        run_worker(&self);
+    }
+
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    for (int i = 0; i < pool->worker_count; i++)
+        pool->queues[i].head = pool->queues[i].tail = 0;
+
+    free(threads);
+    free(arguments);
+}
+
+void destroy_thread_pool(thread_pool *pool)
+{
+    if (pool == NULL)
+        return;
+
+    for (int i = 0; i < pool->worker_count; i++)
+    {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+        free(pool->queues[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->stats_lock);
+    free(pool->queues);
+    free(pool);
+}
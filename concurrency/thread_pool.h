@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+
+/// @brief Uma tarefa do conjunto de threads.
+/// @param argument O argumento informado em submit_task().
+/// @param worker O índice da thread que executa a tarefa, de 0 a worker_count - 1.
+typedef void (*task_function)(void *argument, int worker);
+
+/// @brief Uma tarefa pendente.
+typedef struct task
+{
+    task_function function;
+    void *argument;
+} task;
+
+/// @brief A fila de tarefas de uma thread.
+/// @note A própria thread retira tarefas do fim da fila; as outras roubam do início.
+typedef struct task_queue
+{
+    task *tasks;
+    int head;     // Posição da próxima tarefa a ser roubada.
+    int tail;     // Uma posição após a última tarefa.
+    int capacity;
+    pthread_mutex_t lock;
+} task_queue;
+
+/// @brief Um conjunto de threads com roubo de tarefas (work stealing).
+/// @note As tarefas são distribuídas entre as filas em rodízio. Quando a fila de uma thread
+///       se esgota, ela rouba tarefas das filas das outras, de modo que arquivos grandes
+///       não deixam threads ociosas esperando.
+typedef struct thread_pool
+{
+    int worker_count;
+    task_queue *queues;
+    int next_queue;   // A fila que recebe a próxima tarefa submetida.
+    long stolen;      // Quantidade de tarefas executadas por roubo na última execução.
+    pthread_mutex_t stats_lock;
+} thread_pool;
+
+/// @brief Cria um conjunto de threads.
+/// @param worker_count A quantidade de threads. Valores menores que 1 usam a quantidade de processadores.
+/// @return O conjunto criado, ou NULL se não houver memória.
+thread_pool *create_thread_pool(int worker_count);
+
+/// @brief Adiciona uma tarefa a ser executada pela próxima chamada de run_thread_pool().
+/// @return 1 em caso de sucesso, 0 se não houver memória.
+int submit_task(thread_pool *pool, task_function function, void *argument);
+
+/// @brief Executa todas as tarefas submetidas e retorna quando todas terminarem.
+/// @attention As tarefas não podem submeter novas tarefas durante a execução.
+void run_thread_pool(thread_pool *pool);
+
+/// @brief Libera o conjunto de threads e as tarefas que não foram executadas.
+void destroy_thread_pool(thread_pool *pool);
+
+#endif // THREAD_POOL_H
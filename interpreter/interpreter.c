@@ -0,0 +1,282 @@
+#include <stdarg.h> // va_list
+#include <stdio.h>  // snprintf(), vsnprintf()
+#include <stdlib.h> // calloc(), free()
+#include <string.h> // memcpy()
+#include "interpreter.h"
+
+/// @brief O estado de uma execução.
+typedef struct interpreter
+{
+    unsigned char *frame; // As variáveis do programa, nos endereços da tabela de símbolos.
+    program_io *io;
+    execution_error *error;
+    int failed; // 1 depois de um erro de execução; interrompe os laços e as listas de comandos.
+} interpreter;
+
+static void fail(interpreter *state, int line, const char *format, ...)
+{
+    if (state->failed)
+        return;
+    state->failed = 1;
+    state->error->line = line;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(state->error->message, sizeof(state->error->message), format, args);
+    va_end(args);
+}
+
+// O quadro segue o leiaute da tabela de símbolos, em que um real pode começar em um endereço
+// que não é múltiplo de 8; memcpy() faz o acesso sem exigir alinhamento.
+static inline int load_integer(const interpreter *state, int address)
+{
+    int value;
+    memcpy(&value, state->frame + address, sizeof(value));
+    return value;
+}
+
+static inline double load_real(const interpreter *state, int address)
+{
+    double value;
+    memcpy(&value, state->frame + address, sizeof(value));
+    return value;
+}
+
+static inline void store_integer(interpreter *state, int address, int value)
+{
+    memcpy(state->frame + address, &value, sizeof(value));
+}
+
+static inline void store_real(interpreter *state, int address, double value)
+{
+    memcpy(state->frame + address, &value, sizeof(value));
+}
+
+static int evaluate_integer(interpreter *state, const tree_node *node);
+static double evaluate_real(interpreter *state, const tree_node *node);
+
+static int evaluate_integer(interpreter *state, const tree_node *node)
+{
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        return node->attribute.int_value;
+    case IDENTIFIER_EXPRESSION:
+        return load_integer(state, node->memory_address);
+    case OPERATION_EXPRESSION:
+    {
+        // As operações são feitas sem sinal para que o estouro dê a volta, como no hardware
+        unsigned int left = (unsigned int)evaluate_integer(state, node->child[0]);
+        unsigned int right = (unsigned int)evaluate_integer(state, node->child[1]);
+        switch (node->attribute.op)
+        {
+        case T_SOMA:
+            return (int)(left + right);
+        case T_SUB:
+            return (int)(left - right);
+        case T_MULT:
+            return (int)(left * right);
+        case T_DIV:
+            if (right == 0)
+            {
+                fail(state, node->line_number, "divisao por zero");
+                return 0;
+            }
+            if ((int)right == -1)
+                return (int)(0u - left);
+            return (int)left / (int)right;
+        default:
+            break;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return 0;
+}
+
+static double evaluate_real(interpreter *state, const tree_node *node)
+{
+    if (node->type == INTEGER)
+        return (double)evaluate_integer(state, node);
+
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        return node->attribute.real_value;
+    case IDENTIFIER_EXPRESSION:
+        return load_real(state, node->memory_address);
+    case CONVERSION_EXPRESSION:
+        return (double)evaluate_integer(state, node->child[0]);
+    case OPERATION_EXPRESSION:
+    {
+        double left = evaluate_real(state, node->child[0]);
+        double right = evaluate_real(state, node->child[1]);
+        switch (node->attribute.op)
+        {
+        case T_SOMA:
+            return left + right;
+        case T_SUB:
+            return left - right;
+        case T_MULT:
+            return left * right;
+        case T_DIV:
+            return left / right;
+        default:
+            break;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return 0.0;
+}
+
+static int evaluate_condition(interpreter *state, const tree_node *node)
+{
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+        return node->attribute.int_value != 0; // Condição avaliada pelo compilador
+    if (node->kind.exp != OPERATION_EXPRESSION)
+        return 0;
+
+    token_type op = node->attribute.op;
+    if (op == T_E)
+        return evaluate_condition(state, node->child[0]) && evaluate_condition(state, node->child[1]);
+    if (op == T_OU)
+        return evaluate_condition(state, node->child[0]) || evaluate_condition(state, node->child[1]);
+
+    // Após os ajustes semânticos, os dois operandos de uma comparação têm o mesmo tipo
+    if (node->child[0]->type == REAL || node->child[1]->type == REAL)
+    {
+        double left = evaluate_real(state, node->child[0]);
+        double right = evaluate_real(state, node->child[1]);
+        switch (op)
+        {
+        case T_MENOR:
+            return left < right;
+        case T_MENOR_IGUAL:
+            return left <= right;
+        case T_MAIOR:
+            return left > right;
+        case T_MAIOR_IGUAL:
+            return left >= right;
+        case T_IGUAL:
+            return left == right;
+        case T_DIFERENTE:
+            return left != right;
+        default:
+            return 0;
+        }
+    }
+
+    int left = evaluate_integer(state, node->child[0]);
+    int right = evaluate_integer(state, node->child[1]);
+    switch (op)
+    {
+    case T_MENOR:
+        return left < right;
+    case T_MENOR_IGUAL:
+        return left <= right;
+    case T_MAIOR:
+        return left > right;
+    case T_MAIOR_IGUAL:
+        return left >= right;
+    case T_IGUAL:
+        return left == right;
+    case T_DIFERENTE:
+        return left != right;
+    default:
+        return 0;
+    }
+}
+
+static void execute_statements(interpreter *state, const tree_node *node)
+{
+    for (; node != NULL && !state->failed; node = node->sibling)
+    {
+        if (node->node_kind != STATEMENT_KIND)
+            continue;
+
+        switch (node->kind.stmt)
+        {
+        case ASSIGNMENT_STATEMENT:
+            if (node->type == REAL)
+                store_real(state, node->memory_address, evaluate_real(state, node->child[0]));
+            else
+                store_integer(state, node->memory_address, evaluate_integer(state, node->child[0]));
+            break;
+        case READ_STATEMENT:
+            if (node->type == REAL)
+            {
+                double value;
+                if (read_real(state->io, &value))
+                    store_real(state, node->memory_address, value);
+                else
+                    fail(state, node->line_number, "entrada invalida ou encerrada");
+            }
+            else
+            {
+                int value;
+                if (read_integer(state->io, &value))
+                    store_integer(state, node->memory_address, value);
+                else
+                    fail(state, node->line_number, "entrada invalida ou encerrada");
+            }
+            break;
+        case WRITE_STATEMENT:
+            if (node->child[0]->type == REAL)
+            {
+                double value = evaluate_real(state, node->child[0]);
+                if (!state->failed)
+                    write_real(state->io, value);
+            }
+            else
+            {
+                int value = evaluate_integer(state, node->child[0]);
+                if (!state->failed)
+                    write_integer(state->io, value);
+            }
+            break;
+        case IF_STATEMENT:
+            if (evaluate_condition(state, node->child[0]))
+                execute_statements(state, node->child[1]);
+            else
+                execute_statements(state, node->child[2]);
+            break;
+        case WHILE_STATEMENT:
+            while (!state->failed && evaluate_condition(state, node->child[0]))
+                execute_statements(state, node->child[1]);
+            break;
+        case REPEAT_STATEMENT:
+            // repita ... ate <condição>: o corpo executa até a condição se tornar verdadeira
+            do
+                execute_statements(state, node->child[0]);
+            while (!state->failed && !evaluate_condition(state, node->child[1]));
+            break;
+        case DECLARATION_STATEMENT:
+            break;
+        }
+    }
+}
+
+int interpret_program(tree_node *tree, int frame_size, program_io *io, execution_error *error)
+{
+    interpreter state;
+    state.frame = (unsigned char *)calloc(1, (size_t)frame_size + 8);
+    state.io = io;
+    state.error = error;
+    state.failed = 0;
+
+    if (state.frame == NULL)
+    {
+        error->line = 0;
+        snprintf(error->message, sizeof(error->message), "memoria insuficiente");
+        return 0;
+    }
+
+    execute_statements(&state, tree);
+    free(state.frame);
+    return !state.failed;
+}
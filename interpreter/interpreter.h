@@ -0,0 +1,25 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "../parser/parser.h"
+#include "../runtime/program_io.h"
+
+/// @brief O erro que interrompeu a execução de um programa.
+typedef struct execution_error
+{
+    int line;
+    char message[256];
+} execution_error;
+
+/// @brief Executa um programa percorrendo a sua árvore ajustada.
+/// @note As variáveis ficam em um quadro de frame_size bytes, zerado no início, nos endereços
+///       da tabela de símbolos. A árvore precisa ter passado por resolve_tree(): nenhum nome é
+///       consultado durante a execução.
+/// @param tree A árvore ajustada e resolvida.
+/// @param frame_size O tamanho do quadro, em bytes (o próximo endereço livre da tabela de símbolos).
+/// @param io A entrada de ler() e a saída de mostrar().
+/// @param error Recebe a descrição do erro, se a execução for interrompida.
+/// @return 1 se o programa terminou normalmente, 0 se foi interrompido por um erro de execução.
+int interpret_program(tree_node *tree, int frame_size, program_io *io, execution_error *error);
+
+#endif // INTERPRETER_H
@@ -0,0 +1,291 @@
+#include <stdlib.h> // calloc(), malloc(), free()
+#include <string.h> // memcpy()
+#include "ir.h"
+
+/*
+ * Numeração de valores sobre a árvore de dominadores: uma instrução é redundante se uma instrução igual
+ * (mesma operação, mesmo tipo e os mesmos operandos) a domina, porque então ela já foi executada em
+ * todo caminho que chega à segunda. A tabela guarda as instruções dos blocos que dominam o bloco
+ * visitado; ao sair de um bloco, as instruções que ele acrescentou são retiradas, na ordem inversa.
+ */
+typedef struct value_table
+{
+    ir_program *program;
+    int *slots; // O índice de uma instrução, ou -1.
+    int mask;
+    int *inserted; // As posições ocupadas, na ordem em que foram ocupadas.
+    int inserted_count;
+} value_table;
+
+static int is_pure(ir_opcode opcode)
+{
+    return opcode >= IR_ADD && opcode <= IR_TO_REAL;
+}
+
+static int is_commutative(ir_opcode opcode)
+{
+    return opcode == IR_ADD || opcode == IR_MUL || opcode == IR_EQ || opcode == IR_NE;
+}
+
+/// @brief Os operandos de uma instrução, com as substituições seguidas e em ordem fixa nas operações comutativas.
+static void value_key(const ir_program *program, const ir_value *value, int key[2])
+{
+    key[0] = resolve_ir_value(program, value->operands[0]);
+    key[1] = resolve_ir_value(program, value->operands[1]);
+    if (is_commutative(value->opcode) && key[0] > key[1])
+    {
+        int swap = key[0];
+        key[0] = key[1];
+        key[1] = swap;
+    }
+}
+
+static unsigned int hash_value(const ir_program *program, const ir_value *value)
+{
+    int key[2];
+    value_key(program, value, key);
+    unsigned int hash = (unsigned int)value->opcode * 31u + (unsigned int)value->type;
+    hash = hash * 2654435761u ^ (unsigned int)key[0];
+    hash = hash * 2654435761u ^ (unsigned int)key[1];
+    return hash * 2654435761u;
+}
+
+static int same_value(const ir_program *program, const ir_value *a, const ir_value *b)
+{
+    if (a->opcode != b->opcode || a->type != b->type)
+        return 0;
+    int key_a[2], key_b[2];
+    value_key(program, a, key_a);
+    value_key(program, b, key_b);
+    return key_a[0] == key_b[0] && key_a[1] == key_b[1];
+}
+
+/// @brief Procura uma instrução igual na tabela; se não houver, acrescenta esta.
+/// @return A instrução igual, ou -1.
+static int find_or_insert(value_table *table, int index)
+{
+    const ir_value *value = &table->program->values[index];
+    int slot = (int)(hash_value(table->program, value) & (unsigned int)table->mask);
+    while (table->slots[slot] >= 0)
+    {
+        if (same_value(table->program, &table->program->values[table->slots[slot]], value))
+            return table->slots[slot];
+        slot = (slot + 1) & table->mask;
+    }
+    table->slots[slot] = index;
+    table->inserted[table->inserted_count++] = slot;
+    return -1;
+}
+
+static int same_bits(const ir_value *a, const ir_value *b)
+{
+    if (a->type != b->type)
+        return 0;
+    if (a->type == REAL)
+        return memcmp(&a->constant.real_value, &b->constant.real_value, sizeof(double)) == 0;
+    return a->constant.int_value == b->constant.int_value;
+}
+
+/// @brief Faz as constantes iguais virarem um único valor, para que as instruções que as usam sejam comparáveis.
+static void unify_constants(ir_program *program, int *slots, int mask)
+{
+    for (int i = 0; i < program->value_count; i++)
+    {
+        ir_value *value = &program->values[i];
+        if (value->opcode != IR_CONSTANT || value->replacement >= 0)
+            continue;
+        unsigned int bits = (unsigned int)value->constant.int_value;
+        if (value->type == REAL)
+        {
+            unsigned long long word;
+            memcpy(&word, &value->constant.real_value, sizeof(word));
+            bits = (unsigned int)(word ^ (word >> 32));
+        }
+        int slot = (int)(((bits ^ (unsigned int)value->type) * 2654435761u) & (unsigned int)mask);
+        while (slots[slot] >= 0 && !same_bits(&program->values[slots[slot]], value))
+            slot = (slot + 1) & mask;
+        if (slots[slot] >= 0)
+            value->replacement = slots[slot];
+        else
+            slots[slot] = i;
+    }
+}
+
+/// @brief Ordena os blocos alcançáveis em pós-ordem reversa, com uma busca em profundidade sem recursão.
+/// @return Quantos blocos foram ordenados.
+static int reverse_postorder(const ir_program *program, int *order, int *number, int *stack, int *next)
+{
+    int count = 0, depth = 0;
+    for (int b = 0; b < program->block_count; b++)
+    {
+        number[b] = -1;
+        next[b] = 0;
+    }
+    number[0] = -2; // Visitado, ainda sem número
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        int b = stack[depth - 1];
+        const ir_block *block = &program->blocks[b];
+        int successors = (block->terminator == IR_BRANCH) ? 2 : (block->terminator == IR_JUMP) ? 1 : 0;
+        if (next[b] < successors)
+        {
+            int successor = block->successors[next[b]++];
+            if (number[successor] == -1)
+            {
+                number[successor] = -2;
+                stack[depth++] = successor;
+            }
+            continue;
+        }
+        depth--;
+        order[count++] = b;
+    }
+    // order está em pós-ordem; inverte e numera
+    for (int i = 0; i < count / 2; i++)
+    {
+        int swap = order[i];
+        order[i] = order[count - 1 - i];
+        order[count - 1 - i] = swap;
+    }
+    for (int i = 0; i < count; i++)
+        number[order[i]] = i;
+    return count;
+}
+
+/// @brief Calcula o dominador imediato de cada bloco (Cooper, Harvey e Kennedy).
+static void compute_dominators(const ir_program *program, const int *order, const int *number, int count, int *idom)
+{
+    for (int b = 0; b < program->block_count; b++)
+        idom[b] = -1;
+    idom[0] = 0;
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int i = 1; i < count; i++)
+        {
+            int b = order[i];
+            const ir_block *block = &program->blocks[b];
+            int dominator = -1;
+            for (int p = 0; p < block->predecessor_count; p++)
+            {
+                int predecessor = block->predecessors[p];
+                if (number[predecessor] < 0 || idom[predecessor] < 0)
+                    continue;
+                if (dominator < 0)
+                {
+                    dominator = predecessor;
+                    continue;
+                }
+                int a = predecessor, c = dominator;
+                while (a != c)
+                {
+                    while (number[a] > number[c])
+                        a = idom[a];
+                    while (number[c] > number[a])
+                        c = idom[c];
+                }
+                dominator = a;
+            }
+            if (dominator >= 0 && idom[b] != dominator)
+            {
+                idom[b] = dominator;
+                changed = 1;
+            }
+        }
+    }
+}
+
+int number_ir_values(ir_program *program)
+{
+    int block_count = program->block_count;
+    if (block_count == 0)
+        return 1;
+
+    int capacity = 16;
+    while (capacity < program->value_count * 2)
+        capacity *= 2;
+
+    int *order = (int *)malloc((size_t)block_count * sizeof(int));
+    int *number = (int *)malloc((size_t)block_count * sizeof(int));
+    int *idom = (int *)malloc((size_t)block_count * sizeof(int));
+    int *next = (int *)malloc((size_t)block_count * sizeof(int));
+    int *stack = (int *)malloc((size_t)block_count * 2 * sizeof(int));
+    int *first_child = (int *)malloc(((size_t)block_count + 1) * sizeof(int));
+    int *children = (int *)malloc((size_t)block_count * sizeof(int));
+    int *slots = (int *)malloc((size_t)capacity * sizeof(int));
+    int *inserted = (int *)malloc((size_t)capacity * sizeof(int));
+    int *marks = (int *)malloc((size_t)block_count * sizeof(int));
+    int ok = order && number && idom && next && stack && first_child && children && slots && inserted && marks;
+
+    if (ok)
+    {
+        for (int i = 0; i < capacity; i++)
+            slots[i] = -1;
+        unify_constants(program, slots, capacity - 1);
+        for (int i = 0; i < capacity; i++)
+            slots[i] = -1;
+
+        int count = reverse_postorder(program, order, number, stack, next);
+        compute_dominators(program, order, number, count, idom);
+
+        // Os filhos de cada bloco na árvore de dominadores, em lista compacta
+        for (int b = 0; b <= block_count; b++)
+            first_child[b] = 0;
+        for (int i = 1; i < count; i++)
+            first_child[idom[order[i]] + 1]++;
+        for (int b = 0; b < block_count; b++)
+            first_child[b + 1] += first_child[b];
+        for (int b = 0; b < block_count; b++)
+            next[b] = first_child[b];
+        for (int i = 1; i < count; i++)
+            children[next[idom[order[i]]]++] = order[i];
+
+        // Percorre a árvore em pré-ordem; um valor negativo na pilha marca a saída do bloco -(b + 1)
+        value_table table = {program, slots, capacity - 1, inserted, 0};
+        int depth = 0;
+        stack[depth++] = 0;
+        while (depth > 0)
+        {
+            int b = stack[--depth];
+            if (b < 0)
+            {
+                while (table.inserted_count > marks[-b - 1])
+                    table.slots[table.inserted[--table.inserted_count]] = -1;
+                continue;
+            }
+            marks[b] = table.inserted_count;
+            stack[depth++] = -(b + 1);
+
+            const ir_block *block = &program->blocks[b];
+            for (int i = 0; i < block->instruction_count; i++)
+            {
+                int index = block->instructions[i];
+                ir_value *value = &program->values[index];
+                if (!is_pure(value->opcode) || value->replacement >= 0)
+                    continue;
+                int equal = find_or_insert(&table, index);
+                if (equal >= 0)
+                {
+                    value->replacement = equal;
+                    program->redundant_values++;
+                }
+            }
+            for (int c = first_child[b]; c < first_child[b + 1]; c++)
+                stack[depth++] = children[c];
+        }
+    }
+
+    free(order);
+    free(number);
+    free(idom);
+    free(next);
+    free(stack);
+    free(first_child);
+    free(children);
+    free(slots);
+    free(inserted);
+    free(marks);
+    return ok;
+}
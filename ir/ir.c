@@ -0,0 +1,619 @@
+#include <stdlib.h> // malloc(), calloc(), realloc(), free()
+#include <string.h> // memset()
+#include "ir.h"
+
+/// @brief Uma entrada do registro de atribuições: a variável e o valor que ela tinha antes.
+typedef struct ir_assignment
+{
+    int variable;
+    int previous;
+} ir_assignment;
+
+/// @brief O estado da tradução da árvore.
+/// @note current guarda o valor atual de cada variável no ponto da tradução. Cada mudança é registrada
+///       em log, para que o caminho "então" de um se possa ser desfeito antes da tradução do "senão";
+///       pending guarda, enquanto o "senão" é traduzido, os valores de cada variável no fim do "então".
+typedef struct ir_builder
+{
+    ir_program *program;
+    semantic_analyzer *analyzer;
+    int block;      // O bloco onde as instruções estão sendo emitidas.
+    int *current;   // O valor atual de cada variável; -1 enquanto ela vale o 0 inicial.
+    int *zeros;     // A constante 0 do tipo de cada variável, criada na primeira vez que é preciso.
+    ir_assignment *log;
+    int log_count;
+    int log_capacity;
+    ir_assignment *pending;
+    int pending_count;
+    int pending_capacity;
+    int *assigned;  // As variáveis atribuídas no corpo do laço que está sendo traduzido.
+    int assigned_count;
+    int assigned_capacity;
+    int *seen;      // Para não repetir variáveis numa lista: seen[v] == generation se v já está nela.
+    int generation;
+    int failed;
+} ir_builder;
+
+/// @brief Garante espaço para mais um elemento num vetor que cresce por duplicação.
+static int reserve(ir_builder *builder, void **items, int count, int *capacity, size_t item_size)
+{
+    if (count < *capacity)
+        return 1;
+    int grown_capacity = (*capacity == 0) ? 8 : *capacity * 2;
+    void *grown = realloc(*items, (size_t)grown_capacity * item_size);
+    if (grown == NULL)
+    {
+        builder->failed = 1;
+        return 0;
+    }
+    *items = grown;
+    *capacity = grown_capacity;
+    return 1;
+}
+
+static int push_int(ir_builder *builder, int **items, int *count, int *capacity, int item)
+{
+    void *memory = *items;
+    if (!reserve(builder, &memory, *count, capacity, sizeof(int)))
+        return 0;
+    *items = (int *)memory;
+    (*items)[(*count)++] = item;
+    return 1;
+}
+
+static int new_value(ir_builder *builder, ir_opcode opcode, exp_type type, int block)
+{
+    ir_program *program = builder->program;
+    void *memory = program->values;
+    if (!reserve(builder, &memory, program->value_count, &program->value_capacity, sizeof(ir_value)))
+        return 0; // O valor 0 continua válido; a tradução é descartada no final
+    program->values = (ir_value *)memory;
+
+    int index = program->value_count++;
+    ir_value *value = &program->values[index];
+    value->opcode = opcode;
+    value->type = type;
+    value->block = block;
+    value->operands[0] = -1;
+    value->operands[1] = -1;
+    value->variable = -1;
+    value->line = 0;
+    value->constant.real_value = 0;
+    value->state = IR_UNKNOWN;
+    value->replacement = -1;
+    if (block >= 0)
+    {
+        ir_block *owner = &program->blocks[block];
+        push_int(builder, &owner->instructions, &owner->instruction_count, &owner->instruction_capacity, index);
+    }
+    return index;
+}
+
+static int new_block(ir_builder *builder)
+{
+    ir_program *program = builder->program;
+    void *memory = program->blocks;
+    if (!reserve(builder, &memory, program->block_count, &program->block_capacity, sizeof(ir_block)))
+        return 0;
+    program->blocks = (ir_block *)memory;
+
+    ir_block *block = &program->blocks[program->block_count];
+    memset(block, 0, sizeof(ir_block));
+    block->terminator = IR_RETURN;
+    block->condition = -1;
+    block->successors[0] = -1;
+    block->successors[1] = -1;
+    block->reachable = 1;
+    return program->block_count++;
+}
+
+static void add_edge(ir_builder *builder, int from, int to)
+{
+    ir_block *target = &builder->program->blocks[to];
+    push_int(builder, &target->predecessors, &target->predecessor_count, &target->predecessor_capacity, from);
+}
+
+static void jump(ir_builder *builder, int from, int to)
+{
+    ir_block *block = &builder->program->blocks[from];
+    block->terminator = IR_JUMP;
+    block->successors[0] = to;
+    add_edge(builder, from, to);
+}
+
+static void branch(ir_builder *builder, int from, int condition, int when_true, int when_false)
+{
+    ir_block *block = &builder->program->blocks[from];
+    block->terminator = IR_BRANCH;
+    block->condition = condition;
+    block->successors[0] = when_true;
+    block->successors[1] = when_false;
+    add_edge(builder, from, when_true);
+    add_edge(builder, from, when_false);
+}
+
+static int new_integer_constant(ir_builder *builder, exp_type type, int value)
+{
+    int index = new_value(builder, IR_CONSTANT, type, -1);
+    builder->program->values[index].constant.int_value = value;
+    builder->program->values[index].state = IR_KNOWN;
+    return index;
+}
+
+static int new_real_constant(ir_builder *builder, double value)
+{
+    int index = new_value(builder, IR_CONSTANT, REAL, -1);
+    builder->program->values[index].constant.real_value = value;
+    builder->program->values[index].state = IR_KNOWN;
+    return index;
+}
+
+static exp_type variable_type(ir_builder *builder, int variable)
+{
+    return (builder->analyzer->table.symbols[variable].type == DT_REAL) ? REAL : INTEGER;
+}
+
+/// @brief O valor de uma variável que ainda não foi atribuída: o 0 do seu tipo.
+static int zero_of(ir_builder *builder, int variable)
+{
+    if (builder->zeros[variable] < 0)
+    {
+        builder->zeros[variable] = (variable_type(builder, variable) == REAL)
+                                       ? new_real_constant(builder, 0.0)
+                                       : new_integer_constant(builder, INTEGER, 0);
+    }
+    return builder->zeros[variable];
+}
+
+static int value_of(ir_builder *builder, int variable)
+{
+    int value = builder->current[variable];
+    return (value >= 0) ? value : zero_of(builder, variable);
+}
+
+static void set_current(ir_builder *builder, int variable, int value)
+{
+    void *memory = builder->log;
+    if (!reserve(builder, &memory, builder->log_count, &builder->log_capacity, sizeof(ir_assignment)))
+        return;
+    builder->log = (ir_assignment *)memory;
+    builder->log[builder->log_count].variable = variable;
+    builder->log[builder->log_count].previous = builder->current[variable];
+    builder->log_count++;
+    builder->current[variable] = value;
+}
+
+/// @brief Desfaz as atribuições registradas depois de mark.
+static void undo(ir_builder *builder, int mark)
+{
+    while (builder->log_count > mark)
+    {
+        builder->log_count--;
+        builder->current[builder->log[builder->log_count].variable] = builder->log[builder->log_count].previous;
+    }
+}
+
+static void push_pending(ir_builder *builder, int variable, int value)
+{
+    void *memory = builder->pending;
+    if (!reserve(builder, &memory, builder->pending_count, &builder->pending_capacity, sizeof(ir_assignment)))
+        return;
+    builder->pending = (ir_assignment *)memory;
+    builder->pending[builder->pending_count].variable = variable;
+    builder->pending[builder->pending_count].previous = value;
+    builder->pending_count++;
+}
+
+static int new_phi(ir_builder *builder, int block, int variable, exp_type type, int first, int second)
+{
+    int index = new_value(builder, IR_PHI, type, block);
+    ir_value *phi = &builder->program->values[index];
+    phi->variable = variable;
+    phi->operands[0] = first;
+    phi->operands[1] = second;
+    return index;
+}
+
+static int is_comparison(token_type op)
+{
+    return op == T_MENOR || op == T_MENOR_IGUAL || op == T_MAIOR || op == T_MAIOR_IGUAL ||
+           op == T_IGUAL || op == T_DIFERENTE;
+}
+
+static ir_opcode operation_opcode(token_type op)
+{
+    switch (op)
+    {
+    case T_SOMA:
+        return IR_ADD;
+    case T_SUB:
+        return IR_SUB;
+    case T_MULT:
+        return IR_MUL;
+    case T_DIV:
+        return IR_DIV;
+    case T_MENOR:
+        return IR_LT;
+    case T_MENOR_IGUAL:
+        return IR_LE;
+    case T_MAIOR:
+        return IR_GT;
+    case T_MAIOR_IGUAL:
+        return IR_GE;
+    case T_IGUAL:
+        return IR_EQ;
+    default:
+        return IR_NE;
+    }
+}
+
+static void lower_condition(ir_builder *builder, tree_node *node, int when_true, int when_false);
+
+static int lower_expression(ir_builder *builder, tree_node *node)
+{
+    ir_program *program = builder->program;
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        if (node->type == REAL)
+            return new_real_constant(builder, node->attribute.real_value);
+        return new_integer_constant(builder, node->type == BOOLEAN ? BOOLEAN : INTEGER, node->attribute.int_value);
+    case IDENTIFIER_EXPRESSION:
+    {
+        int variable = symbol_index(builder->analyzer, node->attribute.name);
+        if (variable < 0)
+            return new_integer_constant(builder, INTEGER, 0);
+        int value = value_of(builder, variable);
+        void *memory = program->uses;
+        if (reserve(builder, &memory, program->use_count, &program->use_capacity, sizeof(ir_use)))
+        {
+            program->uses = (ir_use *)memory;
+            program->uses[program->use_count].node = node;
+            program->uses[program->use_count].value = value;
+            program->use_count++;
+        }
+        return value;
+    }
+    case CONVERSION_EXPRESSION:
+    {
+        int operand = lower_expression(builder, node->child[0]);
+        int index = new_value(builder, IR_TO_REAL, REAL, builder->block);
+        program->values[index].operands[0] = operand;
+        return index;
+    }
+    case OPERATION_EXPRESSION:
+    default:
+        break;
+    }
+
+    token_type op = node->attribute.op;
+    if (op == T_E || op == T_OU)
+    {
+        // Um valor lógico fora de uma condição: os dois caminhos se encontram numa phi
+        int when_true = new_block(builder), when_false = new_block(builder), join = new_block(builder);
+        lower_condition(builder, node, when_true, when_false);
+        jump(builder, when_true, join);
+        jump(builder, when_false, join);
+        builder->block = join;
+        return new_phi(builder, join, -1, BOOLEAN, new_integer_constant(builder, BOOLEAN, 1),
+                       new_integer_constant(builder, BOOLEAN, 0));
+    }
+
+    int left = lower_expression(builder, node->child[0]);
+    int right = lower_expression(builder, node->child[1]);
+    exp_type type = BOOLEAN;
+    if (!is_comparison(op))
+        type = (program->values[left].type == REAL || program->values[right].type == REAL) ? REAL : INTEGER;
+    int index = new_value(builder, operation_opcode(op), type, builder->block);
+    program->values[index].operands[0] = left;
+    program->values[index].operands[1] = right;
+    program->values[index].line = node->line_number;
+    return index;
+}
+
+/// @brief Traduz uma condição em desvios para when_true e when_false, em curto-circuito.
+static void lower_condition(ir_builder *builder, tree_node *node, int when_true, int when_false)
+{
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+    {
+        jump(builder, builder->block, node->attribute.int_value ? when_true : when_false);
+        return;
+    }
+    if (node->kind.exp == OPERATION_EXPRESSION && (node->attribute.op == T_E || node->attribute.op == T_OU))
+    {
+        int middle = new_block(builder);
+        if (node->attribute.op == T_E)
+            lower_condition(builder, node->child[0], middle, when_false);
+        else
+            lower_condition(builder, node->child[0], when_true, middle);
+        builder->block = middle;
+        lower_condition(builder, node->child[1], when_true, when_false);
+        return;
+    }
+    int condition = lower_expression(builder, node);
+    branch(builder, builder->block, condition, when_true, when_false);
+}
+
+/// @brief Acrescenta a builder->assigned as variáveis atribuídas ou lidas com ler() numa lista de comandos.
+static void collect_assigned(ir_builder *builder, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+        {
+            int variable = symbol_index(builder->analyzer, node->attribute.name);
+            if (variable >= 0 && builder->seen[variable] != builder->generation)
+            {
+                builder->seen[variable] = builder->generation;
+                push_int(builder, &builder->assigned, &builder->assigned_count, &builder->assigned_capacity, variable);
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                collect_assigned(builder, node->child[i]);
+        }
+    }
+}
+
+/// @brief Cria no cabeçalho de um laço uma phi para cada variável atribuída no corpo, com o valor de
+///        entrada como primeiro operando; o segundo, o valor no fim do corpo, é preenchido por close_loop().
+/// @return Quantas phis foram criadas; elas são as primeiras instruções do bloco.
+static int open_loop(ir_builder *builder, const tree_node *body, int header)
+{
+    builder->generation++;
+    builder->assigned_count = 0;
+    collect_assigned(builder, body);
+    for (int i = 0; i < builder->assigned_count; i++)
+    {
+        int variable = builder->assigned[i];
+        int phi = new_phi(builder, header, variable, variable_type(builder, variable), value_of(builder, variable), -1);
+        set_current(builder, variable, phi);
+    }
+    return builder->assigned_count;
+}
+
+static void close_loop(ir_builder *builder, int header, int phi_count)
+{
+    ir_program *program = builder->program;
+    for (int i = 0; i < phi_count && !builder->failed; i++)
+    {
+        ir_value *phi = &program->values[program->blocks[header].instructions[i]];
+        phi->operands[1] = value_of(builder, phi->variable);
+    }
+}
+
+static void lower_statements(ir_builder *builder, tree_node *node);
+
+static void lower_if(ir_builder *builder, tree_node *node)
+{
+    int then_block = new_block(builder), else_block = new_block(builder);
+    lower_condition(builder, node->child[0], then_block, else_block);
+
+    int mark = builder->log_count;
+    builder->block = then_block;
+    lower_statements(builder, node->child[1]);
+    int then_end = builder->block;
+
+    // Guarda o valor, no fim do "então", de cada variável atribuída nele e desfaz as atribuições
+    int base = builder->pending_count;
+    builder->generation++;
+    for (int i = mark; i < builder->log_count; i++)
+    {
+        int variable = builder->log[i].variable;
+        if (builder->seen[variable] != builder->generation)
+        {
+            builder->seen[variable] = builder->generation;
+            push_pending(builder, variable, builder->current[variable]);
+        }
+    }
+    undo(builder, mark);
+
+    builder->block = else_block;
+    lower_statements(builder, node->child[2]);
+    int else_end = builder->block;
+
+    // As variáveis atribuídas só no "senão" tinham, no fim do "então", o valor de antes do se
+    builder->generation++;
+    for (int k = base; k < builder->pending_count; k++)
+        builder->seen[builder->pending[k].variable] = builder->generation;
+    for (int i = mark; i < builder->log_count; i++)
+    {
+        int variable = builder->log[i].variable;
+        if (builder->seen[variable] != builder->generation)
+        {
+            builder->seen[variable] = builder->generation;
+            push_pending(builder, variable, builder->log[i].previous);
+        }
+    }
+
+    int join = new_block(builder);
+    jump(builder, then_end, join);
+    jump(builder, else_end, join);
+    builder->block = join;
+    for (int k = base; k < builder->pending_count && !builder->failed; k++)
+    {
+        int variable = builder->pending[k].variable;
+        int then_value = builder->pending[k].previous;
+        if (then_value < 0)
+            then_value = zero_of(builder, variable);
+        int else_value = value_of(builder, variable);
+        if (then_value != else_value)
+            set_current(builder, variable,
+                        new_phi(builder, join, variable, variable_type(builder, variable), then_value, else_value));
+    }
+    builder->pending_count = base;
+}
+
+static void lower_while(ir_builder *builder, tree_node *node)
+{
+    int header = new_block(builder);
+    jump(builder, builder->block, header);
+    int phi_count = open_loop(builder, node->child[1], header);
+
+    int body = new_block(builder), exit = new_block(builder);
+    builder->block = header;
+    lower_condition(builder, node->child[0], body, exit);
+    builder->block = body;
+    lower_statements(builder, node->child[1]);
+    jump(builder, builder->block, header);
+    close_loop(builder, header, phi_count);
+
+    // O laço termina no cabeçalho, onde as variáveis valem as phis
+    for (int i = 0; i < phi_count && !builder->failed; i++)
+    {
+        int phi = builder->program->blocks[header].instructions[i];
+        set_current(builder, builder->program->values[phi].variable, phi);
+    }
+    builder->block = exit;
+}
+
+static void lower_repeat(ir_builder *builder, tree_node *node)
+{
+    int body = new_block(builder);
+    jump(builder, builder->block, body);
+    int phi_count = open_loop(builder, node->child[0], body);
+
+    builder->block = body;
+    lower_statements(builder, node->child[0]);
+    int exit = new_block(builder), latch = new_block(builder);
+    lower_condition(builder, node->child[1], exit, latch);
+    jump(builder, latch, body);
+    close_loop(builder, body, phi_count);
+    builder->block = exit; // O laço termina no fim do corpo, com os valores que as variáveis têm lá
+}
+
+static void lower_statements(ir_builder *builder, tree_node *node)
+{
+    ir_program *program = builder->program;
+    for (; node != NULL && !builder->failed; node = node->sibling)
+    {
+        switch (node->kind.stmt)
+        {
+        case ASSIGNMENT_STATEMENT:
+        {
+            int variable = symbol_index(builder->analyzer, node->attribute.name);
+            int value = lower_expression(builder, node->child[0]);
+            if (variable >= 0)
+                set_current(builder, variable, value);
+            break;
+        }
+        case READ_STATEMENT:
+        {
+            int variable = symbol_index(builder->analyzer, node->attribute.name);
+            if (variable < 0)
+                break;
+            int value = new_value(builder, IR_READ, variable_type(builder, variable), builder->block);
+            program->values[value].variable = variable;
+            program->values[value].line = node->line_number;
+            set_current(builder, variable, value);
+            break;
+        }
+        case WRITE_STATEMENT:
+        {
+            int operand = lower_expression(builder, node->child[0]);
+            int value = new_value(builder, IR_WRITE, VOID, builder->block);
+            program->values[value].operands[0] = operand;
+            program->values[value].line = node->line_number;
+            break;
+        }
+        case IF_STATEMENT:
+            lower_if(builder, node);
+            break;
+        case WHILE_STATEMENT:
+            lower_while(builder, node);
+            break;
+        case REPEAT_STATEMENT:
+            lower_repeat(builder, node);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int resolve_ir_value(const ir_program *program, int value)
+{
+    while (value >= 0 && program->values[value].replacement >= 0)
+        value = program->values[value].replacement;
+    return value;
+}
+
+/// @brief Troca as phis triviais, cujos operandos são todos o mesmo valor (ou a própria phi), por esse
+///        valor. Repete até não haver mudança, porque uma troca pode tornar outra phi trivial.
+static void remove_trivial_phis(ir_program *program)
+{
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int i = 0; i < program->value_count; i++)
+        {
+            ir_value *value = &program->values[i];
+            if (value->opcode != IR_PHI || value->replacement >= 0)
+                continue;
+            int first = resolve_ir_value(program, value->operands[0]);
+            int second = resolve_ir_value(program, value->operands[1]);
+            if (first == second || second == i)
+                value->replacement = first;
+            else if (first == i)
+                value->replacement = second;
+            changed = changed || value->replacement >= 0;
+        }
+    }
+}
+
+ir_program *build_ir(semantic_analyzer *analyzer, tree_node *tree)
+{
+    int variable_count = analyzer->table.count;
+    ir_program *program = (ir_program *)calloc(1, sizeof(ir_program));
+    ir_builder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.program = program;
+    builder.analyzer = analyzer;
+    builder.current = (int *)malloc(((size_t)variable_count + 1) * sizeof(int));
+    builder.zeros = (int *)malloc(((size_t)variable_count + 1) * sizeof(int));
+    builder.seen = (int *)calloc((size_t)variable_count + 1, sizeof(int));
+    builder.failed = (program == NULL || builder.current == NULL || builder.zeros == NULL || builder.seen == NULL);
+
+    if (!builder.failed)
+    {
+        program->symbols = &analyzer->table;
+        for (int i = 0; i < variable_count; i++)
+        {
+            builder.current[i] = -1;
+            builder.zeros[i] = -1;
+        }
+        builder.block = new_block(&builder);
+        lower_statements(&builder, tree);
+    }
+
+    free(builder.current);
+    free(builder.zeros);
+    free(builder.seen);
+    free(builder.log);
+    free(builder.pending);
+    free(builder.assigned);
+    if (builder.failed)
+    {
+        destroy_ir(program);
+        return NULL;
+    }
+    remove_trivial_phis(program);
+    return program;
+}
+
+void destroy_ir(ir_program *program)
+{
+    if (program == NULL)
+        return;
+    for (int b = 0; b < program->block_count; b++)
+    {
+        free(program->blocks[b].predecessors);
+        free(program->blocks[b].instructions);
+    }
+    free(program->blocks);
+    free(program->values);
+    free(program->uses);
+    free(program);
+}
@@ -0,0 +1,149 @@
+#ifndef IR_H
+#define IR_H
+
+#include "../semantic/semantic.h"
+
+/*
+ * A representação intermediária: um grafo de fluxo de controle em que cada bloco básico é uma
+ * sequência de instruções em forma SSA, terminada por um salto, um desvio condicional ou o fim do
+ * programa. Cada instrução define um único valor, identificado pelo seu índice (v0, v1, ...).
+ * As variáveis do programa não aparecem nas instruções: cada leitura de uma variável é trocada pelo
+ * valor da sua definição mais recente, e onde caminhos com definições diferentes se encontram (depois
+ * de um se e no início de um laço) é criada uma instrução phi.
+ *
+ * As constantes também são valores, mas não pertencem a nenhum bloco. Uma variável que ainda não foi
+ * atribuída vale 0, como no quadro zerado da execução.
+ */
+#define IR_OPCODE_LIST(X)  \
+    X(CONSTANT, "const")   \
+    X(ADD, "add")          \
+    X(SUB, "sub")          \
+    X(MUL, "mul")          \
+    X(DIV, "div")          \
+    X(LT, "lt")            \
+    X(LE, "le")            \
+    X(GT, "gt")            \
+    X(GE, "ge")            \
+    X(EQ, "eq")            \
+    X(NE, "ne")            \
+    X(TO_REAL, "to_real")  \
+    X(READ, "read")        \
+    X(WRITE, "write")      \
+    X(PHI, "phi")
+
+#define IR_OPCODE_ENUM(name, text) IR_##name,
+
+typedef enum ir_opcode
+{
+    IR_OPCODE_LIST(IR_OPCODE_ENUM)
+    IR_OPCODE_COUNT
+} ir_opcode;
+
+#undef IR_OPCODE_ENUM
+
+/// @brief Como um bloco termina.
+typedef enum ir_terminator
+{
+    IR_JUMP,   // Salta para successors[0].
+    IR_BRANCH, // Vai para successors[0] se condition for verdadeira, senão para successors[1].
+    IR_RETURN  // Fim do programa.
+} ir_terminator;
+
+/// @brief O que a propagação de constantes sabe sobre um valor.
+typedef enum ir_state
+{
+    IR_UNKNOWN, // Ainda não foi visto num caminho executável.
+    IR_KNOWN,   // Sempre vale constant.
+    IR_VARYING  // Pode valer qualquer coisa.
+} ir_state;
+
+typedef union ir_constant
+{
+    int int_value; // Também os valores lógicos, 0 ou 1.
+    double real_value;
+} ir_constant;
+
+/// @brief Uma instrução, ou uma constante.
+typedef struct ir_value
+{
+    ir_opcode opcode;
+    exp_type type;   // INTEGER, REAL ou BOOLEAN; VOID para write.
+    int block;       // O bloco da instrução; -1 para as constantes.
+    int operands[2]; // Os operandos; numa phi, o valor vindo de cada predecessor do bloco, na mesma ordem.
+    int variable;    // read e phi: o índice da variável na tabela de símbolos.
+    int line;
+    ir_constant constant; // O valor das constantes, e dos valores que a propagação mostrou constantes.
+    ir_state state;
+    int replacement; // O valor que substitui este (phi trivial, constante ou valor redundante); -1 se nenhum.
+} ir_value;
+
+typedef struct ir_block
+{
+    int *predecessors;
+    int predecessor_count;
+    int predecessor_capacity;
+    int *instructions; // As phis vêm primeiro.
+    int instruction_count;
+    int instruction_capacity;
+    ir_terminator terminator;
+    int condition;     // O valor testado por IR_BRANCH.
+    int successors[2];
+    int reachable;     // 0 se a propagação de constantes mostrou que o bloco nunca executa.
+} ir_block;
+
+/// @brief Uma leitura de variável na árvore e o valor SSA que ela lê.
+typedef struct ir_use
+{
+    tree_node *node;
+    int value;
+} ir_use;
+
+/// @brief Um programa na representação intermediária.
+typedef struct ir_program
+{
+    ir_value *values;
+    int value_count;
+    int value_capacity;
+    ir_block *blocks; // O bloco 0 é a entrada.
+    int block_count;
+    int block_capacity;
+    ir_use *uses;
+    int use_count;
+    int use_capacity;
+    const symbol_table *symbols;
+    int constant_values;    // Instruções trocadas por constantes pela propagação.
+    int unreachable_blocks; // Blocos que nunca executam.
+    int redundant_values;   // Instruções trocadas por um valor igual já calculado.
+} ir_program;
+
+/// @brief Traduz a árvore ajustada para a representação intermediária em forma SSA.
+/// @note Os laços e os se viram blocos básicos; && e || viram desvios, preservando a avaliação em curto-circuito.
+///       O custo é linear no tamanho da árvore, exceto pela busca das variáveis atribuídas em cada laço,
+///       proporcional também à profundidade dos laços aninhados.
+/// @param analyzer O analisador, após analyze_semantics() de um programa sem erros.
+/// @param tree A árvore ajustada (não precisa ter passado por resolve_tree()).
+/// @return O programa, ou NULL se não houver memória.
+ir_program *build_ir(semantic_analyzer *analyzer, tree_node *tree);
+
+/// @brief Propagação de constantes esparsa e condicional (Wegman e Zadeck): descobre os valores que são
+///        sempre constantes e os blocos que nunca executam, considerando só os desvios que podem ser tomados.
+/// @note Preenche state e constant de cada valor; o programa não é modificado.
+/// @return 1, ou 0 se não houver memória.
+int propagate_ir_constants(ir_program *program);
+
+/// @brief Aplica o resultado de propagate_ir_constants(): os valores constantes são substituídos por
+///        constantes, os desvios com condição constante viram saltos e os blocos que nunca executam são
+///        desligados do grafo.
+void apply_ir_constants(ir_program *program);
+
+/// @brief Numeração global de valores: percorre a árvore de dominadores e troca cada instrução sem
+///        efeitos colaterais por uma instrução igual, com os mesmos operandos, que a domina.
+/// @return 1, ou 0 se não houver memória.
+int number_ir_values(ir_program *program);
+
+/// @brief Segue as substituições até o valor que ficou no programa.
+int resolve_ir_value(const ir_program *program, int value);
+
+void destroy_ir(ir_program *program);
+
+#endif // IR_H
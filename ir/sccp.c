@@ -0,0 +1,424 @@
+#include <stdlib.h> // calloc(), malloc(), free()
+#include <string.h> // memcmp()
+#include "ir.h"
+
+/*
+ * Os usuários de cada valor ficam numa lista compacta: os de v estão em users[first[v]..first[v+1]).
+ * Um usuário é o índice de uma instrução, ou -(b + 1) para o desvio condicional do bloco b.
+ * Cada aresta do grafo é identificada pela posição do predecessor no bloco de destino:
+ * a aresta predecessors[p] -> b é a aresta edge_base[b] + p.
+ */
+typedef struct sccp
+{
+    ir_program *program;
+    int *first;
+    int *users;
+    int *edge_base;
+    char *edge_executable;
+    char *block_executable;
+    int *flow;        // Os blocos com uma aresta de entrada que acabou de se tornar executável.
+    int flow_count;
+    int *changed;     // Os valores cujo estado mudou e cujos usuários precisam ser reavaliados.
+    int changed_count;
+} sccp;
+
+static int same_constant(exp_type type, ir_constant a, ir_constant b)
+{
+    if (type == REAL)
+        return memcmp(&a.real_value, &b.real_value, sizeof(double)) == 0;
+    return a.int_value == b.int_value;
+}
+
+/// @brief Abaixa o valor na ordem desconhecido -> constante -> variável. Cada valor muda no máximo duas vezes.
+static void lower_state(sccp *state, int index, ir_state new_state, ir_constant constant)
+{
+    ir_value *value = &state->program->values[index];
+    if (value->state == IR_VARYING || new_state == IR_UNKNOWN)
+        return;
+    if (new_state == IR_KNOWN && value->state == IR_KNOWN)
+    {
+        if (same_constant(value->type, value->constant, constant))
+            return;
+        new_state = IR_VARYING;
+    }
+    value->state = new_state;
+    value->constant = constant;
+    state->changed[state->changed_count++] = index;
+}
+
+static double as_real(const ir_value *value)
+{
+    return (value->type == REAL) ? value->constant.real_value : value->constant.int_value;
+}
+
+/// @brief Calcula uma operação entre constantes, com a mesma semântica da execução.
+/// @return 0 se a operação é uma divisão inteira por zero, que não tem valor.
+static int evaluate_operation(ir_opcode opcode, exp_type type, const ir_value *left, const ir_value *right,
+                              ir_constant *result)
+{
+    if (opcode >= IR_LT && opcode <= IR_NE)
+    {
+        double a = as_real(left), b = as_real(right);
+        int truth = (opcode == IR_LT)   ? a < b
+                    : (opcode == IR_LE) ? a <= b
+                    : (opcode == IR_GT) ? a > b
+                    : (opcode == IR_GE) ? a >= b
+                    : (opcode == IR_EQ) ? a == b
+                                        : a != b;
+        result->int_value = truth;
+        return 1;
+    }
+    if (type == REAL)
+    {
+        double a = as_real(left), b = as_real(right);
+        result->real_value = (opcode == IR_ADD)   ? a + b
+                             : (opcode == IR_SUB) ? a - b
+                             : (opcode == IR_MUL) ? a * b
+                                                  : a / b;
+        return 1;
+    }
+
+    // Como na execução: a aritmética inteira é feita sem sinal, truncada em 32 bits
+    unsigned int a = (unsigned int)left->constant.int_value;
+    unsigned int b = (unsigned int)right->constant.int_value;
+    switch (opcode)
+    {
+    case IR_ADD:
+        result->int_value = (int)(a + b);
+        return 1;
+    case IR_SUB:
+        result->int_value = (int)(a - b);
+        return 1;
+    case IR_MUL:
+        result->int_value = (int)(a * b);
+        return 1;
+    default:
+        if (b == 0)
+            return 0;
+        result->int_value = ((int)b == -1) ? (int)(0u - a) : (int)a / (int)b;
+        return 1;
+    }
+}
+
+static void evaluate_value(sccp *state, int index)
+{
+    ir_program *program = state->program;
+    ir_value *value = &program->values[index];
+    ir_constant result;
+    result.real_value = 0;
+
+    switch (value->opcode)
+    {
+    case IR_CONSTANT:
+    case IR_WRITE:
+        return;
+    case IR_READ:
+        lower_state(state, index, IR_VARYING, result);
+        return;
+    case IR_PHI:
+    {
+        // Só contam os operandos que chegam por arestas executáveis
+        const ir_block *block = &program->blocks[value->block];
+        for (int p = 0; p < block->predecessor_count && p < 2; p++)
+        {
+            if (!state->edge_executable[state->edge_base[value->block] + p])
+                continue;
+            const ir_value *operand = &program->values[resolve_ir_value(program, value->operands[p])];
+            lower_state(state, index, operand->state, operand->constant);
+        }
+        return;
+    }
+    case IR_TO_REAL:
+    {
+        const ir_value *operand = &program->values[resolve_ir_value(program, value->operands[0])];
+        if (operand->state == IR_KNOWN)
+            result.real_value = operand->constant.int_value;
+        lower_state(state, index, operand->state, result);
+        return;
+    }
+    default:
+    {
+        const ir_value *left = &program->values[resolve_ir_value(program, value->operands[0])];
+        const ir_value *right = &program->values[resolve_ir_value(program, value->operands[1])];
+        if (left->state == IR_VARYING || right->state == IR_VARYING)
+            lower_state(state, index, IR_VARYING, result);
+        else if (left->state == IR_KNOWN && right->state == IR_KNOWN)
+        {
+            if (evaluate_operation(value->opcode, value->type, left, right, &result))
+                lower_state(state, index, IR_KNOWN, result);
+            else
+                lower_state(state, index, IR_VARYING, result);
+        }
+        return;
+    }
+    }
+}
+
+static void mark_edge(sccp *state, int from, int to)
+{
+    const ir_block *block = &state->program->blocks[to];
+    for (int p = 0; p < block->predecessor_count; p++)
+    {
+        int edge = state->edge_base[to] + p;
+        if (block->predecessors[p] == from && !state->edge_executable[edge])
+        {
+            state->edge_executable[edge] = 1;
+            state->flow[state->flow_count++] = to;
+        }
+    }
+}
+
+static void evaluate_terminator(sccp *state, int b)
+{
+    const ir_block *block = &state->program->blocks[b];
+    if (block->terminator == IR_JUMP)
+        mark_edge(state, b, block->successors[0]);
+    else if (block->terminator == IR_BRANCH)
+    {
+        const ir_value *condition = &state->program->values[resolve_ir_value(state->program, block->condition)];
+        if (condition->state == IR_UNKNOWN)
+            return;
+        if (condition->state == IR_VARYING || condition->constant.int_value != 0)
+            mark_edge(state, b, block->successors[0]);
+        if (condition->state == IR_VARYING || condition->constant.int_value == 0)
+            mark_edge(state, b, block->successors[1]);
+    }
+}
+
+static int is_live(const ir_value *value)
+{
+    return value->block >= 0 && value->replacement < 0;
+}
+
+/// @brief Monta a lista de usuários de cada valor.
+static int build_users(sccp *state)
+{
+    ir_program *program = state->program;
+    int value_count = program->value_count;
+    state->first = (int *)calloc((size_t)value_count + 2, sizeof(int));
+    if (state->first == NULL)
+        return 0;
+
+    // Conta os usuários de cada valor em first[v + 2] e os acumula em first[v + 1], depois preenche
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < value_count; i++)
+        {
+            const ir_value *value = &program->values[i];
+            if (!is_live(value))
+                continue;
+            for (int k = 0; k < 2; k++)
+            {
+                if (value->operands[k] < 0)
+                    continue;
+                int operand = resolve_ir_value(program, value->operands[k]);
+                if (pass == 0)
+                    state->first[operand + 2]++;
+                else
+                    state->users[state->first[operand + 1]++] = i;
+            }
+        }
+        for (int b = 0; b < program->block_count; b++)
+        {
+            const ir_block *block = &program->blocks[b];
+            if (block->terminator != IR_BRANCH)
+                continue;
+            int operand = resolve_ir_value(program, block->condition);
+            if (pass == 0)
+                state->first[operand + 2]++;
+            else
+                state->users[state->first[operand + 1]++] = -(b + 1);
+        }
+        if (pass == 0)
+        {
+            for (int i = 0; i < value_count; i++)
+                state->first[i + 2] += state->first[i + 1];
+            state->users = (int *)malloc(((size_t)state->first[value_count + 1] + 1) * sizeof(int));
+            if (state->users == NULL)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+static void visit_block(sccp *state, int b, int phis_only)
+{
+    ir_program *program = state->program;
+    const ir_block *block = &program->blocks[b];
+    for (int i = 0; i < block->instruction_count; i++)
+    {
+        int index = block->instructions[i];
+        if (phis_only && program->values[index].opcode != IR_PHI)
+            break;
+        if (program->values[index].replacement < 0)
+            evaluate_value(state, index);
+    }
+    if (!phis_only)
+        evaluate_terminator(state, b);
+}
+
+int propagate_ir_constants(ir_program *program)
+{
+    sccp state;
+    memset(&state, 0, sizeof(state));
+    state.program = program;
+
+    int edge_count = 0;
+    state.edge_base = (int *)malloc(((size_t)program->block_count + 1) * sizeof(int));
+    if (state.edge_base != NULL)
+    {
+        for (int b = 0; b < program->block_count; b++)
+        {
+            state.edge_base[b] = edge_count;
+            edge_count += program->blocks[b].predecessor_count;
+        }
+    }
+    state.edge_executable = (char *)calloc((size_t)edge_count + 1, 1);
+    state.block_executable = (char *)calloc((size_t)program->block_count + 1, 1);
+    state.flow = (int *)malloc(((size_t)edge_count + 1) * sizeof(int));
+    state.changed = (int *)malloc(((size_t)program->value_count * 2 + 1) * sizeof(int));
+    int ok = state.edge_base != NULL && state.edge_executable != NULL && state.block_executable != NULL &&
+             state.flow != NULL && state.changed != NULL && build_users(&state);
+
+    if (ok && program->block_count > 0)
+    {
+        state.block_executable[0] = 1;
+        visit_block(&state, 0, 0);
+        int flow_next = 0, changed_next = 0;
+        while (flow_next < state.flow_count || changed_next < state.changed_count)
+        {
+            while (flow_next < state.flow_count)
+            {
+                int b = state.flow[flow_next++];
+                int phis_only = state.block_executable[b];
+                state.block_executable[b] = 1;
+                visit_block(&state, b, phis_only);
+            }
+            while (changed_next < state.changed_count)
+            {
+                int index = state.changed[changed_next++];
+                for (int u = state.first[index]; u < state.first[index + 1]; u++)
+                {
+                    int user = state.users[u];
+                    if (user < 0)
+                    {
+                        if (state.block_executable[-user - 1])
+                            evaluate_terminator(&state, -user - 1);
+                    }
+                    else if (state.block_executable[program->values[user].block])
+                        evaluate_value(&state, user);
+                }
+            }
+        }
+        for (int b = 0; b < program->block_count; b++)
+            program->blocks[b].reachable = state.block_executable[b];
+    }
+
+    free(state.first);
+    free(state.users);
+    free(state.edge_base);
+    free(state.edge_executable);
+    free(state.block_executable);
+    free(state.flow);
+    free(state.changed);
+    return ok;
+}
+
+/// @brief Indica se a aresta from -> to ainda existe depois que os desvios constantes viraram saltos.
+static int keeps_edge(const ir_program *program, int from, int to)
+{
+    const ir_block *block = &program->blocks[from];
+    if (!block->reachable)
+        return 0;
+    if (block->terminator == IR_JUMP)
+        return block->successors[0] == to;
+    return block->terminator == IR_BRANCH && (block->successors[0] == to || block->successors[1] == to);
+}
+
+static int new_constant(ir_program *program, const ir_value *model)
+{
+    if (program->value_count == program->value_capacity)
+    {
+        int grown_capacity = program->value_capacity * 2 + 8;
+        ir_value *grown = (ir_value *)realloc(program->values, (size_t)grown_capacity * sizeof(ir_value));
+        if (grown == NULL)
+            return -1;
+        program->values = grown;
+        program->value_capacity = grown_capacity;
+    }
+    ir_value *constant = &program->values[program->value_count];
+    *constant = *model;
+    constant->opcode = IR_CONSTANT;
+    constant->block = -1;
+    constant->operands[0] = constant->operands[1] = -1;
+    constant->variable = -1;
+    constant->replacement = -1;
+    return program->value_count++;
+}
+
+void apply_ir_constants(ir_program *program)
+{
+    // Os desvios com condição constante viram saltos
+    for (int b = 0; b < program->block_count; b++)
+    {
+        ir_block *block = &program->blocks[b];
+        if (!block->reachable)
+        {
+            program->unreachable_blocks++;
+            continue;
+        }
+        if (block->terminator != IR_BRANCH)
+            continue;
+        const ir_value *condition = &program->values[resolve_ir_value(program, block->condition)];
+        if (condition->state == IR_KNOWN)
+        {
+            block->terminator = IR_JUMP;
+            block->successors[0] = block->successors[condition->constant.int_value ? 0 : 1];
+            block->successors[1] = -1;
+        }
+    }
+
+    // As instruções constantes viram constantes
+    int value_count = program->value_count;
+    for (int i = 0; i < value_count; i++)
+    {
+        ir_value model = program->values[i];
+        if (!is_live(&model) || model.state != IR_KNOWN || !program->blocks[model.block].reachable)
+            continue;
+        int constant = new_constant(program, &model);
+        if (constant < 0)
+            break;
+        program->values[i].replacement = constant;
+        program->constant_values++;
+    }
+
+    // Restam, em cada bloco, só os predecessores ligados por arestas executáveis
+    for (int b = 0; b < program->block_count; b++)
+    {
+        ir_block *block = &program->blocks[b];
+        int kept[2] = {0, 0};
+        int count = 0;
+        for (int p = 0; p < block->predecessor_count; p++)
+        {
+            if (!keeps_edge(program, block->predecessors[p], b))
+                continue;
+            if (p < 2)
+                kept[count] = p;
+            block->predecessors[count++] = block->predecessors[p];
+        }
+        if (count == block->predecessor_count)
+            continue;
+        block->predecessor_count = count;
+
+        for (int i = 0; i < block->instruction_count; i++)
+        {
+            ir_value *phi = &program->values[block->instructions[i]];
+            if (phi->opcode != IR_PHI)
+                break;
+            if (phi->replacement >= 0)
+                continue;
+            if (count == 1)
+                phi->replacement = resolve_ir_value(program, phi->operands[kept[0]]);
+        }
+    }
+}
@@ -0,0 +1,964 @@
+#include <stdint.h>   // uint8_t, uint32_t, uint64_t, uintptr_t
+#include <stdio.h>    // snprintf()
+#include <stdlib.h>   // malloc(), calloc(), realloc(), free()
+#include <string.h>   // memcpy()
+#include <sys/mman.h> // mmap(), mprotect(), munmap()
+#include <unistd.h>   // sysconf()
+#include "jit.h"
+#include "../optimizer/optimizer.h"
+
+/// @brief O que o código gerado recebe, além do quadro: a entrada e a saída e onde guardar o erro.
+typedef struct jit_context
+{
+    program_io *io;
+    execution_error *error;
+    struct timespec entered; // O instante em que o código gerado começou a executar.
+} jit_context;
+
+/// @brief A assinatura do código gerado: retorna 1 se o programa terminou normalmente.
+typedef int (*jit_entry)(unsigned char *frame, jit_context *context);
+
+// Funções chamadas pelo código gerado. O código recebe os seus endereços como constantes.
+
+static void jit_enter(jit_context *context)
+{
+    clock_gettime(CLOCK_MONOTONIC, &context->entered);
+}
+
+static void jit_fail(jit_context *context, int line, const char *message)
+{
+    context->error->line = line;
+    snprintf(context->error->message, sizeof(context->error->message), "%s", message);
+}
+
+static int jit_read_integer(jit_context *context, int line, unsigned char *destination)
+{
+    int value;
+    if (!read_integer(context->io, &value))
+    {
+        jit_fail(context, line, "entrada invalida ou encerrada");
+        return 0;
+    }
+    memcpy(destination, &value, sizeof(value));
+    return 1;
+}
+
+static int jit_read_real(jit_context *context, int line, unsigned char *destination)
+{
+    double value;
+    if (!read_real(context->io, &value))
+    {
+        jit_fail(context, line, "entrada invalida ou encerrada");
+        return 0;
+    }
+    memcpy(destination, &value, sizeof(value));
+    return 1;
+}
+
+static void jit_write_integer(jit_context *context, int value)
+{
+    write_integer(context->io, value);
+}
+
+static void jit_write_real(jit_context *context, double value)
+{
+    write_real(context->io, value);
+}
+
+static void jit_division_by_zero(jit_context *context, int line)
+{
+    jit_fail(context, line, "divisao por zero");
+}
+
+// Números dos registradores na codificação das instruções
+enum
+{
+    EAX = 0,
+    ECX = 1,
+    EDX = 2,
+    XMM0 = 0,
+    XMM1 = 1
+};
+
+/// @brief Um salto cujo deslocamento é preenchido quando todos os rótulos são conhecidos.
+typedef struct fixup
+{
+    size_t offset; // Onde fica o deslocamento de 32 bits.
+    int label;
+} fixup;
+
+/// @brief Um desvio para o erro de divisão por zero, emitido depois do corpo do programa.
+typedef struct division_stub
+{
+    int label;
+    int line;
+} division_stub;
+
+/// @brief O estado da tradução de uma árvore para código de máquina.
+typedef struct jit_compiler
+{
+    uint8_t *buffer;
+    size_t length;
+    size_t capacity;
+    long *labels; // A posição de cada rótulo, ou -1 enquanto não é conhecida.
+    int label_count;
+    int label_capacity;
+    fixup *fixups;
+    int fixup_count;
+    int fixup_capacity;
+    division_stub *stubs;
+    int stub_count;
+    int stub_capacity;
+    int division_label; // Restaura a pilha e registra a divisão por zero da linha em esi.
+    int fail_label;     // Encerra o programa com o erro já registrado.
+    int failed;         // 1 se faltou memória.
+} jit_compiler;
+
+static int reserve(jit_compiler *c, void **items, int count, int *capacity, size_t item_size)
+{
+    if (count < *capacity)
+        return 1;
+    int new_capacity = (*capacity == 0) ? 64 : *capacity * 2;
+    void *grown = realloc(*items, (size_t)new_capacity * item_size);
+    if (grown == NULL)
+    {
+        c->failed = 1;
+        return 0;
+    }
+    *items = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+static void emit_bytes(jit_compiler *c, const uint8_t *bytes, size_t count)
+{
+    if (c->length + count > c->capacity)
+    {
+        size_t capacity = (c->capacity == 0) ? 4096 : c->capacity * 2;
+        while (capacity < c->length + count)
+            capacity *= 2;
+        uint8_t *buffer = (uint8_t *)realloc(c->buffer, capacity);
+        if (buffer == NULL)
+        {
+            c->failed = 1;
+            return;
+        }
+        c->buffer = buffer;
+        c->capacity = capacity;
+    }
+    memcpy(c->buffer + c->length, bytes, count);
+    c->length += count;
+}
+
+#define EMIT(c, ...)                                     \
+    do                                                   \
+    {                                                    \
+        static const uint8_t bytes_[] = {__VA_ARGS__};   \
+        emit_bytes((c), bytes_, sizeof(bytes_));         \
+    } while (0)
+
+static void emit_byte(jit_compiler *c, uint8_t byte)
+{
+    emit_bytes(c, &byte, 1);
+}
+
+static void emit_u32(jit_compiler *c, uint32_t value)
+{
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    emit_bytes(c, bytes, 4);
+}
+
+static void emit_u64(jit_compiler *c, uint64_t value)
+{
+    emit_u32(c, (uint32_t)value);
+    emit_u32(c, (uint32_t)(value >> 32));
+}
+
+/// @brief O operando de memória [rbx + address]: a variável no quadro, cujo início fica em rbx.
+static void emit_frame_operand(jit_compiler *c, int reg, int address)
+{
+    if (address >= -128 && address <= 127)
+    {
+        emit_byte(c, (uint8_t)(0x40 | (reg << 3) | 3));
+        emit_byte(c, (uint8_t)address);
+    }
+    else
+    {
+        emit_byte(c, (uint8_t)(0x80 | (reg << 3) | 3));
+        emit_u32(c, (uint32_t)address);
+    }
+}
+
+/// @brief Uma instrução com um operando no quadro: os bytes do código e depois o operando.
+static void emit_frame_instruction(jit_compiler *c, const uint8_t *opcode, size_t count, int reg, int address)
+{
+    emit_bytes(c, opcode, count);
+    emit_frame_operand(c, reg, address);
+}
+
+static int new_label(jit_compiler *c)
+{
+    if (!reserve(c, (void **)&c->labels, c->label_count, &c->label_capacity, sizeof(long)))
+        return 0;
+    c->labels[c->label_count] = -1;
+    return c->label_count++;
+}
+
+static void bind_label(jit_compiler *c, int label)
+{
+    if (!c->failed)
+        c->labels[label] = (long)c->length;
+}
+
+/// @brief Um salto de 32 bits para um rótulo, com os bytes de código indicados.
+static void emit_jump(jit_compiler *c, const uint8_t *opcode, size_t count, int label)
+{
+    emit_bytes(c, opcode, count);
+    if (!reserve(c, (void **)&c->fixups, c->fixup_count, &c->fixup_capacity, sizeof(fixup)))
+        return;
+    c->fixups[c->fixup_count].offset = c->length;
+    c->fixups[c->fixup_count].label = label;
+    c->fixup_count++;
+    emit_u32(c, 0);
+}
+
+static void jump(jit_compiler *c, int label)
+{
+    static const uint8_t jmp[] = {0xE9};
+    emit_jump(c, jmp, 1, label);
+}
+
+/// @brief Salto condicional: condition é o segundo byte de 0F 8x (0x84 je, 0x8C jl...).
+static void jump_if(jit_compiler *c, uint8_t condition, int label)
+{
+    uint8_t jcc[] = {0x0F, condition};
+    emit_jump(c, jcc, 2, label);
+}
+
+/// @brief mov rax, function; call rax
+static void emit_call(jit_compiler *c, uintptr_t function)
+{
+    EMIT(c, 0x48, 0xB8);
+    emit_u64(c, (uint64_t)function);
+    EMIT(c, 0xFF, 0xD0);
+}
+
+/// @brief mov rax, bits; movq xmm<reg>, rax
+static void load_real_constant(jit_compiler *c, int reg, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (bits == 0)
+    {
+        EMIT(c, 0x66, 0x0F, 0xEF); // pxor
+        emit_byte(c, (uint8_t)(0xC0 | (reg << 3) | reg));
+        return;
+    }
+    EMIT(c, 0x48, 0xB8);
+    emit_u64(c, bits);
+    EMIT(c, 0x66, 0x48, 0x0F, 0x6E);
+    emit_byte(c, (uint8_t)(0xC0 | (reg << 3)));
+}
+
+static int is_integer_constant(const tree_node *node)
+{
+    return node->kind.exp == CONSTANT_EXPRESSION && node->type == INTEGER;
+}
+
+static int is_integer_variable(const tree_node *node)
+{
+    return node->kind.exp == IDENTIFIER_EXPRESSION && node->type == INTEGER;
+}
+
+static int is_real_variable(const tree_node *node)
+{
+    return node->kind.exp == IDENTIFIER_EXPRESSION && node->type == REAL;
+}
+
+static int is_real_constant(const tree_node *node)
+{
+    return node->kind.exp == CONSTANT_EXPRESSION && node->type == REAL;
+}
+
+/// @brief A posição de uma comparação na ordem LT, LE, GT, GE, EQ, NE.
+static int comparison_index(token_type op)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return 0;
+    case T_MENOR_IGUAL:
+        return 1;
+    case T_MAIOR:
+        return 2;
+    case T_MAIOR_IGUAL:
+        return 3;
+    case T_IGUAL:
+        return 4;
+    case T_DIFERENTE:
+        return 5;
+    default:
+        return -1;
+    }
+}
+
+static void integer_expression(jit_compiler *c, const tree_node *node);
+static void real_expression(jit_compiler *c, const tree_node *node);
+static void branch(jit_compiler *c, const tree_node *node, int jump_when, int target);
+
+/// @brief Calcula right em ecx preservando eax: push rax; <right>; mov ecx, eax; pop rax
+static void integer_right_operand(jit_compiler *c, const tree_node *right)
+{
+    static const uint8_t mov_ecx[] = {0x8B};
+    if (is_integer_constant(right))
+    {
+        emit_byte(c, 0xB9); // mov ecx, imm32
+        emit_u32(c, (uint32_t)right->attribute.int_value);
+    }
+    else if (is_integer_variable(right))
+        emit_frame_instruction(c, mov_ecx, 1, ECX, right->memory_address);
+    else
+    {
+        EMIT(c, 0x50);
+        integer_expression(c, right);
+        EMIT(c, 0x89, 0xC1, 0x58);
+    }
+}
+
+/// @brief Divide eax por right com as regras do interpretador: divisão por zero é um erro de execução
+///        e x / -1 é -x (idiv falharia com o menor inteiro). A divisão por uma constante vira
+///        deslocamentos (potências de 2) ou uma multiplicação pela parte alta do produto.
+static void integer_division(jit_compiler *c, const tree_node *right, int line)
+{
+    if (!reserve(c, (void **)&c->stubs, c->stub_count, &c->stub_capacity, sizeof(division_stub)))
+        return;
+    division_stub *stub = &c->stubs[c->stub_count];
+
+    if (is_integer_constant(right) && right->attribute.int_value != 0)
+    {
+        int divisor = right->attribute.int_value;
+        unsigned int magnitude = (divisor < 0) ? 0u - (unsigned int)divisor : (unsigned int)divisor;
+        int exponent = power_of_two_exponent(magnitude);
+        division_magic_number magic;
+        if (divisor == -1)
+            EMIT(c, 0xF7, 0xD8); // neg eax
+        else if (exponent > 0 && exponent < 31)
+        {
+            // Soma 2^k - 1 aos dividendos negativos, para truncar em direção a zero
+            EMIT(c, 0x89, 0xC1, 0xC1, 0xF9, 0x1F); // mov ecx, eax; sar ecx, 31
+            EMIT(c, 0xC1, 0xE9); // shr ecx, 32 - k
+            emit_byte(c, (uint8_t)(32 - exponent));
+            EMIT(c, 0x01, 0xC8, 0xC1, 0xF8); // add eax, ecx; sar eax, k
+            emit_byte(c, (uint8_t)exponent);
+            if (divisor < 0)
+                EMIT(c, 0xF7, 0xD8); // neg eax
+        }
+        else if (division_magic(divisor, &magic))
+        {
+            EMIT(c, 0x89, 0xC1, 0xB8); // mov ecx, eax; mov eax, multiplier
+            emit_u32(c, (uint32_t)magic.multiplier);
+            EMIT(c, 0xF7, 0xE9); // imul ecx: edx = parte alta
+            if (magic.correction > 0)
+                EMIT(c, 0x01, 0xCA); // add edx, ecx
+            else if (magic.correction < 0)
+                EMIT(c, 0x29, 0xCA); // sub edx, ecx
+            if (magic.shift > 0)
+            {
+                EMIT(c, 0xC1, 0xFA); // sar edx, shift
+                emit_byte(c, (uint8_t)magic.shift);
+            }
+            EMIT(c, 0x89, 0xD0, 0xC1, 0xE8, 0x1F); // mov eax, edx; shr eax, 31
+            EMIT(c, 0x01, 0xD0); // add eax, edx
+        }
+        else
+        {
+            integer_right_operand(c, right);
+            EMIT(c, 0x99, 0xF7, 0xF9); // cdq; idiv ecx
+        }
+        return;
+    }
+
+    stub->label = new_label(c);
+    stub->line = line;
+    c->stub_count++;
+    int label = stub->label;
+    if (is_integer_constant(right))
+    {
+        jump(c, label);
+        return;
+    }
+
+    int negate = new_label(c), done = new_label(c);
+    integer_right_operand(c, right);
+    EMIT(c, 0x85, 0xC9); // test ecx, ecx
+    jump_if(c, 0x84, label);
+    EMIT(c, 0x83, 0xF9, 0xFF); // cmp ecx, -1
+    jump_if(c, 0x84, negate);
+    EMIT(c, 0x99, 0xF7, 0xF9); // cdq; idiv ecx
+    jump(c, done);
+    bind_label(c, negate);
+    EMIT(c, 0xF7, 0xD8); // neg eax
+    bind_label(c, done);
+}
+
+/// @brief Deixa o valor de uma expressão inteira (ou lógica, como 0 ou 1) em eax.
+static void integer_expression(jit_compiler *c, const tree_node *node)
+{
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        if (node->attribute.int_value == 0)
+            EMIT(c, 0x31, 0xC0); // xor eax, eax
+        else
+        {
+            emit_byte(c, 0xB8); // mov eax, imm32
+            emit_u32(c, (uint32_t)node->attribute.int_value);
+        }
+        return;
+    case IDENTIFIER_EXPRESSION:
+    {
+        static const uint8_t mov[] = {0x8B};
+        emit_frame_instruction(c, mov, 1, EAX, node->memory_address);
+        return;
+    }
+    case CONVERSION_EXPRESSION:
+        integer_expression(c, node->child[0]);
+        return;
+    case OPERATION_EXPRESSION:
+        break;
+    }
+
+    if (node->type == BOOLEAN)
+    {
+        int is_false = new_label(c), end = new_label(c);
+        branch(c, node, 0, is_false);
+        emit_byte(c, 0xB8);
+        emit_u32(c, 1);
+        jump(c, end);
+        bind_label(c, is_false);
+        EMIT(c, 0x31, 0xC0);
+        bind_label(c, end);
+        return;
+    }
+
+    const tree_node *right = node->child[1];
+    integer_expression(c, node->child[0]);
+    if (node->attribute.op == T_DIV)
+    {
+        integer_division(c, right, node->line_number);
+        return;
+    }
+
+    // Para cada operação: com imediato, com operando no quadro e com ecx
+    static const uint8_t add_memory[] = {0x03}, sub_memory[] = {0x2B}, imul_memory[] = {0x0F, 0xAF};
+    if (is_integer_constant(right))
+    {
+        uint32_t value = (uint32_t)right->attribute.int_value;
+        int exponent = power_of_two_exponent(value);
+        if (node->attribute.op == T_MULT && exponent > 0)
+        {
+            EMIT(c, 0xC1, 0xE0); // shl eax, k
+            emit_byte(c, (uint8_t)exponent);
+            return;
+        }
+        if (node->attribute.op == T_SOMA)
+            emit_byte(c, 0x05);
+        else if (node->attribute.op == T_SUB)
+            emit_byte(c, 0x2D);
+        else
+            EMIT(c, 0x69, 0xC0);
+        emit_u32(c, value);
+    }
+    else if (is_integer_variable(right))
+    {
+        if (node->attribute.op == T_SOMA)
+            emit_frame_instruction(c, add_memory, 1, EAX, right->memory_address);
+        else if (node->attribute.op == T_SUB)
+            emit_frame_instruction(c, sub_memory, 1, EAX, right->memory_address);
+        else
+            emit_frame_instruction(c, imul_memory, 2, EAX, right->memory_address);
+    }
+    else
+    {
+        integer_right_operand(c, right);
+        if (node->attribute.op == T_SOMA)
+            EMIT(c, 0x01, 0xC8);
+        else if (node->attribute.op == T_SUB)
+            EMIT(c, 0x29, 0xC8);
+        else
+            EMIT(c, 0x0F, 0xAF, 0xC1);
+    }
+}
+
+/// @brief Deixa o valor de uma expressão em xmm0, convertendo as expressões inteiras.
+static void real_expression(jit_compiler *c, const tree_node *node)
+{
+    if (node->type == INTEGER || node->kind.exp == CONVERSION_EXPRESSION)
+    {
+        const tree_node *value = (node->kind.exp == CONVERSION_EXPRESSION) ? node->child[0] : node;
+        if (is_integer_constant(value))
+        {
+            load_real_constant(c, XMM0, (double)value->attribute.int_value);
+            return;
+        }
+        if (is_integer_variable(value))
+        {
+            static const uint8_t cvtsi2sd[] = {0xF2, 0x0F, 0x2A};
+            EMIT(c, 0x66, 0x0F, 0xEF, 0xC0); // pxor xmm0, xmm0
+            emit_frame_instruction(c, cvtsi2sd, 3, XMM0, value->memory_address);
+            return;
+        }
+        integer_expression(c, value);
+        EMIT(c, 0x66, 0x0F, 0xEF, 0xC0, 0xF2, 0x0F, 0x2A, 0xC0); // pxor xmm0, xmm0; cvtsi2sd xmm0, eax
+        return;
+    }
+
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        load_real_constant(c, XMM0, node->attribute.real_value);
+        return;
+    case IDENTIFIER_EXPRESSION:
+    {
+        static const uint8_t movsd[] = {0xF2, 0x0F, 0x10};
+        emit_frame_instruction(c, movsd, 3, XMM0, node->memory_address);
+        return;
+    }
+    default:
+        break;
+    }
+
+    uint8_t operation;
+    switch (node->attribute.op)
+    {
+    case T_SOMA:
+        operation = 0x58;
+        break;
+    case T_SUB:
+        operation = 0x5C;
+        break;
+    case T_MULT:
+        operation = 0x59;
+        break;
+    default:
+        operation = 0x5E;
+        break;
+    }
+
+    const tree_node *right = node->child[1];
+    real_expression(c, node->child[0]);
+    if (is_real_variable(right))
+    {
+        uint8_t instruction[] = {0xF2, 0x0F, operation};
+        emit_frame_instruction(c, instruction, 3, XMM0, right->memory_address);
+        return;
+    }
+    if (is_real_constant(right))
+        load_real_constant(c, XMM1, right->attribute.real_value);
+    else
+    {
+        EMIT(c, 0x48, 0x83, 0xEC, 0x08, 0xF2, 0x0F, 0x11, 0x04, 0x24); // sub rsp, 8; movsd [rsp], xmm0
+        real_expression(c, right);
+        EMIT(c, 0x66, 0x0F, 0x28, 0xC8);                               // movapd xmm1, xmm0
+        EMIT(c, 0xF2, 0x0F, 0x10, 0x04, 0x24, 0x48, 0x83, 0xC4, 0x08); // movsd xmm0, [rsp]; add rsp, 8
+    }
+    uint8_t instruction[] = {0xF2, 0x0F, operation, 0xC1};
+    emit_bytes(c, instruction, sizeof(instruction));
+}
+
+/// @brief Emite o salto depois de ucomisd: se algum valor é NaN, PF é ligado e toda comparação,
+///        exceto !=, é falsa.
+static void real_jump(jit_compiler *c, int index, int jump_when, int target)
+{
+    // Para cada comparação: o salto com o resultado ordenado e se PF deve desviar (1), pular (2) ou nada (0)
+    static const uint8_t when_true[] = {0x82, 0x86, 0x87, 0x83, 0x84, 0x85};
+    static const int parity_true[] = {2, 2, 0, 0, 2, 1};
+    static const uint8_t when_false[] = {0x83, 0x87, 0x86, 0x82, 0x85, 0x84};
+    static const int parity_false[] = {1, 1, 0, 0, 1, 2};
+
+    uint8_t condition = jump_when ? when_true[index] : when_false[index];
+    int parity = jump_when ? parity_true[index] : parity_false[index];
+    if (parity == 1)
+    {
+        jump_if(c, 0x8A, target);
+        jump_if(c, condition, target);
+    }
+    else if (parity == 2)
+    {
+        int skip = new_label(c);
+        jump_if(c, 0x8A, skip);
+        jump_if(c, condition, target);
+        bind_label(c, skip);
+    }
+    else
+        jump_if(c, condition, target);
+}
+
+/// @brief Emite um salto para target quando a condição tiver o valor jump_when.
+/// @note e/ou são compilados em curto-circuito, como na máquina virtual.
+static void branch(jit_compiler *c, const tree_node *node, int jump_when, int target)
+{
+    // Condição avaliada pelo compilador: o salto é incondicional ou desaparece
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+    {
+        if ((node->attribute.int_value != 0) == jump_when)
+            jump(c, target);
+        return;
+    }
+
+    if (node->kind.exp == OPERATION_EXPRESSION && (node->attribute.op == T_E || node->attribute.op == T_OU))
+    {
+        int shortcut = (node->attribute.op == T_OU);
+        if (jump_when == shortcut)
+        {
+            branch(c, node->child[0], jump_when, target);
+            branch(c, node->child[1], jump_when, target);
+        }
+        else
+        {
+            int skip = new_label(c);
+            branch(c, node->child[0], shortcut, skip);
+            branch(c, node->child[1], jump_when, target);
+            bind_label(c, skip);
+        }
+        return;
+    }
+
+    int index = (node->kind.exp == OPERATION_EXPRESSION) ? comparison_index(node->attribute.op) : -1;
+    if (index < 0)
+    {
+        integer_expression(c, node);
+        EMIT(c, 0x85, 0xC0); // test eax, eax
+        jump_if(c, jump_when ? 0x85 : 0x84, target);
+        return;
+    }
+
+    const tree_node *left = node->child[0];
+    const tree_node *right = node->child[1];
+
+    if (left->type == INTEGER && right->type == INTEGER)
+    {
+        static const uint8_t when_true[] = {0x8C, 0x8E, 0x8F, 0x8D, 0x84, 0x85};
+        static const uint8_t when_false[] = {0x8D, 0x8F, 0x8E, 0x8C, 0x85, 0x84};
+
+        if (is_integer_constant(left) && is_integer_variable(right))
+        {
+            static const int mirrored[] = {2, 3, 0, 1, 4, 5};
+            const tree_node *swap = left;
+            left = right;
+            right = swap;
+            index = mirrored[index];
+        }
+
+        if (is_integer_variable(left) && is_integer_constant(right))
+        {
+            static const uint8_t cmp_immediate[] = {0x81};
+            emit_frame_instruction(c, cmp_immediate, 1, 7, left->memory_address);
+            emit_u32(c, (uint32_t)right->attribute.int_value);
+        }
+        else
+        {
+            integer_expression(c, left);
+            if (is_integer_constant(right))
+            {
+                emit_byte(c, 0x3D); // cmp eax, imm32
+                emit_u32(c, (uint32_t)right->attribute.int_value);
+            }
+            else if (is_integer_variable(right))
+            {
+                static const uint8_t cmp_memory[] = {0x3B};
+                emit_frame_instruction(c, cmp_memory, 1, EAX, right->memory_address);
+            }
+            else
+            {
+                integer_right_operand(c, right);
+                EMIT(c, 0x39, 0xC8); // cmp eax, ecx
+            }
+        }
+        jump_if(c, jump_when ? when_true[index] : when_false[index], target);
+        return;
+    }
+
+    real_expression(c, left);
+    if (is_real_variable(right))
+    {
+        static const uint8_t ucomisd[] = {0x66, 0x0F, 0x2E};
+        emit_frame_instruction(c, ucomisd, 3, XMM0, right->memory_address);
+    }
+    else
+    {
+        if (is_real_constant(right))
+            load_real_constant(c, XMM1, right->attribute.real_value);
+        else
+        {
+            EMIT(c, 0x48, 0x83, 0xEC, 0x08, 0xF2, 0x0F, 0x11, 0x04, 0x24);
+            real_expression(c, right);
+            EMIT(c, 0x66, 0x0F, 0x28, 0xC8);
+            EMIT(c, 0xF2, 0x0F, 0x10, 0x04, 0x24, 0x48, 0x83, 0xC4, 0x08);
+        }
+        EMIT(c, 0x66, 0x0F, 0x2E, 0xC1); // ucomisd xmm0, xmm1
+    }
+    real_jump(c, index, jump_when, target);
+}
+
+/// @brief x = x + k e x = x - k viram uma única instrução sobre o quadro.
+static int increment(jit_compiler *c, const tree_node *node)
+{
+    const tree_node *value = node->child[0];
+    if (node->type != INTEGER || value->kind.exp != OPERATION_EXPRESSION ||
+        (value->attribute.op != T_SOMA && value->attribute.op != T_SUB))
+        return 0;
+
+    const tree_node *left = value->child[0];
+    const tree_node *right = value->child[1];
+    if (value->attribute.op == T_SOMA && is_integer_constant(left))
+    {
+        left = value->child[1];
+        right = value->child[0];
+    }
+    if (!is_integer_variable(left) || left->memory_address != node->memory_address || !is_integer_constant(right))
+        return 0;
+
+    static const uint8_t add_immediate[] = {0x81};
+    emit_frame_instruction(c, add_immediate, 1, value->attribute.op == T_SOMA ? 0 : 5, node->memory_address);
+    emit_u32(c, (uint32_t)right->attribute.int_value);
+    return 1;
+}
+
+static void statements(jit_compiler *c, const tree_node *node)
+{
+    static const uint8_t store_integer[] = {0x89}, store_real[] = {0xF2, 0x0F, 0x11};
+    static const uint8_t lea_rdx[] = {0x48, 0x8D};
+
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind != STATEMENT_KIND)
+            continue;
+
+        switch (node->kind.stmt)
+        {
+        case ASSIGNMENT_STATEMENT:
+            if (node->type == REAL)
+            {
+                real_expression(c, node->child[0]);
+                emit_frame_instruction(c, store_real, 3, XMM0, node->memory_address);
+            }
+            else if (is_integer_constant(node->child[0]))
+            {
+                static const uint8_t mov_immediate[] = {0xC7};
+                emit_frame_instruction(c, mov_immediate, 1, 0, node->memory_address);
+                emit_u32(c, (uint32_t)node->child[0]->attribute.int_value);
+            }
+            else if (!increment(c, node))
+            {
+                integer_expression(c, node->child[0]);
+                emit_frame_instruction(c, store_integer, 1, EAX, node->memory_address);
+            }
+            break;
+        case READ_STATEMENT:
+            EMIT(c, 0x4C, 0x89, 0xE7); // mov rdi, r12
+            emit_byte(c, 0xBE);        // mov esi, line
+            emit_u32(c, (uint32_t)node->line_number);
+            emit_frame_instruction(c, lea_rdx, 2, EDX, node->memory_address);
+            emit_call(c, node->type == REAL ? (uintptr_t)jit_read_real : (uintptr_t)jit_read_integer);
+            EMIT(c, 0x85, 0xC0); // test eax, eax
+            jump_if(c, 0x84, c->fail_label);
+            break;
+        case WRITE_STATEMENT:
+            if (node->child[0]->type == REAL)
+            {
+                real_expression(c, node->child[0]);
+                EMIT(c, 0x4C, 0x89, 0xE7);
+                emit_call(c, (uintptr_t)jit_write_real);
+            }
+            else
+            {
+                integer_expression(c, node->child[0]);
+                EMIT(c, 0x89, 0xC6, 0x4C, 0x89, 0xE7); // mov esi, eax; mov rdi, r12
+                emit_call(c, (uintptr_t)jit_write_integer);
+            }
+            break;
+        case IF_STATEMENT:
+        {
+            int otherwise = new_label(c), end = new_label(c);
+            branch(c, node->child[0], 0, otherwise);
+            statements(c, node->child[1]);
+            if (node->child[2] != NULL)
+                jump(c, end);
+            bind_label(c, otherwise);
+            statements(c, node->child[2]);
+            bind_label(c, end);
+            break;
+        }
+        case WHILE_STATEMENT:
+        {
+            // A condição fica depois do corpo: cada volta do laço executa um único salto
+            int condition = new_label(c), body = new_label(c);
+            jump(c, condition);
+            bind_label(c, body);
+            statements(c, node->child[1]);
+            bind_label(c, condition);
+            branch(c, node->child[0], 1, body);
+            break;
+        }
+        case REPEAT_STATEMENT:
+        {
+            int body = new_label(c);
+            bind_label(c, body);
+            statements(c, node->child[0]);
+            branch(c, node->child[1], 0, body);
+            break;
+        }
+        case DECLARATION_STATEMENT:
+            break;
+        }
+    }
+}
+
+/// @brief O programa inteiro: rbx aponta para o quadro e r12 para o contexto durante toda a execução.
+static void translate(jit_compiler *c, tree_node *tree)
+{
+    int epilogue = new_label(c);
+    c->division_label = new_label(c);
+    c->fail_label = new_label(c);
+
+    EMIT(c, 0x55, 0x48, 0x89, 0xE5); // push rbp; mov rbp, rsp
+    EMIT(c, 0x53, 0x41, 0x54);       // push rbx; push r12 (a pilha fica alinhada em 16 bytes)
+    EMIT(c, 0x48, 0x89, 0xFB);       // mov rbx, rdi
+    EMIT(c, 0x49, 0x89, 0xF4);       // mov r12, rsi
+    EMIT(c, 0x4C, 0x89, 0xE7);       // mov rdi, r12
+    emit_call(c, (uintptr_t)jit_enter);
+
+    statements(c, tree);
+
+    emit_byte(c, 0xB8); // mov eax, 1
+    emit_u32(c, 1);
+    bind_label(c, epilogue);
+    EMIT(c, 0x48, 0x8D, 0x65, 0xF0); // lea rsp, [rbp-16]: descarta o que as expressões deixaram na pilha
+    EMIT(c, 0x41, 0x5C, 0x5B, 0x5D, 0xC3); // pop r12; pop rbx; pop rbp; ret
+
+    for (int i = 0; i < c->stub_count; i++)
+    {
+        bind_label(c, c->stubs[i].label);
+        emit_byte(c, 0xBE); // mov esi, line
+        emit_u32(c, (uint32_t)c->stubs[i].line);
+        jump(c, c->division_label);
+    }
+
+    bind_label(c, c->division_label);
+    EMIT(c, 0x48, 0x8D, 0x65, 0xF0, 0x4C, 0x89, 0xE7); // lea rsp, [rbp-16]; mov rdi, r12
+    emit_call(c, (uintptr_t)jit_division_by_zero);
+    bind_label(c, c->fail_label);
+    EMIT(c, 0x31, 0xC0); // xor eax, eax
+    jump(c, epilogue);
+
+    for (int i = 0; i < c->fixup_count && !c->failed; i++)
+    {
+        long displacement = c->labels[c->fixups[i].label] - (long)(c->fixups[i].offset + 4);
+        uint32_t value = (uint32_t)(int32_t)displacement;
+        memcpy(c->buffer + c->fixups[i].offset, &value, sizeof(value));
+    }
+}
+
+int jit_supported(void)
+{
+#if defined(__x86_64__) && !defined(_WIN32)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static double seconds_between(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+jit_program *compile_jit(tree_node *tree, int frame_size)
+{
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    if (!jit_supported())
+        return NULL;
+
+    jit_compiler c;
+    memset(&c, 0, sizeof(c));
+    translate(&c, tree);
+
+    jit_program *program = c.failed ? NULL : (jit_program *)calloc(1, sizeof(jit_program));
+    if (program != NULL)
+    {
+        // A região é escrita e só depois passa a ser executável: nunca é as duas coisas ao mesmo tempo
+        long page = sysconf(_SC_PAGESIZE);
+        size_t page_size = (page > 0) ? (size_t)page : 4096;
+        program->mapped_size = (c.length + page_size - 1) / page_size * page_size;
+        void *memory = mmap(NULL, program->mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            free(program);
+            program = NULL;
+        }
+        else
+        {
+            memcpy(memory, c.buffer, c.length);
+            if (mprotect(memory, program->mapped_size, PROT_READ | PROT_EXEC) != 0)
+            {
+                munmap(memory, program->mapped_size);
+                free(program);
+                program = NULL;
+            }
+            else
+            {
+                program->code = (unsigned char *)memory;
+                program->length = c.length;
+                program->frame_size = frame_size;
+                program->compile_started = started;
+                program->first_instruction_seconds = -1;
+            }
+        }
+    }
+
+    free(c.buffer);
+    free(c.labels);
+    free(c.fixups);
+    free(c.stubs);
+
+    if (program != NULL)
+    {
+        struct timespec finished;
+        clock_gettime(CLOCK_MONOTONIC, &finished);
+        program->compile_seconds = seconds_between(&started, &finished);
+    }
+    return program;
+}
+
+int run_jit(jit_program *program, program_io *io, execution_error *error)
+{
+    unsigned char *frame = (unsigned char *)calloc(1, (size_t)program->frame_size + 8);
+    if (frame == NULL)
+    {
+        error->line = 0;
+        snprintf(error->message, sizeof(error->message), "memoria insuficiente");
+        return 0;
+    }
+
+    jit_context context = {io, error, {0, 0}};
+    jit_entry entry;
+    void *code = program->code;
+    memcpy(&entry, &code, sizeof(entry)); // Um ponteiro de dados não pode ser convertido direto em função em C
+
+    int finished = entry(frame, &context);
+    program->first_instruction_seconds = seconds_between(&program->compile_started, &context.entered);
+
+    free(frame);
+    return finished;
+}
+
+void destroy_jit(jit_program *program)
+{
+    if (program == NULL)
+        return;
+    if (program->code != NULL)
+        munmap(program->code, program->mapped_size);
+    free(program);
+}
@@ -0,0 +1,45 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stddef.h>
+#include <time.h>
+#include "../interpreter/interpreter.h"
+#include "../parser/parser.h"
+#include "../runtime/program_io.h"
+
+/// @brief Um programa traduzido para código de máquina x86-64 em memória executável.
+/// @note Cada nó da árvore vira um trecho fixo de instruções (um template), sem passar por assembly.
+///       As variáveis são lidas e escritas no quadro, nos endereços da tabela de símbolos, a partir
+///       de um registrador com o início do quadro.
+typedef struct jit_program
+{
+    unsigned char *code; // Região obtida com mmap(), só de leitura e execução depois da compilação.
+    size_t length;       // Bytes de código gerados.
+    size_t mapped_size;  // Bytes mapeados (length arredondado para páginas).
+    int frame_size;
+    struct timespec compile_started;  // O início de compile_jit().
+    double compile_seconds;           // Da chamada de compile_jit() até o código ficar executável.
+    double first_instruction_seconds; // Da chamada de compile_jit() até a primeira instrução do programa
+                                      // executar; preenchido por run_jit() (-1 antes da execução).
+} jit_program;
+
+/// @brief Indica se a plataforma atual executa o código gerado (x86-64 com a convenção System V).
+int jit_supported(void);
+
+/// @brief Traduz a árvore ajustada e resolvida para código de máquina.
+/// @param tree A árvore ajustada e resolvida (resolve_tree()).
+/// @param frame_size O tamanho do quadro, em bytes (o próximo endereço livre da tabela de símbolos).
+/// @return O programa, ou NULL se não houver memória ou a plataforma não for suportada.
+jit_program *compile_jit(tree_node *tree, int frame_size);
+
+/// @brief Executa o código gerado.
+/// @param program O programa.
+/// @param io A entrada de ler() e a saída de mostrar().
+/// @param error Recebe a descrição do erro, se a execução for interrompida.
+/// @return 1 se o programa terminou normalmente, 0 se foi interrompido por um erro de execução.
+int run_jit(jit_program *program, program_io *io, execution_error *error);
+
+/// @brief Libera o código e o programa.
+void destroy_jit(jit_program *program);
+
+#endif // JIT_H
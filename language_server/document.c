@@ -0,0 +1,1237 @@
+#include <limits.h> // INT_MAX
+#include <stdio.h>  // snprintf()
+#include <stdlib.h> // malloc(), calloc(), realloc(), free()
+#include <string.h> // memcpy(), memmove(), memchr(), memcmp(), memset(), strlen(), strncmp(), strdup()
+#include "document.h"
+
+/// @brief O tamanho inicial do índice de hash dos nomes.
+#define NAME_SLOTS_INITIAL 256
+
+/// @brief O tamanho dos blocos das arenas dos nomes e dos símbolos.
+#define NAME_ARENA_BLOCK_SIZE (16 * 1024)
+
+/// @brief A mensagem do Bison para um erro de sintaxe, usada também nos erros que a divisão em unidades encontra.
+#define SYNTAX_ERROR_MESSAGE "syntax error"
+
+// ============================================================================
+// VETORES, NOMES E ERROS
+// ============================================================================
+
+/// @brief Garante espaço para needed elementos em um vetor que cresce dobrando de tamanho.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+static int reserve(void **items, int *capacity, int needed, size_t item_size)
+{
+    if (needed <= *capacity)
+        return 1;
+    int grown = (*capacity > 0) ? *capacity : 16;
+    while (grown < needed)
+        grown *= 2;
+    void *resized = realloc(*items, (size_t)grown * item_size);
+    if (resized == NULL)
+        return 0;
+    *items = resized;
+    *capacity = grown;
+    return 1;
+}
+
+/// @brief Garante espaço para size bytes no buffer dos analisadores.
+static int reserve_buffer(document *document, size_t size)
+{
+    if (size <= document->buffer_capacity)
+        return 1;
+    size_t grown = (document->buffer_capacity > 0) ? document->buffer_capacity : 4096;
+    while (grown < size)
+        grown *= 2;
+    char *resized = (char *)realloc(document->buffer, grown);
+    if (resized == NULL)
+        return 0;
+    document->buffer = resized;
+    document->buffer_capacity = grown;
+    return 1;
+}
+
+/// @brief Hash FNV-1a de um nome que não precisa terminar em '\0'.
+static unsigned int hash_text(const char *text, size_t length)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/// @brief Procura a posição de um nome no índice de hash: a do nome, ou a vaga onde ele entraria.
+static int find_name_slot(const document *document, const char *name, size_t length)
+{
+    unsigned int mask = (unsigned int)document->name_slot_count - 1;
+    unsigned int slot = hash_text(name, length) & mask;
+    while (document->name_slots[slot] != 0)
+    {
+        const char *known = document->names[document->name_slots[slot] - 1].name;
+        if (strncmp(known, name, length) == 0 && known[length] == '\0')
+            break;
+        slot = (slot + 1) & mask;
+    }
+    return (int)slot;
+}
+
+static int grow_name_slots(document *document)
+{
+    int slot_count = (document->name_slot_count > 0) ? document->name_slot_count * 2 : NAME_SLOTS_INITIAL;
+    int *slots = (int *)calloc((size_t)slot_count, sizeof(int));
+    if (slots == NULL)
+        return 0;
+    free(document->name_slots);
+    document->name_slots = slots;
+    document->name_slot_count = slot_count;
+    for (int i = 0; i < document->name_count; i++)
+    {
+        const char *name = document->names[i].name;
+        document->name_slots[find_name_slot(document, name, strlen(name))] = i + 1;
+    }
+    return 1;
+}
+
+/// @brief Procura um nome já conhecido pelo documento.
+/// @return A posição do nome em document.names, ou -1.
+static int find_name(const document *document, const char *name, size_t length)
+{
+    if (document->name_slot_count == 0)
+        return -1;
+    return document->name_slots[find_name_slot(document, name, length)] - 1;
+}
+
+/// @brief Procura um nome e o acrescenta ao documento se ele ainda não é conhecido.
+/// @return A posição do nome em document.names, ou -1 se faltou memória.
+static int intern_name(document *document, const char *name, size_t length)
+{
+    if ((document->name_count + 1) * 2 > document->name_slot_count && !grow_name_slots(document))
+        return -1;
+    int slot = find_name_slot(document, name, length);
+    if (document->name_slots[slot] != 0)
+        return document->name_slots[slot] - 1;
+
+    if (!reserve((void **)&document->names, &document->name_capacity, document->name_count + 1, sizeof(name_info)))
+        return -1;
+    char *copy = arena_strndup(document->name_arena, name, length);
+    if (copy == NULL)
+        return -1;
+    name_info *info = &document->names[document->name_count];
+    memset(info, 0, sizeof(name_info));
+    info->name = copy;
+    document->name_slots[slot] = ++document->name_count;
+    return document->name_count - 1;
+}
+
+static int add_diagnostic(document *document, unit_diagnostics *list, int line, diagnostic_kind kind,
+                          const char *message)
+{
+    if (!reserve((void **)&list->items, &list->capacity, list->count + 1, sizeof(unit_diagnostic)))
+        return 0;
+    char *copy = strdup(message);
+    if (copy == NULL)
+        return 0;
+    list->items[list->count++] = (unit_diagnostic){line, kind, copy};
+    document->diagnostic_count++;
+    return 1;
+}
+
+static void clear_diagnostics(document *document, unit_diagnostics *list)
+{
+    for (int i = 0; i < list->count; i++)
+        free(list->items[i].message);
+    document->diagnostic_count -= list->count;
+    list->count = 0;
+}
+
+static void free_unit(document *document, document_unit *unit)
+{
+    clear_diagnostics(document, &unit->syntax);
+    clear_diagnostics(document, &unit->semantic);
+    free(unit->syntax.items);
+    free(unit->semantic.items);
+    for (int i = 0; unit->kind == UNIT_STATEMENT && i < unit->name_count; i++)
+        document->names[unit->names[i]].use_count--;
+    free(unit->names);
+    free(unit->initializes);
+    free(unit);
+}
+
+/// @brief Conta as quebras de linha de um trecho do texto.
+static int count_newlines(const document *document, size_t start, size_t end)
+{
+    int count = 0;
+    const char *position = document->text + start;
+    const char *limit = document->text + end;
+    while (position < limit && (position = (const char *)memchr(position, '\n', (size_t)(limit - position))) != NULL)
+    {
+        count++;
+        position++;
+    }
+    return count;
+}
+
+/// @brief Procura a última unidade que começa até a posição dada.
+static int find_unit(const document *document, size_t offset)
+{
+    int low = 0, high = document->unit_count - 1, found = 0;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (document->units[middle]->start <= offset)
+        {
+            found = middle;
+            low = middle + 1;
+        }
+        else
+            high = middle - 1;
+    }
+    return found;
+}
+
+// ============================================================================
+// DIVISÃO EM UNIDADES
+// ============================================================================
+
+/// @brief Analisa um trecho do texto com o analisador léxico e guarda os tokens em document.tokens.
+/// @note O trecho é copiado: o Flex escreve no texto que analisa. As posições e as linhas dos tokens são
+///       relativas ao início do trecho.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+static int scan_text(document *document, size_t start, size_t end)
+{
+    size_t length = end - start;
+    if (!reserve_buffer(document, length + 2))
+        return 0;
+    memcpy(document->buffer, document->text + start, length);
+    if (!open_source_buffer(document->context->scanner, document->buffer, length))
+        return 0;
+
+    document->token_count = 0;
+    int ok = 1;
+    for (token current = get_token(document->context->scanner); current.type != T_EOF;
+         current = get_token(document->context->scanner))
+    {
+        if (!reserve((void **)&document->tokens, &document->token_capacity, document->token_count + 1,
+                     sizeof(document_token)))
+        {
+            ok = 0;
+            break;
+        }
+        document->tokens[document->token_count++] =
+            (document_token){current.type, (size_t)current.offset, current.length, current.line};
+    }
+    close_source_file(document->context->scanner);
+    document->stats.scanned_bytes += length;
+    return ok;
+}
+
+/// @brief Indica se o token começa uma declaração ou um comando que não pode fazer parte de uma expressão:
+///        um comando com erro termina antes dele, como na recuperação de erros do analisador sintático.
+static int starts_statement(token_type type)
+{
+    return type == T_SE || type == T_ENQUANTO || type == T_REPITA || type == T_LER || type == T_MOSTRAR ||
+           type == T_INTEIRO || type == T_REAL;
+}
+
+/// @brief Avança até o token esperado ou até um token que encerra o comando: ';', uma chave ou o início
+///        de outro comando.
+/// @return A posição do token onde parou, ou count.
+static int skip_to(const document_token *tokens, int count, int i, token_type expected)
+{
+    while (i < count && tokens[i].type != expected && tokens[i].type != T_PONTO_VIRGULA &&
+           tokens[i].type != T_ABRE_CHAVES && tokens[i].type != T_FECHA_CHAVES && !starts_statement(tokens[i].type))
+        i++;
+    return i;
+}
+
+/// @brief Termina um comando que vai até o ';': o ';' faz parte dele, os outros tokens que encerram não.
+static int end_simple(const document_token *tokens, int count, int i, int *incomplete)
+{
+    i = skip_to(tokens, count, i, T_PONTO_VIRGULA);
+    if (i == count)
+    {
+        *incomplete = 1;
+        return count;
+    }
+    return (tokens[i].type == T_PONTO_VIRGULA) ? i + 1 : i;
+}
+
+/// @brief Avança sobre uma condição entre parênteses, a partir do '('.
+static int skip_parentheses(const document_token *tokens, int count, int i)
+{
+    int depth = 0;
+    for (; i < count; i++)
+    {
+        token_type type = tokens[i].type;
+        if (type == T_ABRE_PARENTESES)
+            depth++;
+        else if (type == T_FECHA_PARENTESES && --depth == 0)
+            return i + 1;
+        else if (type == T_PONTO_VIRGULA || type == T_ABRE_CHAVES || type == T_FECHA_CHAVES || starts_statement(type))
+            return i;
+    }
+    return count;
+}
+
+static int skim_statement(const document_token *tokens, int count, int i, int *incomplete);
+
+/// @brief Avança sobre o comando de um se, enquanto ou repita. Uma '}' não é consumida: o comando falta.
+static int skim_command(const document_token *tokens, int count, int i, int *incomplete)
+{
+    if (i == count)
+    {
+        *incomplete = 1;
+        return count;
+    }
+    return (tokens[i].type == T_FECHA_CHAVES) ? i : skim_statement(tokens, count, i, incomplete);
+}
+
+/// @brief Avança sobre um comando, sem construir a árvore, para achar onde ele termina.
+/// @note Segue a gramática: o senao fica com o se mais próximo, e o repita termina no ';' depois do ate.
+///       Em um comando com erro, termina no próximo ';' ou antes da próxima chave ou do próximo comando.
+/// @param incomplete Recebe 1 se os tokens acabaram antes do fim do comando.
+/// @return A posição do primeiro token depois do comando; sempre avança ao menos um token.
+static int skim_statement(const document_token *tokens, int count, int i, int *incomplete)
+{
+    switch (tokens[i].type)
+    {
+    case T_SE:
+        i = skip_to(tokens, count, i + 1, T_ENTAO);
+        if (i == count)
+        {
+            *incomplete = 1;
+            return count;
+        }
+        if (tokens[i].type != T_ENTAO)
+            return (tokens[i].type == T_PONTO_VIRGULA) ? i + 1 : i;
+        i = skim_command(tokens, count, i + 1, incomplete);
+        if (!*incomplete && i < count && tokens[i].type == T_SENAO)
+            i = skim_command(tokens, count, i + 1, incomplete);
+        return i;
+    case T_ENQUANTO:
+        i++;
+        if (i < count && tokens[i].type == T_ABRE_PARENTESES)
+            i = skip_parentheses(tokens, count, i);
+        return skim_command(tokens, count, i, incomplete);
+    case T_REPITA:
+        i = skim_command(tokens, count, i + 1, incomplete);
+        if (*incomplete)
+            return i;
+        if (i == count)
+        {
+            *incomplete = 1;
+            return count;
+        }
+        return (tokens[i].type == T_ATE) ? end_simple(tokens, count, i + 1, incomplete) : i;
+    case T_ABRE_CHAVES:
+        i++;
+        while (i < count && tokens[i].type != T_FECHA_CHAVES && !*incomplete)
+            i = skim_statement(tokens, count, i, incomplete);
+        if (*incomplete)
+            return i;
+        if (i == count)
+        {
+            *incomplete = 1;
+            return count;
+        }
+        return i + 1;
+    case T_PONTO_VIRGULA:
+        return i + 1;
+    default:
+        return end_simple(tokens, count, i + 1, incomplete);
+    }
+}
+
+/// @brief Divide os tokens de document.tokens em unidades e as guarda em document.segments.
+/// @param state O estado antes do primeiro token; recebe o estado depois do último.
+/// @param incomplete Recebe 1 se a última unidade pode continuar depois do último token.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+static int segment_tokens(document *document, unit_state *state, int *incomplete)
+{
+    const document_token *tokens = document->tokens;
+    int count = document->token_count;
+    document->segment_count = 0;
+    *incomplete = 0;
+
+    for (int i = 0; i < count;)
+    {
+        if (!reserve((void **)&document->segments, &document->segment_capacity, document->segment_count + 1,
+                     sizeof(document_segment)))
+            return 0;
+        document_segment *segment = &document->segments[document->segment_count++];
+        segment->first_token = i;
+        *incomplete = 0;
+
+        if (*state == BEFORE_PROGRAM)
+        {
+            if (tokens[i].type == T_ABRE_CHAVES)
+            {
+                segment->kind = UNIT_OPEN;
+                *state = INSIDE_PROGRAM;
+                i++;
+            }
+            else
+            {
+                segment->kind = UNIT_JUNK;
+                while (i < count && tokens[i].type != T_ABRE_CHAVES)
+                    i++;
+            }
+        }
+        else if (*state == INSIDE_PROGRAM)
+        {
+            if (tokens[i].type == T_FECHA_CHAVES)
+            {
+                segment->kind = UNIT_CLOSE;
+                *state = AFTER_PROGRAM;
+                i++;
+            }
+            else if (tokens[i].type == T_INTEIRO || tokens[i].type == T_REAL)
+            {
+                segment->kind = UNIT_DECLARATION;
+                i = end_simple(tokens, count, i + 1, incomplete);
+            }
+            else
+            {
+                segment->kind = UNIT_STATEMENT;
+                i = skim_statement(tokens, count, i, incomplete);
+            }
+        }
+        else
+        {
+            // Depois do programa tudo é um único erro, que vai até o fim do documento
+            segment->kind = UNIT_JUNK;
+            i = count;
+            *incomplete = 1;
+        }
+        segment->state_after = *state;
+    }
+    return 1;
+}
+
+/// @brief Indica se um trecho sem tokens termina dentro de um comentário que não foi fechado.
+static int ends_inside_comment(const document *document, size_t start, size_t end)
+{
+    for (size_t i = start; i + 1 < end; i++)
+    {
+        if (document->text[i] != '/' || document->text[i + 1] != '*')
+            continue;
+        for (i += 2; i + 1 < end && !(document->text[i] == '*' && document->text[i + 1] == '/'); i++)
+            ;
+        if (i + 1 >= end)
+            return 1;
+        i++;
+    }
+    return 0;
+}
+
+// ============================================================================
+// ANÁLISE DE UMA UNIDADE
+// ============================================================================
+
+/// @brief Constrói a árvore sintática de uma unidade, analisando "{ unidade }" como um programa.
+/// @note As linhas da árvore e dos erros ficam relativas ao início da unidade. A árvore é construída
+///       uma única vez por atualização.
+/// @param record_errors 1 para guardar os erros léxicos e sintáticos na unidade.
+/// @return A árvore, ou NULL se a unidade não tem comandos válidos.
+static tree_node *parse_unit(document *document, document_unit *unit, int record_errors)
+{
+    if (unit->parsed_in == document->update)
+        return unit->tree;
+
+    size_t length = unit->length + 2;
+    unit->tree = NULL;
+    unit->parsed_in = document->update;
+    if (!reserve_buffer(document, length + 2))
+        return NULL;
+    document->buffer[0] = '{';
+    memcpy(document->buffer + 1, document->text + unit->start, unit->length);
+    document->buffer[length - 1] = '}';
+
+    parse_context *context = document->context;
+    if (!open_source_buffer(context->scanner, document->buffer, length))
+        return NULL;
+    unit->tree = parse(context);
+    close_source_file(context->scanner);
+    document->stats.parsed_units++;
+
+    if (record_errors)
+    {
+        clear_diagnostics(document, &unit->syntax);
+        for (int i = 0; i < context->error_count; i++)
+            add_diagnostic(document, &unit->syntax, context->errors[i].line,
+                           context->errors[i].is_lexical ? LEXICAL_DIAGNOSTIC : SYNTAX_DIAGNOSTIC,
+                           context->errors[i].message);
+    }
+    return unit->tree;
+}
+
+/// @brief Acrescenta um nome a document.collected, se ele ainda não está lá.
+static void collect_name(document *document, const char *name)
+{
+    int index = intern_name(document, name, strlen(name));
+    if (index < 0 || document->names[index].mark == document->marks)
+        return;
+    if (!reserve((void **)&document->collected, &document->collected_capacity, document->collected_count + 1,
+                 sizeof(int)))
+        return;
+    document->names[index].mark = document->marks;
+    document->collected[document->collected_count++] = index;
+}
+
+/// @brief Coleta os nomes usados em uma lista de comandos ou em uma expressão.
+static void collect_names(document *document, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind == STATEMENT_KIND)
+        {
+            if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT ||
+                node->kind.stmt == DECLARATION_STATEMENT)
+                collect_name(document, node->attribute.name);
+        }
+        else if (node->kind.exp == IDENTIFIER_EXPRESSION)
+            collect_name(document, node->attribute.name);
+
+        for (int i = 0; i < MAXCHILDREN; i++)
+            collect_names(document, node->child[i]);
+    }
+}
+
+/// @brief Indica se uma atribuição marca a variável como inicializada, como em adjust_assignment(): a
+///        expressão precisa ter um tipo, o que só não acontece quando ela falta ou é uma variável não declarada.
+static int assigns_value(document *document, const tree_node *expression)
+{
+    if (expression == NULL || expression->node_kind != EXPRESSION_KIND)
+        return 0;
+    if (expression->kind.exp == IDENTIFIER_EXPRESSION)
+        return find_symbol(document->analyzer, expression->attribute.name) != NULL;
+    return 1;
+}
+
+/// @brief Coleta as variáveis que uma lista de comandos inicializa, com as mesmas regras de
+///        adjust_tree_sequential(): atribuições a variáveis declaradas e leituras de variáveis numéricas.
+static void collect_initializers(document *document, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind != STATEMENT_KIND)
+            continue;
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+        {
+            symbol *sym = find_symbol(document->analyzer, node->attribute.name);
+            int initializes = (node->kind.stmt == ASSIGNMENT_STATEMENT)
+                                  ? assigns_value(document, node->child[0])
+                                  : (sym != NULL && (sym->type == DT_INTEGER || sym->type == DT_REAL));
+            if (sym != NULL && initializes)
+                collect_name(document, node->attribute.name);
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                collect_initializers(document, node->child[i]);
+        }
+    }
+}
+
+/// @brief Copia document.collected para um vetor da unidade.
+static int take_collected(document *document, int **list, int *count)
+{
+    int *copy = NULL;
+    if (document->collected_count > 0)
+    {
+        copy = (int *)malloc((size_t)document->collected_count * sizeof(int));
+        if (copy == NULL)
+            return 0;
+        memcpy(copy, document->collected, (size_t)document->collected_count * sizeof(int));
+    }
+    free(*list);
+    *list = copy;
+    *count = document->collected_count;
+    return 1;
+}
+
+static void mark_dirty(document *document, document_unit *unit)
+{
+    if (unit->dirty_in == document->update ||
+        !reserve((void **)&document->dirty, &document->dirty_capacity, document->dirty_count + 1,
+                 sizeof(document_unit *)))
+        return;
+    unit->dirty_in = document->update;
+    document->dirty[document->dirty_count++] = unit;
+}
+
+/// @brief Registra que a primeira inicialização de uma variável pode mudar nesta atualização, guardando
+///        onde ela estava antes.
+static void touch_name(document *document, int index)
+{
+    name_info *info = &document->names[index];
+    if (info->affected_in == document->update ||
+        !reserve((void **)&document->affected, &document->affected_capacity, document->affected_count + 1,
+                 sizeof(int)))
+        return;
+    info->affected_in = document->update;
+    info->previous = (info->lost_in == document->update) ? NULL : info->initialized_in;
+    document->affected[document->affected_count++] = index;
+}
+
+/// @brief Registra que a primeira inicialização de uma variável deixou de existir.
+/// @param position A partir de onde a próxima inicialização deve ser procurada.
+static void lose_initializer(document *document, int index, int position)
+{
+    name_info *info = &document->names[index];
+    touch_name(document, index);
+    if (info->lost_in != document->update || position < info->lost_at)
+        info->lost_at = position;
+    info->lost_in = document->update;
+    info->previous = NULL;
+    info->initialized_in = NULL;
+}
+
+/// @brief Recalcula as variáveis que uma unidade inicializa e atualiza as primeiras inicializações.
+static void update_initializers(document *document, document_unit *unit)
+{
+    tree_node *tree = parse_unit(document, unit, 0);
+    document->marks++;
+    document->collected_count = 0;
+    if (unit->kind == UNIT_STATEMENT)
+        collect_initializers(document, tree);
+
+    // As variáveis que a unidade deixou de inicializar têm a marca antiga
+    for (int i = 0; i < unit->initialize_count; i++)
+    {
+        int index = unit->initializes[i];
+        if (document->names[index].mark != document->marks && document->names[index].initialized_in == unit)
+            lose_initializer(document, index, unit->index);
+    }
+    for (int i = 0; i < document->collected_count; i++)
+    {
+        name_info *info = &document->names[document->collected[i]];
+        touch_name(document, document->collected[i]);
+        if (info->initialized_in == NULL || unit->index < info->initialized_in->index)
+            info->initialized_in = unit;
+    }
+    take_collected(document, &unit->initializes, &unit->initialize_count);
+}
+
+static int unit_initializes(const document_unit *unit, int index)
+{
+    for (int i = 0; i < unit->initialize_count; i++)
+    {
+        if (unit->initializes[i] == index)
+            return 1;
+    }
+    return 0;
+}
+
+/// @brief Verifica uma unidade com adjust_tree_sequential(), com cada variável inicializada se a primeira
+///        inicialização dela vem antes da unidade.
+static void check_unit(document *document, document_unit *unit)
+{
+    tree_node *tree = parse_unit(document, unit, 0);
+    semantic_analyzer *analyzer = document->analyzer;
+    clear_diagnostics(document, &unit->semantic);
+    document->stats.checked_units++;
+    if (tree == NULL)
+        return;
+
+    for (int i = 0; i < unit->name_count; i++)
+    {
+        const name_info *info = &document->names[unit->names[i]];
+        symbol *sym = find_symbol(analyzer, info->name);
+        if (sym != NULL)
+            sym->is_initialized = info->initialized_in != NULL && info->initialized_in->index < unit->index;
+    }
+
+    // As conversões criadas pela verificação ficam na arena de rascunho, com a árvore
+    analyzer->arena = document->context->arena;
+    analyzer->error_count = 0;
+    adjust_tree_sequential(analyzer, tree);
+    for (int i = 0; i < analyzer->error_count; i++)
+        add_diagnostic(document, &unit->semantic, analyzer->errors[i].line, SEMANTIC_DIAGNOSTIC,
+                       analyzer->errors[i].message);
+    analyzer->error_count = 0;
+    analyzer->arena = document->symbol_arena;
+}
+
+/// @brief Refaz a tabela de símbolos a partir das unidades de declaração, em ordem, e marca os nomes cuja
+///        declaração mudou.
+/// @return Quantos nomes mudaram e são usados em alguma unidade: se nenhum é usado, não há o que verificar.
+static int rebuild_symbols(document *document)
+{
+    semantic_analyzer *analyzer = document->analyzer;
+    document->stats.rebuilt_symbols = 1;
+
+    // As declarações anteriores, para a comparação
+    document->collected_count = 0;
+    for (int i = 0; i < analyzer->table.count; i++)
+    {
+        const symbol *sym = &analyzer->table.symbols[i];
+        int index = intern_name(document, sym->name, strlen(sym->name));
+        if (index < 0 || !reserve((void **)&document->collected, &document->collected_capacity,
+                                  document->collected_count + 1, sizeof(int)))
+            continue;
+        document->names[index].old_type_in = document->update;
+        document->names[index].old_type = sym->type;
+        document->names[index].declared_in = NULL;
+        document->collected[document->collected_count++] = index;
+    }
+    arena_reset(document->symbol_arena);
+    reset_semantic_analyzer(analyzer, NULL, document->symbol_arena);
+
+    // Uma declaração depois de um comando é um erro de sintaxe e não declara nada
+    int seen_statement = 0;
+    int found = 0;
+    document->last_declaration = NULL;
+    for (int i = 0; i < document->unit_count && found < document->declaration_count; i++)
+    {
+        document_unit *unit = document->units[i];
+        if (unit->kind == UNIT_STATEMENT)
+            seen_statement = 1;
+        if (unit->kind != UNIT_DECLARATION)
+            continue;
+        found++;
+        document->last_declaration = unit;
+        clear_diagnostics(document, &unit->semantic);
+        if (seen_statement)
+        {
+            add_diagnostic(document, &unit->semantic, 1, SYNTAX_DIAGNOSTIC, SYNTAX_ERROR_MESSAGE);
+            continue;
+        }
+        for (const tree_node *node = parse_unit(document, unit, 0); node != NULL; node = node->sibling)
+        {
+            if (node->node_kind != STATEMENT_KIND || node->kind.stmt != DECLARATION_STATEMENT)
+                continue;
+            add_symbol(analyzer, node->attribute.name, (node->type == INTEGER) ? DT_INTEGER : DT_REAL,
+                       node->line_number);
+            if (analyzer->error_count > 0)
+            {
+                add_diagnostic(document, &unit->semantic, analyzer->errors[0].line, SEMANTIC_DIAGNOSTIC,
+                               analyzer->errors[0].message);
+                analyzer->error_count = 0;
+                continue;
+            }
+            int index = intern_name(document, node->attribute.name, strlen(node->attribute.name));
+            if (index >= 0)
+                document->names[index].declared_in = unit;
+        }
+    }
+
+    int changed = 0;
+    for (int i = 0; i < analyzer->table.count; i++)
+    {
+        const symbol *sym = &analyzer->table.symbols[i];
+        int index = intern_name(document, sym->name, strlen(sym->name));
+        name_info *info = (index >= 0) ? &document->names[index] : NULL;
+        if (info != NULL && (info->old_type_in != document->update || info->old_type != sym->type))
+        {
+            info->changed_in = document->update;
+            changed += info->use_count > 0;
+        }
+    }
+    for (int i = 0; i < document->collected_count; i++)
+    {
+        name_info *info = &document->names[document->collected[i]];
+        if (find_symbol(analyzer, info->name) == NULL)
+        {
+            info->changed_in = document->update;
+            changed += info->use_count > 0;
+        }
+    }
+    return changed;
+}
+
+/// @brief Preenche os erros de uma unidade fora do programa: um erro de sintaxe no primeiro token e um
+///        erro léxico em cada caractere inválido.
+static void describe_junk(document *document, document_unit *unit, size_t region_start, int first, int end, int line)
+{
+    add_diagnostic(document, &unit->syntax, document->tokens[first].line - line + 1, SYNTAX_DIAGNOSTIC,
+                   SYNTAX_ERROR_MESSAGE);
+    for (int i = first; i < end; i++)
+    {
+        const document_token *current = &document->tokens[i];
+        if (current->type != T_ERRO)
+            continue;
+        char message[64];
+        snprintf(message, sizeof(message), "Caractere inesperado '%.*s'", current->length,
+                 document->text + region_start + current->offset);
+        add_diagnostic(document, &unit->syntax, current->line - line + 1, LEXICAL_DIAGNOSTIC, message);
+    }
+}
+
+// ============================================================================
+// ATUALIZAÇÃO
+// ============================================================================
+
+/// @brief Troca as unidades de first a last por novas unidades, de acordo com o texto novo do trecho, e
+///        refaz a análise do que depende delas.
+/// @param region_start O início do trecho, que é o início da unidade first.
+/// @param region_end O fim do trecho no texto novo.
+/// @param delta Quanto o texto cresceu.
+/// @param old_lines Quantas quebras de linha o trecho tinha.
+static int update_units(document *document, int first, int last, size_t region_start, size_t region_end,
+                        ptrdiff_t delta, int old_lines)
+{
+    unit_state entry = (first > 0) ? document->units[first - 1]->state_after : BEFORE_PROGRAM;
+    int region_line = (first < document->unit_count) ? document->units[first]->first_line : 1;
+
+    // O trecho cresce até que as novas unidades terminem onde uma unidade antiga terminava, no mesmo estado
+    for (;;)
+    {
+        unit_state state = entry;
+        int incomplete;
+        if (!scan_text(document, region_start, region_end) || !segment_tokens(document, &state, &incomplete))
+            return 0;
+        if (last + 1 >= document->unit_count)
+            break;
+        size_t trailing = (document->token_count > 0)
+                              ? region_start + document->tokens[document->token_count - 1].offset +
+                                    (size_t)document->tokens[document->token_count - 1].length
+                              : region_start;
+        if (!incomplete && document->segment_count > 0 && state == document->units[last]->state_after &&
+            document->units[last + 1]->first_token != T_SENAO &&
+            !ends_inside_comment(document, trailing, region_end))
+            break;
+
+        int extended = last + (last - first + 1);
+        if (extended > document->unit_count - 1)
+            extended = document->unit_count - 1;
+        for (int i = last + 1; i <= extended; i++)
+            old_lines += document->units[i]->line_count;
+        const document_unit *end_unit = document->units[extended];
+        region_end = (size_t)((ptrdiff_t)(end_unit->start + end_unit->length) + delta);
+        last = extended;
+    }
+
+    // As unidades antigas saem; as inicializações e declarações delas deixam de valer
+    int removed = last - first + 1;
+    int rebuild = document->last_declaration != NULL && first <= document->last_declaration->index;
+    for (int i = first; i <= last; i++)
+    {
+        document_unit *unit = document->units[i];
+        for (int j = 0; j < unit->initialize_count; j++)
+        {
+            if (document->names[unit->initializes[j]].initialized_in == unit)
+                lose_initializer(document, unit->initializes[j], first);
+        }
+        if (unit->kind == UNIT_DECLARATION)
+        {
+            rebuild = 1;
+            document->declaration_count--;
+        }
+        if (unit == document->last_declaration)
+            document->last_declaration = NULL;
+        free_unit(document, unit);
+    }
+    document->stats.replaced_units = removed;
+
+    int created = document->segment_count;
+    if (!reserve((void **)&document->units, &document->unit_capacity, document->unit_count - removed + created,
+                 sizeof(document_unit *)))
+        return 0;
+    if (last + 1 < document->unit_count)
+        memmove(document->units + first + created, document->units + last + 1,
+                (size_t)(document->unit_count - last - 1) * sizeof(document_unit *));
+    document->unit_count += created - removed;
+
+    for (int s = 0; s < created; s++)
+    {
+        const document_segment *segment = &document->segments[s];
+        int end_token = (s + 1 < created) ? document->segments[s + 1].first_token : document->token_count;
+        const document_token *first_token = &document->tokens[segment->first_token];
+        size_t start = (s == 0) ? region_start : region_start + first_token->offset;
+        size_t end = (s + 1 < created) ? region_start + document->tokens[end_token].offset : region_end;
+        int line = (s == 0) ? 1 : first_token->line;
+
+        document_unit *unit = (document_unit *)calloc(1, sizeof(document_unit));
+        if (unit == NULL)
+            return 0;
+        unit->start = start;
+        unit->length = end - start;
+        unit->first_line = region_line + line - 1;
+        unit->line_count = count_newlines(document, start, end);
+        unit->kind = segment->kind;
+        unit->state_after = segment->state_after;
+        unit->first_token = first_token->type;
+        unit->first_length = first_token->length;
+        document->units[first + s] = unit;
+
+        if (unit->kind == UNIT_JUNK)
+            describe_junk(document, unit, region_start, segment->first_token, end_token, line);
+        if (unit->kind == UNIT_DECLARATION)
+        {
+            rebuild = 1;
+            document->declaration_count++;
+        }
+    }
+
+    // Um trecho sem tokens são só espaços e comentários depois da unidade anterior
+    int line_delta = count_newlines(document, region_start, region_end) - old_lines;
+    if (created == 0 && first > 0)
+    {
+        document->units[first - 1]->length += region_end - region_start;
+        document->units[first - 1]->line_count += count_newlines(document, region_start, region_end);
+    }
+
+    // As unidades seguintes só mudam de lugar
+    for (int i = first; i < document->unit_count; i++)
+    {
+        document_unit *unit = document->units[i];
+        unit->index = i;
+        if (i >= first + created)
+        {
+            unit->start = (size_t)((ptrdiff_t)unit->start + delta);
+            unit->first_line += line_delta;
+        }
+    }
+
+    // Os erros de sintaxe e os nomes das unidades novas
+    for (int i = first; i < first + created; i++)
+    {
+        document_unit *unit = document->units[i];
+        if (unit->kind != UNIT_STATEMENT && unit->kind != UNIT_DECLARATION)
+            continue;
+        document->marks++;
+        document->collected_count = 0;
+        collect_names(document, parse_unit(document, unit, 1));
+        take_collected(document, &unit->names, &unit->name_count);
+        for (int j = 0; unit->kind == UNIT_STATEMENT && j < unit->name_count; j++)
+            document->names[unit->names[j]].use_count++;
+        if (unit->kind == UNIT_STATEMENT)
+            mark_dirty(document, unit);
+    }
+
+    // Se as declarações mudaram, as unidades que usam os nomes alterados são verificadas de novo
+    if (rebuild && rebuild_symbols(document) > 0)
+    {
+        for (int i = 0; i < document->unit_count; i++)
+        {
+            document_unit *unit = document->units[i];
+            if (unit->kind != UNIT_STATEMENT || unit->dirty_in == document->update)
+                continue;
+            for (int j = 0; j < unit->name_count; j++)
+            {
+                if (document->names[unit->names[j]].changed_in == document->update)
+                {
+                    mark_dirty(document, unit);
+                    break;
+                }
+            }
+        }
+    }
+
+    // As inicializações das unidades novas e das que dependem de declarações alteradas
+    for (int i = 0; i < document->dirty_count; i++)
+        update_initializers(document, document->dirty[i]);
+
+    // Onde a primeira inicialização de uma variável mudou, os usos entre a posição antiga e a nova mudam
+    int low = INT_MAX, high = -1;
+    for (int i = 0; i < document->affected_count; i++)
+    {
+        name_info *info = &document->names[document->affected[i]];
+        int limit = (info->initialized_in != NULL) ? info->initialized_in->index : document->unit_count;
+        if (info->lost_in == document->update)
+        {
+            for (int j = info->lost_at; j < limit; j++)
+            {
+                if (unit_initializes(document->units[j], document->affected[i]))
+                {
+                    info->initialized_in = document->units[j];
+                    break;
+                }
+            }
+        }
+        int before = (info->lost_in == document->update) ? info->lost_at
+                     : (info->previous != NULL)          ? info->previous->index
+                                                         : document->unit_count;
+        int after = (info->initialized_in != NULL) ? info->initialized_in->index : document->unit_count;
+        if (before == after)
+            continue;
+        info->moved_in = document->update;
+        info->moved_from = (before < after) ? before : after;
+        info->moved_to = (before < after) ? after : before;
+        if (info->moved_from < low)
+            low = info->moved_from;
+        if (info->moved_to > high)
+            high = info->moved_to;
+    }
+    if (high >= document->unit_count)
+        high = document->unit_count - 1;
+    for (int i = low; i <= high; i++)
+    {
+        document_unit *unit = document->units[i];
+        if (unit->kind != UNIT_STATEMENT || unit->dirty_in == document->update)
+            continue;
+        for (int j = 0; j < unit->name_count; j++)
+        {
+            const name_info *info = &document->names[unit->names[j]];
+            if (info->moved_in == document->update && info->moved_from <= i && i <= info->moved_to)
+            {
+                mark_dirty(document, unit);
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < document->dirty_count; i++)
+        check_unit(document, document->dirty[i]);
+
+    document->dirty_count = 0;
+    document->affected_count = 0;
+    arena_reset(document->context->arena);
+    return 1;
+}
+
+// ============================================================================
+// INTERFACE
+// ============================================================================
+
+document *create_document(void)
+{
+    document *created = (document *)calloc(1, sizeof(document));
+    if (created == NULL)
+        return NULL;
+    created->context = create_parse_context();
+    created->name_arena = arena_create(NAME_ARENA_BLOCK_SIZE);
+    created->symbol_arena = arena_create(NAME_ARENA_BLOCK_SIZE);
+    created->analyzer = create_semantic_analyzer(NULL, created->symbol_arena);
+    created->text = (char *)malloc(2);
+    created->capacity = 2;
+    if (created->context == NULL || created->name_arena == NULL || created->symbol_arena == NULL ||
+        created->analyzer == NULL || created->text == NULL)
+    {
+        destroy_document(created);
+        return NULL;
+    }
+    created->context->print_errors = 0;
+    return created;
+}
+
+int set_document_text(document *document, const char *text, size_t length)
+{
+    return edit_document(document, 0, document->length, text, length);
+}
+
+int edit_document(document *document, size_t start, size_t end, const char *text, size_t length)
+{
+    if (end > document->length)
+        end = document->length;
+    if (start > end)
+        start = end;
+
+    document->update++;
+    memset(&document->stats, 0, sizeof(document->stats));
+
+    // As unidades tocadas: a do byte antes da troca (que pode se juntar ao texto novo) até a do byte depois
+    int first = 0, last = -1;
+    size_t region_start = 0, region_end = document->length;
+    int old_lines = 0;
+    if (document->unit_count > 0)
+    {
+        first = find_unit(document, (start > 0) ? start - 1 : 0);
+        last = find_unit(document, end);
+        // Uma unidade pode terminar antes do primeiro token da seguinte: se ele muda, ela também pode mudar
+        if (first > 0 && start <= document->units[first]->start + (size_t)document->units[first]->first_length)
+            first--;
+        region_start = document->units[first]->start;
+        region_end = document->units[last]->start + document->units[last]->length;
+        for (int i = first; i <= last; i++)
+            old_lines += document->units[i]->line_count;
+    }
+    else
+        old_lines = count_newlines(document, 0, document->length);
+
+    // O texto fica contíguo, com os dois bytes de folga que o Flex exige nas cópias
+    size_t new_length = document->length - (end - start) + length;
+    if (new_length + 2 > document->capacity)
+    {
+        size_t capacity = document->capacity * 2;
+        if (capacity < new_length + 2)
+            capacity = new_length + 2;
+        char *grown = (char *)realloc(document->text, capacity);
+        if (grown == NULL)
+            return 0;
+        document->text = grown;
+        document->capacity = capacity;
+    }
+    memmove(document->text + start + length, document->text + end, document->length - end);
+    memcpy(document->text + start, text, length);
+    document->length = new_length;
+    document->text[new_length] = '\0';
+
+    ptrdiff_t delta = (ptrdiff_t)length - (ptrdiff_t)(end - start);
+    return update_units(document, first, last, region_start, (size_t)((ptrdiff_t)region_end + delta), delta,
+                        old_lines);
+}
+
+size_t document_line_start(const document *document, int line)
+{
+    // A última unidade que começa antes da linha; a linha começa nela ou depois dela
+    int low = 0, high = document->unit_count - 1, found = -1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (document->units[middle]->first_line < line)
+        {
+            found = middle;
+            low = middle + 1;
+        }
+        else
+            high = middle - 1;
+    }
+    size_t position = (found >= 0) ? document->units[found]->start : 0;
+    int current = (found >= 0) ? document->units[found]->first_line : 1;
+    while (current < line)
+    {
+        const char *newline = (const char *)memchr(document->text + position, '\n', document->length - position);
+        if (newline == NULL)
+            return document->length;
+        position = (size_t)(newline - document->text) + 1;
+        current++;
+    }
+    return position;
+}
+
+int document_line_count(const document *document)
+{
+    if (document->unit_count == 0)
+        return count_newlines(document, 0, document->length) + 1;
+    const document_unit *last = document->units[document->unit_count - 1];
+    return last->first_line + last->line_count;
+}
+
+/// @brief O tamanho em bytes do caractere UTF-8 que começa com o byte dado.
+static int utf8_length(unsigned char c)
+{
+    if (c >= 0xF0)
+        return 4;
+    if (c >= 0xE0)
+        return 3;
+    if (c >= 0xC0)
+        return 2;
+    return 1;
+}
+
+size_t document_offset(const document *document, int line, int character)
+{
+    size_t position = document_line_start(document, line + 1);
+    while (character > 0 && position < document->length && document->text[position] != '\n')
+    {
+        int length = utf8_length((unsigned char)document->text[position]);
+        character -= (length == 4) ? 2 : 1; // Caracteres fora do plano básico ocupam duas unidades UTF-16
+        position += (size_t)length;
+    }
+    return (position > document->length) ? document->length : position;
+}
+
+void document_position(const document *document, size_t offset, int *line, int *character)
+{
+    if (offset > document->length)
+        offset = document->length;
+    size_t start = 0;
+    int current = 1;
+    if (document->unit_count > 0)
+    {
+        const document_unit *unit = document->units[find_unit(document, offset)];
+        start = unit->start;
+        current = unit->first_line;
+    }
+    current += count_newlines(document, start, offset);
+
+    size_t line_start = offset;
+    while (line_start > 0 && document->text[line_start - 1] != '\n')
+        line_start--;
+    int units = 0;
+    for (size_t i = line_start; i < offset; i += (size_t)utf8_length((unsigned char)document->text[i]))
+        units += (utf8_length((unsigned char)document->text[i]) == 4) ? 2 : 1;
+    *line = current - 1;
+    *character = units;
+}
+
+/// @brief Procura, nos tokens de uma unidade, o que contém a posição ou termina nela.
+static int find_token(document *document, const document_unit *unit, size_t offset, document_token *found)
+{
+    if (!scan_text(document, unit->start, unit->start + unit->length))
+        return 0;
+    int result = 0;
+    for (int i = 0; i < document->token_count; i++)
+    {
+        document_token current = document->tokens[i];
+        current.offset += unit->start;
+        current.line += unit->first_line - 1;
+        if (current.offset <= offset && offset < current.offset + (size_t)current.length)
+        {
+            *found = current;
+            return 1;
+        }
+        // O cursor logo depois de um identificador também o indica
+        if (offset == current.offset + (size_t)current.length)
+        {
+            *found = current;
+            result = 1;
+        }
+    }
+    return result;
+}
+
+int document_token_at(document *document, size_t offset, document_token *token)
+{
+    if (document->unit_count == 0)
+        return 0;
+    return find_token(document, document->units[find_unit(document, offset)], offset, token);
+}
+
+symbol *document_declaration(document *document, const char *name, size_t length, document_token *declaration)
+{
+    int index = find_name(document, name, length);
+    if (index < 0)
+        return NULL;
+    const name_info *info = &document->names[index];
+    symbol *sym = find_symbol(document->analyzer, info->name);
+    if (sym == NULL || info->declared_in == NULL)
+        return sym;
+
+    const document_unit *unit = info->declared_in;
+    memset(declaration, 0, sizeof(document_token));
+    if (!scan_text(document, unit->start, unit->start + unit->length))
+        return sym;
+    for (int i = 0; i < document->token_count; i++)
+    {
+        const document_token *current = &document->tokens[i];
+        if (current->type == T_ID && (size_t)current->length == length &&
+            memcmp(document->text + unit->start + current->offset, name, length) == 0)
+        {
+            *declaration = *current;
+            declaration->offset += unit->start;
+            declaration->line += unit->first_line - 1;
+            break;
+        }
+    }
+    return sym;
+}
+
+void destroy_document(document *document)
+{
+    if (document == NULL)
+        return;
+    for (int i = 0; i < document->unit_count; i++)
+        free_unit(document, document->units[i]);
+    free(document->units);
+    free(document->names);
+    free(document->name_slots);
+    if (document->name_arena != NULL)
+        arena_release(document->name_arena);
+    destroy_semantic_analyzer(document->analyzer);
+    if (document->symbol_arena != NULL)
+        arena_release(document->symbol_arena);
+    destroy_parse_context(document->context);
+    free(document->text);
+    free(document->buffer);
+    free(document->tokens);
+    free(document->segments);
+    free(document->collected);
+    free(document->dirty);
+    free(document->affected);
+    free(document);
+}
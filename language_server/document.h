@@ -0,0 +1,212 @@
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+#include <stddef.h> // size_t
+#include "../parser/parser.h"
+#include "../semantic/semantic.h"
+#include "../compiler/compiler.h"
+
+/// @brief O que uma unidade do documento contém.
+/// @note O programa é "{ declarações comandos }": cada declaração e cada comando do nível mais externo
+///       é uma unidade, e as chaves do programa são unidades próprias. O que vem antes da chave de
+///       abertura ou depois da de fechamento é UNIT_JUNK.
+typedef enum unit_kind
+{
+    UNIT_OPEN,
+    UNIT_DECLARATION,
+    UNIT_STATEMENT,
+    UNIT_CLOSE,
+    UNIT_JUNK
+} unit_kind;
+
+/// @brief Em que parte do programa o texto está, depois de uma unidade.
+typedef enum unit_state
+{
+    BEFORE_PROGRAM,
+    INSIDE_PROGRAM,
+    AFTER_PROGRAM
+} unit_state;
+
+/// @brief Um erro de uma unidade, com a linha relativa ao início dela (1 é a primeira linha da unidade).
+typedef struct unit_diagnostic
+{
+    int line;
+    diagnostic_kind kind;
+    char *message;
+} unit_diagnostic;
+
+/// @brief Uma lista de erros de uma unidade.
+typedef struct unit_diagnostics
+{
+    unit_diagnostic *items;
+    int count;
+    int capacity;
+} unit_diagnostics;
+
+/// @brief Um trecho do documento: uma declaração, um comando ou uma chave do programa, com os espaços e
+///        comentários que vêm depois dele.
+/// @note A unidade guarda só o que a análise incremental precisa para decidir o que verificar de novo: os
+///       nomes que ela usa e as variáveis que ela inicializa. A árvore sintática é refeita a partir do texto
+///       quando a unidade precisa ser verificada e só existe durante a atualização.
+typedef struct document_unit
+{
+    size_t start;  // A posição do primeiro token no documento (0 para a primeira unidade)
+    size_t length; // Até o primeiro token da próxima unidade, ou até o fim do documento
+    int first_line;
+    int line_count; // Quantas quebras de linha a unidade contém
+    int index;      // A posição da unidade no documento
+    unit_kind kind;
+    unit_state state_after;
+    token_type first_token;
+    int first_length; // O tamanho do primeiro token
+    int *names; // Os nomes usados pela unidade, sem repetições, como índices de document.names
+    int name_count;
+    int *initializes; // As variáveis que a unidade inicializa, sem repetições
+    int initialize_count;
+    unit_diagnostics syntax;   // Os erros léxicos e sintáticos, que só mudam quando o texto muda
+    unit_diagnostics semantic; // Os erros da última verificação, ou das declarações
+    tree_node *tree;           // Na arena de rascunho, válida só durante a atualização
+    int parsed_in;             // A atualização em que tree foi construída
+    int dirty_in;              // A atualização em que a unidade foi marcada para verificação
+} document_unit;
+
+/// @brief O que o documento sabe sobre um nome usado em alguma unidade.
+typedef struct name_info
+{
+    const char *name;
+    document_unit *declared_in;    // A declaração que vale para o nome, ou NULL
+    document_unit *initialized_in; // A primeira unidade que inicializa a variável, ou NULL
+    int mark;                      // Para eliminar repetições na coleta dos nomes de uma unidade
+    int use_count;                 // Quantos comandos usam o nome
+    int old_type_in;               // A atualização em que old_type foi registrado (a declaração anterior)
+    data_type old_type;
+    int changed_in;                // A atualização em que a declaração do nome mudou
+    int moved_in;                  // A atualização em que a primeira inicialização mudou de lugar
+    int moved_from, moved_to;      // As unidades entre as posições antiga e nova da primeira inicialização
+    int lost_in;                   // A atualização em que a primeira inicialização deixou de existir
+    int lost_at;                   // A partir de onde procurar a nova primeira inicialização
+    int affected_in;               // A atualização em que o nome entrou em document.affected
+    document_unit *previous;       // A primeira inicialização quando o nome entrou em document.affected
+} name_info;
+
+/// @brief Um trecho de tokens que forma uma unidade, encontrado na divisão de um trecho do texto.
+typedef struct document_segment
+{
+    int first_token;
+    unit_kind kind;
+    unit_state state_after;
+} document_segment;
+
+/// @brief Um token encontrado em uma consulta ao documento.
+typedef struct document_token
+{
+    token_type type;
+    size_t offset; // No documento
+    int length;
+    int line; // Relativa ao início do trecho analisado
+} document_token;
+
+/// @brief O que a última atualização fez, para medições.
+typedef struct document_stats
+{
+    size_t scanned_bytes; // Os bytes analisados pelo analisador léxico para achar as unidades
+    int replaced_units;   // As unidades antigas trocadas
+    int parsed_units;     // As unidades analisadas pelo analisador sintático
+    int checked_units;    // As unidades verificadas pelo analisador semântico
+    int rebuilt_symbols;  // 1 se a tabela de símbolos foi refeita
+} document_stats;
+
+/// @brief Um documento aberto, mantido em memória entre as edições.
+/// @note O texto, as unidades, a tabela de símbolos e os erros estão sempre de acordo com a última edição.
+///       Uma edição analisa de novo só as unidades que ela toca e verifica de novo só as que dependem de
+///       uma declaração ou de uma primeira inicialização que mudou.
+typedef struct document
+{
+    char *text; // Com dois bytes de folga
+    size_t length;
+    size_t capacity;
+
+    document_unit **units;
+    int unit_count;
+    int unit_capacity;
+    int declaration_count;
+    document_unit *last_declaration; // A última unidade de declaração, conhecida desde a última tabela
+
+    name_info *names;
+    int name_count;
+    int name_capacity;
+    int *name_slots; // Índice de hash dos nomes: a posição em names mais um; 0 indica vazio
+    int name_slot_count;
+    arena *name_arena; // Os textos dos nomes, que não mudam enquanto o documento existe
+
+    parse_context *context;      // A arena do contexto é a de rascunho
+    semantic_analyzer *analyzer; // A tabela de símbolos das declarações
+    arena *symbol_arena;         // Os nomes dos símbolos, refeitos com a tabela
+
+    char *buffer; // Onde os trechos são copiados para os analisadores léxico e sintático
+    size_t buffer_capacity;
+    document_token *tokens;
+    int token_count;
+    int token_capacity;
+    document_segment *segments;
+    int segment_count;
+    int segment_capacity;
+    int *collected; // Os nomes encontrados em uma unidade, antes de irem para ela
+    int collected_count;
+    int collected_capacity;
+    document_unit **dirty; // As unidades a verificar na atualização corrente
+    int dirty_count;
+    int dirty_capacity;
+    int *affected; // Os nomes cuja primeira inicialização pode ter mudado
+    int affected_count;
+    int affected_capacity;
+
+    int update; // O número da atualização corrente
+    int marks;  // O contador de name_info.mark
+    int diagnostic_count;
+    document_stats stats;
+} document;
+
+/// @brief Cria um documento vazio.
+/// @return O documento, ou NULL se não houver memória.
+document *create_document(void);
+
+/// @brief Troca todo o texto do documento e o analisa.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+int set_document_text(document *document, const char *text, size_t length);
+
+/// @brief Troca um trecho do texto e analisa de novo o que a troca afeta.
+/// @param start A posição do primeiro byte trocado.
+/// @param end A posição depois do último byte trocado.
+/// @param text O novo texto do trecho.
+/// @param length O tamanho do novo texto.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+int edit_document(document *document, size_t start, size_t end, const char *text, size_t length);
+
+/// @brief Converte uma posição do protocolo (linha e caractere em unidades UTF-16, a partir de 0) em
+///        uma posição no texto.
+size_t document_offset(const document *document, int line, int character);
+
+/// @brief Converte uma posição no texto em uma posição do protocolo.
+void document_position(const document *document, size_t offset, int *line, int *character);
+
+/// @brief A posição no texto do início de uma linha, contada a partir de 1.
+size_t document_line_start(const document *document, int line);
+
+/// @brief Quantas linhas o documento tem.
+int document_line_count(const document *document);
+
+/// @brief Procura o token que contém uma posição do texto.
+/// @return 1 se há um token na posição, 0 caso contrário.
+int document_token_at(document *document, size_t offset, document_token *token);
+
+/// @brief Procura a declaração de uma variável.
+/// @param name O nome, que não precisa terminar em '\0'.
+/// @param declaration Recebe o identificador da declaração.
+/// @return O símbolo, ou NULL se a variável não está declarada.
+symbol *document_declaration(document *document, const char *name, size_t length, document_token *declaration);
+
+/// @brief Libera o documento.
+void destroy_document(document *document);
+
+#endif // DOCUMENT_H
@@ -0,0 +1,463 @@
+#include <stdlib.h> // strtod()
+#include <string.h> // memcpy(), memcmp(), memset(), strchr(), strcmp(), strlen()
+#include "json.h"
+
+/// @brief O estado da leitura de um texto JSON.
+typedef struct json_reader
+{
+    arena *arena;
+    const char *text;
+    size_t length;
+    size_t position;
+    int depth;
+} json_reader;
+
+static json_value *read_value(json_reader *reader);
+
+static void skip_whitespace(json_reader *reader)
+{
+    while (reader->position < reader->length)
+    {
+        char c = reader->text[reader->position];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            break;
+        reader->position++;
+    }
+}
+
+/// @brief Consome o caractere esperado, depois dos espaços.
+/// @return 1 se ele estava lá, 0 caso contrário.
+static int expect(json_reader *reader, char c)
+{
+    skip_whitespace(reader);
+    if (reader->position >= reader->length || reader->text[reader->position] != c)
+        return 0;
+    reader->position++;
+    return 1;
+}
+
+/// @brief Consome uma palavra fixa (true, false ou null).
+static int expect_word(json_reader *reader, const char *word, size_t length)
+{
+    if (reader->length - reader->position < length || memcmp(reader->text + reader->position, word, length) != 0)
+        return 0;
+    reader->position += length;
+    return 1;
+}
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/// @brief Lê os quatro dígitos hexadecimais de um escape \\u.
+/// @return O código lido, ou -1 se os dígitos são inválidos.
+static long read_hex4(json_reader *reader)
+{
+    if (reader->length - reader->position < 4)
+        return -1;
+    long code = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int digit = hex_digit(reader->text[reader->position++]);
+        if (digit < 0)
+            return -1;
+        code = code * 16 + digit;
+    }
+    return code;
+}
+
+/// @brief Escreve um código Unicode em UTF-8.
+/// @return Quantos bytes foram escritos.
+static size_t encode_utf8(long code, char *out)
+{
+    if (code < 0x80)
+    {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800)
+    {
+        out[0] = (char)(0xC0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000)
+    {
+        out[0] = (char)(0xE0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+/// @brief Lê uma string, depois das aspas de abertura, e a decodifica na arena.
+/// @note O texto decodificado nunca é maior que o original, então o espaço é reservado de uma vez.
+static const char *read_string(json_reader *reader, size_t *length)
+{
+    size_t end = reader->position;
+    while (end < reader->length && reader->text[end] != '"')
+        end += (reader->text[end] == '\\') ? 2 : 1;
+    if (end >= reader->length)
+        return NULL;
+
+    char *out = (char *)arena_alloc(reader->arena, end - reader->position + 1);
+    if (out == NULL)
+        return NULL;
+    size_t used = 0;
+    while (reader->position < end)
+    {
+        char c = reader->text[reader->position++];
+        if ((unsigned char)c < 0x20)
+            return NULL;
+        if (c != '\\')
+        {
+            out[used++] = c;
+            continue;
+        }
+        c = reader->text[reader->position++];
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            out[used++] = c;
+            break;
+        case 'b':
+            out[used++] = '\b';
+            break;
+        case 'f':
+            out[used++] = '\f';
+            break;
+        case 'n':
+            out[used++] = '\n';
+            break;
+        case 'r':
+            out[used++] = '\r';
+            break;
+        case 't':
+            out[used++] = '\t';
+            break;
+        case 'u':
+        {
+            long code = read_hex4(reader);
+            if (code < 0)
+                return NULL;
+            // Um par de substitutos UTF-16 forma um único código
+            if (code >= 0xD800 && code < 0xDC00 && end - reader->position >= 6 &&
+                reader->text[reader->position] == '\\' && reader->text[reader->position + 1] == 'u')
+            {
+                reader->position += 2;
+                long low = read_hex4(reader);
+                if (low < 0xDC00 || low >= 0xE000)
+                    return NULL;
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+            used += encode_utf8(code, out + used);
+            break;
+        }
+        default:
+            return NULL;
+        }
+    }
+    reader->position = end + 1;
+    out[used] = '\0';
+    *length = used;
+    return out;
+}
+
+static json_value *new_value(json_reader *reader, json_type type)
+{
+    json_value *value = (json_value *)arena_alloc(reader->arena, sizeof(json_value));
+    if (value != NULL)
+    {
+        memset(value, 0, sizeof(json_value));
+        value->type = type;
+    }
+    return value;
+}
+
+/// @brief Lê os elementos de um vetor ou os membros de um objeto, depois do colchete ou da chave de abertura.
+static json_value *read_container(json_reader *reader, json_type type)
+{
+    json_value *container = new_value(reader, type);
+    if (container == NULL || ++reader->depth > JSON_MAX_DEPTH)
+        return NULL;
+    char close = (type == JSON_ARRAY) ? ']' : '}';
+    if (expect(reader, close))
+    {
+        reader->depth--;
+        return container;
+    }
+
+    json_value **tail = &container->first;
+    do
+    {
+        const char *key = NULL;
+        if (type == JSON_OBJECT)
+        {
+            size_t key_length;
+            if (!expect(reader, '"') || (key = read_string(reader, &key_length)) == NULL || !expect(reader, ':'))
+                return NULL;
+        }
+        json_value *element = read_value(reader);
+        if (element == NULL)
+            return NULL;
+        element->key = key;
+        *tail = element;
+        tail = &element->next;
+    } while (expect(reader, ','));
+
+    if (!expect(reader, close))
+        return NULL;
+    reader->depth--;
+    return container;
+}
+
+static json_value *read_value(json_reader *reader)
+{
+    skip_whitespace(reader);
+    if (reader->position >= reader->length)
+        return NULL;
+
+    char c = reader->text[reader->position];
+    json_value *value;
+    switch (c)
+    {
+    case '{':
+        reader->position++;
+        return read_container(reader, JSON_OBJECT);
+    case '[':
+        reader->position++;
+        return read_container(reader, JSON_ARRAY);
+    case '"':
+        reader->position++;
+        value = new_value(reader, JSON_STRING);
+        if (value != NULL && (value->string = read_string(reader, &value->length)) == NULL)
+            return NULL;
+        return value;
+    case 't':
+        return expect_word(reader, "true", 4) ? new_value(reader, JSON_TRUE) : NULL;
+    case 'f':
+        return expect_word(reader, "false", 5) ? new_value(reader, JSON_FALSE) : NULL;
+    case 'n':
+        return expect_word(reader, "null", 4) ? new_value(reader, JSON_NULL) : NULL;
+    default:
+    {
+        // strtod() precisa de um texto terminado em '\0': o número é copiado antes
+        char digits[64];
+        size_t length = 0;
+        while (reader->position + length < reader->length && length < sizeof(digits) - 1 &&
+               strchr("+-0123456789.eE", reader->text[reader->position + length]) != NULL)
+            length++;
+        if (length == 0)
+            return NULL;
+        memcpy(digits, reader->text + reader->position, length);
+        digits[length] = '\0';
+        char *end;
+        double number = strtod(digits, &end);
+        if ((size_t)(end - digits) != length)
+            return NULL;
+        reader->position += length;
+        value = new_value(reader, JSON_NUMBER);
+        if (value != NULL)
+            value->number = number;
+        return value;
+    }
+    }
+}
+
+json_value *parse_json(arena *arena, const char *text, size_t length)
+{
+    json_reader reader = {arena, text, length, 0, 0};
+    json_value *value = read_value(&reader);
+    skip_whitespace(&reader);
+    return (reader.position == length) ? value : NULL;
+}
+
+const json_value *json_member(const json_value *value, const char *key)
+{
+    if (value == NULL || value->type != JSON_OBJECT)
+        return NULL;
+    for (const json_value *member = value->first; member != NULL; member = member->next)
+    {
+        if (strcmp(member->key, key) == 0)
+            return member;
+    }
+    return NULL;
+}
+
+int json_member_int(const json_value *value, const char *key, int fallback)
+{
+    const json_value *member = json_member(value, key);
+    return (member != NULL && member->type == JSON_NUMBER) ? (int)member->number : fallback;
+}
+
+size_t utf8_character_length(const char *text, size_t length)
+{
+    const unsigned char *bytes = (const unsigned char *)text;
+    if (length == 0)
+        return 0;
+    if (bytes[0] < 0x80)
+        return 1;
+
+    size_t needed;
+    unsigned int code, minimum;
+    if ((bytes[0] & 0xe0) == 0xc0)
+    {
+        needed = 2;
+        code = bytes[0] & 0x1fu;
+        minimum = 0x80;
+    }
+    else if ((bytes[0] & 0xf0) == 0xe0)
+    {
+        needed = 3;
+        code = bytes[0] & 0x0fu;
+        minimum = 0x800;
+    }
+    else if ((bytes[0] & 0xf8) == 0xf0)
+    {
+        needed = 4;
+        code = bytes[0] & 0x07u;
+        minimum = 0x10000;
+    }
+    else
+        return 0;
+
+    if (length < needed)
+        return 0;
+    for (size_t i = 1; i < needed; i++)
+    {
+        if ((bytes[i] & 0xc0) != 0x80)
+            return 0;
+        code = (code << 6) | (bytes[i] & 0x3fu);
+    }
+    if (code < minimum || code > 0x10ffff || (code >= 0xd800 && code <= 0xdfff))
+        return 0;
+    return needed;
+}
+
+size_t utf8_prefix_length(const char *text, size_t length, size_t limit)
+{
+    if (length <= limit)
+        return length;
+    size_t end = 0;
+    while (end < length)
+    {
+        // Um byte inválido conta sozinho: ele não pertence a nenhum caractere
+        size_t character = utf8_character_length(text + end, length - end);
+        if (character == 0)
+            character = 1;
+        if (end + character > limit)
+            break;
+        end += character;
+    }
+    return end;
+}
+
+void write_json_string(FILE *file, const char *text, size_t length)
+{
+    fputc('"', file);
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 0x80)
+        {
+            size_t character = utf8_character_length(text + i, length - i);
+            if (character > 0)
+            {
+                i += character - 1;
+                continue;
+            }
+        }
+        else if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        // Os trechos sem escapes são escritos de uma vez
+        fwrite(text + start, 1, i - start, file);
+        start = i + 1;
+        switch (c)
+        {
+        case '"':
+            fputs("\\\"", file);
+            break;
+        case '\\':
+            fputs("\\\\", file);
+            break;
+        case '\n':
+            fputs("\\n", file);
+            break;
+        case '\r':
+            fputs("\\r", file);
+            break;
+        case '\t':
+            fputs("\\t", file);
+            break;
+        default:
+            if (c >= 0x80)
+                fputs("\\ufffd", file); // Um byte que não forma um caractere UTF-8
+            else
+                fprintf(file, "\\u%04x", c);
+            break;
+        }
+    }
+    fwrite(text + start, 1, length - start, file);
+    fputc('"', file);
+}
+
+void write_json_value(FILE *file, const json_value *value)
+{
+    if (value == NULL)
+    {
+        fputs("null", file);
+        return;
+    }
+    switch (value->type)
+    {
+    case JSON_NULL:
+        fputs("null", file);
+        break;
+    case JSON_FALSE:
+        fputs("false", file);
+        break;
+    case JSON_TRUE:
+        fputs("true", file);
+        break;
+    case JSON_NUMBER:
+        // Os ids das requisições são inteiros: %.17g os reproduz sem casas decimais
+        fprintf(file, "%.17g", value->number);
+        break;
+    case JSON_STRING:
+        write_json_string(file, value->string, value->length);
+        break;
+    case JSON_ARRAY:
+    case JSON_OBJECT:
+    {
+        fputc(value->type == JSON_ARRAY ? '[' : '{', file);
+        for (const json_value *element = value->first; element != NULL; element = element->next)
+        {
+            if (element != value->first)
+                fputc(',', file);
+            if (value->type == JSON_OBJECT)
+            {
+                write_json_string(file, element->key, strlen(element->key));
+                fputc(':', file);
+            }
+            write_json_value(file, element);
+        }
+        fputc(value->type == JSON_ARRAY ? ']' : '}', file);
+        break;
+    }
+    }
+}
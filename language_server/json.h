@@ -0,0 +1,69 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdio.h>  // FILE
+#include <stddef.h> // size_t
+#include "../memory/arena.h"
+
+/// @brief A maior profundidade de objetos e vetores aninhados aceita pelo leitor.
+#define JSON_MAX_DEPTH 128
+
+/// @brief Os tipos de valor JSON.
+typedef enum json_type
+{
+    JSON_NULL,
+    JSON_FALSE,
+    JSON_TRUE,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+} json_type;
+
+/// @brief Um valor JSON lido de uma mensagem.
+/// @note Os elementos de um vetor e os membros de um objeto formam uma lista ligada por next, na ordem do
+///       texto; os membros guardam o nome em key. Todos os valores e textos ficam na arena da leitura.
+typedef struct json_value
+{
+    json_type type;
+    double number;
+    const char *string; // Já decodificado e terminado em '\0'
+    size_t length;      // O tamanho de string, em bytes
+    const char *key;    // O nome do membro, se o valor está num objeto
+    struct json_value *first;
+    struct json_value *next;
+} json_value;
+
+/// @brief Lê um texto JSON.
+/// @param arena A arena onde os valores são criados.
+/// @param text O texto, que não precisa terminar em '\0'.
+/// @param length O tamanho do texto.
+/// @return O valor lido, ou NULL se o texto não é JSON válido ou não há memória.
+json_value *parse_json(arena *arena, const char *text, size_t length);
+
+/// @brief Procura um membro de um objeto pelo nome.
+/// @return O membro, ou NULL se value não é um objeto ou não tem o membro.
+const json_value *json_member(const json_value *value, const char *key);
+
+/// @brief Lê um número inteiro de um membro de um objeto.
+/// @return O número, ou fallback se o membro não existe ou não é um número.
+int json_member_int(const json_value *value, const char *key, int fallback);
+
+/// @brief O tamanho do caractere UTF-8 no início do texto.
+/// @return De 1 a 4 bytes, ou 0 se o texto não começa com um caractere válido: um byte de continuação solto,
+///         uma sequência incompleta ou mais longa que o necessário, um substituto UTF-16 ou um valor
+///         acima de U+10FFFF.
+size_t utf8_character_length(const char *text, size_t length);
+
+/// @brief O maior prefixo do texto com até limit bytes que não corta um caractere UTF-8 ao meio.
+size_t utf8_prefix_length(const char *text, size_t length, size_t limit);
+
+/// @brief Escreve um texto como uma string JSON, entre aspas e com os caracteres de controle escapados.
+/// @note Os bytes que não formam UTF-8 válido, como os de um caractere cortado ou de um erro léxico num
+///       caractere acentuado, são escritos como U+FFFD, para que a mensagem continue sendo UTF-8 válido.
+void write_json_string(FILE *file, const char *text, size_t length);
+
+/// @brief Escreve um valor JSON lido por parse_json(), como o id de uma requisição.
+void write_json_value(FILE *file, const json_value *value);
+
+#endif // JSON_H
@@ -0,0 +1,460 @@
+#include <stdio.h>   // fprintf(), snprintf(), fgets(), fread(), open_memstream()
+#include <stdlib.h>  // realloc(), calloc(), free(), atol()
+#include <string.h>  // memcpy(), strcmp(), strdup(), strlen()
+#include <strings.h> // strncasecmp()
+#include <time.h>    // clock_gettime()
+#include "json.h"
+#include "language_server.h"
+
+/// @brief O nome do servidor, informado na resposta de "initialize".
+#define LANGUAGE_SERVER_NAME "pminus-language-server"
+
+/// @brief Os prefixos das mensagens de erro, por origem, como nas respostas do servidor de compilação.
+static const char *kind_names[] = {"erro lexico: ", "erro sintatico: ", ""};
+
+static double elapsed_microseconds(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1e6 + (end.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+// ============================================================================
+// MENSAGENS
+// ============================================================================
+
+/// @brief Escreve uma mensagem montada em memória, com o cabeçalho do protocolo.
+/// @note O texto e o tamanho são os registrados em open_memstream(), que só ficam prontos em fclose().
+static void send_body(language_server *server, FILE *body, char **text, size_t *length)
+{
+    if (fclose(body) == 0)
+    {
+        fprintf(server->output, "Content-Length: %zu\r\n\r\n", *length);
+        fwrite(*text, 1, *length, server->output);
+        fflush(server->output);
+    }
+    free(*text);
+}
+
+/// @brief Começa uma resposta a uma requisição; o resultado é escrito em seguida e a resposta é enviada
+///        por finish_message().
+static FILE *begin_response(const json_value *id, char **text, size_t *length)
+{
+    FILE *body = open_memstream(text, length);
+    if (body == NULL)
+        return NULL;
+    fputs("{\"jsonrpc\":\"2.0\",\"id\":", body);
+    write_json_value(body, id);
+    fputs(",\"result\":", body);
+    return body;
+}
+
+static void finish_message(language_server *server, FILE *body, char **text, size_t *length)
+{
+    fputc('}', body);
+    send_body(server, body, text, length);
+}
+
+static void send_error(language_server *server, const json_value *id, int code, const char *message)
+{
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = open_memstream(&text, &length);
+    if (body == NULL)
+        return;
+    fputs("{\"jsonrpc\":\"2.0\",\"id\":", body);
+    write_json_value(body, id);
+    fprintf(body, ",\"error\":{\"code\":%d,\"message\":", code);
+    write_json_string(body, message, strlen(message));
+    fputs("}}", body);
+    send_body(server, body, &text, &length);
+}
+
+static void send_result(language_server *server, const json_value *id, const char *result)
+{
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = begin_response(id, &text, &length);
+    if (body == NULL)
+        return;
+    fputs(result, body);
+    finish_message(server, body, &text, &length);
+}
+
+int read_lsp_message(FILE *input, char **content, size_t *capacity, size_t *length)
+{
+    char header[256];
+    long content_length = -1;
+    for (;;)
+    {
+        if (fgets(header, sizeof(header), input) == NULL)
+            return 0;
+        if (strcmp(header, "\r\n") == 0 || strcmp(header, "\n") == 0)
+            break;
+        if (strncasecmp(header, "Content-Length:", 15) == 0)
+            content_length = atol(header + 15);
+    }
+    if (content_length < 0 || (unsigned long)content_length > LSP_MAX_MESSAGE_LENGTH)
+        return 0;
+
+    if ((size_t)content_length + 1 > *capacity)
+    {
+        char *grown = (char *)realloc(*content, (size_t)content_length + 1);
+        if (grown == NULL)
+            return 0;
+        *content = grown;
+        *capacity = (size_t)content_length + 1;
+    }
+    if (fread(*content, 1, (size_t)content_length, input) != (size_t)content_length)
+        return 0;
+    (*content)[content_length] = '\0';
+    *length = (size_t)content_length;
+    return 1;
+}
+
+// ============================================================================
+// DOCUMENTOS
+// ============================================================================
+
+static open_document *find_document(language_server *server, const json_value *params)
+{
+    const json_value *uri = json_member(json_member(params, "textDocument"), "uri");
+    if (uri == NULL || uri->type != JSON_STRING)
+        return NULL;
+    for (int i = 0; i < server->document_count; i++)
+    {
+        if (strcmp(server->documents[i].uri, uri->string) == 0)
+            return &server->documents[i];
+    }
+    return NULL;
+}
+
+static void write_position(FILE *body, int line, int character)
+{
+    fprintf(body, "{\"line\":%d,\"character\":%d}", line, character);
+}
+
+/// @brief Escreve um erro do documento; o trecho marcado é a linha inteira.
+static void write_diagnostic(FILE *body, int *written, int line, const unit_diagnostic *diagnostic)
+{
+    if ((*written)++ > 0)
+        fputc(',', body);
+    fputs("{\"range\":{\"start\":", body);
+    write_position(body, line - 1, 0);
+    fputs(",\"end\":", body);
+    write_position(body, line, 0);
+    fputs("},\"severity\":1,\"source\":\"p-\",\"message\":", body);
+
+    // Uma mensagem longa é cortada entre dois caracteres, nunca no meio de um caractere acentuado
+    char message[320];
+    size_t prefix = strlen(kind_names[diagnostic->kind]);
+    size_t length = utf8_prefix_length(diagnostic->message, strlen(diagnostic->message), sizeof(message) - prefix);
+    memcpy(message, kind_names[diagnostic->kind], prefix);
+    memcpy(message + prefix, diagnostic->message, length);
+    write_json_string(body, message, prefix + length);
+    fputc('}', body);
+}
+
+/// @brief Publica todos os erros de um documento.
+/// @note As unidades sem erros são puladas e a busca para quando todos os erros foram escritos.
+static void publish_diagnostics(language_server *server, const char *uri, const document *document)
+{
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = open_memstream(&text, &length);
+    if (body == NULL)
+        return;
+    fputs("{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":", body);
+    write_json_string(body, uri, strlen(uri));
+    fputs(",\"diagnostics\":[", body);
+
+    int written = 0;
+    if (document != NULL)
+    {
+        for (int i = 0; i < document->unit_count && written < document->diagnostic_count; i++)
+        {
+            const document_unit *unit = document->units[i];
+            for (int j = 0; j < unit->syntax.count; j++)
+                write_diagnostic(body, &written, unit->first_line + unit->syntax.items[j].line - 1,
+                                 &unit->syntax.items[j]);
+            for (int j = 0; j < unit->semantic.count; j++)
+                write_diagnostic(body, &written, unit->first_line + unit->semantic.items[j].line - 1,
+                                 &unit->semantic.items[j]);
+        }
+
+        // Um programa sem a chave de fechamento termina com um erro de sintaxe no fim do texto
+        if (document->unit_count == 0 || document->units[document->unit_count - 1]->state_after == INSIDE_PROGRAM)
+        {
+            unit_diagnostic missing = {0, SYNTAX_DIAGNOSTIC, (char *)"syntax error"};
+            write_diagnostic(body, &written, document_line_count(document), &missing);
+        }
+    }
+    fputs("]}", body);
+    finish_message(server, body, &text, &length);
+}
+
+static void did_open(language_server *server, const json_value *params)
+{
+    const json_value *item = json_member(params, "textDocument");
+    const json_value *uri = json_member(item, "uri");
+    const json_value *text = json_member(item, "text");
+    if (uri == NULL || uri->type != JSON_STRING || text == NULL || text->type != JSON_STRING)
+        return;
+
+    open_document *open = find_document(server, params);
+    if (open == NULL)
+    {
+        if (server->document_count == server->document_capacity)
+        {
+            int capacity = (server->document_capacity > 0) ? server->document_capacity * 2 : 4;
+            open_document *grown =
+                (open_document *)realloc(server->documents, (size_t)capacity * sizeof(open_document));
+            if (grown == NULL)
+                return;
+            server->documents = grown;
+            server->document_capacity = capacity;
+        }
+        document *created = create_document();
+        char *copy = strdup(uri->string);
+        if (created == NULL || copy == NULL)
+        {
+            destroy_document(created);
+            free(copy);
+            return;
+        }
+        open = &server->documents[server->document_count++];
+        open->uri = copy;
+        open->document = created;
+    }
+    set_document_text(open->document, text->string, text->length);
+    publish_diagnostics(server, open->uri, open->document);
+}
+
+static void did_change(language_server *server, const json_value *params)
+{
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    open_document *open = find_document(server, params);
+    const json_value *changes = json_member(params, "contentChanges");
+    if (open == NULL || changes == NULL || changes->type != JSON_ARRAY)
+        return;
+
+    // As mudanças são aplicadas em ordem, cada uma sobre o texto deixado pela anterior
+    for (const json_value *change = changes->first; change != NULL; change = change->next)
+    {
+        const json_value *text = json_member(change, "text");
+        const json_value *range = json_member(change, "range");
+        if (text == NULL || text->type != JSON_STRING)
+            continue;
+        if (range == NULL)
+        {
+            set_document_text(open->document, text->string, text->length);
+            continue;
+        }
+        const json_value *range_start = json_member(range, "start");
+        const json_value *range_end = json_member(range, "end");
+        size_t start_offset = document_offset(open->document, json_member_int(range_start, "line", 0),
+                                              json_member_int(range_start, "character", 0));
+        size_t end_offset = document_offset(open->document, json_member_int(range_end, "line", 0),
+                                            json_member_int(range_end, "character", 0));
+        edit_document(open->document, start_offset, end_offset, text->string, text->length);
+    }
+    publish_diagnostics(server, open->uri, open->document);
+    record_latency(server->latencies, elapsed_microseconds(&start));
+}
+
+static void did_close(language_server *server, const json_value *params)
+{
+    open_document *open = find_document(server, params);
+    if (open == NULL)
+        return;
+    publish_diagnostics(server, open->uri, NULL);
+    free(open->uri);
+    destroy_document(open->document);
+    *open = server->documents[--server->document_count];
+}
+
+// ============================================================================
+// CONSULTAS
+// ============================================================================
+
+/// @brief Procura o token na posição de uma requisição textDocument/hover ou textDocument/definition.
+static open_document *token_at_position(language_server *server, const json_value *params, document_token *found)
+{
+    open_document *open = find_document(server, params);
+    const json_value *position = json_member(params, "position");
+    if (open == NULL || position == NULL)
+        return NULL;
+    size_t offset = document_offset(open->document, json_member_int(position, "line", 0),
+                                    json_member_int(position, "character", 0));
+    return document_token_at(open->document, offset, found) ? open : NULL;
+}
+
+static void write_range(FILE *body, const document *document, size_t start, size_t end)
+{
+    int line, character;
+    fputs("{\"start\":", body);
+    document_position(document, start, &line, &character);
+    write_position(body, line, character);
+    fputs(",\"end\":", body);
+    document_position(document, end, &line, &character);
+    write_position(body, line, character);
+    fputc('}', body);
+}
+
+/// @brief Responde textDocument/hover: o tipo de uma variável e a linha da declaração, ou o tipo de uma constante.
+static void hover(language_server *server, const json_value *id, const json_value *params)
+{
+    document_token found;
+    open_document *open = token_at_position(server, params, &found);
+    if (open == NULL || (found.type != T_ID && found.type != T_NUMERO_INT && found.type != T_NUMERO_REAL))
+    {
+        send_result(server, id, "null");
+        return;
+    }
+
+    const char *name = open->document->text + found.offset;
+    char contents[320];
+    if (found.type == T_ID)
+    {
+        document_token declaration;
+        symbol *sym = document_declaration(open->document, name, (size_t)found.length, &declaration);
+        if (sym == NULL)
+            snprintf(contents, sizeof(contents), "**%.*s**: nao declarada", found.length, name);
+        else
+            snprintf(contents, sizeof(contents), "**%.*s**: %s\n\nDeclarada na linha %d", found.length, name,
+                     (sym->type == DT_INTEGER) ? "inteiro" : "real", declaration.line);
+    }
+    else
+        snprintf(contents, sizeof(contents), "Constante %s", (found.type == T_NUMERO_INT) ? "inteira" : "real");
+
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = begin_response(id, &text, &length);
+    if (body == NULL)
+        return;
+    fputs("{\"contents\":{\"kind\":\"markdown\",\"value\":", body);
+    write_json_string(body, contents, strlen(contents));
+    fputs("},\"range\":", body);
+    write_range(body, open->document, found.offset, found.offset + (size_t)found.length);
+    fputc('}', body);
+    finish_message(server, body, &text, &length);
+}
+
+/// @brief Responde textDocument/definition: onde a variável sob o cursor é declarada.
+static void definition(language_server *server, const json_value *id, const json_value *params)
+{
+    document_token found, declaration;
+    open_document *open = token_at_position(server, params, &found);
+    if (open == NULL || found.type != T_ID ||
+        document_declaration(open->document, open->document->text + found.offset, (size_t)found.length,
+                             &declaration) == NULL ||
+        declaration.length == 0)
+    {
+        send_result(server, id, "null");
+        return;
+    }
+
+    char *text = NULL;
+    size_t length = 0;
+    FILE *body = begin_response(id, &text, &length);
+    if (body == NULL)
+        return;
+    fputs("{\"uri\":", body);
+    write_json_string(body, open->uri, strlen(open->uri));
+    fputs(",\"range\":", body);
+    write_range(body, open->document, declaration.offset, declaration.offset + (size_t)declaration.length);
+    fputc('}', body);
+    finish_message(server, body, &text, &length);
+}
+
+// ============================================================================
+// SERVIDOR
+// ============================================================================
+
+language_server *create_language_server(FILE *output)
+{
+    language_server *server = (language_server *)calloc(1, sizeof(language_server));
+    if (server == NULL)
+        return NULL;
+    server->output = output;
+    server->message_arena = arena_create(LSP_MESSAGE_BLOCK_SIZE);
+    server->latencies = create_latency_recorder();
+    server->exit_code = 1;
+    if (server->message_arena == NULL || server->latencies == NULL)
+    {
+        destroy_language_server(server);
+        return NULL;
+    }
+    return server;
+}
+
+int handle_message(language_server *server, const char *content, size_t length)
+{
+    arena_reset(server->message_arena);
+    json_value *message = parse_json(server->message_arena, content, length);
+    if (message == NULL || message->type != JSON_OBJECT)
+    {
+        send_error(server, NULL, JSONRPC_PARSE_ERROR, "Mensagem invalida");
+        return 1;
+    }
+
+    const json_value *id = json_member(message, "id");
+    const json_value *method = json_member(message, "method");
+    const json_value *params = json_member(message, "params");
+    if (method == NULL || method->type != JSON_STRING)
+    {
+        // Respostas do editor a requisições do servidor: o servidor não faz requisições
+        if (id == NULL)
+            send_error(server, NULL, JSONRPC_INVALID_REQUEST, "Mensagem sem metodo");
+        return 1;
+    }
+
+    const char *name = method->string;
+    if (strcmp(name, "initialize") == 0)
+        send_result(server, id,
+                    "{\"capabilities\":{\"textDocumentSync\":{\"openClose\":true,\"change\":2},"
+                    "\"hoverProvider\":true,\"definitionProvider\":true},"
+                    "\"serverInfo\":{\"name\":\"" LANGUAGE_SERVER_NAME "\"}}");
+    else if (strcmp(name, "shutdown") == 0)
+    {
+        server->shutdown_requested = 1;
+        send_result(server, id, "null");
+    }
+    else if (strcmp(name, "exit") == 0)
+    {
+        server->exit_code = server->shutdown_requested ? 0 : 1;
+        return 0;
+    }
+    else if (strcmp(name, "textDocument/didOpen") == 0)
+        did_open(server, params);
+    else if (strcmp(name, "textDocument/didChange") == 0)
+        did_change(server, params);
+    else if (strcmp(name, "textDocument/didClose") == 0)
+        did_close(server, params);
+    else if (strcmp(name, "textDocument/hover") == 0 && id != NULL)
+        hover(server, id, params);
+    else if (strcmp(name, "textDocument/definition") == 0 && id != NULL)
+        definition(server, id, params);
+    else if (id != NULL)
+        send_error(server, id, JSONRPC_METHOD_NOT_FOUND, "Metodo nao suportado");
+    // Notificações desconhecidas, como initialized e $/cancelRequest, são ignoradas
+    return 1;
+}
+
+void destroy_language_server(language_server *server)
+{
+    if (server == NULL)
+        return;
+    for (int i = 0; i < server->document_count; i++)
+    {
+        free(server->documents[i].uri);
+        destroy_document(server->documents[i].document);
+    }
+    free(server->documents);
+    if (server->message_arena != NULL)
+        arena_release(server->message_arena);
+    destroy_latency_recorder(server->latencies);
+    free(server);
+}
@@ -0,0 +1,69 @@
+#ifndef LANGUAGE_SERVER_H
+#define LANGUAGE_SERVER_H
+
+#include <stdio.h>  // FILE
+#include <stddef.h> // size_t
+#include "../memory/arena.h"
+#include "../server/latency.h"
+#include "document.h"
+
+/// @brief O maior conteúdo aceito em uma mensagem (64 MiB).
+#define LSP_MAX_MESSAGE_LENGTH (64u * 1024u * 1024u)
+
+/// @brief O tamanho dos blocos da arena onde cada mensagem recebida é lida.
+#define LSP_MESSAGE_BLOCK_SIZE (64 * 1024)
+
+/// @brief Código de erro do JSON-RPC: a mensagem não é JSON válido.
+#define JSONRPC_PARSE_ERROR -32700
+
+/// @brief Código de erro do JSON-RPC: a mensagem não é uma requisição válida.
+#define JSONRPC_INVALID_REQUEST -32600
+
+/// @brief Código de erro do JSON-RPC: o método não é atendido pelo servidor.
+#define JSONRPC_METHOD_NOT_FOUND -32601
+
+/// @brief Um documento aberto pelo editor.
+typedef struct open_document
+{
+    char *uri;
+    document *document;
+} open_document;
+
+/// @brief Um servidor de linguagem (Language Server Protocol) para P-, que conversa por JSON-RPC.
+/// @note Atende textDocument/didOpen, didChange (com trechos ou com o texto inteiro) e didClose, publicando
+///       os erros de cada documento depois de cada mudança, além de textDocument/hover (o tipo de uma
+///       variável) e textDocument/definition (a declaração dela). As posições seguem o protocolo: linhas a
+///       partir de 0 e caracteres em unidades UTF-16.
+typedef struct language_server
+{
+    FILE *output;
+    open_document *documents;
+    int document_count;
+    int document_capacity;
+    arena *message_arena;        // Os valores JSON da mensagem corrente
+    latency_recorder *latencies; // Da chegada de uma mudança até a publicação dos erros, em microssegundos
+    int shutdown_requested;
+    int exit_code; // Depois de "exit": 0 se "shutdown" veio antes, 1 caso contrário
+} language_server;
+
+/// @brief Cria um servidor.
+/// @param output Onde as respostas e as notificações são escritas, já com o cabeçalho Content-Length.
+/// @return O servidor, ou NULL se não houver memória.
+language_server *create_language_server(FILE *output);
+
+/// @brief Lê o conteúdo de uma mensagem do protocolo: os cabeçalhos, uma linha em branco e o conteúdo.
+/// @param content O buffer do conteúdo, reaproveitado entre mensagens e aumentado quando preciso.
+/// @param capacity A capacidade do buffer.
+/// @param length Recebe o tamanho do conteúdo.
+/// @return 1 se uma mensagem foi lida, 0 no fim da entrada ou se a mensagem é inválida.
+int read_lsp_message(FILE *input, char **content, size_t *capacity, size_t *length);
+
+/// @brief Atende uma mensagem (requisição ou notificação) e escreve as respostas.
+/// @param content O conteúdo JSON da mensagem.
+/// @return 1 para continuar, 0 depois da notificação "exit".
+int handle_message(language_server *server, const char *content, size_t length);
+
+/// @brief Libera o servidor e os documentos abertos.
+void destroy_language_server(language_server *server);
+
+#endif // LANGUAGE_SERVER_H
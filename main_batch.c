@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "scanner/scanner.h"
+#include "parser/parser.h"
+#include "semantic/semantic.h"
+#include "semantic/report.h"
+#include "compiler/compiler.h"
+#include "concurrency/thread_pool.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief O resultado da compilação de um arquivo.
+typedef enum job_status
+{
+    JOB_OK,
+    JOB_UNREADABLE,
+    JOB_SYNTAX_ERROR,
+    JOB_SEMANTIC_ERROR,
+    JOB_REPORT_ERROR
+} job_status;
+
+/// @brief Um arquivo a ser compilado e o resultado da sua compilação.
+typedef struct compile_job
+{
+    const char *path;
+    const char *output_directory; // NULL para salvar o relatório ao lado do arquivo
+    compiler **compilers;         // Um compilador por thread do conjunto
+    job_status status;
+    int error_count;
+} compile_job;
+
+/// @brief Monta o caminho do relatório de um arquivo.
+/// @note Sem diretório de saída, o relatório fica ao lado do arquivo, como em main_semantic.c.
+///       Com diretório de saída, as barras do caminho viram '_' para que arquivos de pastas
+///       diferentes com o mesmo nome não se sobrescrevam.
+static void build_report_path(const compile_job *job, char *buffer, size_t size)
+{
+    if (job->output_directory == NULL)
+    {
+        snprintf(buffer, size, "%s_semantic_report.txt", job->path);
+        return;
+    }
+
+    int length = snprintf(buffer, size, "%s/", job->output_directory);
+    for (const char *c = job->path; *c != '\0' && length + 1 < (int)size; c++)
+        buffer[length++] = (*c == '/') ? '_' : *c;
+    snprintf(buffer + length, size - (size_t)length, "_semantic_report.txt");
+}
+
+/// @brief Compila um arquivo com o compilador da thread que executa a tarefa e salva o seu relatório.
+/// @note É executada ao mesmo tempo em várias threads: cada thread tem o seu próprio compilador,
+///       reaproveitado em todos os arquivos que ela compila.
+static void compile_task(void *argument, int worker)
+{
+    compile_job *job = (compile_job *)argument;
+    compiler *compiler = job->compilers[worker];
+
+    const compile_result *result = compile_file(compiler, job->path);
+    if (result == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", job->path);
+        job->status = JOB_UNREADABLE;
+        return;
+    }
+
+    for (int i = 0; i < result->diagnostic_count; i++)
+    {
+        if (result->diagnostics[i].kind != SEMANTIC_DIAGNOSTIC)
+            fprintf(stderr, "%s:%d: %s\n", job->path, result->diagnostics[i].line, result->diagnostics[i].message);
+    }
+
+    if (result->syntax_tree == NULL)
+    {
+        job->status = JOB_SYNTAX_ERROR;
+        return;
+    }
+
+    char report_filename[4096];
+    build_report_path(job, report_filename, sizeof(report_filename));
+    FILE *report = fopen(report_filename, "w");
+    if (report == NULL)
+    {
+        fprintf(stderr, "Erro ao criar arquivo de relatorio: %s\n", report_filename);
+        job->status = JOB_REPORT_ERROR;
+        return;
+    }
+
+    write_report(compiler->analyzer, report);
+    fclose(report);
+    job->error_count = compiler->analyzer->error_count;
+    job->status = compiler->context->is_error         ? JOB_SYNTAX_ERROR
+                  : compiler->analyzer->error_count > 0 ? JOB_SEMANTIC_ERROR
+                                                        : JOB_OK;
+}
+
+/// @brief Lê uma lista de caminhos, um por linha, e os adiciona ao vetor de arquivos.
+/// @return 1 em caso de sucesso, 0 em caso de erro.
+static int read_file_list(const char *list_path, char ***paths, int *count, int *capacity)
+{
+    FILE *list = (strcmp(list_path, "-") == 0) ? stdin : fopen(list_path, "r");
+    if (list == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel abrir a lista %s\n", list_path);
+        return 0;
+    }
+
+    char line[4096];
+    while (fgets(line, sizeof(line), list) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0')
+            continue;
+
+        if (*count == *capacity)
+        {
+            *capacity = (*capacity == 0) ? 256 : *capacity * 2;
+            *paths = (char **)realloc(*paths, (size_t)*capacity * sizeof(char *));
+        }
+        (*paths)[(*count)++] = strdup(line);
+    }
+
+    if (list != stdin)
+        fclose(list);
+    return 1;
+}
+
+/// @brief Compila vários programas P- em paralelo e salva um relatório por arquivo.
+/// @param argc Número de argumentos passados pela linha de comando.
+/// @param argv Opções (-j threads, -o diretório, -l lista) seguidas dos arquivos a compilar.
+/// @return 0 se todos os arquivos foram compilados sem erros, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+
+    int workers = 0;
+    const char *output_directory = NULL;
+    char **paths = NULL;
+    int count = 0;
+    int capacity = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output_directory = argv[++i];
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            if (!read_file_list(argv[++i], &paths, &count, &capacity))
+                return 1;
+        }
+        else
+        {
+            if (count == capacity)
+            {
+                capacity = (capacity == 0) ? 256 : capacity * 2;
+                paths = (char **)realloc(paths, (size_t)capacity * sizeof(char *));
+            }
+            paths[count++] = strdup(argv[i]);
+        }
+    }
+
+    if (count == 0)
+    {
+        fprintf(stderr, "Uso: %s [-j threads] [-o diretorio] [-l lista] <arquivos...>\n", argv[0]);
+        return 1;
+    }
+
+    compile_job *jobs = (compile_job *)calloc((size_t)count, sizeof(compile_job));
+    thread_pool *pool = create_thread_pool(workers);
+    compiler **compilers = (pool != NULL) ? (compiler **)calloc((size_t)pool->worker_count, sizeof(compiler *)) : NULL;
+    if (jobs == NULL || compilers == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+    for (int i = 0; i < pool->worker_count; i++)
+    {
+        compilers[i] = create_compiler();
+        if (compilers[i] == NULL)
+        {
+            fprintf(stderr, "Memoria insuficiente\n");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        jobs[i].path = paths[i];
+        jobs[i].output_directory = output_directory;
+        jobs[i].compilers = compilers;
+        submit_task(pool, compile_task, &jobs[i]);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    run_thread_pool(pool);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    int totals[JOB_REPORT_ERROR + 1] = {0};
+    for (int i = 0; i < count; i++)
+    {
+        totals[jobs[i].status]++;
+        if (jobs[i].status == JOB_SEMANTIC_ERROR)
+            printf("%s: %d erro(s) semantico(s)\n", jobs[i].path, jobs[i].error_count);
+        else if (jobs[i].status == JOB_SYNTAX_ERROR)
+            printf("%s: erro sintatico\n", jobs[i].path);
+    }
+
+    printf("-------------------------------------\n");
+    printf("Arquivos compilados:     %d\n", count);
+    printf("Sem erros:               %d\n", totals[JOB_OK]);
+    printf("Com erros sintaticos:    %d\n", totals[JOB_SYNTAX_ERROR]);
+    printf("Com erros semanticos:    %d\n", totals[JOB_SEMANTIC_ERROR]);
+    printf("Nao lidos ou sem saida:  %d\n", totals[JOB_UNREADABLE] + totals[JOB_REPORT_ERROR]);
+    printf("Threads:                 %d (%ld tarefas roubadas)\n", pool->worker_count, pool->stolen);
+    printf("Tempo:                   %.3f s (%.0f arquivos/s)\n", seconds, count / seconds);
+
+    for (int i = 0; i < pool->worker_count; i++)
+        destroy_compiler(compilers[i]);
+    free(compilers);
+    destroy_thread_pool(pool);
+    for (int i = 0; i < count; i++)
+        free(paths[i]);
+    free(paths);
+    free(jobs);
+
+    return totals[JOB_OK] == count ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>  // printf(), fprintf(), fopen(), fread()
+#include <stdlib.h> // atol(), malloc(), realloc(), free()
+#include <string.h> // strcmp()
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // close()
+#include "server/protocol.h"
+#include "server/latency.h"
+
+/// @brief Lê um arquivo inteiro para a memória.
+/// @return O conteúdo, ou NULL em caso de erro.
+static char *read_source(const char *path, size_t *length)
+{
+    FILE *file = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    size_t capacity = 4096;
+    char *text = (char *)malloc(capacity);
+    *length = 0;
+    while (text != NULL)
+    {
+        *length += fread(text + *length, 1, capacity - *length, file);
+        if (*length < capacity)
+            break;
+        capacity *= 2;
+        char *grown = (char *)realloc(text, capacity);
+        if (grown == NULL)
+            free(text);
+        text = grown;
+    }
+
+    if (file != stdin)
+        fclose(file);
+    return text;
+}
+
+/// @brief Cliente do servidor de compilação.
+/// @param argc Número de argumentos passados pela linha de comando.
+/// @param argv Opções (-s socket, -d apenas erros, -n repetições, -e estatísticas, -q encerrar) e o arquivo.
+/// @return 0 se o programa foi compilado sem erros, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    const char *socket_path = DEFAULT_SOCKET_PATH;
+    const char *path = NULL;
+    char request = REQUEST_COMPILE;
+    long repetitions = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            socket_path = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            repetitions = atol(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0)
+            request = REQUEST_DIAGNOSTICS;
+        else if (strcmp(argv[i], "-e") == 0)
+            request = REQUEST_STATS;
+        else if (strcmp(argv[i], "-q") == 0)
+            request = REQUEST_SHUTDOWN;
+        else
+            path = argv[i];
+    }
+
+    int needs_source = (request == REQUEST_COMPILE || request == REQUEST_DIAGNOSTICS);
+    if ((needs_source && path == NULL) || repetitions < 1)
+    {
+        fprintf(stderr, "Uso: %s [-s socket] [-d] [-n repeticoes] <arquivo> | -e | -q\n", argv[0]);
+        return 1;
+    }
+
+    size_t length = 0;
+    char *source = NULL;
+    if (needs_source && (source = read_source(path, &length)) == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        return 1;
+    }
+
+    int fd = connect_to_server(socket_path);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Nao foi possivel conectar ao servidor em %s\n", socket_path);
+        free(source);
+        return 1;
+    }
+
+    // Com -n, a mesma requisição é repetida na mesma conexão e a latência de ida e volta é medida
+    latency_recorder *latencies = (repetitions > 1) ? create_latency_recorder() : NULL;
+    message_buffer response = {NULL, 0, 0};
+    char answer = RESPONSE_FAILURE;
+    int connected = 1;
+
+    for (long i = 0; i < repetitions && connected; i++)
+    {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        connected = send_message(fd, request, source, (uint32_t)length) && receive_message(fd, &answer, &response);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        if (latencies != NULL)
+            record_latency(latencies, (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3);
+    }
+
+    if (!connected)
+        fprintf(stderr, "Conexao com o servidor perdida\n");
+    else if (latencies == NULL)
+        fwrite(response.data, 1, response.length, stdout);
+    else
+    {
+        latency_summary summary = summarize_latencies(latencies);
+        printf("Requisicoes:     %ld\n", summary.count);
+        printf("Latencia media:  %.1f us\n", summary.mean);
+        printf("Latencia p50:    %.1f us\n", summary.p50);
+        printf("Latencia p90:    %.1f us\n", summary.p90);
+        printf("Latencia p99:    %.1f us\n", summary.p99);
+        printf("Latencia maxima: %.1f us\n", summary.max);
+    }
+
+    destroy_latency_recorder(latencies);
+    free(response.data);
+    free(source);
+    close(fd);
+    return (connected && answer == RESPONSE_OK) ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#include <stdio.h>  // fprintf()
+#include <stdlib.h> // free()
+#include "language_server/language_server.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Servidor de linguagem de P- para editores: lê as mensagens do protocolo da entrada padrão e
+///        escreve as respostas e os erros publicados na saída padrão. Ao terminar, mostra em stderr a
+///        latência entre cada mudança recebida e a publicação dos erros.
+/// @return 0 se o editor pediu shutdown antes de exit, 1 caso contrário.
+int main(void)
+{
+    yydebug = 0;
+    language_server *server = create_language_server(stdout);
+    if (server == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+
+    char *content = NULL;
+    size_t capacity = 0, length = 0;
+    while (read_lsp_message(stdin, &content, &capacity, &length) && handle_message(server, content, length))
+        ;
+
+    latency_summary summary = summarize_latencies(server->latencies);
+    if (summary.count > 0)
+        fprintf(stderr, "Mudancas: %ld, latencia ate os erros (us): media %.1f, p50 %.1f, p99 %.1f, max %.1f\n",
+                summary.count, summary.mean, summary.p50, summary.p99, summary.max);
+
+    int exit_code = server->exit_code;
+    free(content);
+    destroy_language_server(server);
+    return exit_code;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>  // fprintf(), fopen(), fdopen(), fclose()
+#include <stdlib.h> // getenv()
+#include <string.h> // strcmp(), strlen()
+#include <unistd.h> // close(), unlink(), mkstemps()
+#include "compiler/compiler.h"
+#include "backend/codegen_x86_64.h"
+#include "backend/regalloc.h"
+#include "backend/toolchain.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Imprime os erros de compilação em stderr.
+static void print_diagnostics(const char *path, const compile_result *result)
+{
+    static const char *kind_names[] = {"erro lexico", "erro sintatico", "erro semantico"};
+
+    for (int i = 0; i < result->diagnostic_count; i++)
+        fprintf(stderr, "%s:%d: %s: %s\n",
+                path,
+                result->diagnostics[i].line,
+                kind_names[result->diagnostics[i].kind],
+                result->diagnostics[i].message);
+}
+
+/// @brief O nome padrão da saída: o programa sem a extensão .p, com .s se for apenas o assembly.
+static void default_output(const char *path, int assembly_only, char *output, size_t size)
+{
+    size_t length = strlen(path);
+    int has_extension = (length > 2 && strcmp(path + length - 2, ".p") == 0);
+    if (has_extension)
+        length -= 2;
+    snprintf(output, size, "%.*s%s", (int)length, path, assembly_only ? ".s" : (has_extension ? "" : ".out"));
+}
+
+/// @brief Compila um programa P- para um executável x86-64.
+/// @param argc Número de argumentos passados pela linha de comando.
+/// @param argv Opções (-o saída, -S apenas o assembly, -R sem alocação de registradores, -r diretório
+///             do compilador) seguidas do arquivo do programa.
+/// @return 0 se o executável (ou o assembly) foi gerado, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    const char *path = NULL;
+    const char *output = NULL;
+    const char *root = getenv("PMINUS_ROOT");
+    int assembly_only = 0;
+    int use_registers = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-S") == 0)
+            assembly_only = 1;
+        else if (strcmp(argv[i], "-R") == 0)
+            use_registers = 0;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            root = argv[++i];
+        else
+            path = argv[i];
+    }
+
+    if (path == NULL)
+    {
+        fprintf(stderr, "Uso: %s [-o saida] [-S] [-R] [-r raiz] <arquivo>\n", argv[0]);
+        return 1;
+    }
+    if (root == NULL)
+        root = ".";
+
+    char default_path[4096];
+    if (output == NULL)
+    {
+        default_output(path, assembly_only, default_path, sizeof(default_path));
+        output = default_path;
+    }
+
+    compiler *compiler = create_compiler();
+    if (compiler == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+
+    const compile_result *result = compile_file(compiler, path);
+    if (result == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        destroy_compiler(compiler);
+        return 1;
+    }
+    if (result->has_errors)
+    {
+        print_diagnostics(path, result);
+        destroy_compiler(compiler);
+        return 1;
+    }
+
+    resolve_tree(compiler->analyzer);
+    register_allocation *allocation = allocate_registers(compiler->result.adjusted_tree, result->symbols,
+                                                         use_registers ? X86_64_INTEGER_REGISTERS : 0,
+                                                         use_registers ? X86_64_REAL_REGISTERS : 0);
+    if (allocation == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        destroy_compiler(compiler);
+        return 1;
+    }
+
+    // Sem -S, o assembly vai para um arquivo temporário que é removido depois da ligação
+    char assembly_path[] = "/tmp/pminus-XXXXXX.s";
+    FILE *assembly = NULL;
+    if (assembly_only)
+        assembly = fopen(output, "w");
+    else
+    {
+        int fd = mkstemps(assembly_path, 2);
+        assembly = (fd >= 0) ? fdopen(fd, "w") : NULL;
+        if (fd >= 0 && assembly == NULL)
+            close(fd);
+    }
+
+    int ok = 0;
+    if (assembly == NULL)
+        fprintf(stderr, "Nao foi possivel criar o arquivo %s\n", assembly_only ? output : assembly_path);
+    else
+    {
+        ok = generate_x86_64(compiler->result.adjusted_tree, allocation, assembly);
+        ok = (fclose(assembly) == 0) && ok;
+        if (!ok)
+            fprintf(stderr, "Falha ao gerar o assembly\n");
+
+        char error[256];
+        if (ok && !assembly_only && !link_executable(assembly_path, output, root, error, sizeof(error)))
+        {
+            fprintf(stderr, "Falha ao gerar o executavel: %s\n", error);
+            ok = 0;
+        }
+        if (!assembly_only)
+            unlink(assembly_path);
+    }
+
+    destroy_register_allocation(allocation);
+    destroy_compiler(compiler);
+    return ok ? 0 : 1;
+}
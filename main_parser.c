@@ -21,17 +21,18 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    yyin = fopen(argv[1], "r");
-    if (!yyin)
+    parse_context *context = create_parse_context();
+    if (context == NULL || !open_source_file(context->scanner, argv[1]))
     {
         fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", argv[1]);
+        destroy_parse_context(context);
         return 1;
     }
 
     printf("Compilando o arquivo: %s\n", argv[1]);
     printf("-------------------------------------\n");
 
-    syntaxTree = parse();
+    syntaxTree = parse(context);
 
     if (syntaxTree != NULL)
     {
@@ -44,6 +45,6 @@ int main(int argc, char **argv)
         printf("\nNao foi possivel construir a arvore sintatica devido a erros.\n");
     }
 
-    fclose(yyin);
+    destroy_parse_context(context);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include <stdio.h>  // printf(), fprintf()
+#include <string.h> // strcmp()
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // STDIN_FILENO, STDOUT_FILENO
+#include "compiler/compiler.h"
+#include "interpreter/interpreter.h"
+#include "jit/jit.h"
+#include "runtime/program_io.h"
+#include "vm/bytecode.h"
+#include "vm/vm.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief Imprime os erros de compilação em stderr.
+static void print_diagnostics(const char *path, const compile_result *result)
+{
+    static const char *kind_names[] = {"erro lexico", "erro sintatico", "erro semantico"};
+
+    for (int i = 0; i < result->diagnostic_count; i++)
+        fprintf(stderr, "%s:%d: %s: %s\n",
+                path,
+                result->diagnostics[i].line,
+                kind_names[result->diagnostics[i].kind],
+                result->diagnostics[i].message);
+}
+
+/// @brief As formas de executar um programa.
+typedef enum engine
+{
+    TREE_ENGINE,      // Interpretador que percorre a árvore ajustada.
+    VM_ENGINE,        // Máquina virtual com goto calculado.
+    VM_SWITCH_ENGINE, // Máquina virtual com despacho por switch.
+    JIT_ENGINE        // Código de máquina x86-64 gerado em memória.
+} engine;
+
+/// @brief Executa o programa já compilado e resolvido com o motor escolhido.
+/// @return 1 se o programa terminou normalmente, 0 caso contrário.
+/// @param show_time Com o motor JIT, mostra em stderr a latência da compilação até a primeira instrução.
+static int execute(compiler *compiler, engine engine, int use_superinstructions, int list_bytecode, int show_time,
+                   program_io *io, execution_error *error)
+{
+    int frame_size = compiler->analyzer->table.next_address;
+    if (engine == TREE_ENGINE)
+        return interpret_program(compiler->result.adjusted_tree, frame_size, io, error);
+
+    if (engine == JIT_ENGINE)
+    {
+        jit_program *program = compile_jit(compiler->result.adjusted_tree, frame_size);
+        if (program == NULL)
+        {
+            error->line = 0;
+            snprintf(error->message, sizeof(error->message),
+                     jit_supported() ? "memoria insuficiente" : "JIT indisponivel nesta plataforma");
+            return 0;
+        }
+        int finished = run_jit(program, io, error);
+        if (show_time)
+            fprintf(stderr, "Compilacao JIT: %.1f us, primeira instrucao apos %.1f us (%zu bytes de codigo)\n",
+                    program->compile_seconds * 1e6, program->first_instruction_seconds * 1e6, program->length);
+        destroy_jit(program);
+        return finished;
+    }
+
+    bytecode *program = compile_bytecode(compiler->result.adjusted_tree, frame_size, use_superinstructions);
+    if (program == NULL)
+    {
+        error->line = 0;
+        snprintf(error->message, sizeof(error->message), "memoria insuficiente");
+        return 0;
+    }
+    if (list_bytecode)
+        disassemble_bytecode(program, stderr);
+
+    int finished = run_bytecode(program, engine == VM_ENGINE ? THREADED_DISPATCH : SWITCH_DISPATCH, io, error);
+    destroy_bytecode(program);
+    return finished;
+}
+
+/// @brief Compila e executa um programa P-. ler() lê da entrada padrão e mostrar() escreve na saída padrão.
+/// @param argc Número de argumentos passados pela linha de comando.
+/// @param argv Opções (-t tempo de execução, -e motor, -S sem superinstruções, -b listagem do bytecode)
+///             seguidas do arquivo do programa.
+/// @return 0 se o programa foi compilado e executado sem erros, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    const char *path = NULL;
+    int show_time = 0;
+    engine engine = TREE_ENGINE;
+    int use_superinstructions = 1;
+    int list_bytecode = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0)
+            show_time = 1;
+        else if (strcmp(argv[i], "-S") == 0)
+            use_superinstructions = 0;
+        else if (strcmp(argv[i], "-b") == 0)
+            list_bytecode = 1;
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "arvore") == 0)
+                engine = TREE_ENGINE;
+            else if (strcmp(argv[i], "vm") == 0)
+                engine = VM_ENGINE;
+            else if (strcmp(argv[i], "vm-switch") == 0)
+                engine = VM_SWITCH_ENGINE;
+            else if (strcmp(argv[i], "jit") == 0)
+                engine = JIT_ENGINE;
+            else
+            {
+                fprintf(stderr, "Motor desconhecido: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+            path = argv[i];
+    }
+
+    if (path == NULL)
+    {
+        fprintf(stderr, "Uso: %s [-t] [-e arvore|vm|vm-switch|jit] [-S] [-b] <arquivo>\n", argv[0]);
+        return 1;
+    }
+
+    compiler *compiler = create_compiler();
+    if (compiler == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+
+    const compile_result *result = compile_file(compiler, path);
+    if (result == NULL)
+    {
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        destroy_compiler(compiler);
+        return 1;
+    }
+    if (result->has_errors)
+    {
+        print_diagnostics(path, result);
+        destroy_compiler(compiler);
+        return 1;
+    }
+
+    // Os nomes são trocados por endereços do quadro uma única vez, antes da execução
+    resolve_tree(compiler->analyzer);
+
+    program_io *io = create_program_io(STDIN_FILENO, STDOUT_FILENO);
+    if (io == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente\n");
+        destroy_compiler(compiler);
+        return 1;
+    }
+
+    struct timespec start, end;
+    execution_error error;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int finished = execute(compiler, engine, use_superinstructions, list_bytecode, show_time, io, &error);
+    destroy_program_io(io); // Envia a saída pendente antes de qualquer mensagem de erro
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (!finished)
+        fprintf(stderr, "Erro de execucao na linha %d: %s\n", error.line, error.message);
+    if (show_time)
+        fprintf(stderr, "Tempo de execucao: %.3f s\n",
+                (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+
+    destroy_compiler(compiler);
+    return finished ? 0 : 1;
+}
@@ -1,43 +1,83 @@
-#include <stdio.h>   // printf(), fprintf(), fopen(), fclose()
-#include <stdlib.h>  // free()
+#include <stdio.h>   // printf(), fprintf()
+#include <string.h>  // strcmp()
+#include <time.h>    // clock_gettime()
 #include "scanner/scanner.h" // token_type, token, get_token()
 
+/// @brief Consome todos os tokens da entrada sem imprimi-los e mostra a vazão do analisador léxico.
+/// @return A quantidade de erros léxicos encontrados.
+static int measure_throughput(yyscan_t scanner)
+{
+    struct timespec start, end;
+    long tokens = 0;
+    int errors = 0;
+    token current_token;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        current_token = get_token(scanner);
+        tokens++;
+        errors += (current_token.type == T_ERRO);
+    } while (current_token.type != T_EOF);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double megabytes = current_token.offset / (1024.0 * 1024.0);
+
+    printf("Bytes:    %ld\n", current_token.offset);
+    printf("Tokens:   %ld\n", tokens);
+    printf("Tempo:    %.3f s\n", seconds);
+    printf("Vazao:    %.1f MB/s\n", megabytes / seconds);
+    return errors;
+}
+
 /// @brief O ponto de entrada do programa.
 /// @param argc Número de argumentos passados pela linha de comando.
 /// @param argv Array de strings contendo os argumentos da linha de comando.
 ///             O primeiro elemento (argv[0]) normalmente é o nome do programa.
+///             Com a opção -t, os tokens não são impressos e a vazão do analisador é medida.
 /// @return O código de saída do programa: 0 em caso de sucesso, diferente de 0 em caso de erro.
 int main(int argc, char **argv)
 {
+    int throughput_mode = (argc >= 3 && strcmp(argv[1], "-t") == 0);
+    const char *path = throughput_mode ? argv[2] : argv[1];
+
     // Verifica se um arquivo foi fornecido na linha de comando
-    if (argc < 2)
+    if (argc < 2 || path == NULL)
     {
-        fprintf(stderr, "Uso: %s <arquivo_de_entrada>\n", argv[0]);
+        fprintf(stderr, "Uso: %s [-t] <arquivo_de_entrada>\n", argv[0]);
         return 1;
     }
 
     // Abre o arquivo P-
-    yyin = fopen(argv[1], "r"); // yyin é uma variável global definida pelo Flex.
-    if (!yyin)
+    yyscan_t scanner = create_scanner();
+    if (scanner == NULL || !open_source_file(scanner, path)) // Mapeia o arquivo em memória, ou lê por streaming
     {
-        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", argv[1]);
+        fprintf(stderr, "Nao foi possivel abrir o arquivo %s\n", path);
+        destroy_scanner(scanner);
         return 1;
     }
 
+    if (throughput_mode)
+    {
+        int errors = measure_throughput(scanner);
+        destroy_scanner(scanner);
+        return errors != 0;
+    }
+
     token current_token;
 
     // Colete tokens até encontrar o fim do arquivo
     do
     {
-        current_token = get_token();
+        current_token = get_token(scanner);
+        if (current_token.type == T_ERRO)
+            fprintf(stderr, "Erro lexico na linha %d: Caractere inesperado '%s'\n", current_token.line, current_token.lexeme);
         print_token(&current_token);
-
-        // Libere a memória alocada por strdup() dentro do Flex
-        free(current_token.lexeme);
     } while (current_token.type != T_EOF);
 
-    // Fecha o arquivo P-
-    fclose(yyin);
+    // Fecha o arquivo P- e libera o analisador léxico
+    destroy_scanner(scanner);
 
     return 0;
-}
\ No newline at end of file
+}
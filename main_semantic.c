@@ -1,31 +1,137 @@
 #include <stdio.h>
+#include <stdlib.h> // malloc(), realloc(), free()
+#include <string.h> // strcmp()
 #include "parser/parser.h"
 #include "semantic/semantic.h"
+#include "semantic/report.h"
+#include "cache/cache.h"
 
 /// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
 extern int yydebug;
 
+/// @brief Lê um arquivo inteiro para a memória, com os dois bytes extras que open_source_buffer() exige.
+/// @return O conteúdo, ou NULL em caso de erro.
+static char *read_source(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    size_t capacity = 4096;
+    char *text = (char *)malloc(capacity);
+    *length = 0;
+    while (text != NULL)
+    {
+        *length += fread(text + *length, 1, capacity - 2 - *length, file);
+        if (*length < capacity - 2)
+            break;
+        capacity *= 2;
+        char *grown = (char *)realloc(text, capacity);
+        if (grown == NULL)
+            free(text);
+        text = grown;
+    }
+
+    fclose(file);
+    return text;
+}
+
 int main(int argc, char **argv)
 {
     yydebug = 0;
-    
-    if (argc < 2)
+    const char *path = NULL;
+    const char *cache_directory = NULL;
+    report_options options = default_report_options();
+    int quiet = 0;
+    int valid = 1;
+
+    for (int i = 1; i < argc; i++)
     {
-        fprintf(stderr, "Uso: %s <arquivo_de_entrada>\n", argv[0]);
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            cache_directory = argv[++i];
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+            valid &= parse_report_format(argv[++i], &options.format);
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+            valid &= skip_report_sections(argv[++i], &options.sections);
+        else if (strcmp(argv[i], "-q") == 0)
+            quiet = 1;
+        else
+            path = argv[i];
+    }
+
+    if (path == NULL || !valid)
+    {
+        fprintf(stderr,
+                "Uso: %s [-c diretorio_do_cache] [-f texto|json|binario] [-x secoes] [-q] <arquivo_de_entrada>\n"
+                "  -x: secoes omitidas, separadas por virgulas: arvores, original, ajustada, simbolos, erros,\n"
+                "      otimizacoes, ri\n"
+                "  -q: nao mostra o relatorio no console\n",
+                argv[0]);
         return 1;
     }
-    
-    yyin = fopen(argv[1], "r");
-    if (!yyin)
+
+    // Só o texto vai também para o console; JSON e binário são para ferramentas e ficam só no arquivo
+    options.console = !quiet && options.format == REPORT_TEXT;
+
+    // Com o cache, a fonte é lida uma vez: os mesmos bytes dão a chave e vão para o analisador léxico
+    program_cache cache;
+    char *source = NULL;
+    size_t length = 0;
+    if (cache_directory != NULL)
+    {
+        if (!open_program_cache(&cache, cache_directory))
+        {
+            fprintf(stderr, "Nao foi possivel usar o diretorio de cache %s\n", cache_directory);
+            return 1;
+        }
+        source = read_source(path, &length);
+        if (source == NULL)
+        {
+            fprintf(stderr, "Não foi possível abrir o arquivo %s\n", path);
+            return 1;
+        }
+    }
+
+    char report_filename[256];
+    snprintf(report_filename, sizeof(report_filename), "%s%s", path, report_file_suffix(options.format));
+
+    cache_key key;
+    cached_program cached;
+    if (source != NULL)
     {
-        fprintf(stderr, "Não foi possível abrir o arquivo %s\n", argv[1]);
+        key = compute_cache_key(source, length);
+        if (lookup_program(&cache, key, &cached))
+        {
+            // Sem análise léxica, sintática e semântica: o relatório vem do arquivo mapeado
+            printf("Compilando o arquivo: %s\n", path);
+            printf("-------------------------------------\n");
+            printf("\nConstrucao da arvore sintatica finalizada.\n");
+            printf("-------------------------------------\n");
+            generate_cached_report(&cached, report_filename, &options);
+            printf("\n-------------------------------------\n");
+            printf("Analise semantica concluida. Relatorio salvo em: %s\n", report_filename);
+            printf("Cache: acerto (%zu bytes lidos)\n", cache.stats.bytes_read);
+            release_cached_program(&cached);
+            free(source);
+            return 0;
+        }
+    }
+
+    parse_context *context = create_parse_context();
+    int opened = (context != NULL) && ((source != NULL) ? open_source_buffer(context->scanner, source, length)
+                                                        : open_source_file(context->scanner, path));
+    if (!opened)
+    {
+        fprintf(stderr, "Não foi possível abrir o arquivo %s\n", path);
+        destroy_parse_context(context);
+        free(source);
         return 1;
     }
-    
-    printf("Compilando o arquivo: %s\n", argv[1]);
+
+    printf("Compilando o arquivo: %s\n", path);
     printf("-------------------------------------\n");
-    
-    tree_node *syntaxTree = parse();
+
+    tree_node *syntaxTree = parse(context);
 
     if (syntaxTree != NULL)
     {
@@ -33,22 +139,29 @@ int main(int argc, char **argv)
         printf("-------------------------------------\n");
 
         // Análise semântica
-        semantic_analyzer *analyzer = create_semantic_analyzer(syntaxTree);
+        semantic_analyzer *analyzer = create_semantic_analyzer(syntaxTree, context->arena);
         analyze_semantics(analyzer);
 
         // Gerar relatório
-        char report_filename[256];
-        snprintf(report_filename, sizeof(report_filename), "%s_semantic_report.txt", argv[1]);
-        generate_report(analyzer, report_filename);
+        generate_report(analyzer, report_filename, &options);
 
         printf("\n-------------------------------------\n");
         printf("Analise semantica concluida. Relatorio salvo em: %s\n", report_filename);
+
+        // Programas com erros léxicos ou sintáticos não são guardados: os erros só aparecem na análise
+        if (source != NULL)
+        {
+            int stored = context->error_count == 0 && !context->is_error && store_program(&cache, key, analyzer);
+            printf("Cache: falha (%s)\n", stored ? "resultado guardado" : "resultado nao guardado");
+        }
+        destroy_semantic_analyzer(analyzer);
     }
     else
     {
         printf("\nNao foi possivel construir a arvore sintatica devido a erros.\n");
     }
 
-    fclose(yyin);
+    destroy_parse_context(context);
+    free(source);
     return 0;
-}
\ No newline at end of file
+}
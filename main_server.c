@@ -0,0 +1,338 @@
+#include <errno.h>      // errno, EINTR
+#include <pthread.h>    // pthread_create(), pthread_detach(), pthread_cond_wait()
+#include <signal.h>     // sigaction()
+#include <stdio.h>      // printf(), fprintf(), open_memstream()
+#include <stdlib.h>     // malloc(), free()
+#include <string.h>     // strcmp(), strlen()
+#include <time.h>       // clock_gettime()
+#include <unistd.h>     // close(), unlink()
+#include <sys/socket.h> // socket(), bind(), listen(), accept(), shutdown()
+#include <sys/un.h>     // sockaddr_un
+#include "compiler/compiler.h"
+#include "semantic/report.h"
+#include "server/protocol.h"
+#include "server/latency.h"
+
+/// @brief Variável de depuração do Bison. 0 desativa o debug trace, 1 ativa o debug trace
+extern int yydebug;
+
+/// @brief O estado compartilhado por todas as conexões do servidor.
+typedef struct compile_server
+{
+    int listen_fd;
+    latency_recorder *latencies;
+    pthread_mutex_t lock;                // Protege os contadores e a lista de conexões.
+    pthread_cond_t idle;                 // Sinalizada quando uma conexão termina.
+    long connections;                    // Total de conexões aceitas.
+    long active;                         // Conexões abertas no momento.
+    struct connection *open_connections; // Para encerrá-las junto com o servidor.
+} compile_server;
+
+/// @brief Uma conexão e o servidor que a aceitou.
+typedef struct connection
+{
+    compile_server *server;
+    int fd;
+    struct connection *next; // Na lista de conexões abertas do servidor.
+    struct connection *previous;
+} connection;
+
+/// @brief Indica que o servidor deve parar de aceitar conexões.
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int signal_number)
+{
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+static double elapsed_microseconds(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1e6 + (end.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+/// @brief Compila o programa recebido e escreve os erros e, se pedido, o relatório na resposta.
+/// @return O tipo da resposta.
+static char answer_compile(compiler *compiler, const message_buffer *request, int with_report, FILE *response)
+{
+    static const char *kind_names[] = {"erro lexico: ", "erro sintatico: ", ""};
+
+    const compile_result *result = compile_source(compiler, request->data, request->length);
+    if (result == NULL)
+    {
+        fprintf(response, "Memoria insuficiente\n");
+        return RESPONSE_FAILURE;
+    }
+
+    for (int i = 0; i < result->diagnostic_count; i++)
+        fprintf(response, "Linha %d: %s%s\n",
+                result->diagnostics[i].line,
+                kind_names[result->diagnostics[i].kind],
+                result->diagnostics[i].message);
+
+    if (with_report && result->syntax_tree != NULL)
+        write_report(compiler->analyzer, response);
+
+    return result->has_errors ? RESPONSE_ERRORS : RESPONSE_OK;
+}
+
+/// @brief Escreve na resposta as estatísticas de latência do servidor.
+static void answer_stats(compile_server *server, FILE *response)
+{
+    latency_summary summary = summarize_latencies(server->latencies);
+
+    pthread_mutex_lock(&server->lock);
+    long connections = server->connections;
+    long active = server->active;
+    pthread_mutex_unlock(&server->lock);
+
+    fprintf(response, "Requisicoes:     %ld\n", summary.count);
+    fprintf(response, "Conexoes:        %ld (%ld ativas)\n", connections, active);
+    fprintf(response, "Latencia media:  %.1f us\n", summary.mean);
+    fprintf(response, "Latencia p50:    %.1f us\n", summary.p50);
+    fprintf(response, "Latencia p90:    %.1f us\n", summary.p90);
+    fprintf(response, "Latencia p99:    %.1f us\n", summary.p99);
+    fprintf(response, "Latencia maxima: %.1f us\n", summary.max);
+}
+
+/// @brief Acrescenta uma conexão à lista de conexões abertas do servidor.
+/// @note Chamada com o lock do servidor.
+static void add_connection(connection *client)
+{
+    compile_server *server = client->server;
+    client->previous = NULL;
+    client->next = server->open_connections;
+    if (server->open_connections != NULL)
+        server->open_connections->previous = client;
+    server->open_connections = client;
+    server->connections++;
+    server->active++;
+}
+
+/// @brief Retira uma conexão da lista de conexões abertas do servidor.
+/// @note Chamada com o lock do servidor.
+static void remove_connection(connection *client)
+{
+    compile_server *server = client->server;
+    if (client->previous != NULL)
+        client->previous->next = client->next;
+    else
+        server->open_connections = client->next;
+    if (client->next != NULL)
+        client->next->previous = client->previous;
+    server->active--;
+}
+
+/// @brief Encerra as conexões abertas e espera as suas threads terminarem.
+/// @note As threads que esperam uma requisição acordam com o fim da leitura; as que estão compilando
+///       terminam a requisição atual. Depois disso nenhuma thread usa o estado do servidor.
+static void close_connections(compile_server *server)
+{
+    pthread_mutex_lock(&server->lock);
+    for (connection *client = server->open_connections; client != NULL; client = client->next)
+        shutdown(client->fd, SHUT_RDWR);
+    while (server->active > 0)
+        pthread_cond_wait(&server->idle, &server->lock);
+    pthread_mutex_unlock(&server->lock);
+}
+
+/// @brief Atende as requisições de uma conexão até que o cliente a feche.
+/// @note Cada conexão tem o seu próprio compilador, reaproveitado em todas as suas requisições,
+///       de modo que clientes simultâneos não compartilham nenhum estado de compilação.
+static void *serve_connection(void *argument)
+{
+    connection *self = (connection *)argument;
+    compile_server *server = self->server;
+    compiler *compiler = create_compiler();
+    message_buffer request = {NULL, 0, 0};
+    char type;
+
+    while (compiler != NULL && receive_message(self->fd, &type, &request))
+    {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        char *text = NULL;
+        size_t length = 0;
+        FILE *response = open_memstream(&text, &length);
+        if (response == NULL)
+            break;
+
+        char answer;
+        switch (type)
+        {
+        case REQUEST_COMPILE:
+        case REQUEST_DIAGNOSTICS:
+            answer = answer_compile(compiler, &request, type == REQUEST_COMPILE, response);
+            break;
+        case REQUEST_STATS:
+            answer_stats(server, response);
+            answer = RESPONSE_OK;
+            break;
+        case REQUEST_SHUTDOWN:
+            fprintf(response, "Servidor encerrado\n");
+            answer = RESPONSE_OK;
+            break;
+        default:
+            fprintf(response, "Requisicao desconhecida '%c'\n", type);
+            answer = RESPONSE_FAILURE;
+            break;
+        }
+        fclose(response);
+
+        int sent = send_message(self->fd, answer, text, (uint32_t)length);
+        free(text);
+        if (type == REQUEST_SHUTDOWN)
+        {
+            // Só depois da resposta: a thread principal sai do laço e o processo termina logo em seguida
+            stop_requested = 1;
+            shutdown(server->listen_fd, SHUT_RDWR); // Acorda o accept() da thread principal
+        }
+        if (type == REQUEST_COMPILE || type == REQUEST_DIAGNOSTICS)
+            record_latency(server->latencies, elapsed_microseconds(&start));
+        if (!sent)
+            break;
+    }
+
+    destroy_compiler(compiler);
+    free(request.data);
+
+    // A conexão sai da lista antes de o descritor ser fechado, para que o encerramento não o reutilize
+    pthread_mutex_lock(&server->lock);
+    remove_connection(self);
+    pthread_cond_signal(&server->idle);
+    pthread_mutex_unlock(&server->lock);
+    close(self->fd);
+    free(self);
+    return NULL;
+}
+
+/// @brief Cria o socket do servidor no caminho indicado.
+/// @return O socket, ou -1 em caso de erro.
+static int create_listen_socket(const char *path)
+{
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Caminho do socket muito longo: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path, strlen(path) + 1);
+
+    unlink(path); // Remove o socket deixado por uma execução anterior
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 128) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Servidor de compilação: mantém o compilador carregado e atende requisições por um socket Unix.
+/// @param argc Número de argumentos passados pela linha de comando.
+/// @param argv Opções: -s caminho do socket.
+/// @return 0 se o servidor foi encerrado normalmente, 1 caso contrário.
+int main(int argc, char **argv)
+{
+    yydebug = 0;
+    const char *socket_path = DEFAULT_SOCKET_PATH;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            socket_path = argv[++i];
+        else
+        {
+            fprintf(stderr, "Uso: %s [-s socket]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    compile_server server = {-1, create_latency_recorder(), PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                             0, 0, NULL};
+    server.listen_fd = create_listen_socket(socket_path);
+    if (server.latencies == NULL || server.listen_fd < 0)
+    {
+        fprintf(stderr, "Nao foi possivel criar o socket %s\n", socket_path);
+        if (server.listen_fd >= 0)
+            close(server.listen_fd);
+        destroy_latency_recorder(server.latencies);
+        return 1;
+    }
+
+    // Sem SA_RESTART, um sinal interrompe o accept() e o laço percebe o pedido de parada
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN); // Um cliente que desconecta não derruba o servidor
+
+    // As threads das conexões não recebem os sinais de parada; apenas a thread principal
+    sigset_t stop_signals, previous;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+
+    printf("Servidor de compilacao ouvindo em %s\n", socket_path);
+    fflush(stdout);
+
+    while (!stop_requested)
+    {
+        int fd = accept(server.listen_fd, NULL, NULL);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            break; // O socket foi fechado por um pedido de encerramento
+        }
+
+        connection *client = (connection *)malloc(sizeof(connection));
+        if (client == NULL)
+        {
+            close(fd);
+            continue;
+        }
+        client->server = &server;
+        client->fd = fd;
+
+        pthread_mutex_lock(&server.lock);
+        add_connection(client);
+        pthread_mutex_unlock(&server.lock);
+
+        pthread_t thread;
+        pthread_sigmask(SIG_BLOCK, &stop_signals, &previous);
+        int created = pthread_create(&thread, NULL, serve_connection, client);
+        pthread_sigmask(SIG_SETMASK, &previous, NULL);
+        if (created != 0)
+        {
+            pthread_mutex_lock(&server.lock);
+            remove_connection(client);
+            pthread_mutex_unlock(&server.lock);
+            close(fd);
+            free(client);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+
+    // As conexões ainda abertas são encerradas antes de o registro de latências ser liberado
+    close_connections(&server);
+
+    latency_summary summary = summarize_latencies(server.latencies);
+    printf("Requisicoes atendidas: %ld (p50 %.1f us, p99 %.1f us)\n", summary.count, summary.p50, summary.p99);
+
+    close(server.listen_fd);
+    unlink(socket_path);
+    destroy_latency_recorder(server.latencies);
+    return 0;
+}
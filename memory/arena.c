@@ -0,0 +1,133 @@
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // memcpy(), strlen()
+#include "arena.h"
+
+/// @brief Alinhamento garantido para todas as alocações da arena.
+#define ARENA_ALIGNMENT 16
+
+/// @brief Arredonda um tamanho para o próximo múltiplo do alinhamento.
+#define ARENA_ALIGN(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/// @brief Aloca um novo bloco e o coloca no topo da lista de blocos da arena.
+/// @param arena A arena.
+/// @param capacity A capacidade mínima do bloco.
+/// @return O bloco criado, ou NULL se não houver memória.
+static arena_block *arena_push_block(arena *arena, size_t capacity);
+
+arena *arena_create(size_t block_size)
+{
+    arena *new_arena = (arena *)malloc(sizeof(arena));
+    if (new_arena == NULL)
+        return NULL;
+
+    new_arena->current = NULL;
+    new_arena->block_size = ARENA_ALIGN(block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE);
+    new_arena->reserved = 0;
+    new_arena->allocated = 0;
+    return new_arena;
+}
+
+static arena_block *arena_push_block(arena *arena, size_t capacity)
+{
+    arena_block *block = (arena_block *)malloc(sizeof(arena_block) + capacity);
+    if (block == NULL)
+        return NULL;
+
+    block->capacity = capacity;
+    block->used = 0;
+    block->next = arena->current;
+    arena->current = block;
+    arena->reserved += sizeof(arena_block) + capacity;
+    return block;
+}
+
+void *arena_alloc(arena *arena, size_t size)
+{
+    size = ARENA_ALIGN(size);
+    arena->allocated += size;
+
+#ifdef ARENA_USE_MALLOC
+    // Modo de comparação: uma chamada a malloc() por objeto, como antes da arena.
+    arena_block *single = arena_push_block(arena, size);
+    return single != NULL ? single->data : NULL;
+#else
+    arena_block *block = arena->current;
+    if (block != NULL && block->capacity - block->used >= size)
+    {
+        void *memory = block->data + block->used;
+        block->used += size;
+        return memory;
+    }
+
+    // Objetos grandes recebem um bloco próprio para não desperdiçar o bloco atual
+    if (size > arena->block_size / 4 && block != NULL)
+    {
+        arena_block *large = (arena_block *)malloc(sizeof(arena_block) + size);
+        if (large == NULL)
+            return NULL;
+        large->capacity = size;
+        large->used = size;
+        large->next = block->next;
+        block->next = large;
+        arena->reserved += sizeof(arena_block) + size;
+        return large->data;
+    }
+
+    block = arena_push_block(arena, size > arena->block_size ? size : arena->block_size);
+    if (block == NULL)
+        return NULL;
+    block->used = size;
+    return block->data;
+#endif
+}
+
+char *arena_strndup(arena *arena, const char *string, size_t length)
+{
+    char *copy = (char *)arena_alloc(arena, length + 1);
+    if (copy == NULL)
+        return NULL;
+
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+char *arena_strdup(arena *arena, const char *string)
+{
+    return arena_strndup(arena, string, strlen(string));
+}
+
+void arena_reset(arena *arena)
+{
+    arena_block *kept = arena->current;
+    arena->allocated = 0;
+    if (kept == NULL)
+        return;
+
+    arena_block *block = kept->next;
+    while (block != NULL)
+    {
+        arena_block *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    kept->next = NULL;
+    kept->used = 0;
+    arena->reserved = sizeof(arena_block) + kept->capacity;
+}
+
+void arena_release(arena *arena)
+{
+    if (arena == NULL)
+        return;
+
+    arena_block *block = arena->current;
+    while (block != NULL)
+    {
+        arena_block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
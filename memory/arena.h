@@ -0,0 +1,63 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/// @brief Tamanho padrão de cada bloco da arena (1 MiB).
+#define ARENA_DEFAULT_BLOCK_SIZE (1024 * 1024)
+
+/// @brief Um bloco de memória contígua pertencente a uma arena.
+typedef struct arena_block
+{
+    struct arena_block *next; // Bloco alocado anteriormente.
+    size_t capacity;          // Quantidade de bytes disponíveis em data.
+    size_t used;              // Quantidade de bytes já entregues.
+    unsigned char data[];     // Área de alocação.
+} arena_block;
+
+/// @brief Alocador por incremento de ponteiro com tempo de vida de uma compilação.
+/// @note Os objetos alocados não são liberados individualmente: toda a memória
+///       é devolvida de uma só vez por arena_release().
+typedef struct arena
+{
+    arena_block *current; // Bloco onde as próximas alocações são feitas.
+    size_t block_size;    // Capacidade dos novos blocos.
+    size_t reserved;      // Total de bytes obtidos do sistema.
+    size_t allocated;     // Total de bytes entregues aos usuários da arena.
+} arena;
+
+/// @brief Cria uma arena vazia.
+/// @param block_size A capacidade de cada bloco, em bytes.
+/// @return A arena criada, ou NULL se não houver memória.
+arena *arena_create(size_t block_size);
+
+/// @brief Reserva memória alinhada dentro da arena.
+/// @param arena A arena.
+/// @param size A quantidade de bytes.
+/// @return Um ponteiro para a memória reservada, ou NULL se não houver memória.
+void *arena_alloc(arena *arena, size_t size);
+
+/// @brief Copia uma string para dentro da arena.
+/// @param arena A arena.
+/// @param string A string terminada em '\0'.
+/// @return A cópia da string.
+char *arena_strdup(arena *arena, const char *string);
+
+/// @brief Copia os primeiros caracteres de uma string para dentro da arena.
+/// @param arena A arena.
+/// @param string A string de origem.
+/// @param length A quantidade de caracteres a copiar.
+/// @return A cópia, terminada em '\0'.
+char *arena_strndup(arena *arena, const char *string, size_t length);
+
+/// @brief Esvazia a arena para reutilizá-la em outra compilação.
+/// @note O bloco mais recente é mantido, de modo que compilações pequenas seguidas não pedem memória ao sistema.
+///       Todos os objetos alocados anteriormente deixam de ser válidos.
+/// @param arena A arena.
+void arena_reset(arena *arena);
+
+/// @brief Libera de uma só vez toda a memória da arena, inclusive a própria arena.
+/// @param arena A arena.
+void arena_release(arena *arena);
+
+#endif // ARENA_H
@@ -0,0 +1,430 @@
+#include <stdlib.h> // calloc(), realloc(), free()
+#include <string.h> // memset(), strcmp()
+#include "optimizer.h"
+
+/// @brief Uma expressão já calculada, disponível enquanto nenhuma das variáveis que ela lê for atribuída.
+typedef struct available_expression
+{
+    tree_node *expression; // A primeira ocorrência
+    tree_node **slot;      // Onde a primeira ocorrência está, para trocá-la pela leitura da temporária
+    tree_node *statement;  // O comando da primeira ocorrência, antes do qual a temporária é atribuída
+    tree_node **link;      // Onde o comando estava na sua lista quando a expressão foi registrada
+    int inner;             // As expressões registradas dentro desta ficam na pilha a partir deste índice
+    unsigned int hash;
+    int created; // O relógio quando a expressão foi registrada
+    const char *temporary;
+    int next; // A próxima expressão do mesmo balde, ou -1
+} available_expression;
+
+/// @brief O estado da eliminação de subexpressões comuns.
+/// @note As expressões disponíveis formam uma pilha: as registradas numa lista de comandos saem dela
+///       no fim da lista, e cada balde aponta para a mais recente, que é a primeira a sair. Cada
+///       atribuição ou ler() avança o relógio e guarda o novo valor em assigned_at; uma expressão só
+///       vale enquanto nenhuma das variáveis que ela lê for atribuída depois do seu registro.
+typedef struct common_subexpressions
+{
+    semantic_analyzer *analyzer;
+    int variable_count;
+    int *assigned_at;
+    int clock;
+    available_expression *available;
+    int count;
+    int capacity;
+    int *buckets;
+    int bucket_count; // Uma potência de 2
+    const tree_node **definitions; // A expressão de cada temporária $c, pela ordem de criação
+    int definition_count;
+    int definition_capacity;
+    int apply; // 0 só procura uma expressão repetida; 1 troca as repetições pela temporária
+    int found;
+    int failed;
+} common_subexpressions;
+
+/// @brief Troca a leitura de uma temporária criada por esta otimização pela expressão que ela guarda.
+/// @note É o expression_expander de expression_hash(): a expressão registrada continua com o mesmo hash
+///       quando uma parte dela passa a ser lida de uma temporária.
+static const tree_node *expand(const void *context, const tree_node *node)
+{
+    const common_subexpressions *state = (const common_subexpressions *)context;
+    while (node != NULL && node->kind.exp == IDENTIFIER_EXPRESSION)
+    {
+        int index = symbol_index(state->analyzer, node->attribute.name) - state->variable_count;
+        if (index < 0 || index >= state->definition_count)
+            break;
+        node = state->definitions[index];
+    }
+    return node;
+}
+
+/// @brief Como same_expression(), mas vendo através das temporárias.
+static int equivalent(const common_subexpressions *state, const tree_node *a, const tree_node *b)
+{
+    a = expand(state, a);
+    b = expand(state, b);
+    if (a == b)
+        return 1;
+    if (a == NULL || b == NULL || a->kind.exp != b->kind.exp)
+        return 0;
+    switch (a->kind.exp)
+    {
+    case IDENTIFIER_EXPRESSION:
+        return strcmp(a->attribute.name, b->attribute.name) == 0;
+    case CONSTANT_EXPRESSION:
+        return same_expression(a, b);
+    case CONVERSION_EXPRESSION:
+        return equivalent(state, a->child[0], b->child[0]);
+    default:
+        return a->attribute.op == b->attribute.op && equivalent(state, a->child[0], b->child[0]) &&
+               equivalent(state, a->child[1], b->child[1]);
+    }
+}
+
+/// @brief O valor do relógio na última atribuição a uma variável lida pela expressão (0 se nenhuma).
+static int last_assignment(const common_subexpressions *state, const tree_node *node)
+{
+    node = expand(state, node);
+    if (node == NULL || node->kind.exp == CONSTANT_EXPRESSION)
+        return 0;
+    if (node->kind.exp == IDENTIFIER_EXPRESSION)
+    {
+        int index = symbol_index(state->analyzer, node->attribute.name);
+        return (index >= 0 && index < state->variable_count) ? state->assigned_at[index] : 0;
+    }
+    int left = last_assignment(state, node->child[0]);
+    int right = last_assignment(state, node->child[1]);
+    return (left > right) ? left : right;
+}
+
+static int reads_variable(const tree_node *node)
+{
+    if (node == NULL || node->kind.exp == CONSTANT_EXPRESSION)
+        return 0;
+    return node->kind.exp == IDENTIFIER_EXPRESSION || reads_variable(node->child[0]) || reads_variable(node->child[1]);
+}
+
+/// @brief Só as operações aritméticas e conversões que leem alguma variável são reaproveitadas. As que
+///        podem falhar ficam onde estão, para que o erro de execução aconteça no mesmo ponto.
+static int is_candidate(const tree_node *node)
+{
+    return (node->kind.exp == CONVERSION_EXPRESSION ||
+            (node->kind.exp == OPERATION_EXPRESSION && is_arithmetic(node->attribute.op))) &&
+           reads_variable(node) && !expression_may_fail(node);
+}
+
+static void assign(common_subexpressions *state, const char *name)
+{
+    int index = symbol_index(state->analyzer, name);
+    if (index >= 0 && index < state->variable_count)
+        state->assigned_at[index] = ++state->clock;
+}
+
+/// @brief Avança o relógio para as variáveis atribuídas ou lidas numa lista de comandos: dentro de um
+///        laço, elas podem ter mudado desde a volta anterior.
+static void assign_all(common_subexpressions *state, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+            assign(state, node->attribute.name);
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                assign_all(state, node->child[i]);
+        }
+    }
+}
+
+/// @note Só a ocorrência mais recente de cada expressão é examinada: as anteriores foram registradas
+///       antes e leem as mesmas variáveis, então também não valem se ela não valer. Assim, uma expressão
+///       registrada de novo a cada comando, como a * 3 em a = a * 3 + 1, não deixa o balde cada vez mais longo.
+static available_expression *find_available(common_subexpressions *state, const tree_node *node, unsigned int hash)
+{
+    if (state->bucket_count == 0)
+        return NULL;
+    for (int i = state->buckets[hash & (unsigned int)(state->bucket_count - 1)]; i >= 0; i = state->available[i].next)
+    {
+        available_expression *entry = &state->available[i];
+        if (entry->hash == hash && equivalent(state, entry->expression, node))
+            return (last_assignment(state, entry->expression) <= entry->created) ? entry : NULL;
+    }
+    return NULL;
+}
+
+/// @brief Refaz os baldes; as expressões são percorridas da mais antiga para a mais recente, para que
+///        cada balde continue apontando para a mais recente.
+static int grow_buckets(common_subexpressions *state)
+{
+    int bucket_count = (state->bucket_count == 0) ? 64 : state->bucket_count * 2;
+    int *buckets = (int *)realloc(state->buckets, (size_t)bucket_count * sizeof(int));
+    if (buckets == NULL)
+        return 0;
+    state->buckets = buckets;
+    state->bucket_count = bucket_count;
+    memset(buckets, -1, (size_t)bucket_count * sizeof(int));
+    for (int i = 0; i < state->count; i++)
+    {
+        unsigned int bucket = state->available[i].hash & (unsigned int)(bucket_count - 1);
+        state->available[i].next = buckets[bucket];
+        buckets[bucket] = i;
+    }
+    return 1;
+}
+
+static void record(common_subexpressions *state, tree_node **slot, tree_node *statement, tree_node **link,
+                   unsigned int hash, int inner)
+{
+    if (state->count == state->capacity)
+    {
+        int capacity = (state->capacity == 0) ? 64 : state->capacity * 2;
+        available_expression *grown =
+            (available_expression *)realloc(state->available, (size_t)capacity * sizeof(available_expression));
+        if (grown == NULL)
+        {
+            state->failed = 1;
+            return;
+        }
+        state->available = grown;
+        state->capacity = capacity;
+    }
+    if (state->count >= state->bucket_count && !grow_buckets(state))
+    {
+        state->failed = 1;
+        return;
+    }
+
+    unsigned int bucket = hash & (unsigned int)(state->bucket_count - 1);
+    available_expression *entry = &state->available[state->count];
+    entry->expression = *slot;
+    entry->slot = slot;
+    entry->statement = statement;
+    entry->link = link;
+    entry->hash = hash;
+    entry->created = state->clock;
+    entry->inner = inner;
+    entry->temporary = NULL;
+    entry->next = state->buckets[bucket];
+    state->buckets[bucket] = state->count++;
+}
+
+/// @brief Tira da pilha as expressões registradas depois de mark, no fim de uma lista de comandos.
+static void forget(common_subexpressions *state, int mark)
+{
+    while (state->count > mark)
+    {
+        available_expression *entry = &state->available[--state->count];
+        state->buckets[entry->hash & (unsigned int)(state->bucket_count - 1)] = entry->next;
+    }
+}
+
+static tree_node *read_temporary(common_subexpressions *state, const char *temporary, int line)
+{
+    tree_node *read = new_expression_node(state->analyzer->arena, IDENTIFIER_EXPRESSION, line);
+    if (read == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    read->attribute.name = (char *)temporary;
+    return read;
+}
+
+/// @brief Cria a temporária de uma expressão na segunda vez que ela aparece: a atribuição vai logo antes
+///        do comando da primeira ocorrência, que passa a ler a temporária.
+/// @note As temporárias criadas antes, que a expressão pode ler, já estão antes desse comando. As
+///       expressões registradas dentro desta passam a estar na atribuição à temporária, e as suas
+///       temporárias, se forem criadas depois, vão antes dela.
+static const char *new_temporary(common_subexpressions *state, available_expression *entry)
+{
+    semantic_analyzer *analyzer = state->analyzer;
+    tree_node *expression = entry->expression;
+    if (state->definition_count == state->definition_capacity)
+    {
+        int capacity = (state->definition_capacity == 0) ? 16 : state->definition_capacity * 2;
+        const tree_node **grown =
+            (const tree_node **)realloc(state->definitions, (size_t)capacity * sizeof(const tree_node *));
+        if (grown == NULL)
+            return NULL;
+        state->definitions = grown;
+        state->definition_capacity = capacity;
+    }
+
+    int line = expression->line_number;
+    const char *temporary = new_optimizer_temporary(analyzer, 'c', analyzer->optimizations.common_subexpressions + 1,
+                                                    expression_type(analyzer, expression), line);
+    if (temporary == NULL)
+        return NULL;
+    tree_node *assignment = new_statement_node(analyzer->arena, ASSIGNMENT_STATEMENT, line);
+    tree_node *read = read_temporary(state, temporary, line);
+    if (assignment == NULL || read == NULL)
+        return NULL;
+    analyzer->optimizations.common_subexpressions++;
+    state->definitions[state->definition_count++] = expression;
+
+    tree_node **link = entry->link;
+    while (*link != entry->statement)
+        link = &(*link)->sibling;
+    assignment->attribute.name = (char *)temporary;
+    assignment->child[0] = expression;
+    assignment->sibling = entry->statement;
+    *link = assignment;
+    *entry->slot = read;
+    // As que já foram para a atribuição de uma temporária interna continuam lá
+    for (int i = entry->inner; i < (int)(entry - state->available); i++)
+    {
+        if (state->available[i].statement == entry->statement)
+            state->available[i].statement = assignment;
+    }
+    return temporary;
+}
+
+/// @brief Troca uma repetição de uma expressão disponível pela leitura da sua temporária.
+static void reuse(common_subexpressions *state, available_expression *entry, tree_node **slot)
+{
+    if (!state->apply)
+    {
+        state->found = 1;
+        return;
+    }
+    if (entry->temporary == NULL && (entry->temporary = new_temporary(state, entry)) == NULL)
+    {
+        state->failed = 1;
+        return;
+    }
+    tree_node *read = read_temporary(state, entry->temporary, (*slot)->line_number);
+    if (read == NULL)
+        return;
+    *slot = read;
+    state->analyzer->optimizations.reused_expressions++;
+}
+
+/// @brief Procura, de cima para baixo, as maiores subexpressões já disponíveis, e registra as demais.
+/// @param may_record 0 para as expressões que podem não ser avaliadas, como o lado direito de && e ||
+///        e a condição dos laços, que são avaliadas de novo a cada volta: elas podem reaproveitar uma
+///        expressão disponível, mas não ficam disponíveis para os comandos seguintes.
+static void scan_expression(common_subexpressions *state, tree_node **slot, tree_node *statement, tree_node **link,
+                            int may_record)
+{
+    tree_node *node = *slot;
+    if (node->kind.exp != OPERATION_EXPRESSION && node->kind.exp != CONVERSION_EXPRESSION)
+        return;
+
+    int candidate = is_candidate(node);
+    unsigned int hash = 0;
+    if (candidate)
+    {
+        hash = expression_hash(node, expand, state);
+        available_expression *entry = find_available(state, node, hash);
+        if (entry != NULL)
+        {
+            reuse(state, entry, slot);
+            return;
+        }
+    }
+
+    int inner = state->count;
+    int logical = node->kind.exp == OPERATION_EXPRESSION && (node->attribute.op == T_E || node->attribute.op == T_OU);
+    for (int i = 0; i < 2 && !state->failed; i++)
+    {
+        if (node->child[i] != NULL)
+            scan_expression(state, &node->child[i], statement, link, may_record && !(logical && i == 1));
+    }
+    if (candidate && may_record && !state->failed)
+        record(state, slot, statement, link, hash, inner);
+}
+
+static void scan_statements(common_subexpressions *state, tree_node **list);
+
+/// @brief Percorre uma lista de comandos sem tirar da pilha as expressões registradas nela.
+static void scan_list(common_subexpressions *state, tree_node **list)
+{
+    tree_node **link = list;
+    while (*link != NULL && !state->failed)
+    {
+        tree_node *node = *link;
+        switch (node->kind.stmt)
+        {
+        case IF_STATEMENT:
+            scan_expression(state, &node->child[0], node, link, 1);
+            if (node->child[1] != NULL)
+                scan_statements(state, &node->child[1]);
+            if (node->child[2] != NULL)
+                scan_statements(state, &node->child[2]);
+            break;
+        case WHILE_STATEMENT:
+            assign_all(state, node->child[1]);
+            scan_expression(state, &node->child[0], node, link, 0);
+            scan_statements(state, &node->child[1]);
+            break;
+        case REPEAT_STATEMENT:
+        {
+            // A condição é avaliada no fim de cada volta e pode reaproveitar o que o corpo calculou
+            assign_all(state, node->child[0]);
+            int mark = state->count;
+            scan_list(state, &node->child[0]);
+            scan_expression(state, &node->child[1], node, link, 0);
+            forget(state, mark);
+            break;
+        }
+        default:
+            for (int i = 0; i < MAXCHILDREN; i++)
+            {
+                if (node->child[i] != NULL && node->child[i]->node_kind == EXPRESSION_KIND)
+                    scan_expression(state, &node->child[i], node, link, 1);
+            }
+            if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+                assign(state, node->attribute.name);
+            break;
+        }
+
+        // Uma temporária pode ter sido atribuída antes deste comando, no lugar dele na lista
+        while (*link != node)
+            link = &(*link)->sibling;
+        link = &node->sibling;
+    }
+}
+
+/// @brief Percorre uma lista de comandos; as expressões registradas nela deixam de estar disponíveis no
+///        fim da lista, já que os comandos seguintes podem ser alcançados sem passar por ela.
+static void scan_statements(common_subexpressions *state, tree_node **list)
+{
+    int mark = state->count;
+    scan_list(state, list);
+    forget(state, mark);
+}
+
+static void release(common_subexpressions *state)
+{
+    free(state->assigned_at);
+    free(state->available);
+    free(state->buckets);
+    free(state->definitions);
+}
+
+int eliminate_common_subexpressions(semantic_analyzer *analyzer)
+{
+    common_subexpressions state;
+    memset(&state, 0, sizeof(state));
+    state.analyzer = analyzer;
+    state.variable_count = analyzer->table.count;
+    state.assigned_at = (int *)calloc((size_t)analyzer->table.count + 1, sizeof(int));
+    if (state.assigned_at == NULL)
+        return 0;
+
+    // Primeiro só procura; a árvore só é copiada se alguma expressão se repetir
+    scan_statements(&state, &analyzer->adjusted_tree);
+    int ok = !state.failed;
+    if (ok && state.found)
+    {
+        ok = detach_adjusted_tree(analyzer);
+        if (ok)
+        {
+            memset(state.assigned_at, 0, ((size_t)state.variable_count + 1) * sizeof(int));
+            state.clock = 0;
+            state.apply = 1;
+            scan_statements(&state, &analyzer->adjusted_tree);
+            ok = !state.failed;
+        }
+    }
+    release(&state);
+    return ok;
+}
@@ -0,0 +1,326 @@
+#include <stdlib.h> // calloc(), free()
+#include <string.h> // memset()
+#include "optimizer.h"
+
+/// @brief O estado da eliminação: quantas vezes cada variável, pelo seu índice na tabela de símbolos, é
+///        lida. As leituras na expressão de uma atribuição removível à própria variável (x = x + 1) não
+///        contam.
+typedef struct dead_code
+{
+    semantic_analyzer *analyzer;
+    int *reads;
+} dead_code;
+
+static int is_constant(const tree_node *node)
+{
+    return node != NULL && node->kind.exp == CONSTANT_EXPRESSION;
+}
+
+static int never_completes(const tree_node *list);
+
+/// @brief Indica se o comando nunca termina normalmente: um enquanto com condição sempre verdadeira,
+///        um repita com condição sempre falsa ou cujo corpo nunca termina, ou um se cujos dois
+///        caminhos nunca terminam. Os comandos depois dele nunca são executados.
+static int statement_never_completes(const tree_node *node)
+{
+    switch (node->kind.stmt)
+    {
+    case WHILE_STATEMENT:
+        return is_constant(node->child[0]) && node->child[0]->attribute.int_value != 0;
+    case REPEAT_STATEMENT:
+        return (is_constant(node->child[1]) && node->child[1]->attribute.int_value == 0) ||
+               never_completes(node->child[0]);
+    case IF_STATEMENT:
+        return never_completes(node->child[1]) && never_completes(node->child[2]);
+    default:
+        return 0;
+    }
+}
+
+static int never_completes(const tree_node *list)
+{
+    for (; list != NULL; list = list->sibling)
+    {
+        if (statement_never_completes(list))
+            return 1;
+    }
+    return 0;
+}
+
+/// @brief Se o comando nunca termina, remove os comandos que vêm depois dele.
+static void cut_unreachable(semantic_analyzer *analyzer, tree_node *node)
+{
+    if (node->sibling == NULL || !statement_never_completes(node))
+        return;
+    for (tree_node *next = node->sibling; next != NULL; next = next->sibling)
+        analyzer->optimizations.unreachable_statements++;
+    node->sibling = NULL;
+}
+
+/// @brief Troca os desvios com condição constante pelos comandos do caminho tomado e remove os comandos
+///        inalcançáveis de uma lista.
+/// @return O novo início da lista.
+static tree_node *prune_statements(semantic_analyzer *analyzer, tree_node *list)
+{
+    tree_node **link = &list;
+    while (*link != NULL)
+    {
+        tree_node *node = *link;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                node->child[i] = prune_statements(analyzer, node->child[i]);
+        }
+
+        tree_node *replacement = node;
+        if (node->kind.stmt == IF_STATEMENT && is_constant(node->child[0]))
+            replacement = node->child[0]->attribute.int_value ? node->child[1] : node->child[2];
+        else if (node->kind.stmt == WHILE_STATEMENT && is_constant(node->child[0]) &&
+                 node->child[0]->attribute.int_value == 0)
+            replacement = NULL;
+        else if (node->kind.stmt == REPEAT_STATEMENT && is_constant(node->child[1]) &&
+                 node->child[1]->attribute.int_value != 0)
+            replacement = node->child[0]; // O corpo executa uma única vez
+
+        if (replacement == node)
+        {
+            cut_unreachable(analyzer, node);
+            link = &node->sibling;
+            continue;
+        }
+
+        // Os comandos do caminho tomado já foram simplificados e entram no lugar do desvio
+        analyzer->optimizations.pruned_branches++;
+        tree_node *next = node->sibling;
+        if (replacement == NULL)
+        {
+            *link = next;
+            continue;
+        }
+        *link = replacement;
+        while (replacement->sibling != NULL)
+            replacement = replacement->sibling;
+        replacement->sibling = next;
+        cut_unreachable(analyzer, replacement);
+        link = &replacement->sibling;
+    }
+    return list;
+}
+
+/// @brief Soma delta às leituras das variáveis de uma expressão, exceto às da variável owner.
+static void count_reads(dead_code *state, const tree_node *node, int owner, int delta)
+{
+    if (node == NULL)
+        return;
+    if (node->kind.exp == IDENTIFIER_EXPRESSION)
+    {
+        int index = symbol_index(state->analyzer, node->attribute.name);
+        if (index >= 0 && index != owner)
+            state->reads[index] += delta;
+        return;
+    }
+    for (int i = 0; i < MAXCHILDREN; i++)
+        count_reads(state, node->child[i], owner, delta);
+}
+
+static void count_statement_reads(dead_code *state, const tree_node *list)
+{
+    for (; list != NULL; list = list->sibling)
+    {
+        // Uma atribuição que não pode ser removida conta as leituras da própria variável
+        int owner = (list->kind.stmt == ASSIGNMENT_STATEMENT && !expression_may_fail(list->child[0]))
+                        ? symbol_index(state->analyzer, list->attribute.name)
+                        : -1;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (list->child[i] == NULL)
+                continue;
+            if (list->child[i]->node_kind == STATEMENT_KIND)
+                count_statement_reads(state, list->child[i]);
+            else
+                count_reads(state, list->child[i], owner, 1);
+        }
+    }
+}
+
+/// @brief Indica se o comando pode ser removido: uma atribuição a uma variável que nunca é lida ou um
+///        se sem comandos, desde que a expressão avaliada não possa falhar.
+static int is_dead(dead_code *state, const tree_node *node, int *owner)
+{
+    *owner = -1;
+    if (node->kind.stmt == ASSIGNMENT_STATEMENT)
+    {
+        *owner = symbol_index(state->analyzer, node->attribute.name);
+        return *owner >= 0 && state->reads[*owner] == 0 && !expression_may_fail(node->child[0]);
+    }
+    if (node->kind.stmt == IF_STATEMENT)
+        return node->child[1] == NULL && node->child[2] == NULL && !expression_may_fail(node->child[0]);
+    return 0;
+}
+
+/// @brief Remove de uma lista os comandos sem efeito, atualizando as leituras das variáveis.
+/// @return Quantos comandos foram removidos.
+static int remove_dead_statements(dead_code *state, tree_node **list)
+{
+    optimization_stats *stats = &state->analyzer->optimizations;
+    int removed = 0;
+    tree_node **link = list;
+    while (*link != NULL)
+    {
+        tree_node *node = *link;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                removed += remove_dead_statements(state, &node->child[i]);
+        }
+
+        int owner;
+        if (is_dead(state, node, &owner))
+        {
+            if (node->kind.stmt == ASSIGNMENT_STATEMENT)
+                stats->dead_assignments++;
+            else
+                stats->pruned_branches++;
+            count_reads(state, node->child[0], owner, -1);
+            *link = node->sibling;
+            removed++;
+            continue;
+        }
+        link = &node->sibling;
+    }
+    return removed;
+}
+
+/// @brief Conta, para cada variável, os nós da árvore que usam o seu endereço.
+static void count_uses(semantic_analyzer *analyzer, const tree_node *node, int *uses)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        int uses_address = (node->node_kind == STATEMENT_KIND)
+                               ? (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+                               : (node->kind.exp == IDENTIFIER_EXPRESSION);
+        if (uses_address)
+        {
+            int index = symbol_index(analyzer, node->attribute.name);
+            if (index >= 0)
+                uses[index]++;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+            count_uses(analyzer, node->child[i], uses);
+    }
+}
+
+static void remove_declarations(semantic_analyzer *analyzer, tree_node **list, const int *uses)
+{
+    tree_node **link = list;
+    while (*link != NULL)
+    {
+        tree_node *node = *link;
+        if (node->kind.stmt == DECLARATION_STATEMENT)
+        {
+            int index = symbol_index(analyzer, node->attribute.name);
+            if (index >= 0 && uses[index] == 0)
+            {
+                *link = node->sibling;
+                continue;
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                remove_declarations(analyzer, &node->child[i], uses);
+        }
+        link = &node->sibling;
+    }
+}
+
+/// @brief Reendereça as variáveis que ainda são usadas, em ordem de declaração e sem lacunas.
+/// @note A eliminação pode ser executada mais de uma vez; só contam as variáveis que ainda tinham espaço.
+static void compact_frame(semantic_analyzer *analyzer, const int *uses)
+{
+    symbol_table *table = &analyzer->table;
+    int address = 0;
+    for (int i = 0; i < table->count; i++)
+    {
+        symbol *sym = &table->symbols[i];
+        if (uses[i] > 0)
+        {
+            sym->memory_address = address;
+            address += sym->size;
+        }
+        else
+        {
+            if (sym->memory_address >= 0)
+                analyzer->optimizations.removed_variables++;
+            sym->memory_address = -1;
+            sym->size = 0;
+        }
+    }
+    table->next_address = address;
+}
+
+static int has_constant_conditions(const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if ((node->kind.stmt == IF_STATEMENT || node->kind.stmt == WHILE_STATEMENT) && is_constant(node->child[0]))
+            return 1;
+        if (node->kind.stmt == REPEAT_STATEMENT && is_constant(node->child[1]))
+            return 1;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND &&
+                has_constant_conditions(node->child[i]))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+int eliminate_dead_code(semantic_analyzer *analyzer)
+{
+    int count = analyzer->table.count;
+
+    dead_code state = {analyzer, (int *)calloc((size_t)count + 1, sizeof(int))};
+    int *uses = (int *)calloc((size_t)count + 1, sizeof(int));
+    if (state.reads == NULL || uses == NULL)
+    {
+        free(state.reads);
+        free(uses);
+        return 0;
+    }
+
+    // Sem condições constantes e com todas as variáveis lidas, não há o que remover
+    count_statement_reads(&state, analyzer->adjusted_tree);
+    int has_unread = 0;
+    for (int i = 0; i < count; i++)
+        has_unread = has_unread || state.reads[i] == 0;
+    if (!has_unread && !has_constant_conditions(analyzer->adjusted_tree))
+    {
+        free(state.reads);
+        free(uses);
+        return 1;
+    }
+    if (!detach_adjusted_tree(analyzer))
+    {
+        free(state.reads);
+        free(uses);
+        return 0;
+    }
+
+    analyzer->adjusted_tree = prune_statements(analyzer, analyzer->adjusted_tree);
+
+    // Remover uma atribuição pode deixar outra variável sem leituras; repete até não haver mudança
+    memset(state.reads, 0, (size_t)count * sizeof(int));
+    count_statement_reads(&state, analyzer->adjusted_tree);
+    while (remove_dead_statements(&state, &analyzer->adjusted_tree) > 0)
+        ;
+
+    count_uses(analyzer, analyzer->adjusted_tree, uses);
+    remove_declarations(analyzer, &analyzer->adjusted_tree, uses);
+    compact_frame(analyzer, uses);
+
+    free(state.reads);
+    free(uses);
+    return 1;
+}
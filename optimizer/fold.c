@@ -0,0 +1,242 @@
+#include "optimizer.h"
+
+static int is_comparison(token_type op)
+{
+    return op == T_MENOR || op == T_MENOR_IGUAL || op == T_MAIOR || op == T_MAIOR_IGUAL ||
+           op == T_IGUAL || op == T_DIFERENTE;
+}
+
+static int is_constant(const tree_node *node)
+{
+    return node != NULL && node->kind.exp == CONSTANT_EXPRESSION;
+}
+
+static double real_value(const tree_node *constant)
+{
+    return (constant->type == REAL) ? constant->attribute.real_value : constant->attribute.int_value;
+}
+
+/// @brief Indica se a operação entre duas constantes é uma divisão inteira por zero, que não é avaliada.
+static int is_division_by_zero(token_type op, const tree_node *left, const tree_node *right)
+{
+    return op == T_DIV && left->type == INTEGER && right->type == INTEGER && right->attribute.int_value == 0;
+}
+
+int expression_may_fail(const tree_node *node)
+{
+    if (node == NULL || node->node_kind != EXPRESSION_KIND)
+        return 0;
+    if (node->kind.exp == OPERATION_EXPRESSION && node->attribute.op == T_DIV)
+    {
+        const tree_node *divisor = node->child[1];
+        if (!is_constant(divisor) || (divisor->type == INTEGER && divisor->attribute.int_value == 0))
+            return 1;
+    }
+    return expression_may_fail(node->child[0]) || expression_may_fail(node->child[1]);
+}
+
+/// @brief Transforma o nó em uma constante inteira ou lógica.
+static tree_node *make_integer(tree_node *node, exp_type type, int value)
+{
+    node->kind.exp = CONSTANT_EXPRESSION;
+    node->type = type;
+    node->attribute.int_value = value;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        node->child[i] = NULL;
+    return node;
+}
+
+/// @brief Transforma o nó em uma constante real.
+static tree_node *make_real(tree_node *node, double value)
+{
+    node->kind.exp = CONSTANT_EXPRESSION;
+    node->type = REAL;
+    node->attribute.real_value = value;
+    for (int i = 0; i < MAXCHILDREN; i++)
+        node->child[i] = NULL;
+    return node;
+}
+
+static int compare(token_type op, double left, double right)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return left < right;
+    case T_MENOR_IGUAL:
+        return left <= right;
+    case T_MAIOR:
+        return left > right;
+    case T_MAIOR_IGUAL:
+        return left >= right;
+    case T_IGUAL:
+        return left == right;
+    default:
+        return left != right;
+    }
+}
+
+/// @brief Simplifica && e || quando um dos operandos é uma constante.
+/// @return O nó que substitui a operação.
+static tree_node *fold_logical(semantic_analyzer *analyzer, tree_node *node)
+{
+    tree_node *left = node->child[0];
+    tree_node *right = node->child[1];
+    int deciding = (node->attribute.op == T_OU); // O valor que decide o resultado sozinho
+
+    if (is_constant(left))
+    {
+        // Se o operando esquerdo decide, o direito nunca seria avaliado
+        analyzer->optimizations.folded_conditions++;
+        if ((left->attribute.int_value != 0) == deciding)
+            return make_integer(node, BOOLEAN, deciding);
+        return right;
+    }
+    if (is_constant(right))
+    {
+        if ((right->attribute.int_value != 0) != deciding)
+        {
+            analyzer->optimizations.folded_conditions++;
+            return left;
+        }
+        // O operando esquerdo só pode ser descartado se a sua avaliação não puder falhar
+        if (!expression_may_fail(left))
+        {
+            analyzer->optimizations.folded_conditions++;
+            return make_integer(node, BOOLEAN, deciding);
+        }
+    }
+    return node;
+}
+
+/// @brief Avalia uma operação cujos operandos já foram simplificados.
+/// @return O nó que substitui a operação.
+static tree_node *fold_operation(semantic_analyzer *analyzer, tree_node *node)
+{
+    tree_node *left = node->child[0];
+    tree_node *right = node->child[1];
+    token_type op = node->attribute.op;
+
+    if (op == T_E || op == T_OU)
+        return fold_logical(analyzer, node);
+    if (!is_constant(left) || !is_constant(right) || is_division_by_zero(op, left, right))
+        return node;
+
+    // Um inteiro de 32 bits é representado exatamente por um double
+    if (is_comparison(op))
+    {
+        analyzer->optimizations.folded_conditions++;
+        return make_integer(node, BOOLEAN, compare(op, real_value(left), real_value(right)));
+    }
+
+    if (left->type == REAL || right->type == REAL)
+    {
+        double a = real_value(left), b = real_value(right);
+        analyzer->optimizations.folded_operations++;
+        switch (op)
+        {
+        case T_SOMA:
+            return make_real(node, a + b);
+        case T_SUB:
+            return make_real(node, a - b);
+        case T_MULT:
+            return make_real(node, a * b);
+        default:
+            return make_real(node, a / b);
+        }
+    }
+
+    // Como na execução: a aritmética inteira é feita sem sinal, truncada em 32 bits
+    unsigned int a = (unsigned int)left->attribute.int_value;
+    unsigned int b = (unsigned int)right->attribute.int_value;
+    analyzer->optimizations.folded_operations++;
+    switch (op)
+    {
+    case T_SOMA:
+        return make_integer(node, INTEGER, (int)(a + b));
+    case T_SUB:
+        return make_integer(node, INTEGER, (int)(a - b));
+    case T_MULT:
+        return make_integer(node, INTEGER, (int)(a * b));
+    default:
+        if ((int)b == -1)
+            return make_integer(node, INTEGER, (int)(0u - a));
+        return make_integer(node, INTEGER, (int)a / (int)b);
+    }
+}
+
+/// @brief Simplifica uma expressão de baixo para cima.
+/// @return O nó que substitui a expressão.
+static tree_node *fold_expression(semantic_analyzer *analyzer, tree_node *node)
+{
+    switch (node->kind.exp)
+    {
+    case CONVERSION_EXPRESSION:
+        node->child[0] = fold_expression(analyzer, node->child[0]);
+        if (is_constant(node->child[0]))
+        {
+            analyzer->optimizations.folded_conversions++;
+            return make_real(node, real_value(node->child[0]));
+        }
+        return node;
+    case OPERATION_EXPRESSION:
+        node->child[0] = fold_expression(analyzer, node->child[0]);
+        node->child[1] = fold_expression(analyzer, node->child[1]);
+        return fold_operation(analyzer, node);
+    default:
+        return node;
+    }
+}
+
+static void fold_statements(semantic_analyzer *analyzer, tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] == NULL)
+                continue;
+            if (node->child[i]->node_kind == STATEMENT_KIND)
+                fold_statements(analyzer, node->child[i]);
+            else
+                node->child[i] = fold_expression(analyzer, node->child[i]);
+        }
+    }
+}
+
+/// @brief Indica se fold_statements() mudaria alguma expressão da lista de comandos. Antes da
+///        simplificação, as únicas constantes são os literais do programa, então basta procurar uma
+///        conversão de um literal ou uma operação entre dois literais.
+static int has_constant_expressions(const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind == EXPRESSION_KIND)
+        {
+            const tree_node *left = node->child[0];
+            const tree_node *right = node->child[1];
+            if (node->kind.exp == CONVERSION_EXPRESSION && is_constant(left))
+                return 1;
+            if (node->kind.exp == OPERATION_EXPRESSION && is_constant(left) && is_constant(right) &&
+                !is_division_by_zero(node->attribute.op, left, right))
+                return 1;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (has_constant_expressions(node->child[i]))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+int fold_constants(semantic_analyzer *analyzer)
+{
+    if (!has_constant_expressions(analyzer->adjusted_tree))
+        return 1;
+
+    if (!detach_adjusted_tree(analyzer))
+        return 0;
+    fold_statements(analyzer, analyzer->adjusted_tree);
+    return 1;
+}
@@ -0,0 +1,553 @@
+#include <limits.h> // INT_MIN, INT_MAX
+#include <stdlib.h> // calloc(), realloc(), free()
+#include <string.h> // memset(), strcmp()
+#include "optimizer.h"
+
+/// @brief O que se sabe de uma variável no laço e na lista de comandos que estão sendo tratados.
+/// @note Os campos de contagem só valem quando loop é o número do laço atual, e value só vale quando
+///       list é o número da lista atual; assim o vetor não precisa ser limpo entre um laço e outro.
+typedef struct variable_state
+{
+    int loop;
+    int assignments;       // Atribuições no laço; uma leitura com ler() conta como duas
+    tree_node *assignment; // A última atribuição encontrada no laço
+    int top_level;         // 1 se essa atribuição está diretamente no corpo, fora de se e de laços internos
+    int list;
+    int value; // O valor constante da variável no ponto da lista que está sendo percorrido
+} variable_state;
+
+/// @brief Uma multiplicação v * k já trocada, no laço atual, pela temporária que guarda o seu valor.
+typedef struct reduced_product
+{
+    int variable;
+    int factor;
+    const char *temporary;
+    tree_node *initialization; // A atribuição inicial da temporária, antes do laço
+} reduced_product;
+
+/// @brief O estado da análise das variáveis de indução.
+typedef struct induction_analysis
+{
+    semantic_analyzer *analyzer;
+    int variable_count; // As temporárias criadas pela análise, com índice a partir daqui, são ignoradas
+    variable_state *variables;
+    int loop;
+    int list;
+    int apply; // 0 só procura uma multiplicação que possa ser trocada; 1 troca
+    int found;
+    reduced_product *products; // As multiplicações trocadas no laço atual
+    int product_count;
+    int product_capacity;
+    int temporaries;
+    int failed;
+} induction_analysis;
+
+/// @brief A posição da variável na tabela de símbolos, ou -1 se ela não é uma variável do programa.
+static int variable_index(induction_analysis *state, const char *name)
+{
+    int index = symbol_index(state->analyzer, name);
+    return (index < state->variable_count) ? index : -1;
+}
+
+static int is_integer_constant(const tree_node *node)
+{
+    return node->kind.exp == CONSTANT_EXPRESSION && node->type == INTEGER;
+}
+
+/// @brief Conta as atribuições e leituras de cada variável numa lista de comandos, incluindo os laços internos.
+static void count_assignments(induction_analysis *state, tree_node *node, int top_level)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+        {
+            int index = variable_index(state, node->attribute.name);
+            if (index >= 0)
+            {
+                variable_state *variable = &state->variables[index];
+                if (variable->loop != state->loop)
+                {
+                    variable->loop = state->loop;
+                    variable->assignments = 0;
+                }
+                variable->assignments += (node->kind.stmt == READ_STATEMENT) ? 2 : 1;
+                variable->assignment = node;
+                variable->top_level = top_level;
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                count_assignments(state, node->child[i], 0);
+        }
+    }
+}
+
+/// @brief Indica se a variável é uma variável de indução básica do laço atual: inteira e atribuída uma
+///        única vez no laço, por v = v + c ou v = v - c, com c uma constante diferente de zero.
+/// @param step Recebe o quanto a variável muda a cada execução da atribuição (com a aritmética da execução).
+static int is_basic_induction_variable(induction_analysis *state, int index, int *step)
+{
+    if (index < 0)
+        return 0;
+    const variable_state *variable = &state->variables[index];
+    if (variable->loop != state->loop || variable->assignments != 1)
+        return 0;
+    if (state->analyzer->table.symbols[index].type != DT_INTEGER)
+        return 0;
+
+    const tree_node *assignment = variable->assignment;
+    const tree_node *value = assignment->child[0];
+    if (assignment->kind.stmt != ASSIGNMENT_STATEMENT || value->kind.exp != OPERATION_EXPRESSION ||
+        (value->attribute.op != T_SOMA && value->attribute.op != T_SUB) ||
+        !is_variable(value->child[0], assignment->attribute.name) || !is_integer_constant(value->child[1]) ||
+        value->child[1]->attribute.int_value == 0)
+        return 0;
+
+    int constant = value->child[1]->attribute.int_value;
+    *step = (value->attribute.op == T_SOMA) ? constant : (int)(0u - (unsigned int)constant);
+    return 1;
+}
+
+/// @brief Indica se a expressão é uma função afim de uma variável de indução básica, como i * 4 + 1.
+static int is_affine(induction_analysis *state, const tree_node *node)
+{
+    int step;
+    if (node->kind.exp == IDENTIFIER_EXPRESSION)
+        return is_basic_induction_variable(state, variable_index(state, node->attribute.name), &step);
+    if (node->kind.exp != OPERATION_EXPRESSION || !is_integer_constant(node->child[1]))
+        return 0;
+    token_type op = node->attribute.op;
+    return (op == T_SOMA || op == T_SUB || op == T_MULT) && is_affine(state, node->child[0]);
+}
+
+/// @brief Conta as variáveis de indução derivadas do laço atual: as atribuídas uma única vez no laço
+///        com uma função afim de uma variável de indução básica.
+static int count_derived_variables(induction_analysis *state, const tree_node *node)
+{
+    int count = 0;
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT)
+        {
+            int index = variable_index(state, node->attribute.name);
+            int step;
+            if (index >= 0 && state->variables[index].loop == state->loop &&
+                state->variables[index].assignments == 1 && state->analyzer->table.symbols[index].type == DT_INTEGER &&
+                !is_basic_induction_variable(state, index, &step) && is_affine(state, node->child[0]))
+                count++;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                count += count_derived_variables(state, node->child[i]);
+        }
+    }
+    return count;
+}
+
+static int compare(long long value, token_type op, long long bound)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return value < bound;
+    case T_MENOR_IGUAL:
+        return value <= bound;
+    case T_MAIOR:
+        return value > bound;
+    case T_MAIOR_IGUAL:
+        return value >= bound;
+    case T_IGUAL:
+        return value == bound;
+    default:
+        return value != bound;
+    }
+}
+
+/// @brief Conta quantas vezes v op bound vale seguidamente para v = start, start + step, start + 2 * step, ...
+/// @return O número de vezes, ou -1 se v transbordaria antes de a comparação falhar.
+static long long count_trips(long long start, long long step, token_type op, long long bound)
+{
+    if (start < INT_MIN || start > INT_MAX)
+        return -1;
+    if (!compare(start, op, bound))
+        return 0;
+
+    long long trips;
+    switch (op)
+    {
+    case T_MENOR:
+        trips = (step > 0) ? (bound - start + step - 1) / step : -1;
+        break;
+    case T_MENOR_IGUAL:
+        trips = (step > 0) ? (bound - start) / step + 1 : -1;
+        break;
+    case T_MAIOR:
+        trips = (step < 0) ? (start - bound - step - 1) / -step : -1;
+        break;
+    case T_MAIOR_IGUAL:
+        trips = (step < 0) ? (start - bound) / -step + 1 : -1;
+        break;
+    case T_IGUAL:
+        trips = 1;
+        break;
+    default:
+        trips = ((bound - start) % step == 0 && (bound - start) / step > 0) ? (bound - start) / step : -1;
+        break;
+    }
+
+    // Os valores de v formam uma progressão: se o último não transborda, nenhum transborda
+    if (trips < 0 || trips > INT_MAX)
+        return -1;
+    long long last = start + trips * step;
+    return (last < INT_MIN || last > INT_MAX) ? -1 : trips;
+}
+
+/// @brief Registra o laço em analyzer->loops, com a variável de indução que controla a sua condição e,
+///        se os valores inicial e final são conhecidos, o número de voltas.
+/// @note O número de voltas exige que a variável seja incrementada diretamente no corpo, para que o
+///       incremento execute exatamente uma vez por volta.
+static int record_loop(induction_analysis *state, tree_node *loop)
+{
+    semantic_analyzer *analyzer = state->analyzer;
+    if (analyzer->loop_count == analyzer->loop_capacity)
+    {
+        int capacity = (analyzer->loop_capacity == 0) ? 8 : analyzer->loop_capacity * 2;
+        loop_info *grown = (loop_info *)realloc(analyzer->loops, (size_t)capacity * sizeof(loop_info));
+        if (grown == NULL)
+            return 0;
+        analyzer->loops = grown;
+        analyzer->loop_capacity = capacity;
+    }
+    loop_info *info = &analyzer->loops[analyzer->loop_count++];
+    tree_node *condition = loop_condition(loop);
+    info->loop = loop;
+    info->kind = loop->kind.stmt;
+    info->unroll_factor = 1;
+    info->line = condition->line_number;
+    info->induction_variable = NULL;
+    info->step = 0;
+    info->trip_count = -1;
+    info->derived_variables = count_derived_variables(state, loop_body(loop));
+
+    // A condição v op limite, ou limite op v; o número de voltas exige um limite constante
+    int index = -1, step = 0;
+    token_type op = condition->attribute.op;
+    const tree_node *bound = NULL;
+    if (condition->kind.exp == OPERATION_EXPRESSION && op != T_E && op != T_OU)
+    {
+        const tree_node *left = condition->child[0], *right = condition->child[1];
+        if (left->kind.exp == IDENTIFIER_EXPRESSION &&
+            is_basic_induction_variable(state, variable_index(state, left->attribute.name), &step))
+        {
+            index = variable_index(state, left->attribute.name);
+            bound = right;
+        }
+        else if (right->kind.exp == IDENTIFIER_EXPRESSION &&
+                 is_basic_induction_variable(state, variable_index(state, right->attribute.name), &step))
+        {
+            index = variable_index(state, right->attribute.name);
+            bound = left;
+            op = swapped_comparison(op);
+        }
+        if (bound != NULL && !is_integer_constant(bound))
+            bound = NULL;
+    }
+    if (index < 0)
+    {
+        // Sem uma condição sobre uma variável de indução, registra a primeira do corpo, se houver
+        bound = NULL;
+        index = -1;
+        for (tree_node *node = loop_body(loop); node != NULL && index < 0; node = node->sibling)
+        {
+            int candidate = (node->kind.stmt == ASSIGNMENT_STATEMENT) ? variable_index(state, node->attribute.name) : -1;
+            if (candidate >= 0 && is_basic_induction_variable(state, candidate, &step))
+                index = candidate;
+        }
+        if (index < 0)
+            return 1;
+    }
+    info->induction_variable = analyzer->table.symbols[index].name;
+    info->step = step;
+
+    const variable_state *variable = &state->variables[index];
+    if (bound == NULL || !variable->top_level || variable->list != state->list)
+        return 1;
+    long long start = variable->value;
+    long long trips;
+    if (loop->kind.stmt == WHILE_STATEMENT)
+        trips = count_trips(start, step, op, bound->attribute.int_value);
+    else
+    {
+        // O corpo do repita executa antes da condição, que encerra o laço quando vale
+        trips = count_trips(start + step, step, negated_comparison(op), bound->attribute.int_value);
+        trips = (trips < 0 || trips == INT_MAX) ? -1 : trips + 1;
+    }
+    info->trip_count = (int)trips;
+    return 1;
+}
+
+/// @brief Cria uma temporária com o valor de v * k na entrada do laço, reaproveitando o nó da multiplicação.
+/// @return A temporária, ou NULL se faltou memória.
+static reduced_product *new_product(induction_analysis *state, int variable, tree_node *multiplication)
+{
+    semantic_analyzer *analyzer = state->analyzer;
+    if (state->product_count == state->product_capacity)
+    {
+        int capacity = (state->product_capacity == 0) ? 8 : state->product_capacity * 2;
+        reduced_product *grown =
+            (reduced_product *)realloc(state->products, (size_t)capacity * sizeof(reduced_product));
+        if (grown == NULL)
+            return NULL;
+        state->products = grown;
+        state->product_capacity = capacity;
+    }
+
+    int line = multiplication->line_number;
+    const char *temporary = new_optimizer_temporary(analyzer, 'i', state->temporaries + 1, DT_INTEGER, line);
+    if (temporary == NULL)
+        return NULL;
+    tree_node *assignment = new_statement_node(analyzer->arena, ASSIGNMENT_STATEMENT, line);
+    if (assignment == NULL)
+        return NULL;
+    state->temporaries++;
+    assignment->attribute.name = (char *)temporary;
+    assignment->child[0] = multiplication;
+
+    reduced_product *product = &state->products[state->product_count++];
+    product->variable = variable;
+    product->factor = multiplication->child[1]->attribute.int_value;
+    product->temporary = temporary;
+    product->initialization = assignment;
+    return product;
+}
+
+/// @brief Troca as multiplicações v * k de uma expressão, com v uma variável de indução básica do laço,
+///        pela temporária que acompanha o seu valor.
+static void reduce_expression(induction_analysis *state, tree_node **slot)
+{
+    tree_node *node = *slot;
+    if (node->kind.exp == OPERATION_EXPRESSION && node->attribute.op == T_MULT &&
+        node->child[0]->kind.exp == IDENTIFIER_EXPRESSION && is_integer_constant(node->child[1]))
+    {
+        int step;
+        int index = variable_index(state, node->child[0]->attribute.name);
+        if (index < 0 || !is_basic_induction_variable(state, index, &step))
+            return;
+        if (!state->apply)
+        {
+            state->found = 1;
+            return;
+        }
+
+        reduced_product *product = NULL;
+        for (int i = 0; i < state->product_count && product == NULL; i++)
+        {
+            if (state->products[i].variable == index && state->products[i].factor == node->child[1]->attribute.int_value)
+                product = &state->products[i];
+        }
+        tree_node *read = new_expression_node(state->analyzer->arena, IDENTIFIER_EXPRESSION, node->line_number);
+        if (product == NULL)
+            product = new_product(state, index, node);
+        if (product == NULL || read == NULL)
+        {
+            state->failed = 1;
+            return;
+        }
+        read->attribute.name = (char *)product->temporary;
+        *slot = read;
+        state->analyzer->optimizations.strength_reductions++;
+        return;
+    }
+    if (node->kind.exp == OPERATION_EXPRESSION || node->kind.exp == CONVERSION_EXPRESSION)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            if (node->child[i] != NULL)
+                reduce_expression(state, &node->child[i]);
+        }
+    }
+}
+
+static void reduce_statements(induction_analysis *state, tree_node *node)
+{
+    for (; node != NULL && !state->failed; node = node->sibling)
+    {
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] == NULL)
+                continue;
+            if (node->child[i]->node_kind == STATEMENT_KIND)
+                reduce_statements(state, node->child[i]);
+            else
+                reduce_expression(state, &node->child[i]);
+        }
+    }
+}
+
+/// @brief Acrescenta t = t + step * k depois do incremento de v, para cada temporária t que guarda v * k.
+/// @note Com a aritmética da execução, em 32 bits, (v + step) * k = v * k + step * k vale sempre.
+static void add_increments(induction_analysis *state)
+{
+    semantic_analyzer *analyzer = state->analyzer;
+    for (int i = 0; i < state->product_count; i++)
+    {
+        reduced_product *product = &state->products[i];
+        int step;
+        is_basic_induction_variable(state, product->variable, &step);
+        int increment = (int)((unsigned int)step * (unsigned int)product->factor);
+        if (increment == 0)
+            continue; // v * k não muda: k é múltiplo de 2^32 / step
+
+        tree_node *increment_statement = state->variables[product->variable].assignment;
+        int line = increment_statement->line_number;
+        tree_node *assignment = new_statement_node(analyzer->arena, ASSIGNMENT_STATEMENT, line);
+        tree_node *sum = new_expression_node(analyzer->arena, OPERATION_EXPRESSION, line);
+        tree_node *read = new_expression_node(analyzer->arena, IDENTIFIER_EXPRESSION, line);
+        tree_node *constant = new_expression_node(analyzer->arena, CONSTANT_EXPRESSION, line);
+        if (assignment == NULL || sum == NULL || read == NULL || constant == NULL)
+        {
+            state->failed = 1;
+            return;
+        }
+        read->attribute.name = (char *)product->temporary;
+        constant->type = INTEGER;
+        constant->attribute.int_value = increment;
+        sum->attribute.op = T_SOMA;
+        sum->child[0] = read;
+        sum->child[1] = constant;
+        assignment->attribute.name = (char *)product->temporary;
+        assignment->child[0] = sum;
+        assignment->sibling = increment_statement->sibling;
+        increment_statement->sibling = assignment;
+    }
+}
+
+/// @brief Analisa um laço e troca as multiplicações das suas variáveis de indução por somas.
+/// @return As atribuições iniciais das temporárias, a inserir antes do laço, ou NULL se não há.
+static tree_node *reduce_loop(induction_analysis *state, tree_node *loop)
+{
+    state->loop++;
+    count_assignments(state, loop_body(loop), 1);
+    if (!record_loop(state, loop))
+    {
+        state->failed = 1;
+        return NULL;
+    }
+
+    state->product_count = 0;
+    tree_node *single = loop->sibling;
+    loop->sibling = NULL;
+    reduce_statements(state, loop);
+    loop->sibling = single;
+    if (state->failed || state->product_count == 0)
+        return NULL;
+
+    add_increments(state);
+    for (int i = 0; i + 1 < state->product_count; i++)
+        state->products[i].initialization->sibling = state->products[i + 1].initialization;
+    return state->products[0].initialization;
+}
+
+/// @brief Esquece o valor constante das variáveis atribuídas numa lista de comandos.
+static void forget_assigned(induction_analysis *state, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+        {
+            int index = variable_index(state, node->attribute.name);
+            if (index >= 0)
+                state->variables[index].list = 0;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                forget_assigned(state, node->child[i]);
+        }
+    }
+}
+
+/// @brief Trata os laços de uma lista de comandos e depois os das listas internas, de fora para dentro.
+/// @note Ao percorrer a lista, acompanha as variáveis que receberam uma constante, para conhecer o valor
+///       inicial das variáveis de indução; as listas internas só são percorridas depois.
+static void reduce_list(induction_analysis *state, tree_node **list)
+{
+    state->list++;
+    tree_node **link = list;
+    while (*link != NULL && !state->failed)
+    {
+        tree_node *node = *link;
+        if (is_loop(node))
+        {
+            tree_node *before = reduce_loop(state, node);
+            if (before != NULL)
+            {
+                *link = before;
+                while (before->sibling != NULL)
+                    before = before->sibling;
+                before->sibling = node;
+            }
+        }
+
+        int index = (node->kind.stmt == ASSIGNMENT_STATEMENT) ? variable_index(state, node->attribute.name) : -1;
+        if (index >= 0 && is_integer_constant(node->child[0]) &&
+            state->analyzer->table.symbols[index].type == DT_INTEGER)
+        {
+            state->variables[index].list = state->list;
+            state->variables[index].value = node->child[0]->attribute.int_value;
+        }
+        else
+        {
+            tree_node *single = node->sibling;
+            node->sibling = NULL;
+            forget_assigned(state, node);
+            node->sibling = single;
+        }
+        link = &node->sibling;
+    }
+
+    for (tree_node *node = *list; node != NULL && !state->failed; node = node->sibling)
+    {
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                reduce_list(state, &node->child[i]);
+        }
+    }
+}
+
+int reduce_induction_variables(semantic_analyzer *analyzer)
+{
+    induction_analysis state;
+    memset(&state, 0, sizeof(state));
+    state.analyzer = analyzer;
+    state.variable_count = analyzer->table.count;
+    state.variables = (variable_state *)calloc((size_t)analyzer->table.count + 1, sizeof(variable_state));
+    if (state.variables == NULL)
+        return 0;
+
+    // Primeiro só procura e registra os laços; a árvore só é copiada se alguma multiplicação for trocada
+    analyzer->loop_count = 0;
+    reduce_list(&state, &analyzer->adjusted_tree);
+    int ok = !state.failed;
+    if (ok && state.found)
+    {
+        ok = detach_adjusted_tree(analyzer);
+        if (ok)
+        {
+            // Os laços registrados eram os da árvore original; a segunda passada registra os da cópia
+            memset(state.variables, 0, ((size_t)state.variable_count + 1) * sizeof(variable_state));
+            state.loop = 0;
+            state.list = 0;
+            state.apply = 1;
+            analyzer->loop_count = 0;
+            reduce_list(&state, &analyzer->adjusted_tree);
+            ok = !state.failed;
+        }
+    }
+    free(state.variables);
+    free(state.products);
+    return ok;
+}
@@ -0,0 +1,285 @@
+#include <stdlib.h> // calloc(), realloc(), free()
+#include <string.h> // memset()
+#include "optimizer.h"
+
+/// @brief Uma expressão já movida para fora do laço atual e a temporária que guarda o seu valor.
+typedef struct hoisted_expression
+{
+    const tree_node *expression;
+    unsigned int hash;
+    const char *temporary;
+} hoisted_expression;
+
+/// @brief O estado da movimentação de código invariante.
+/// @note assigned[v] == loop quando a variável v é atribuída ou lida com ler() no laço que está sendo
+///       tratado; cada laço recebe um número novo, e assim o vetor não precisa ser limpo. As temporárias,
+///       com índice a partir de variable_count, são atribuídas só antes do seu laço, que é tratado depois
+///       dos laços que o contêm: são sempre invariantes.
+typedef struct loop_motion
+{
+    semantic_analyzer *analyzer;
+    int variable_count;
+    int *assigned;
+    int loop;
+    int apply;  // 0 só procura uma expressão que possa ser movida; 1 move
+    int found;
+    hoisted_expression *hoisted; // As expressões movidas para fora do laço atual
+    int hoisted_count;
+    int hoisted_capacity;
+    tree_node *before; // As atribuições às temporárias, a inserir antes do laço
+    tree_node *before_last;
+    int failed;
+} loop_motion;
+
+/// @brief Marca as variáveis atribuídas ou lidas numa lista de comandos, incluindo os laços internos.
+static void mark_assigned(loop_motion *state, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT)
+        {
+            int index = symbol_index(state->analyzer, node->attribute.name);
+            if (index >= 0 && index < state->variable_count)
+                state->assigned[index] = state->loop;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                mark_assigned(state, node->child[i]);
+        }
+    }
+}
+
+/// @brief Cria uma temporária para a expressão e acrescenta a atribuição a ela às que vão antes do laço.
+/// @return O nome da temporária, ou NULL se faltou memória.
+static const char *new_temporary(loop_motion *state, tree_node *expression, int line)
+{
+    semantic_analyzer *analyzer = state->analyzer;
+    const char *temporary = new_optimizer_temporary(analyzer, 't', analyzer->optimizations.hoisted_expressions + 1,
+                                                    expression_type(analyzer, expression), line);
+    if (temporary == NULL)
+        return NULL;
+    tree_node *assignment = new_statement_node(analyzer->arena, ASSIGNMENT_STATEMENT, line);
+    if (assignment == NULL)
+        return NULL;
+    analyzer->optimizations.hoisted_expressions++;
+
+    assignment->attribute.name = (char *)temporary;
+    assignment->child[0] = expression;
+    if (state->before == NULL)
+        state->before = assignment;
+    else
+        state->before_last->sibling = assignment;
+    state->before_last = assignment;
+    return temporary;
+}
+
+/// @brief Troca uma expressão invariante por uma leitura da temporária que guarda o seu valor, criando a
+///        temporária se nenhuma expressão igual já foi movida para fora deste laço.
+static void hoist(loop_motion *state, tree_node **slot)
+{
+    tree_node *expression = *slot;
+    if (!state->apply)
+    {
+        state->found = 1;
+        return;
+    }
+
+    unsigned int hash = expression_hash(expression, NULL, NULL);
+    const char *temporary = NULL;
+    for (int i = 0; i < state->hoisted_count && temporary == NULL; i++)
+    {
+        if (state->hoisted[i].hash == hash && same_expression(state->hoisted[i].expression, expression))
+            temporary = state->hoisted[i].temporary;
+    }
+    if (temporary == NULL)
+    {
+        if (state->hoisted_count == state->hoisted_capacity)
+        {
+            int capacity = (state->hoisted_capacity == 0) ? 8 : state->hoisted_capacity * 2;
+            hoisted_expression *grown =
+                (hoisted_expression *)realloc(state->hoisted, (size_t)capacity * sizeof(hoisted_expression));
+            if (grown == NULL)
+            {
+                state->failed = 1;
+                return;
+            }
+            state->hoisted = grown;
+            state->hoisted_capacity = capacity;
+        }
+        temporary = new_temporary(state, expression, expression->line_number);
+        if (temporary == NULL)
+        {
+            state->failed = 1;
+            return;
+        }
+        hoisted_expression *entry = &state->hoisted[state->hoisted_count++];
+        entry->expression = expression;
+        entry->hash = hash;
+        entry->temporary = temporary;
+    }
+
+    tree_node *read = new_expression_node(state->analyzer->arena, IDENTIFIER_EXPRESSION, expression->line_number);
+    if (read == NULL)
+    {
+        state->failed = 1;
+        return;
+    }
+    read->attribute.name = (char *)temporary;
+    *slot = read;
+}
+
+/// @brief Move uma expressão invariante para fora do laço, ou, se ela pode falhar, as partes dela que
+///        não podem. Só as operações aritméticas e as conversões que leem alguma variável são movidas.
+static void try_hoist(loop_motion *state, tree_node **slot, int reads_variable)
+{
+    tree_node *node = *slot;
+    if (node->kind.exp != OPERATION_EXPRESSION && node->kind.exp != CONVERSION_EXPRESSION)
+        return;
+    if (reads_variable && !expression_may_fail(node))
+    {
+        hoist(state, slot);
+        return;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (node->child[i] != NULL)
+            try_hoist(state, &node->child[i], 1);
+    }
+}
+
+/// @brief Procura, de baixo para cima, as maiores subexpressões invariantes e as move para fora do laço.
+/// @param reads_variable Recebe 1 se a expressão lê alguma variável.
+/// @return 1 se a expressão é invariante e pode ser movida pelo nó pai.
+static int scan_expression(loop_motion *state, tree_node **slot, int *reads_variable)
+{
+    tree_node *node = *slot;
+    *reads_variable = 0;
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        return 1;
+    case IDENTIFIER_EXPRESSION:
+    {
+        *reads_variable = 1;
+        int index = symbol_index(state->analyzer, node->attribute.name);
+        return index >= state->variable_count || (index >= 0 && state->assigned[index] != state->loop);
+    }
+    default:
+        break;
+    }
+
+    int invariant[2] = {1, 1}, reads[2] = {0, 0};
+    for (int i = 0; i < 2; i++)
+    {
+        if (node->child[i] != NULL)
+            invariant[i] = scan_expression(state, &node->child[i], &reads[i]);
+    }
+    *reads_variable = reads[0] || reads[1];
+
+    // Comparações e operadores lógicos não são movidos, mas os seus operandos podem ser
+    int movable = node->kind.exp == CONVERSION_EXPRESSION || is_arithmetic(node->attribute.op);
+    if (movable && invariant[0] && invariant[1])
+        return 1;
+    for (int i = 0; i < 2; i++)
+    {
+        if (node->child[i] != NULL && invariant[i])
+            try_hoist(state, &node->child[i], reads[i]);
+    }
+    return 0;
+}
+
+static void scan_statements(loop_motion *state, tree_node *node)
+{
+    for (; node != NULL && !state->failed; node = node->sibling)
+    {
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] == NULL)
+                continue;
+            if (node->child[i]->node_kind == STATEMENT_KIND)
+                scan_statements(state, node->child[i]);
+            else
+            {
+                int reads;
+                if (scan_expression(state, &node->child[i], &reads))
+                    try_hoist(state, &node->child[i], reads);
+            }
+        }
+    }
+}
+
+/// @brief Move para antes do laço as expressões invariantes do seu corpo e da sua condição.
+/// @note Como só são movidas expressões que não podem falhar e que não têm efeitos colaterais,
+///       avaliá-las uma vez antes do laço é seguro mesmo que o corpo de um enquanto nunca execute.
+/// @return As atribuições às temporárias, ou NULL se nenhuma expressão foi movida.
+static tree_node *hoist_loop(loop_motion *state, tree_node *loop)
+{
+    state->loop++;
+    mark_assigned(state, loop->child[0]);
+    mark_assigned(state, loop->child[1]);
+    state->hoisted_count = 0;
+    state->before = NULL;
+    state->before_last = NULL;
+
+    // A condição de um enquanto é o primeiro filho, e a de um repita, o segundo
+    tree_node *single = loop->sibling;
+    loop->sibling = NULL;
+    scan_statements(state, loop);
+    loop->sibling = single;
+    return state->before;
+}
+
+/// @brief Trata os laços de uma lista de comandos de fora para dentro: as expressões invariantes num
+///        laço externo saem dele inteiras, antes que o laço interno as veja.
+static void hoist_statements(loop_motion *state, tree_node **list)
+{
+    tree_node **link = list;
+    while (*link != NULL && !state->failed)
+    {
+        tree_node *node = *link;
+        if (is_loop(node))
+        {
+            tree_node *before = hoist_loop(state, node);
+            if (before != NULL)
+            {
+                *link = before;
+                state->before_last->sibling = node;
+            }
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                hoist_statements(state, &node->child[i]);
+        }
+        link = &node->sibling;
+    }
+}
+
+int hoist_loop_invariants(semantic_analyzer *analyzer)
+{
+    loop_motion state;
+    memset(&state, 0, sizeof(state));
+    state.analyzer = analyzer;
+    state.variable_count = analyzer->table.count;
+    state.assigned = (int *)calloc((size_t)analyzer->table.count + 1, sizeof(int));
+    if (state.assigned == NULL)
+        return 0;
+
+    // Primeiro só procura; a árvore só é copiada se alguma expressão for movida
+    hoist_statements(&state, &analyzer->adjusted_tree);
+    int ok = 1;
+    if (state.found)
+    {
+        ok = detach_adjusted_tree(analyzer);
+        if (ok)
+        {
+            state.apply = 1;
+            hoist_statements(&state, &analyzer->adjusted_tree);
+            ok = !state.failed;
+        }
+    }
+    free(state.assigned);
+    free(state.hoisted);
+    return ok;
+}
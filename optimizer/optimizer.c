@@ -0,0 +1,234 @@
+#include <stdint.h> // uintptr_t
+#include <stdio.h>  // snprintf()
+#include <stdlib.h> // malloc(), free(), qsort(), bsearch()
+#include <string.h> // memcmp(), strcmp()
+#include "optimizer.h"
+
+static int compare_loop_entries(const void *a, const void *b)
+{
+    uintptr_t x = (uintptr_t)((const loop_entry *)a)->loop;
+    uintptr_t y = (uintptr_t)((const loop_entry *)b)->loop;
+    return (x > y) - (x < y);
+}
+
+loop_entry *index_loops(semantic_analyzer *analyzer)
+{
+    loop_entry *index = (loop_entry *)malloc(((size_t)analyzer->loop_count + 1) * sizeof(loop_entry));
+    if (index == NULL)
+        return NULL;
+    for (int i = 0; i < analyzer->loop_count; i++)
+    {
+        index[i].loop = analyzer->loops[i].loop;
+        index[i].info = &analyzer->loops[i];
+    }
+    qsort(index, (size_t)analyzer->loop_count, sizeof(loop_entry), compare_loop_entries);
+    return index;
+}
+
+loop_info *find_loop_info(const loop_entry *index, int count, const tree_node *loop)
+{
+    loop_entry key = {loop, NULL};
+    const loop_entry *entry =
+        (const loop_entry *)bsearch(&key, index, (size_t)count, sizeof(loop_entry), compare_loop_entries);
+    return (entry != NULL) ? entry->info : NULL;
+}
+
+/// @brief Faz os laços registrados apontarem para os nós correspondentes da cópia da árvore.
+static void relocate_loops(const loop_entry *index, int count, const tree_node *original, tree_node *copy)
+{
+    for (; original != NULL; original = original->sibling, copy = copy->sibling)
+    {
+        if (original->kind.stmt == WHILE_STATEMENT || original->kind.stmt == REPEAT_STATEMENT)
+        {
+            loop_info *info = find_loop_info(index, count, original);
+            if (info != NULL)
+                info->loop = copy;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (original->child[i] != NULL && original->child[i]->node_kind == STATEMENT_KIND)
+                relocate_loops(index, count, original->child[i], copy->child[i]);
+        }
+    }
+}
+
+int detach_adjusted_tree(semantic_analyzer *analyzer)
+{
+    if (analyzer->adjusted_tree != analyzer->original_tree || analyzer->adjusted_tree == NULL)
+        return 1;
+
+    loop_entry *index = NULL;
+    if (analyzer->loop_count > 0 && (index = index_loops(analyzer)) == NULL)
+        return 0;
+    tree_node *copy = copy_tree(analyzer->arena, analyzer->adjusted_tree);
+    if (copy == NULL)
+    {
+        free(index);
+        return 0;
+    }
+    if (index != NULL)
+        relocate_loops(index, analyzer->loop_count, analyzer->adjusted_tree, copy);
+    free(index);
+    analyzer->adjusted_tree = copy;
+    return 1;
+}
+
+int same_expression(const tree_node *a, const tree_node *b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+    if (a->kind.exp != b->kind.exp)
+        return 0;
+    switch (a->kind.exp)
+    {
+    case IDENTIFIER_EXPRESSION:
+        return strcmp(a->attribute.name, b->attribute.name) == 0;
+    case CONSTANT_EXPRESSION:
+        if (a->type != b->type)
+            return 0;
+        return (a->type == REAL) ? memcmp(&a->attribute.real_value, &b->attribute.real_value, sizeof(double)) == 0
+                                 : a->attribute.int_value == b->attribute.int_value;
+    case CONVERSION_EXPRESSION:
+        return same_expression(a->child[0], b->child[0]);
+    default:
+        return a->attribute.op == b->attribute.op && same_expression(a->child[0], b->child[0]) &&
+               same_expression(a->child[1], b->child[1]);
+    }
+}
+
+int is_arithmetic(token_type op)
+{
+    return op == T_SOMA || op == T_SUB || op == T_MULT || op == T_DIV;
+}
+
+data_type expression_type(semantic_analyzer *analyzer, const tree_node *node)
+{
+    switch (node->kind.exp)
+    {
+    case IDENTIFIER_EXPRESSION:
+    {
+        int index = symbol_index(analyzer, node->attribute.name);
+        return (index >= 0) ? analyzer->table.symbols[index].type : DT_INTEGER;
+    }
+    case CONSTANT_EXPRESSION:
+        return (node->type == REAL) ? DT_REAL : DT_INTEGER;
+    case CONVERSION_EXPRESSION:
+        return DT_REAL;
+    default:
+        return (expression_type(analyzer, node->child[0]) == DT_REAL ||
+                expression_type(analyzer, node->child[1]) == DT_REAL)
+                   ? DT_REAL
+                   : DT_INTEGER;
+    }
+}
+
+unsigned int expression_hash(const tree_node *node, expression_expander expand, const void *context)
+{
+    if (expand != NULL)
+        node = expand(context, node);
+    if (node == NULL)
+        return 0;
+    unsigned int hash = (unsigned int)node->kind.exp * 31u;
+    switch (node->kind.exp)
+    {
+    case IDENTIFIER_EXPRESSION:
+        for (const char *c = node->attribute.name; *c != '\0'; c++)
+            hash = hash * 31u + (unsigned char)*c;
+        return hash;
+    case CONSTANT_EXPRESSION:
+        return hash ^ (unsigned int)node->attribute.int_value ^ (unsigned int)node->type;
+    default:
+        hash = hash * 31u + (unsigned int)node->attribute.op;
+        hash = hash * 2654435761u ^ expression_hash(node->child[0], expand, context);
+        return hash * 2654435761u ^ expression_hash(node->child[1], expand, context);
+    }
+}
+
+const char *new_optimizer_temporary(semantic_analyzer *analyzer, char prefix, int number, data_type type, int line)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "$%c%d", prefix, number);
+
+    // Os nomes com $ não podem aparecer no programa, então add_symbol() só falha por falta de memória
+    int errors = analyzer->error_count;
+    add_symbol(analyzer, name, type, line);
+    if (analyzer->error_count != errors)
+    {
+        analyzer->error_count = errors;
+        return NULL;
+    }
+    symbol *sym = &analyzer->table.symbols[analyzer->table.count - 1];
+    sym->is_initialized = 1;
+    return sym->name;
+}
+
+int is_variable(const tree_node *node, const char *name)
+{
+    return node->kind.exp == IDENTIFIER_EXPRESSION && strcmp(node->attribute.name, name) == 0;
+}
+
+int is_loop(const tree_node *node)
+{
+    return node->kind.stmt == WHILE_STATEMENT || node->kind.stmt == REPEAT_STATEMENT;
+}
+
+tree_node *loop_body(tree_node *loop)
+{
+    return (loop->kind.stmt == WHILE_STATEMENT) ? loop->child[1] : loop->child[0];
+}
+
+tree_node *loop_condition(tree_node *loop)
+{
+    return (loop->kind.stmt == WHILE_STATEMENT) ? loop->child[0] : loop->child[1];
+}
+
+token_type negated_comparison(token_type op)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return T_MAIOR_IGUAL;
+    case T_MENOR_IGUAL:
+        return T_MAIOR;
+    case T_MAIOR:
+        return T_MENOR_IGUAL;
+    case T_MAIOR_IGUAL:
+        return T_MENOR;
+    case T_IGUAL:
+        return T_DIFERENTE;
+    default:
+        return T_IGUAL;
+    }
+}
+
+token_type swapped_comparison(token_type op)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return T_MAIOR;
+    case T_MENOR_IGUAL:
+        return T_MAIOR_IGUAL;
+    case T_MAIOR:
+        return T_MENOR;
+    case T_MAIOR_IGUAL:
+        return T_MENOR_IGUAL;
+    default:
+        return op;
+    }
+}
+
+int optimize_tree(semantic_analyzer *analyzer)
+{
+    analyzer->optimizations.frame_size_before = analyzer->table.next_address;
+    int ok = fold_constants(analyzer);
+    ok = simplify_algebra(analyzer) && ok;
+    ok = eliminate_dead_code(analyzer) && ok;
+    ok = propagate_constants(analyzer) && ok;
+    ok = reduce_induction_variables(analyzer) && ok;
+    ok = hoist_loop_invariants(analyzer) && ok;
+    ok = unroll_loops(analyzer) && ok;
+    ok = eliminate_common_subexpressions(analyzer) && ok;
+    ok = share_expressions(analyzer) && ok;
+    return ok;
+}
@@ -0,0 +1,209 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "../semantic/semantic.h"
+
+/// @brief Executa as otimizações sobre a árvore ajustada, na ordem: avaliação das expressões constantes,
+///        identidades algébricas, eliminação de código morto, propagação das constantes descobertas na forma SSA, redução
+///        das multiplicações das variáveis de indução, movimentação das expressões invariantes para fora dos laços,
+///        desenrolamento dos laços curtos, eliminação das subexpressões comuns e, por fim, compartilhamento dos
+///        nós de expressão iguais.
+/// @note A árvore original é preservada: se alguma otimização mudar a árvore, a árvore ajustada passa a
+///       ser uma cópia. O que cada otimização fez é contado em analyzer->optimizations.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se todas as otimizações foram feitas, 0 se faltou memória (a árvore continua correta).
+int optimize_tree(semantic_analyzer *analyzer);
+
+/// @brief Garante que a árvore ajustada não compartilhe nós com a árvore original, copiando-a se preciso.
+/// @note Os laços registrados em analyzer->loops passam a apontar para os nós da cópia.
+/// @return 1 se a árvore ajustada pode ser modificada, 0 se faltou memória para a cópia.
+int detach_adjusted_tree(semantic_analyzer *analyzer);
+
+/// @brief Um laço de analyzer->loops, pelo endereço do seu nó.
+typedef struct loop_entry
+{
+    const tree_node *loop;
+    loop_info *info;
+} loop_entry;
+
+/// @brief Ordena os laços registrados em analyzer->loops pelo endereço do nó, para find_loop_info().
+/// @return O índice, a liberar com free(), ou NULL se faltou memória.
+loop_entry *index_loops(semantic_analyzer *analyzer);
+
+/// @brief Procura o registro de um laço num índice criado por index_loops().
+/// @return O registro, ou NULL se o laço não foi registrado.
+loop_info *find_loop_info(const loop_entry *index, int count, const tree_node *loop);
+
+/// @brief Indica se duas expressões são iguais, nó a nó (as constantes reais são comparadas bit a bit).
+int same_expression(const tree_node *a, const tree_node *b);
+
+/// @brief Indica se op é um operador aritmético (+, -, * ou /).
+int is_arithmetic(token_type op);
+
+/// @brief O tipo do valor de uma expressão aritmética, antes de resolve_tree() preencher os tipos.
+data_type expression_type(semantic_analyzer *analyzer, const tree_node *node);
+
+/// @brief Troca um nó de expressão pelo que ele representa, como a leitura de uma temporária pela
+///        expressão que ela guarda, ou devolve o próprio nó.
+typedef const tree_node *(*expression_expander)(const void *context, const tree_node *node);
+
+/// @brief O hash de uma expressão, compatível com same_expression(): expressões iguais têm o mesmo hash.
+/// @param expand Aplicada a cada nó antes do seu hash, ou NULL para usar os nós como estão.
+unsigned int expression_hash(const tree_node *node, expression_expander expand, const void *context);
+
+/// @brief Declara uma temporária de otimização do tipo dado, chamada $ seguido de prefix e de number (como
+///        $t1), já marcada como inicializada.
+/// @return O nome da temporária, ou NULL se faltou memória (a tabela de símbolos fica como estava).
+const char *new_optimizer_temporary(semantic_analyzer *analyzer, char prefix, int number, data_type type, int line);
+
+/// @brief Indica se a expressão é a variável com o nome dado.
+int is_variable(const tree_node *node, const char *name);
+
+/// @brief Indica se o comando é um enquanto ou um repita.
+int is_loop(const tree_node *node);
+
+/// @brief O corpo de um enquanto ou de um repita.
+tree_node *loop_body(tree_node *loop);
+
+/// @brief A condição de um enquanto (que mantém o laço) ou de um repita (que o termina).
+tree_node *loop_condition(tree_node *loop);
+
+/// @brief A comparação que vale quando a comparação op é falsa.
+token_type negated_comparison(token_type op);
+
+/// @brief A comparação equivalente com os operandos trocados: c < v é v > c.
+token_type swapped_comparison(token_type op);
+
+/// @brief Indica se a avaliação da expressão pode terminar em um erro de execução, isto é, se ela tem
+///        uma divisão cujo divisor não é uma constante diferente de zero. Essas expressões não podem
+///        ser descartadas.
+int expression_may_fail(const tree_node *node);
+
+/// @brief Avalia em tempo de compilação as expressões da árvore ajustada cujo valor já é conhecido:
+///        operações entre constantes, conversões de constantes inteiras e comparações e operadores
+///        lógicos com resultado conhecido, que viram constantes do tipo BOOLEAN (0 ou 1).
+/// @note A aritmética inteira segue a da execução (resultado truncado em 32 bits, x / -1 = -x). Divisões
+///       inteiras por zero não são avaliadas, para que o erro continue acontecendo na execução, e
+///       operandos que podem falhar não são descartados.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória (a árvore
+///         ajustada fica como estava).
+int fold_constants(semantic_analyzer *analyzer);
+
+/// @brief Aplica identidades algébricas às operações da árvore ajustada: x * 1, x / 1, x + 0 e x - 0
+///        viram x; entre inteiros, x * 0 e x - x viram 0, x * -1 vira 0 - x, 0 - (0 - x) vira x e
+///        x - (0 - y) vira x + y; -a == -b vira a == b, e, entre reais, -a < -b vira b < a. Entre
+///        inteiros, a constante de + e * passa para a direita, e x == x, x < x, ... viram constantes.
+/// @note Respeita a distinção entre inteiros e reais: entre reais, x + 0.0 não é x (para x = -0.0),
+///       x - x não é 0 (para infinito e NaN) e x * 0.0 não é 0. Operandos que podem falhar não são
+///       descartados. As multiplicações por potências de 2 e as divisões por constantes são trocadas
+///       por deslocamentos e multiplicações na geração de código de máquina.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória.
+int simplify_algebra(semantic_analyzer *analyzer);
+
+/// @brief Remove da árvore ajustada o código que não tem efeito: os desvios que nunca são tomados
+///        (se, enquanto e repita com condição constante), os comandos depois de um laço que nunca
+///        termina e as atribuições a variáveis que nunca são lidas. Depois, as variáveis que não
+///        aparecem mais na árvore perdem o seu espaço no quadro (endereço -1 e tamanho 0) e as demais
+///        são reendereçadas em ordem de declaração, sem lacunas.
+/// @note Deve ser executada depois de fold_constants(), que produz as condições constantes.
+///       Atribuições cuja expressão pode falhar são mantidas, assim como as leituras, que consomem a
+///       entrada.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória (a árvore
+///         ajustada e a tabela de símbolos ficam como estavam).
+int eliminate_dead_code(semantic_analyzer *analyzer);
+
+/// @brief Propagação de constantes pela representação intermediária: traduz a árvore ajustada para a
+///        forma SSA, descobre as leituras de variáveis que sempre leem a mesma constante, mesmo através
+///        de se e laços, e troca essas leituras pela constante na árvore. Em seguida, repete a avaliação
+///        das expressões constantes, as identidades algébricas e a eliminação de código morto.
+/// @note Deve ser executada depois de eliminate_dead_code(). Uma variável que ainda não foi atribuída
+///       vale 0, como no quadro zerado da execução.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória.
+int propagate_constants(semantic_analyzer *analyzer);
+
+/// @brief Analisa as variáveis de indução de cada enquanto e repita. Uma variável de indução básica é
+///        inteira e atribuída uma única vez no laço, por v = v + c ou v = v - c; uma derivada é atribuída
+///        uma única vez com uma função afim de uma básica, como v * 4 + 1. Cada multiplicação v * k no
+///        laço, com v básica, vira uma temporária ($i1, $i2, ...) que recebe v * k antes do laço e soma
+///        c * k logo depois de cada incremento de v.
+/// @note Os laços ficam registrados em analyzer->loops, com a variável de indução da condição e, quando
+///       a condição compara essa variável com uma constante, o valor inicial é uma constante atribuída
+///       antes do laço e o incremento está diretamente no corpo, o número de voltas. A troca vale com a
+///       aritmética da execução, que trunca em 32 bits: (v + c) * k é sempre v * k + c * k.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória.
+int reduce_induction_variables(semantic_analyzer *analyzer);
+
+/// @brief Move para antes de cada enquanto e repita as operações aritméticas e conversões do corpo e da
+///        condição que só leem variáveis não atribuídas no laço, como limite * 2 + base. O valor de cada
+///        expressão movida fica numa temporária ($t1, $t2, ...), acrescentada à tabela de símbolos e ao
+///        quadro; expressões iguais no mesmo laço compartilham a temporária.
+/// @note Expressões que podem falhar (uma divisão por um valor que pode ser zero) não são movidas, porque
+///       o laço pode não executar (enquanto) ou executar comandos antes de chegar a elas (repita); as
+///       suas partes que não podem falhar são movidas. Os laços são tratados de fora para dentro.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória (a árvore
+///         continua correta, com parte das expressões movidas).
+int hoist_loop_invariants(semantic_analyzer *analyzer);
+
+/// @brief Desenrola os enquanto e repita mais internos de corpo curto, repetindo o corpo algumas vezes
+///        por volta para que a condição seja avaliada menos vezes. Com o número de voltas conhecido, as
+///        voltas que sobram da divisão pelo fator vão antes do laço, e um laço de poucas voltas vira as
+///        cópias do corpo. Sem ele, se a condição compara a variável de indução com uma constante ou
+///        uma variável que o laço não atribui (i < n), o laço desenrolado executa enquanto cabem todas as
+///        cópias (i < n - 3 * passo, para o fator 4) e o laço original termina as voltas restantes.
+/// @note O crescimento da árvore é limitado: o desenrolamento para quando a árvore atingiria
+///       analyzer->optimizations.node_limit nós. Usa o número de voltas e a variável de indução
+///       registrados por reduce_induction_variables().
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória.
+int unroll_loops(semantic_analyzer *analyzer);
+
+/// @brief Elimina as subexpressões comuns: uma operação aritmética ou conversão que se repete, sem que as
+///        variáveis que ela lê tenham sido atribuídas entre as duas ocorrências, é calculada uma vez numa
+///        temporária ($c1, $c2, ...), atribuída logo antes do comando da primeira ocorrência, e as
+///        ocorrências passam a ler a temporária.
+/// @note Cada lista de comandos é uma região: o que é calculado no corpo de um se ou de um laço não vale
+///       depois dele, e o que é calculado antes de um laço só vale dentro dele se o laço não atribui as
+///       variáveis lidas. O lado direito de && e ||, que pode não ser avaliado, só reaproveita. Expressões
+///       que podem falhar não são reaproveitadas, para que o erro aconteça no mesmo ponto.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória.
+int eliminate_common_subexpressions(semantic_analyzer *analyzer);
+
+/// @brief Compartilha os nós de expressão iguais da árvore ajustada (hash-consing): nós com o mesmo tipo,
+///        operador ou constante, símbolo resolvido e filhos passam a ser um único nó, e a árvore ajustada
+///        vira um grafo acíclico. Cada expressão distinta fica com um só nó, que resolve_tree() e a
+///        geração de código tratam uma vez por ocorrência, sem alterá-lo.
+/// @note Deve ser a última otimização: as demais alteram os nós de cada ocorrência. Só são compartilhados
+///       nós da mesma linha, para que o relatório e o erro de divisão por zero mostrem a linha de cada
+///       ocorrência.
+/// @param analyzer O analisador, após os ajustes de um programa sem erros semânticos.
+/// @return 1 se a árvore foi otimizada ou não havia o que otimizar, 0 se faltou memória (a árvore
+///         continua correta, com parte dos nós compartilhados).
+int share_expressions(semantic_analyzer *analyzer);
+
+/// @brief A divisão inteira por uma constante d como multiplicação: q = (multiplier * n) >> 32, mais
+///        correction * n, deslocado shift bits para a direita (aritmético) e somado de 1 se negativo.
+typedef struct division_magic_number
+{
+    int multiplier;
+    int shift;
+    int correction; // 1 se n deve ser somado à parte alta do produto, -1 se subtraído, 0 se nenhum.
+} division_magic_number;
+
+/// @brief Indica se value é uma potência de 2 maior que 1 (como inteiro sem sinal).
+/// @return O expoente k, com value == 2^k, ou -1.
+int power_of_two_exponent(unsigned int value);
+
+/// @brief Calcula o multiplicador que troca a divisão inteira com sinal por divisor por uma
+///        multiplicação, com o mesmo resultado (truncado em direção a zero) para todo dividendo de 32 bits.
+/// @note Usada pela geração de código de máquina, onde a divisão é muito mais lenta que a multiplicação.
+/// @return 1, ou 0 para os divisores 0, 1, -1 e o menor inteiro, que são tratados de outra forma.
+int division_magic(int divisor, division_magic_number *magic);
+
+#endif // OPTIMIZER_H
@@ -0,0 +1,69 @@
+#include "optimizer.h"
+#include "../ir/ir.h"
+
+/// @brief O valor constante lido por uma leitura de variável, ou NULL se ela pode ler valores diferentes.
+static const ir_value *known_value(const ir_program *program, const ir_use *use)
+{
+    const ir_value *value = &program->values[resolve_ir_value(program, use->value)];
+    return (value->state == IR_KNOWN) ? value : NULL;
+}
+
+static int has_known_uses(const ir_program *program)
+{
+    for (int i = 0; i < program->use_count; i++)
+    {
+        if (known_value(program, &program->uses[i]) != NULL)
+            return 1;
+    }
+    return 0;
+}
+
+int propagate_constants(semantic_analyzer *analyzer)
+{
+    ir_program *program = build_ir(analyzer, analyzer->adjusted_tree);
+    if (program == NULL || !propagate_ir_constants(program))
+    {
+        destroy_ir(program);
+        return 0;
+    }
+    if (!has_known_uses(program))
+    {
+        destroy_ir(program);
+        return 1;
+    }
+
+    // As leituras apontam para nós da árvore traduzida; se ela ainda é a original, traduz a cópia
+    if (analyzer->adjusted_tree == analyzer->original_tree)
+    {
+        destroy_ir(program);
+        if (!detach_adjusted_tree(analyzer))
+            return 0;
+        program = build_ir(analyzer, analyzer->adjusted_tree);
+        if (program == NULL || !propagate_ir_constants(program))
+        {
+            destroy_ir(program);
+            return 0;
+        }
+    }
+
+    for (int i = 0; i < program->use_count; i++)
+    {
+        const ir_value *value = known_value(program, &program->uses[i]);
+        if (value == NULL)
+            continue;
+        tree_node *node = program->uses[i].node;
+        node->kind.exp = CONSTANT_EXPRESSION;
+        node->type = value->type;
+        if (value->type == REAL)
+            node->attribute.real_value = value->constant.real_value;
+        else
+            node->attribute.int_value = value->constant.int_value;
+        analyzer->optimizations.propagated_constants++;
+    }
+    destroy_ir(program);
+
+    // As constantes propagadas podem tornar outras expressões constantes e outras variáveis sem uso
+    int ok = fold_constants(analyzer);
+    ok = simplify_algebra(analyzer) && ok;
+    return eliminate_dead_code(analyzer) && ok;
+}
@@ -0,0 +1,199 @@
+#include <stdint.h> // uint64_t, uintptr_t
+#include <stdlib.h> // realloc(), free()
+#include <string.h> // memcpy(), memset()
+#include "optimizer.h"
+
+/// @brief O estado do compartilhamento: uma tabela de espalhamento com um nó de cada expressão distinta.
+/// @note Os nós são comparados pelos filhos já compartilhados, e assim cada comparação olha um só nó.
+typedef struct expression_sharing
+{
+    semantic_analyzer *analyzer;
+    tree_node **nodes;
+    unsigned int *hashes;
+    int *next; // O próximo nó do mesmo balde, ou -1
+    int count;
+    int capacity;
+    int *buckets;
+    int bucket_count; // Uma potência de 2
+    int apply;        // 0 só procura um nó repetido; 1 troca as repetições pelo nó compartilhado
+    int found;
+    int failed;
+} expression_sharing;
+
+static const symbol *resolved_symbol(expression_sharing *state, const tree_node *node)
+{
+    return find_symbol(state->analyzer, node->attribute.name);
+}
+
+/// @note A linha faz parte da identidade de todo nó: o nó compartilhado é o da primeira ocorrência, e a
+///       linha dele aparece no relatório e no erro de divisão por zero de todas as outras.
+static unsigned int hash_node(expression_sharing *state, const tree_node *node, tree_node *const children[2])
+{
+    unsigned int hash = (unsigned int)node->kind.exp * 31u + (unsigned int)node->line_number * 2246822519u;
+    switch (node->kind.exp)
+    {
+    case IDENTIFIER_EXPRESSION:
+        return hash ^ (unsigned int)((uintptr_t)resolved_symbol(state, node) >> 3);
+    case CONSTANT_EXPRESSION:
+        if (node->type == REAL)
+        {
+            uint64_t bits;
+            memcpy(&bits, &node->attribute.real_value, sizeof(bits));
+            return hash ^ (unsigned int)bits ^ (unsigned int)(bits >> 32) * 2654435761u ^ (unsigned int)node->type;
+        }
+        return hash ^ (unsigned int)node->attribute.int_value ^ (unsigned int)node->type;
+    default:
+        hash = hash * 31u + (unsigned int)node->attribute.op;
+        hash = hash * 2654435761u ^ (unsigned int)((uintptr_t)children[0] >> 3);
+        return hash * 2654435761u ^ (unsigned int)((uintptr_t)children[1] >> 3);
+    }
+}
+
+/// @brief Indica se o nó compartilhado representa a mesma expressão que node com os filhos children.
+static int same_node(expression_sharing *state, const tree_node *shared, const tree_node *node,
+                     tree_node *const children[2])
+{
+    if (shared->kind.exp != node->kind.exp || shared->line_number != node->line_number)
+        return 0;
+    switch (node->kind.exp)
+    {
+    case IDENTIFIER_EXPRESSION:
+        return resolved_symbol(state, shared) == resolved_symbol(state, node);
+    case CONSTANT_EXPRESSION:
+        return same_expression(shared, node);
+    default:
+        return shared->attribute.op == node->attribute.op && shared->child[0] == children[0] &&
+               shared->child[1] == children[1];
+    }
+}
+
+static int grow(expression_sharing *state)
+{
+    int capacity = (state->capacity == 0) ? 256 : state->capacity * 2;
+    tree_node **nodes = (tree_node **)realloc(state->nodes, (size_t)capacity * sizeof(tree_node *));
+    if (nodes == NULL)
+        return 0;
+    state->nodes = nodes;
+    unsigned int *hashes = (unsigned int *)realloc(state->hashes, (size_t)capacity * sizeof(unsigned int));
+    if (hashes == NULL)
+        return 0;
+    state->hashes = hashes;
+    int *next = (int *)realloc(state->next, (size_t)capacity * sizeof(int));
+    if (next == NULL)
+        return 0;
+    state->next = next;
+    int *buckets = (int *)realloc(state->buckets, (size_t)capacity * sizeof(int));
+    if (buckets == NULL)
+        return 0;
+    state->buckets = buckets;
+    state->capacity = capacity;
+    state->bucket_count = capacity;
+
+    memset(buckets, -1, (size_t)capacity * sizeof(int));
+    for (int i = 0; i < state->count; i++)
+    {
+        unsigned int bucket = hashes[i] & (unsigned int)(capacity - 1);
+        next[i] = buckets[bucket];
+        buckets[bucket] = i;
+    }
+    return 1;
+}
+
+/// @brief Compartilha uma expressão de baixo para cima.
+/// @return O nó compartilhado que a representa.
+static tree_node *share(expression_sharing *state, tree_node *node)
+{
+    if (node == NULL || state->failed || state->found)
+        return node;
+
+    tree_node *children[2] = {share(state, node->child[0]), share(state, node->child[1])};
+    if (state->apply)
+    {
+        node->child[0] = children[0];
+        node->child[1] = children[1];
+    }
+
+    unsigned int hash = hash_node(state, node, children);
+    if (state->bucket_count > 0)
+    {
+        for (int i = state->buckets[hash & (unsigned int)(state->bucket_count - 1)]; i >= 0; i = state->next[i])
+        {
+            tree_node *shared = state->nodes[i];
+            if (state->hashes[i] != hash || shared == node || !same_node(state, shared, node, children))
+                continue;
+            if (!state->apply)
+                state->found = 1;
+            else
+                state->analyzer->optimizations.shared_nodes++;
+            return shared;
+        }
+    }
+
+    if (state->count == state->capacity && !grow(state))
+    {
+        state->failed = 1;
+        return node;
+    }
+    unsigned int bucket = hash & (unsigned int)(state->bucket_count - 1);
+    state->nodes[state->count] = node;
+    state->hashes[state->count] = hash;
+    state->next[state->count] = state->buckets[bucket];
+    state->buckets[bucket] = state->count++;
+    return node;
+}
+
+static void share_statements(expression_sharing *state, tree_node *node)
+{
+    for (; node != NULL && !state->failed && !state->found; node = node->sibling)
+    {
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] == NULL)
+                continue;
+            if (node->child[i]->node_kind == STATEMENT_KIND)
+                share_statements(state, node->child[i]);
+            else
+            {
+                tree_node *shared = share(state, node->child[i]);
+                if (state->apply)
+                    node->child[i] = shared;
+            }
+        }
+    }
+}
+
+static void release(expression_sharing *state)
+{
+    free(state->nodes);
+    free(state->hashes);
+    free(state->next);
+    free(state->buckets);
+}
+
+int share_expressions(semantic_analyzer *analyzer)
+{
+    expression_sharing state;
+    memset(&state, 0, sizeof(state));
+    state.analyzer = analyzer;
+
+    // Primeiro só procura, até a primeira repetição; a árvore só é copiada se alguma expressão se repetir.
+    // A procura não pode continuar depois dela: sem trocar os filhos, os nós da tabela deixam de ser
+    // comparáveis com os filhos compartilhados e toda repetição seguinte iria para o mesmo balde
+    share_statements(&state, analyzer->adjusted_tree);
+    int ok = !state.failed;
+    if (ok && state.found)
+    {
+        ok = detach_adjusted_tree(analyzer);
+        if (ok)
+        {
+            state.count = 0;
+            memset(state.buckets, -1, (size_t)state.bucket_count * sizeof(int));
+            state.found = 0;
+            state.apply = 1;
+            share_statements(&state, analyzer->adjusted_tree);
+            ok = !state.failed;
+        }
+    }
+    release(&state);
+    return ok;
+}
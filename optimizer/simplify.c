@@ -0,0 +1,251 @@
+#include <math.h> // signbit()
+#include "optimizer.h"
+
+/// @brief O estado da simplificação: com apply == 0, só procura uma expressão que possa ser simplificada.
+typedef struct simplifier
+{
+    semantic_analyzer *analyzer;
+    int apply;
+    int found;
+} simplifier;
+
+static int is_comparison(token_type op)
+{
+    return op == T_MENOR || op == T_MENOR_IGUAL || op == T_MAIOR || op == T_MAIOR_IGUAL ||
+           op == T_IGUAL || op == T_DIFERENTE;
+}
+
+static int is_constant(const tree_node *node)
+{
+    return node->kind.exp == CONSTANT_EXPRESSION;
+}
+
+static int is_integer(const tree_node *node, int value)
+{
+    return is_constant(node) && node->type == INTEGER && node->attribute.int_value == value;
+}
+
+static int is_real(const tree_node *node, double value)
+{
+    return is_constant(node) && node->type == REAL && node->attribute.real_value == value &&
+           !signbit(node->attribute.real_value);
+}
+
+/// @brief Indica se a expressão é uma negação, 0 - x (0.0 - x entre reais).
+static int is_negation(const tree_node *node)
+{
+    return node->kind.exp == OPERATION_EXPRESSION && node->attribute.op == T_SUB &&
+           (is_integer(node->child[0], 0) || is_real(node->child[0], 0.0));
+}
+
+/// @brief Indica se a regra pode ser aplicada; na busca, só registra que há o que simplificar.
+static int rewrite(simplifier *state)
+{
+    if (!state->apply)
+    {
+        state->found = 1;
+        return 0;
+    }
+    state->analyzer->optimizations.simplified_operations++;
+    return 1;
+}
+
+static tree_node *make_integer(tree_node *node, exp_type type, int value)
+{
+    node->kind.exp = CONSTANT_EXPRESSION;
+    node->type = type;
+    node->attribute.int_value = value;
+    node->child[0] = node->child[1] = NULL;
+    return node;
+}
+
+static int comparison_with_itself(token_type op)
+{
+    return op == T_MENOR_IGUAL || op == T_MAIOR_IGUAL || op == T_IGUAL;
+}
+
+/// @brief Aplica as identidades a uma comparação cujos operandos já foram simplificados.
+static void simplify_comparison(simplifier *state, tree_node *node, data_type type)
+{
+    tree_node *left = node->child[0];
+    tree_node *right = node->child[1];
+    token_type op = node->attribute.op;
+
+    // -a == -b é a == b; entre reais, -a < -b é b < a (entre inteiros, -x pode transbordar)
+    if (is_negation(left) && is_negation(right) &&
+        (op == T_IGUAL || op == T_DIFERENTE || type == DT_REAL) && rewrite(state))
+    {
+        node->child[0] = left->child[1];
+        node->child[1] = right->child[1];
+        if (op != T_IGUAL && op != T_DIFERENTE)
+        {
+            node->child[0] = right->child[1];
+            node->child[1] = left->child[1];
+        }
+        return;
+    }
+
+    // x < x, x == x, ... entre inteiros (entre reais, x pode ser NaN)
+    if (type == DT_INTEGER && same_expression(left, right) && !expression_may_fail(left) && rewrite(state))
+        make_integer(node, BOOLEAN, comparison_with_itself(op));
+}
+
+/// @brief Aplica as identidades a uma operação aritmética cujos operandos já foram simplificados.
+/// @return O nó que substitui a operação.
+static tree_node *simplify_arithmetic(simplifier *state, tree_node *node, data_type type)
+{
+    tree_node *left = node->child[0];
+    tree_node *right = node->child[1];
+    int integer = (type == DT_INTEGER);
+
+    switch (node->attribute.op)
+    {
+    case T_MULT:
+        if ((is_integer(right, 1) || is_real(right, 1.0)) && rewrite(state))
+            return left;
+        if ((is_integer(left, 1) || is_real(left, 1.0)) && rewrite(state))
+            return right;
+        if (integer && (is_integer(right, 0) || is_integer(left, 0)))
+        {
+            tree_node *other = is_integer(right, 0) ? left : right;
+            if (!expression_may_fail(other) && rewrite(state))
+                return make_integer(node, INTEGER, 0);
+        }
+        if (integer && is_integer(right, -1) && rewrite(state))
+        {
+            // x * -1 é 0 - x, que dispensa a multiplicação
+            node->attribute.op = T_SUB;
+            right->attribute.int_value = 0;
+            node->child[0] = right;
+            node->child[1] = left;
+        }
+        return node;
+    case T_DIV:
+        if ((is_integer(right, 1) || is_real(right, 1.0)) && rewrite(state))
+            return left;
+        return node;
+    case T_SOMA:
+        if (!integer)
+            return node; // -0.0 + 0.0 é 0.0
+        if (is_integer(right, 0) && rewrite(state))
+            return left;
+        if (is_integer(left, 0) && rewrite(state))
+            return right;
+        if (is_negation(right) && rewrite(state))
+        {
+            node->attribute.op = T_SUB; // x + (0 - y) é x - y
+            node->child[1] = right->child[1];
+        }
+        else if (is_negation(left) && rewrite(state))
+        {
+            node->attribute.op = T_SUB; // (0 - x) + y é y - x
+            node->child[0] = right;
+            node->child[1] = left->child[1];
+        }
+        return node;
+    case T_SUB:
+        if ((is_integer(right, 0) || is_real(right, 0.0)) && rewrite(state))
+            return left;
+        if (!integer)
+            return node;
+        if (same_expression(left, right) && !expression_may_fail(left) && rewrite(state))
+            return make_integer(node, INTEGER, 0);
+        if (is_negation(right) && rewrite(state))
+        {
+            // 0 - (0 - y) é y; x - (0 - y) é x + y
+            if (is_integer(left, 0))
+                return right->child[1];
+            node->attribute.op = T_SOMA;
+            node->child[1] = right->child[1];
+        }
+        return node;
+    default:
+        return node;
+    }
+}
+
+/// @brief Simplifica uma expressão de baixo para cima.
+/// @return O tipo da expressão.
+static data_type simplify_expression(simplifier *state, tree_node **slot)
+{
+    tree_node *node = *slot;
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        return (node->type == REAL) ? DT_REAL : (node->type == BOOLEAN) ? DT_BOOLEAN : DT_INTEGER;
+    case IDENTIFIER_EXPRESSION:
+    {
+        symbol *sym = find_symbol(state->analyzer, node->attribute.name);
+        return (sym != NULL) ? sym->type : DT_VOID;
+    }
+    case CONVERSION_EXPRESSION:
+        simplify_expression(state, &node->child[0]);
+        return DT_REAL;
+    case OPERATION_EXPRESSION:
+    default:
+        break;
+    }
+
+    data_type left = simplify_expression(state, &node->child[0]);
+    data_type right = simplify_expression(state, &node->child[1]);
+    token_type op = node->attribute.op;
+    if (op == T_E || op == T_OU)
+        return DT_BOOLEAN;
+    data_type type = (left == DT_REAL || right == DT_REAL) ? DT_REAL : DT_INTEGER;
+    if (is_comparison(op))
+    {
+        simplify_comparison(state, node, type);
+        return DT_BOOLEAN;
+    }
+
+    // Entre inteiros, a constante de + e * vai para a direita, onde as regras e a geração de código a procuram
+    if (type == DT_INTEGER && (op == T_SOMA || op == T_MULT) && is_constant(node->child[0]) &&
+        !is_constant(node->child[1]))
+    {
+        if (!state->apply)
+            state->found = 1;
+        else
+        {
+            tree_node *constant = node->child[0];
+            node->child[0] = node->child[1];
+            node->child[1] = constant;
+        }
+    }
+    *slot = simplify_arithmetic(state, node, type);
+    return type;
+}
+
+static void simplify_statements(simplifier *state, tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] == NULL)
+                continue;
+            if (node->child[i]->node_kind == STATEMENT_KIND)
+                simplify_statements(state, node->child[i]);
+            else
+                simplify_expression(state, &node->child[i]);
+        }
+    }
+}
+
+int simplify_algebra(semantic_analyzer *analyzer)
+{
+    simplifier state = {analyzer, 0, 0};
+    simplify_statements(&state, analyzer->adjusted_tree);
+    if (!state.found)
+        return 1;
+    if (!detach_adjusted_tree(analyzer))
+        return 0;
+
+    state.apply = 1;
+    int before = analyzer->optimizations.simplified_operations;
+    simplify_statements(&state, analyzer->adjusted_tree);
+
+    // Uma identidade pode deixar uma operação entre constantes, como (x - x) * 3
+    if (analyzer->optimizations.simplified_operations != before)
+        return fold_constants(analyzer);
+    return 1;
+}
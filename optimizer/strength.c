@@ -0,0 +1,59 @@
+#include "optimizer.h"
+
+int power_of_two_exponent(unsigned int value)
+{
+    if (value < 2 || (value & (value - 1)) != 0)
+        return -1;
+    int exponent = 0;
+    while ((value >>= 1) != 0)
+        exponent++;
+    return exponent;
+}
+
+int division_magic(int divisor, division_magic_number *magic)
+{
+    // O menor inteiro não tem valor absoluto em 32 bits; 0, 1 e -1 não precisam de divisão
+    if (divisor == 0 || divisor == 1 || divisor == -1 || divisor == (int)0x80000000u)
+        return 0;
+
+    // Hacker's Delight, 10-1: o menor p tal que 2^p > nc * (d - 2^p mod d), com nc o maior
+    // dividendo cujo resto é d - 1
+    const unsigned int two31 = 0x80000000u;
+    unsigned int absolute = (divisor < 0) ? 0u - (unsigned int)divisor : (unsigned int)divisor;
+    unsigned int t = two31 + ((unsigned int)divisor >> 31);
+    unsigned int nc = t - 1 - t % absolute;
+    unsigned int q1 = two31 / nc, r1 = two31 - q1 * nc;
+    unsigned int q2 = two31 / absolute, r2 = two31 - q2 * absolute;
+    unsigned int delta;
+    int p = 31;
+    do
+    {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= nc)
+        {
+            q1++;
+            r1 -= nc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= absolute)
+        {
+            q2++;
+            r2 -= absolute;
+        }
+        delta = absolute - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    magic->multiplier = (int)(q2 + 1);
+    if (divisor < 0)
+        magic->multiplier = -magic->multiplier;
+    magic->shift = p - 32;
+    magic->correction = 0;
+    if (divisor > 0 && magic->multiplier < 0)
+        magic->correction = 1;
+    else if (divisor < 0 && magic->multiplier > 0)
+        magic->correction = -1;
+    return 1;
+}
@@ -0,0 +1,496 @@
+#include <limits.h> // INT_MIN, INT_MAX
+#include <stdlib.h> // free()
+#include <string.h> // memset(), strcmp()
+#include "optimizer.h"
+
+/// @brief Quantas cópias do corpo, no máximo, cada volta de um laço desenrolado executa.
+#define UNROLL_MAX_FACTOR 8
+
+/// @brief Só os corpos com até tantos nós são desenrolados: nos maiores, a condição pesa pouco.
+#define UNROLL_MAX_BODY_NODES 32
+
+/// @brief O tamanho máximo, em nós, das cópias do corpo num laço desenrolado.
+#define UNROLL_MAX_UNROLLED_NODES 128
+
+/// @brief O crescimento da árvore permitido mesmo nos programas pequenos, em nós.
+#define UNROLL_MIN_BUDGET 512
+
+/// @brief Como um laço vai ser desenrolado.
+typedef struct unroll_plan
+{
+    int factor;             // Cópias do corpo por volta; 0 se o laço vira só as cópias do prólogo
+    int prologue;           // Cópias do corpo antes do laço
+    const tree_node *bound; // Sem o número de voltas: o limite da condição i op limite; NULL com ele
+    token_type op;          // A comparação que mantém o laço, como num enquanto
+    int offset;             // (factor - 1) * passo: o quanto a variável de indução avança até a última cópia
+    int growth;             // Quantos nós a árvore ganha
+} unroll_plan;
+
+/// @brief O estado do desenrolamento.
+typedef struct unroller
+{
+    semantic_analyzer *analyzer;
+    loop_entry *index;
+    int node_count; // O tamanho que a árvore tem depois dos laços já desenrolados
+    int apply;      // 0 só procura um laço que possa ser desenrolado; 1 desenrola
+    int found;
+    int temporaries;
+    int failed;
+} unroller;
+
+static int count_nodes(const tree_node *node)
+{
+    int count = 0;
+    for (; node != NULL; node = node->sibling)
+    {
+        count++;
+        for (int i = 0; i < MAXCHILDREN; i++)
+            count += count_nodes(node->child[i]);
+    }
+    return count;
+}
+
+static int contains_loop(const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (is_loop(node))
+            return 1;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND && contains_loop(node->child[i]))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/// @brief Indica se a variável é atribuída ou lida com ler() numa lista de comandos.
+static int assigns(const tree_node *node, const char *name)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if ((node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT) &&
+            strcmp(node->attribute.name, name) == 0)
+            return 1;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND && assigns(node->child[i], name))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/// @brief Reconhece a condição de um laço sem número de voltas conhecido que pode ser desenrolado: a
+///        variável de indução, incrementada diretamente no corpo, comparada com uma constante ou com uma
+///        variável inteira que o laço não atribui, na direção em que ela avança (i < n com passo positivo).
+static int bounded_condition(unroller *state, tree_node *loop, const loop_info *info, unroll_plan *plan)
+{
+    const char *variable = info->induction_variable;
+    const tree_node *condition = loop_condition(loop);
+    if (variable == NULL || condition->kind.exp != OPERATION_EXPRESSION)
+        return 0;
+
+    token_type op = condition->attribute.op;
+    const tree_node *bound;
+    if (is_variable(condition->child[0], variable))
+        bound = condition->child[1];
+    else if (is_variable(condition->child[1], variable))
+    {
+        bound = condition->child[0];
+        op = swapped_comparison(op);
+    }
+    else
+        return 0;
+    if (loop->kind.stmt == REPEAT_STATEMENT)
+        op = negated_comparison(op); // repita ... ate c continua enquanto c é falsa
+
+    int forward = (op == T_MENOR || op == T_MENOR_IGUAL) && info->step > 0;
+    int backward = (op == T_MAIOR || op == T_MAIOR_IGUAL) && info->step < 0;
+    if (!forward && !backward)
+        return 0;
+    if (bound->kind.exp == CONSTANT_EXPRESSION)
+    {
+        if (bound->type != INTEGER)
+            return 0;
+    }
+    else if (bound->kind.exp == IDENTIFIER_EXPRESSION)
+    {
+        symbol *sym = find_symbol(state->analyzer, bound->attribute.name);
+        if (sym == NULL || sym->type != DT_INTEGER || assigns(loop_body(loop), bound->attribute.name))
+            return 0;
+    }
+    else
+        return 0;
+
+    // O incremento precisa executar uma vez em cada cópia do corpo
+    const tree_node *node = loop_body(loop);
+    while (node != NULL && !(node->kind.stmt == ASSIGNMENT_STATEMENT && strcmp(node->attribute.name, variable) == 0))
+        node = node->sibling;
+    if (node == NULL)
+        return 0;
+
+    plan->bound = bound;
+    plan->op = op;
+    return 1;
+}
+
+/// @brief O maior fator, potência de 2, cujas cópias do corpo cabem em UNROLL_MAX_UNROLLED_NODES.
+static int largest_factor(int body_nodes)
+{
+    int factor = UNROLL_MAX_FACTOR;
+    while (factor > 1 && factor * body_nodes > UNROLL_MAX_UNROLLED_NODES)
+        factor /= 2;
+    return factor;
+}
+
+/// @brief Escolhe como desenrolar um laço mais interno dentro do que ainda resta do limite de nós.
+/// @return 1 se o laço deve ser desenrolado.
+static int plan_unrolling(unroller *state, tree_node *loop, const loop_info *info, unroll_plan *plan)
+{
+    memset(plan, 0, sizeof(*plan));
+    int body_nodes = count_nodes(loop_body(loop));
+    if (body_nodes > UNROLL_MAX_BODY_NODES)
+        return 0;
+    int budget = state->analyzer->optimizations.node_limit - state->node_count;
+
+    if (info->trip_count >= 0)
+    {
+        // Poucas voltas: o laço vira as cópias do corpo, sem nenhuma avaliação da condição
+        int trips = info->trip_count;
+        if (trips <= 2 * UNROLL_MAX_FACTOR && trips * body_nodes <= UNROLL_MAX_UNROLLED_NODES)
+        {
+            plan->prologue = trips;
+            plan->growth = (trips - 1) * body_nodes - count_nodes(loop_condition(loop)) - 1;
+            return plan->growth <= budget;
+        }
+
+        // As voltas que sobram da divisão pelo fator vão antes do laço; o laço executa ao menos uma volta
+        for (int factor = largest_factor(body_nodes); factor >= 2; factor /= 2)
+        {
+            plan->factor = factor;
+            plan->prologue = trips % factor;
+            plan->growth = (factor - 1 + plan->prologue) * body_nodes;
+            if (plan->growth <= budget)
+                return 1;
+        }
+        return 0;
+    }
+
+    if (!bounded_condition(state, loop, info, plan))
+        return 0;
+    for (int factor = largest_factor(body_nodes); factor >= 2; factor /= 2)
+    {
+        long long offset = (long long)(factor - 1) * info->step;
+        if (offset > INT_MAX / 2 || offset < INT_MIN / 2)
+            continue;
+        plan->factor = factor;
+        plan->offset = (int)offset;
+
+        // O laço desenrolado e a sua condição; com um limite variável, o se que evita o transbordamento de
+        // limite - offset e a atribuição desse valor a uma temporária
+        plan->growth = factor * body_nodes + 4;
+        if (plan->bound->kind.exp == CONSTANT_EXPRESSION)
+        {
+            long long bound = (long long)plan->bound->attribute.int_value - offset;
+            if (bound < INT_MIN || bound > INT_MAX)
+                continue;
+        }
+        else
+            plan->growth += 8;
+        if (loop->kind.stmt == REPEAT_STATEMENT)
+            plan->growth += body_nodes; // O primeiro corpo fica antes; o repita vira um enquanto
+        if (plan->growth <= budget)
+            return 1;
+    }
+    return 0;
+}
+
+/// @brief Copia uma lista de comandos count vezes, em sequência.
+/// @param last Recebe o último comando da última cópia.
+/// @return A primeira cópia, ou NULL se count é 0 ou faltou memória (state->failed).
+static tree_node *copy_body(unroller *state, const tree_node *body, int count, tree_node **last)
+{
+    tree_node *first = NULL;
+    *last = NULL;
+    for (int i = 0; i < count; i++)
+    {
+        tree_node *copy = copy_tree(state->analyzer->arena, body);
+        if (copy == NULL)
+        {
+            state->failed = 1;
+            return NULL;
+        }
+        if (first == NULL)
+            first = copy;
+        else
+            (*last)->sibling = copy;
+        for (*last = copy; (*last)->sibling != NULL; *last = (*last)->sibling)
+            ;
+    }
+    return first;
+}
+
+static tree_node *new_constant(unroller *state, int value, int line)
+{
+    tree_node *node = new_expression_node(state->analyzer->arena, CONSTANT_EXPRESSION, line);
+    if (node == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    node->type = INTEGER;
+    node->attribute.int_value = value;
+    return node;
+}
+
+static tree_node *new_read(unroller *state, const char *name, int line)
+{
+    tree_node *node = new_expression_node(state->analyzer->arena, IDENTIFIER_EXPRESSION, line);
+    if (node == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    node->attribute.name = (char *)name;
+    return node;
+}
+
+static tree_node *new_operation(unroller *state, token_type op, tree_node *left, tree_node *right, int line)
+{
+    tree_node *node = new_expression_node(state->analyzer->arena, OPERATION_EXPRESSION, line);
+    if (node == NULL || left == NULL || right == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    node->attribute.op = op;
+    node->child[0] = left;
+    node->child[1] = right;
+    return node;
+}
+
+/// @brief Cria uma temporária inteira ($u1, $u2, ...) para o limite do laço desenrolado.
+/// @return O nome, ou NULL se faltou memória.
+static const char *new_temporary(unroller *state, int line)
+{
+    const char *temporary = new_optimizer_temporary(state->analyzer, 'u', state->temporaries + 1, DT_INTEGER, line);
+    if (temporary == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    state->temporaries++;
+    return temporary;
+}
+
+/// @brief Monta o laço desenrolado de um laço sem número de voltas conhecido. Com um limite variável n,
+///        ele fica dentro de se n >= INT_MIN + offset entao { $u = n - offset; enquanto (i op $u) ... }
+///        (n <= INT_MAX + offset com passo negativo), para que n - offset não transborde.
+/// @param unrolled Recebe o enquanto desenrolado.
+/// @return O comando que vai antes do laço que termina as voltas restantes.
+static tree_node *build_unrolled_loop(unroller *state, tree_node *loop, const loop_info *info, const unroll_plan *plan,
+                                      tree_node **unrolled)
+{
+    int line = loop->line_number;
+    tree_node *last;
+    tree_node *main_loop = new_statement_node(state->analyzer->arena, WHILE_STATEMENT, line);
+    tree_node *body = copy_body(state, loop_body(loop), plan->factor, &last);
+    if (main_loop == NULL || body == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    main_loop->child[1] = body;
+    *unrolled = main_loop;
+
+    const char *variable = info->induction_variable;
+    if (plan->bound->kind.exp == CONSTANT_EXPRESSION)
+    {
+        int bound = plan->bound->attribute.int_value - plan->offset;
+        main_loop->child[0] =
+            new_operation(state, plan->op, new_read(state, variable, line), new_constant(state, bound, line), line);
+        return main_loop;
+    }
+
+    const char *limit = plan->bound->attribute.name;
+    const char *temporary = new_temporary(state, line);
+    tree_node *assignment = new_statement_node(state->analyzer->arena, ASSIGNMENT_STATEMENT, line);
+    tree_node *guard = new_statement_node(state->analyzer->arena, IF_STATEMENT, line);
+    if (temporary == NULL || assignment == NULL || guard == NULL)
+    {
+        state->failed = 1;
+        return NULL;
+    }
+    assignment->attribute.name = (char *)temporary;
+    assignment->child[0] =
+        new_operation(state, T_SUB, new_read(state, limit, line), new_constant(state, plan->offset, line), line);
+    assignment->sibling = main_loop;
+    main_loop->child[0] =
+        new_operation(state, plan->op, new_read(state, variable, line), new_read(state, temporary, line), line);
+
+    int positive = plan->offset > 0;
+    int safe = positive ? INT_MIN + plan->offset : INT_MAX + plan->offset;
+    guard->child[0] = new_operation(state, positive ? T_MAIOR_IGUAL : T_MENOR_IGUAL, new_read(state, limit, line),
+                                    new_constant(state, safe, line), line);
+    guard->child[1] = assignment;
+    return guard;
+}
+
+/// @brief Desenrola o laço em *link, se o plano couber no limite de nós.
+/// @return O elo do comando seguinte ao que substituiu o laço.
+static tree_node **unroll_loop(unroller *state, tree_node **link)
+{
+    tree_node *loop = *link;
+    loop_info *info = find_loop_info(state->index, state->analyzer->loop_count, loop);
+    unroll_plan plan;
+    if (info == NULL || !plan_unrolling(state, loop, info, &plan))
+        return &loop->sibling;
+    state->node_count += plan.growth;
+    if (!state->apply)
+    {
+        state->found = 1;
+        return &loop->sibling;
+    }
+
+    tree_node *next = loop->sibling;
+    tree_node *body = loop_body(loop);
+    tree_node *first, *last;
+    if (plan.bound == NULL)
+    {
+        // O prólogo, seguido do laço com as cópias do corpo, ou sozinho se o laço some
+        first = copy_body(state, body, plan.prologue, &last);
+        tree_node *unrolled_last;
+        tree_node *unrolled = copy_body(state, body, plan.factor, &unrolled_last);
+        if (state->failed)
+            return &loop->sibling;
+        if (plan.factor > 0)
+        {
+            if (loop->kind.stmt == WHILE_STATEMENT)
+                loop->child[1] = unrolled;
+            else
+                loop->child[0] = unrolled;
+            if (first == NULL)
+                first = loop;
+            else
+                last->sibling = loop;
+            last = loop;
+            info->unroll_factor = plan.factor;
+        }
+        else
+        {
+            info->loop = NULL;
+            info->unroll_factor = plan.prologue;
+        }
+    }
+    else
+    {
+        // O laço desenrolado, depois o laço original, que termina as voltas restantes; um repita
+        // executa o primeiro corpo antes e vira um enquanto com a condição negada
+        tree_node *unrolled;
+        tree_node *before = build_unrolled_loop(state, loop, info, &plan, &unrolled);
+        tree_node *remainder = loop;
+        first = before;
+        if (loop->kind.stmt == REPEAT_STATEMENT && !state->failed)
+        {
+            tree_node *copy_last;
+            remainder = new_statement_node(state->analyzer->arena, WHILE_STATEMENT, loop->line_number);
+            tree_node *copy = copy_body(state, body, 1, &copy_last);
+            if (remainder == NULL || copy == NULL)
+                state->failed = 1;
+            else
+            {
+                tree_node *condition = loop->child[1];
+                condition->attribute.op = negated_comparison(condition->attribute.op);
+                remainder->child[0] = condition;
+                remainder->child[1] = copy;
+                first = body;
+                for (last = body; last->sibling != NULL; last = last->sibling)
+                    ;
+                last->sibling = before;
+            }
+        }
+        if (state->failed)
+            return &loop->sibling; // O laço continua no lugar, inteiro
+        before->sibling = remainder;
+        last = remainder;
+        info->loop = unrolled;
+        info->unroll_factor = plan.factor;
+    }
+
+    state->analyzer->optimizations.unrolled_loops++;
+    if (first == NULL)
+    {
+        *link = next;
+        return link;
+    }
+    *link = first;
+    last->sibling = next;
+    return &last->sibling;
+}
+
+/// @brief Desenrola os laços mais internos de uma lista de comandos.
+static void unroll_list(unroller *state, tree_node **list)
+{
+    tree_node **link = list;
+    while (*link != NULL && !state->failed)
+    {
+        tree_node *node = *link;
+        if (is_loop(node) && !contains_loop(loop_body(node)))
+        {
+            link = unroll_loop(state, link);
+            continue;
+        }
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (node->child[i] != NULL && node->child[i]->node_kind == STATEMENT_KIND)
+                unroll_list(state, &node->child[i]);
+        }
+        link = &node->sibling;
+    }
+}
+
+int unroll_loops(semantic_analyzer *analyzer)
+{
+    optimization_stats *stats = &analyzer->optimizations;
+    stats->node_count_before = count_nodes(analyzer->adjusted_tree);
+    stats->node_count = stats->node_count_before;
+    int budget = stats->node_count_before / 2;
+    stats->node_limit = stats->node_count_before + ((budget > UNROLL_MIN_BUDGET) ? budget : UNROLL_MIN_BUDGET);
+    if (analyzer->loop_count == 0)
+        return 1;
+
+    unroller state;
+    memset(&state, 0, sizeof(state));
+    state.analyzer = analyzer;
+    state.node_count = stats->node_count_before;
+    state.index = index_loops(analyzer);
+    if (state.index == NULL)
+        return 0;
+
+    // Primeiro só procura; a árvore só é copiada se algum laço for desenrolado
+    unroll_list(&state, &analyzer->adjusted_tree);
+    int ok = 1;
+    if (state.found)
+    {
+        ok = detach_adjusted_tree(analyzer);
+        if (ok)
+        {
+            // A cópia mudou os endereços dos laços
+            free(state.index);
+            state.index = index_loops(analyzer);
+            ok = state.index != NULL;
+        }
+        if (ok)
+        {
+            state.apply = 1;
+            state.node_count = stats->node_count_before;
+            unroll_list(&state, &analyzer->adjusted_tree);
+            ok = !state.failed;
+            stats->node_count = count_nodes(analyzer->adjusted_tree);
+        }
+    }
+    free(state.index);
+    return ok;
+}
@@ -0,0 +1,326 @@
+#include <stdlib.h> // malloc(), realloc(), calloc(), free()
+#include <string.h> // strcmp(), memset()
+#include "flat_tree.h"
+
+/// @brief Capacidade inicial dos vetores da árvore compacta.
+#define FLAT_INITIAL_CAPACITY 256
+
+/// @brief Calcula o hash FNV-1a de um nome.
+static uint32_t hash_name(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name != '\0')
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hash_address(const tree_node *node)
+{
+    return (uint32_t)(((uintptr_t)node >> 3) * 2654435761u);
+}
+
+/// @brief Aumenta um vetor para capacity elementos de size bytes.
+/// @return 1 em caso de sucesso, 0 se não houver memória (o vetor fica como estava).
+static int grow_array(void **array, uint32_t capacity, size_t size)
+{
+    void *grown = realloc(*array, (size_t)capacity * size);
+    if (grown == NULL)
+        return 0;
+    *array = grown;
+    return 1;
+}
+
+static int grow_nodes(flat_tree *flat)
+{
+    uint32_t capacity = (flat->capacity == 0) ? FLAT_INITIAL_CAPACITY : flat->capacity * 2;
+    if (!grow_array((void **)&flat->kinds, capacity, sizeof(uint8_t)) ||
+        !grow_array((void **)&flat->types, capacity, sizeof(uint8_t)) ||
+        !grow_array((void **)&flat->child_counts, capacity, sizeof(uint8_t)) ||
+        !grow_array((void **)&flat->ops, capacity, sizeof(uint16_t)) ||
+        !grow_array((void **)&flat->lines, capacity, sizeof(int32_t)) ||
+        !grow_array((void **)&flat->values, capacity, sizeof(int32_t)) ||
+        !grow_array((void **)&flat->next, capacity, sizeof(node_id)) ||
+        !grow_array((void **)&flat->first_child, capacity, sizeof(node_id)))
+        return 0;
+    flat->capacity = capacity;
+    return 1;
+}
+
+/// @brief Reserva count posições seguidas em children.
+/// @return A primeira posição reservada, ou FLAT_NONE se não houver memória.
+static node_id reserve_children(flat_tree *flat, uint32_t count)
+{
+    if (flat->child_total + count > flat->child_capacity)
+    {
+        uint32_t capacity = (flat->child_capacity == 0) ? FLAT_INITIAL_CAPACITY : flat->child_capacity * 2;
+        if (!grow_array((void **)&flat->children, capacity, sizeof(node_id)))
+            return FLAT_NONE;
+        flat->child_capacity = capacity;
+    }
+    node_id first = flat->child_total;
+    flat->child_total += count;
+    return first;
+}
+
+/// @brief Procura a posição de um nome no índice de espalhamento dos nomes.
+/// @return A posição que contém o nome, ou a posição vazia onde ele seria inserido.
+static uint32_t find_name_slot(const flat_tree *flat, const char *name, uint32_t hash)
+{
+    uint32_t mask = flat->name_slot_count - 1;
+    uint32_t slot = hash & mask;
+    while (flat->name_slots[slot] != 0 && strcmp(flat->names[flat->name_slots[slot] - 1], name) != 0)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+/// @brief Dobra a capacidade dos nomes, reconstruindo o índice (com ocupação máxima de 50%).
+static int grow_names(flat_tree *flat)
+{
+    uint32_t capacity = (flat->name_capacity == 0) ? FLAT_INITIAL_CAPACITY : flat->name_capacity * 2;
+    uint32_t *slots = (uint32_t *)calloc((size_t)capacity * 2, sizeof(uint32_t));
+    if (slots == NULL || !grow_array((void **)&flat->names, capacity, sizeof(const char *)))
+    {
+        free(slots);
+        return 0;
+    }
+    flat->name_capacity = capacity;
+    free(flat->name_slots);
+    flat->name_slots = slots;
+    flat->name_slot_count = capacity * 2;
+    for (uint32_t i = 0; i < flat->name_count; i++)
+        slots[find_name_slot(flat, flat->names[i], hash_name(flat->names[i]))] = i + 1;
+    return 1;
+}
+
+/// @brief Guarda um nome uma única vez.
+/// @return O índice do nome em names, ou -1 se não houver memória.
+static int32_t intern_name(flat_tree *flat, const char *name)
+{
+    uint32_t hash = hash_name(name);
+    if (flat->name_slot_count > 0)
+    {
+        uint32_t slot = find_name_slot(flat, name, hash);
+        if (flat->name_slots[slot] != 0)
+            return (int32_t)flat->name_slots[slot] - 1;
+    }
+    if (flat->name_count == flat->name_capacity && !grow_names(flat))
+        return -1;
+    flat->names[flat->name_count++] = name;
+    flat->name_slots[find_name_slot(flat, name, hash)] = flat->name_count;
+    return (int32_t)flat->name_count - 1;
+}
+
+static int32_t add_real(flat_tree *flat, double value)
+{
+    if (flat->real_count == flat->real_capacity)
+    {
+        uint32_t capacity = (flat->real_capacity == 0) ? FLAT_INITIAL_CAPACITY : flat->real_capacity * 2;
+        if (!grow_array((void **)&flat->reals, capacity, sizeof(double)))
+            return -1;
+        flat->real_capacity = capacity;
+    }
+    flat->reals[flat->real_count] = value;
+    return (int32_t)flat->real_count++;
+}
+
+/// @brief Procura a posição de um nó de expressão no espalhamento dos nós já convertidos.
+static uint32_t find_seen_slot(const flat_tree *flat, const tree_node *node)
+{
+    uint32_t mask = flat->seen_slot_count - 1;
+    uint32_t slot = hash_address(node) & mask;
+    while (flat->seen_nodes[slot] != NULL && flat->seen_nodes[slot] != node)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+/// @brief Registra que node foi convertido no índice id.
+/// @return 1 em caso de sucesso, 0 se não houver memória.
+static int remember_node(flat_tree *flat, const tree_node *node, node_id id)
+{
+    if ((flat->seen_count + 1) * 2 > flat->seen_slot_count)
+    {
+        uint32_t slot_count = (flat->seen_slot_count == 0) ? FLAT_INITIAL_CAPACITY * 2 : flat->seen_slot_count * 2;
+        const tree_node **nodes = (const tree_node **)calloc(slot_count, sizeof(const tree_node *));
+        node_id *ids = (node_id *)malloc((size_t)slot_count * sizeof(node_id));
+        if (nodes == NULL || ids == NULL)
+        {
+            free(nodes);
+            free(ids);
+            return 0;
+        }
+
+        const tree_node **old_nodes = flat->seen_nodes;
+        node_id *old_ids = flat->seen_ids;
+        uint32_t old_slot_count = flat->seen_slot_count;
+        flat->seen_nodes = nodes;
+        flat->seen_ids = ids;
+        flat->seen_slot_count = slot_count;
+        for (uint32_t i = 0; i < old_slot_count; i++)
+        {
+            if (old_nodes[i] == NULL)
+                continue;
+            uint32_t slot = find_seen_slot(flat, old_nodes[i]);
+            nodes[slot] = old_nodes[i];
+            ids[slot] = old_ids[i];
+        }
+        free(old_nodes);
+        free(old_ids);
+    }
+
+    uint32_t slot = find_seen_slot(flat, node);
+    flat->seen_nodes[slot] = node;
+    flat->seen_ids[slot] = id;
+    flat->seen_count++;
+    return 1;
+}
+
+/// @brief Converte uma lista de nós, em pré-ordem.
+/// @return O índice do primeiro nó, FLAT_NONE se a lista é vazia; *failed indica falta de memória.
+static node_id flatten_list(flat_tree *flat, const tree_node *tree, int *failed)
+{
+    node_id first = FLAT_NONE, previous = FLAT_NONE;
+    for (; tree != NULL && !*failed; tree = tree->sibling)
+    {
+        int is_expression = (tree->node_kind == EXPRESSION_KIND);
+        if (is_expression && flat->seen_count > 0)
+        {
+            uint32_t slot = find_seen_slot(flat, tree);
+            if (flat->seen_nodes[slot] == tree)
+                return flat->seen_ids[slot]; // As expressões não têm irmãos
+        }
+
+        if (flat->count == flat->capacity && !grow_nodes(flat))
+        {
+            *failed = 1;
+            break;
+        }
+        node_id id = flat->count++;
+        if (is_expression && !remember_node(flat, tree, id))
+        {
+            *failed = 1;
+            break;
+        }
+
+        int32_t value = 0;
+        int has_index = 0; // value é um índice em names ou reals, e -1 indica falta de memória
+        if (!is_expression)
+        {
+            flat->kinds[id] = (uint8_t)tree->kind.stmt;
+            if (tree->kind.stmt == ASSIGNMENT_STATEMENT || tree->kind.stmt == READ_STATEMENT ||
+                tree->kind.stmt == DECLARATION_STATEMENT)
+            {
+                value = intern_name(flat, tree->attribute.name);
+                has_index = 1;
+            }
+        }
+        else
+        {
+            flat->kinds[id] = (uint8_t)(FLAT_OPERATION + tree->kind.exp);
+            if (tree->kind.exp == IDENTIFIER_EXPRESSION)
+            {
+                value = intern_name(flat, tree->attribute.name);
+                has_index = 1;
+            }
+            else if (tree->kind.exp == CONSTANT_EXPRESSION && tree->type == REAL)
+            {
+                value = add_real(flat, tree->attribute.real_value);
+                has_index = 1;
+            }
+            else if (tree->kind.exp == CONSTANT_EXPRESSION)
+                value = tree->attribute.int_value;
+        }
+        if (has_index && value < 0)
+        {
+            *failed = 1;
+            break;
+        }
+        flat->values[id] = value;
+        flat->types[id] = (uint8_t)tree->type;
+        flat->ops[id] = (is_expression && tree->kind.exp == OPERATION_EXPRESSION) ? (uint16_t)tree->attribute.op : 0;
+        flat->lines[id] = tree->line_number;
+        flat->next[id] = FLAT_NONE;
+
+        // Só as posições até o último filho presente ocupam espaço
+        uint8_t child_count = 0;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            if (tree->child[i] != NULL)
+                child_count = (uint8_t)(i + 1);
+        }
+        flat->child_counts[id] = child_count;
+        flat->first_child[id] = (child_count > 0) ? reserve_children(flat, child_count) : flat->child_total;
+        if (flat->first_child[id] == FLAT_NONE)
+        {
+            *failed = 1;
+            break;
+        }
+        for (int i = 0; i < child_count; i++)
+        {
+            // O vetor children pode mudar de lugar durante a conversão do filho
+            node_id child = flatten_list(flat, tree->child[i], failed);
+            flat->children[flat->first_child[id] + i] = child;
+        }
+
+        if (previous == FLAT_NONE)
+            first = id;
+        else
+            flat->next[previous] = id;
+        previous = id;
+    }
+    return first;
+}
+
+int flatten_tree(flat_tree *flat, const tree_node *tree)
+{
+    flat->count = 0;
+    flat->child_total = 0;
+    flat->name_count = 0;
+    flat->real_count = 0;
+    flat->seen_count = 0;
+    if (flat->name_slots != NULL)
+        memset(flat->name_slots, 0, (size_t)flat->name_slot_count * sizeof(uint32_t));
+    if (flat->seen_nodes != NULL)
+        memset(flat->seen_nodes, 0, (size_t)flat->seen_slot_count * sizeof(const tree_node *));
+
+    int failed = 0;
+    flat->root = flatten_list(flat, tree, &failed);
+    if (failed)
+    {
+        flat->count = 0;
+        flat->child_total = 0;
+        flat->root = FLAT_NONE;
+        flat->source = NULL;
+        return 0;
+    }
+    flat->source = tree;
+    return 1;
+}
+
+void release_flat_tree(flat_tree *flat)
+{
+    free(flat->kinds);
+    free(flat->types);
+    free(flat->child_counts);
+    free(flat->ops);
+    free(flat->lines);
+    free(flat->values);
+    free(flat->next);
+    free(flat->first_child);
+    free(flat->children);
+    free(flat->names);
+    free(flat->name_slots);
+    free(flat->reals);
+    free(flat->seen_nodes);
+    free(flat->seen_ids);
+    memset(flat, 0, sizeof(*flat));
+}
+
+size_t flat_tree_size(const flat_tree *flat)
+{
+    size_t per_node = 3 * sizeof(uint8_t) + sizeof(uint16_t) + 2 * sizeof(int32_t) + 2 * sizeof(node_id);
+    return flat->count * per_node + flat->child_total * sizeof(node_id) + flat->name_count * sizeof(const char *) +
+           flat->real_count * sizeof(double);
+}
@@ -0,0 +1,122 @@
+#ifndef FLAT_TREE_H
+#define FLAT_TREE_H
+
+#include <stdint.h> // uint8_t, uint16_t, uint32_t, int32_t
+#include <stddef.h> // size_t
+#include "parser.h"
+
+/*
+ * A árvore sintática compacta: os nós ficam em vetores contíguos, um por campo (estrutura de vetores),
+ * e são identificados pelo seu índice de 32 bits. Os nós são numerados em pré-ordem: um comando, os
+ * seus filhos e depois o próximo comando da lista, de modo que percorrer os índices em ordem visita a
+ * árvore na mesma ordem que a recursão sobre tree_node.
+ *
+ * Cada nó tem só os filhos que usa: os índices dos filhos ficam em sequência no vetor children, a
+ * partir de first_child, e as folhas não ocupam nada nele. Uma posição vazia no meio (o então sem
+ * comandos de um se com senão) é FLAT_NONE. As listas de comandos continuam encadeadas, pelo vetor next.
+ *
+ * Os nomes são guardados uma vez em names, e as constantes reais em reals; o campo value de cada nó
+ * guarda a constante inteira ou o índice do nome ou da constante real. Os nomes não são copiados: a
+ * árvore compacta só é válida enquanto a arena da árvore de origem existir.
+ *
+ * A árvore compacta é a forma de saída da árvore: o relatório e o cache a montam a partir da árvore já
+ * ajustada, e um acerto no cache a lê sem reconstruir os tree_node. A análise, os ajustes e as otimizações
+ * trabalham sobre tree_node, que eles modificam no lugar.
+ */
+
+/// @brief O índice de um nó da árvore compacta.
+typedef uint32_t node_id;
+
+/// @brief O índice que não corresponde a nenhum nó (filho ausente ou fim da lista).
+#define FLAT_NONE UINT32_MAX
+
+/// @brief O tipo de um nó da árvore compacta: os comandos têm os valores de statement_kind, e as
+///        expressões, os de expression_kind somados a FLAT_OPERATION.
+typedef enum flat_kind
+{
+    FLAT_IF = IF_STATEMENT,
+    FLAT_REPEAT = REPEAT_STATEMENT,
+    FLAT_WHILE = WHILE_STATEMENT,
+    FLAT_ASSIGNMENT = ASSIGNMENT_STATEMENT,
+    FLAT_READ = READ_STATEMENT,
+    FLAT_WRITE = WRITE_STATEMENT,
+    FLAT_DECLARATION = DECLARATION_STATEMENT,
+    FLAT_OPERATION,
+    FLAT_CONSTANT,
+    FLAT_IDENTIFIER,
+    FLAT_CONVERSION
+} flat_kind;
+
+/// @brief A árvore sintática compacta, com um vetor por campo dos nós.
+/// @note Os vetores são mantidos por flatten_tree(): uma nova conversão reaproveita a capacidade já alocada.
+typedef struct flat_tree
+{
+    uint8_t *kinds;       // flat_kind
+    uint8_t *types;       // exp_type
+    uint8_t *child_counts;
+    uint16_t *ops;        // O operador (token_type) das operações
+    int32_t *lines;
+    int32_t *values;      // Constante inteira ou booleana, índice em reals ou índice em names
+    node_id *next;        // O próximo comando da lista, ou FLAT_NONE
+    node_id *first_child; // A posição do primeiro filho em children
+    uint32_t count;
+    uint32_t capacity;
+
+    node_id *children;
+    uint32_t child_total;
+    uint32_t child_capacity;
+
+    const char **names;
+    uint32_t name_count;
+    uint32_t name_capacity;
+    uint32_t *name_slots; // Índice de espalhamento dos nomes: posição em names mais um; 0 indica vazio
+    uint32_t name_slot_count;
+
+    double *reals;
+    uint32_t real_count;
+    uint32_t real_capacity;
+
+    // Os nós de expressão já convertidos, para que um nó compartilhado tenha um só índice
+    const tree_node **seen_nodes; // Espalhamento por endereço; NULL indica vazio
+    node_id *seen_ids;
+    uint32_t seen_count;
+    uint32_t seen_slot_count;
+
+    const tree_node *source; // A árvore convertida por último, ou NULL
+    node_id root;            // O primeiro nó da lista convertida, ou FLAT_NONE se ela era vazia
+} flat_tree;
+
+/// @brief Converte uma lista de nós (o nó, seus irmãos e todos os descendentes) para a árvore compacta.
+/// @note Os nós de expressão compartilhados por share_expressions() são convertidos uma vez e continuam
+///       compartilhados. O conteúdo anterior de flat é descartado.
+/// @param flat A árvore compacta, zerada na primeira conversão.
+/// @param tree O primeiro nó da lista.
+/// @return 1 se a conversão foi feita, 0 se faltou memória (flat fica vazia).
+int flatten_tree(flat_tree *flat, const tree_node *tree);
+
+/// @brief Libera os vetores da árvore compacta (mas não a própria estrutura).
+void release_flat_tree(flat_tree *flat);
+
+/// @brief A memória ocupada pelos nós convertidos, em bytes: os vetores por nó, os filhos, os nomes e as
+///        constantes reais, sem a capacidade reservada e sem o texto dos nomes.
+size_t flat_tree_size(const flat_tree *flat);
+
+/// @brief O i-ésimo filho de um nó, ou FLAT_NONE se o nó não tem esse filho.
+static inline node_id flat_child(const flat_tree *flat, node_id node, int i)
+{
+    return (i < flat->child_counts[node]) ? flat->children[flat->first_child[node] + i] : FLAT_NONE;
+}
+
+/// @brief O nome de um nó de atribuição, leitura, declaração ou identificador.
+static inline const char *flat_name(const flat_tree *flat, node_id node)
+{
+    return flat->names[flat->values[node]];
+}
+
+/// @brief O valor de um nó de constante real.
+static inline double flat_real(const flat_tree *flat, node_id node)
+{
+    return flat->reals[flat->values[node]];
+}
+
+#endif // FLAT_TREE_H
@@ -2,9 +2,28 @@
 #include "../scanner/scanner.h"
 #include "parser.h"
 
-/// @brief Imprime espaços de acordo com a quantidade especificada.
-/// @param argc Quantos espaços devem ser impressos.
-static void print_spaces(const int amount);
+tree_node *copy_tree(arena *arena, const tree_node *tree)
+{
+    tree_node *first = NULL;
+    tree_node **link = &first;
+    for (; tree != NULL; tree = tree->sibling)
+    {
+        tree_node *t = (tree_node *)arena_alloc(arena, sizeof(tree_node));
+        if (t == NULL)
+            return NULL;
+        *t = *tree;
+        t->sibling = NULL;
+        for (int i = 0; i < MAXCHILDREN; i++)
+        {
+            t->child[i] = copy_tree(arena, tree->child[i]);
+            if (tree->child[i] != NULL && t->child[i] == NULL)
+                return NULL;
+        }
+        *link = t;
+        link = &t->sibling;
+    }
+    return first;
+}
 
 void print_node(token_type token, const char *token_string)
 {
@@ -87,9 +106,36 @@ void print_node(token_type token, const char *token_string)
     }
 }
 
-tree_node *new_statement_node(statement_kind kind)
+parse_context *create_parse_context(void)
+{
+    parse_context *context = (parse_context *)calloc(1, sizeof(parse_context));
+    if (context == NULL)
+        return NULL;
+
+    context->scanner = create_scanner();
+    context->arena = arena_create(ARENA_DEFAULT_BLOCK_SIZE);
+    context->print_errors = 1;
+    if (context->scanner == NULL || context->arena == NULL)
+    {
+        destroy_parse_context(context);
+        return NULL;
+    }
+    return context;
+}
+
+void destroy_parse_context(parse_context *context)
 {
-    tree_node *t = (tree_node *)malloc(sizeof(tree_node));
+    if (context == NULL)
+        return;
+
+    destroy_scanner(context->scanner);
+    arena_release(context->arena);
+    free(context);
+}
+
+tree_node *new_statement_node(arena *arena, statement_kind kind, int line_number)
+{
+    tree_node *t = (tree_node *)arena_alloc(arena, sizeof(tree_node));
     int i;
     if (t == NULL)
         printf("Out of memory error at line %d\n", line_number);
@@ -101,14 +147,16 @@ tree_node *new_statement_node(statement_kind kind)
         t->node_kind = STATEMENT_KIND;
         t->kind.stmt = kind;
         t->line_number = line_number;
+        t->type = VOID;
         t->processed = 0; // Inicializar como não processado
+        t->memory_address = -1;
     }
     return t;
 }
 
-tree_node *new_expression_node(expression_kind kind)
+tree_node *new_expression_node(arena *arena, expression_kind kind, int line_number)
 {
-    tree_node *t = (tree_node *)malloc(sizeof(tree_node));
+    tree_node *t = (tree_node *)arena_alloc(arena, sizeof(tree_node));
     int i;
     if (t == NULL)
         printf("Out of memory error at line %d\n", line_number);
@@ -122,10 +170,13 @@ tree_node *new_expression_node(expression_kind kind)
         t->line_number = line_number;
         t->type = VOID;
         t->processed = 0; // Inicializar como não processado
+        t->memory_address = -1;
     }
     return t;
 }
 
+/// @brief Imprime espaços de acordo com a quantidade especificada.
+/// @param amount Quantos espaços devem ser impressos.
 static void print_spaces(const int amount)
 {
     for (int count = 0; count < amount; count++)
@@ -186,6 +237,10 @@ void print_tree(tree_node *tree, const int indentation_level)
                 {
                     printf("Const: %f\n", tree->attribute.real_value);
                 }
+                else if (tree->type == BOOLEAN)
+                {
+                    printf("Const: %s\n", tree->attribute.int_value ? "true" : "false");
+                }
                 else
                 {
                     printf("Const (Unknown Type): %d\n", tree->attribute.int_value);
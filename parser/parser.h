@@ -6,12 +6,7 @@
 #include <ctype.h>
 #include <string.h>
 #include "../scanner/scanner.h"
-
-/// @brief Variável global para armazenar a linha atual.
-extern int line_number;
-
-/// @brief Variável global para definir se ocorreu um erro.
-extern int is_error;
+#include "../memory/arena.h"
 
 /// @brief Os possíveis tipos de nó da árvore sintática.
 typedef enum node_kind
@@ -47,11 +42,19 @@ typedef enum exp_type
     VOID,
     INTEGER,
     REAL,
+    BOOLEAN, // Resultado de operadores relacionais e lógicos
     PROCESSED_MARKER = 999 // Marcador para nós já processados
 } exp_type;
 
 #define MAXCHILDREN 3
 
+/// @brief O nó de expressão já passou pelos ajustes semânticos (bit de tree_node.processed).
+#define NODE_ADJUSTED 1
+
+/// @brief O tipo do nó de expressão já foi calculado pela análise semântica e está em type (bit de
+///        tree_node.processed).
+#define NODE_TYPED 2
+
 /// @brief Um nó da árvore sintática.
 typedef struct tree_node
 {
@@ -72,11 +75,35 @@ typedef struct tree_node
         char *name;
     } attribute;
     exp_type type;
-    int processed; // 0 = não processado, 1 = processado
+    int processed;      // Bits NODE_ADJUSTED e NODE_TYPED; 0 = não processado
+    int memory_address; // Endereço da variável no quadro, preenchido por resolve_tree(); -1 se não resolvido
 } tree_node;
 
-/// @brief Variável global para armazenar o lexema do token.
-extern char *token_string;
+#define MAX_SYNTAX_ERRORS 100
+
+/// @brief Um erro léxico ou sintático encontrado durante a análise.
+typedef struct syntax_error
+{
+    int line;
+    int is_lexical; // 1 = caractere inválido, 0 = erro de sintaxe
+    char message[256];
+} syntax_error;
+
+/// @brief O estado de uma compilação: o analisador léxico, a arena e as informações do token atual.
+/// @note Cada compilação tem o seu próprio contexto, de modo que vários programas podem ser
+///       analisados ao mesmo tempo em threads diferentes.
+typedef struct parse_context
+{
+    yyscan_t scanner;         // A instância do analisador léxico.
+    arena *arena;             // A arena de todos os nós da árvore sintática e dos nomes dos identificadores.
+    const char *token_string; // O lexema do token atual. Só é válido até a leitura do próximo token.
+    int line_number;          // A linha do token atual.
+    int is_error;             // Indica se ocorreu um erro sintático.
+    tree_node *syntax_tree;   // A árvore produzida pela última análise.
+    int print_errors;         // 1 = imprime os erros em stderr à medida que são encontrados, 0 = apenas os guarda.
+    syntax_error errors[MAX_SYNTAX_ERRORS];
+    int error_count;
+} parse_context;
 
 /// @brief Imprime um token e seu lexema.
 /// @param token_type O tipo do token.
@@ -84,22 +111,43 @@ extern char *token_string;
 void print_node(token_type token_type, const char *lexeme);
 
 /// @brief Cria um nó de declaração para construção da árvore sintática.
+/// @param arena A arena da compilação.
 /// @param kind O tipo da declaração.
+/// @param line_number A linha do nó.
 /// @return Um nó da árvore sintática.
-tree_node *new_statement_node(statement_kind kind);
+tree_node *new_statement_node(arena *arena, statement_kind kind, int line_number);
 
 /// @brief Cria um nó de expressão para construção da árvore sintática.
+/// @param arena A arena da compilação.
 /// @param kind O tipo da expressão.
+/// @param line_number A linha do nó.
 /// @return Um nó da árvore sintática.
-tree_node *new_expression_node(expression_kind kind);
+tree_node *new_expression_node(arena *arena, expression_kind kind, int line_number);
+
+/// @brief Copia uma lista de nós (o nó, seus irmãos e todos os descendentes) para a arena.
+/// @note Os nomes dos identificadores são compartilhados com a árvore original.
+/// @param arena A arena da compilação.
+/// @param tree O primeiro nó da lista.
+/// @return A cópia, ou NULL se tree for NULL ou não houver memória.
+tree_node *copy_tree(arena *arena, const tree_node *tree);
 
 /// @brief Imprime a árvore sintática
 /// @param tree Um nó da árvore sintática.
 /// @param intentation_level O nível de indentação do nó atual.
 void print_tree(tree_node *tree, const int indentation_level);
 
+/// @brief Cria o contexto de uma compilação, com o seu analisador léxico e a sua arena.
+/// @return O contexto criado, ou NULL se não houver memória.
+parse_context *create_parse_context(void);
+
+/// @brief Libera o contexto, o analisador léxico e, de uma só vez, todos os nós criados na compilação.
+/// @attention Nenhum nó ou nome obtido da árvore pode ser usado após esta chamada.
+/// @param context O contexto.
+void destroy_parse_context(parse_context *context);
+
 /// @brief Processa um programa P- e retorna sua árvore sintática.
+/// @param context O contexto da compilação, cuja entrada já foi aberta com open_source_file().
 /// @return O nó raíz da árvore sintática.
-tree_node * parse(void);
+tree_node * parse(parse_context *context);
 
 #endif
\ No newline at end of file
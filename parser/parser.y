@@ -6,22 +6,24 @@
 #define YYSTYPE tree_node *
 #define YYDEBUG 1
 
-/* Variaveis globais usadas pelo parser */
-static char * savedName;
-static int savedLineNo;
-static tree_node * savedTree;
-
-/* Definicao da variavel global para o lexema do token */
-char *token_string;
-int line_number;
-int is_error;
+/* Cria nos na arena da compilacao, com a linha do token atual */
+#define NEW_STATEMENT(kind) new_statement_node(context->arena, (kind), context->line_number)
+#define NEW_EXPRESSION(kind) new_expression_node(context->arena, (kind), context->line_number)
 
 /* Prototipos */
-static int yylex(void);
-static int yyerror(char *);
+static int yylex(YYSTYPE *lvalp, parse_context *context);
+static void yyerror(parse_context *context, const char *message);
+static tree_node *list_of(tree_node *node);
+static tree_node *list_append(tree_node *list, tree_node *items);
+static tree_node *list_close(tree_node *list);
 
 %}
 
+/* Analisador reentrante: todo o estado da compilacao fica em "context" */
+%define api.pure full
+%parse-param {parse_context *context}
+%lex-param {parse_context *context}
+
 %code requires {
   /* Redefine YYTOKENTYPE para usar token_type. Isso suprime a geracao do enum padrao do Bison. */
   #define YYTOKENTYPE token_type
@@ -48,17 +50,7 @@ static int yyerror(char *);
 program     : T_ABRE_CHAVES decl_list optional_stmt_seq T_FECHA_CHAVES
                 {
                   // Concatena lista de declarações com statements
-                  tree_node *decls = $2;
-                  tree_node *stmts = $3;
-                  
-                  if (decls == NULL) {
-                    savedTree = stmts;
-                  } else {
-                    tree_node *last = decls;
-                    while (last->sibling != NULL) last = last->sibling;
-                    last->sibling = stmts;
-                    savedTree = decls;
-                  }
+                  context->syntax_tree = list_close(list_append($2, $3));
                 }
             ;
 
@@ -66,16 +58,8 @@ optional_stmt_seq : stmt_seq { $$ = $1; }
                   | /* empty */ { $$ = NULL; }
                   ;
 
-decl_list   : decl_list decl { 
-                  if ($1 != NULL) {
-                    tree_node *t = $1;
-                    while (t->sibling != NULL) t = t->sibling;
-                    t->sibling = $2;
-                    $$ = $1;
-                  } else {
-                    $$ = $2;
-                  }
-                }
+/* decl_list, id_list e stmt_seq sao listas em construcao (ver list_append) */
+decl_list   : decl_list decl { $$ = list_append($1, $2); }
             | /* vazio */ { $$ = NULL; } 
             ;
 
@@ -83,62 +67,50 @@ decl        : T_INTEIRO id_list T_PONTO_VIRGULA
                 { 
                   // Para cada nó na lista de ids, definir o tipo como INTEGER
                   tree_node *t = $2;
-                  while (t != NULL) {
-                    t->type = INTEGER;
+                  do {
                     t = t->sibling;
-                  }
+                    t->type = INTEGER;
+                  } while (t != $2);
                   $$ = $2; 
                 }
             | T_REAL id_list T_PONTO_VIRGULA
                 {
                   // Para cada nó na lista de ids, definir o tipo como REAL
                   tree_node *t = $2;
-                  while (t != NULL) {
-                    t->type = REAL;
+                  do {
                     t = t->sibling;
-                  }
+                    t->type = REAL;
+                  } while (t != $2);
                   $$ = $2;
                 }
             ;
 
 id_list     : T_ID { 
-                  tree_node *t = new_statement_node(DECLARATION_STATEMENT);
-                  t->attribute.name = strdup(token_string);
-                  t->line_number = line_number;
+                  tree_node *t = NEW_STATEMENT(DECLARATION_STATEMENT);
+                  t->attribute.name = arena_strdup(context->arena, context->token_string);
+                  t->line_number = context->line_number;
                   // O tipo será definido na regra decl
-                  $$ = t;
+                  $$ = list_of(t);
                 }
             | id_list T_VIRGULA T_ID { 
-                  tree_node *t = new_statement_node(DECLARATION_STATEMENT);
-                  t->attribute.name = strdup(token_string);
-                  t->line_number = line_number;
+                  tree_node *t = NEW_STATEMENT(DECLARATION_STATEMENT);
+                  t->attribute.name = arena_strdup(context->arena, context->token_string);
+                  t->line_number = context->line_number;
                   // O tipo será definido na regra decl
-                  tree_node *s = $1;
-                  while (s->sibling != NULL) s = s->sibling;
-                  s->sibling = t;
-                  $$ = $1;
+                  $$ = list_append($1, list_of(t));
                 }
             ;
 
-stmt_seq    : stmt_seq stmt
-                 { YYSTYPE t = $1;
-                   if (t != NULL)
-                   { while (t->sibling != NULL)
-                        t = t->sibling;
-                     t->sibling = $2;
-                     $$ = $1;
-                   }
-                   else $$ = $2;
-                 }
+stmt_seq    : stmt_seq stmt { $$ = list_append($1, $2); }
             | stmt  { $$ = $1; }
             ;
 
-stmt        : if_stmt { $$ = $1; }
-            | repeat_stmt T_PONTO_VIRGULA { $$ = $1; }
-            | while_stmt { $$ = $1; }
-            | assign_stmt { $$ = $1; }
-            | read_stmt { $$ = $1; }
-            | write_stmt { $$ = $1; }
+stmt        : if_stmt { $$ = list_of($1); }
+            | repeat_stmt T_PONTO_VIRGULA { $$ = list_of($1); }
+            | while_stmt { $$ = list_of($1); }
+            | assign_stmt { $$ = list_of($1); }
+            | read_stmt { $$ = list_of($1); }
+            | write_stmt { $$ = list_of($1); }
             | block_stmt { $$ = $1; }
             | error  { $$ = NULL; }
             ;
@@ -151,13 +123,13 @@ block_stmt  : T_ABRE_CHAVES stmt_seq T_FECHA_CHAVES
 
 if_stmt     : T_SE exp T_ENTAO command %prec "then"
                  { 
-                   $$ = new_statement_node(IF_STATEMENT);
+                   $$ = NEW_STATEMENT(IF_STATEMENT);
                    $$->child[0] = $2;
                    $$->child[1] = $4;
                  }
             | T_SE exp T_ENTAO command T_SENAO command
                  { 
-                   $$ = new_statement_node(IF_STATEMENT);
+                   $$ = NEW_STATEMENT(IF_STATEMENT);
                    $$->child[0] = $2;
                    $$->child[1] = $4;
                    $$->child[2] = $6;
@@ -165,7 +137,7 @@ if_stmt     : T_SE exp T_ENTAO command %prec "then"
             ;
 
 repeat_stmt : T_REPITA command T_ATE exp
-                 { $$ = new_statement_node(REPEAT_STATEMENT);
+                 { $$ = NEW_STATEMENT(REPEAT_STATEMENT);
                    $$->child[0] = $2; /* command */
                    $$->child[1] = $4; /* exp */
                  }
@@ -173,46 +145,42 @@ repeat_stmt : T_REPITA command T_ATE exp
 
 while_stmt  : T_ENQUANTO T_ABRE_PARENTESES exp T_FECHA_PARENTESES command
                  { 
-                   $$ = new_statement_node(WHILE_STATEMENT);
+                   $$ = NEW_STATEMENT(WHILE_STATEMENT);
                    $$->child[0] = $3; 
                    $$->child[1] = $5; 
                  }
             ;
 
-command     : stmt { $$ = $1; }
+command     : stmt { $$ = list_close($1); }
 	    ;
 
-assign_stmt : T_ID { savedName = strdup(token_string);
-                     savedLineNo = line_number;
+assign_stmt : T_ID { /* O no e criado antes de ler o proximo token, enquanto o lexema do identificador e valido */
+                     $$ = NEW_STATEMENT(ASSIGNMENT_STATEMENT);
+                     if ($$) $$->attribute.name = arena_strdup(context->arena, context->token_string);
                    }
               T_ATRIBUICAO exp T_PONTO_VIRGULA
-                 { $$ = new_statement_node(ASSIGNMENT_STATEMENT);
-                   if ($$)
-                   {
-                       $$->child[0] = $4;
-                       $$->attribute.name = savedName;
-                       $$->line_number = savedLineNo;
-                   }
+                 { $$ = $2;
+                   if ($$) $$->child[0] = $4;
                  }
             ;
 
-read_stmt   : T_LER T_ABRE_PARENTESES T_ID { savedName = strdup(token_string);
-                                                                savedLineNo = line_number;
-                                                              }
-                                                              T_FECHA_PARENTESES T_PONTO_VIRGULA
-                 { $$ = new_statement_node(READ_STATEMENT);
-                   if ($$) $$->attribute.name = savedName;
+read_stmt   : T_LER T_ABRE_PARENTESES T_ID { $$ = NEW_STATEMENT(READ_STATEMENT);
+                                              if ($$) $$->attribute.name = arena_strdup(context->arena, context->token_string);
+                                            }
+              T_FECHA_PARENTESES T_PONTO_VIRGULA
+                 { $$ = $4;
+                   if ($$) $$->line_number = context->line_number;
                  }
             ;
 
 write_stmt  : T_MOSTRAR T_ABRE_PARENTESES exp T_FECHA_PARENTESES T_PONTO_VIRGULA
-                 { $$ = new_statement_node(WRITE_STATEMENT);
+                 { $$ = NEW_STATEMENT(WRITE_STATEMENT);
                    if ($$) $$->child[0] = $3;
                  }
             ;
 
 exp         : exp T_OU log_and_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_OU;
@@ -221,7 +189,7 @@ exp         : exp T_OU log_and_exp
             ;
 
 log_and_exp : log_and_exp T_E rel_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_E;
@@ -230,37 +198,37 @@ log_and_exp : log_and_exp T_E rel_exp
             ;
 
 rel_exp     : arith_exp T_MENOR arith_exp 
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_MENOR;
                  }
             | arith_exp T_MENOR_IGUAL arith_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_MENOR_IGUAL;
                  }
             | arith_exp T_MAIOR arith_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_MAIOR;
                  }
             | arith_exp T_MAIOR_IGUAL arith_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_MAIOR_IGUAL;
                  }
             | arith_exp T_IGUAL arith_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_IGUAL;
                  }
             | arith_exp T_DIFERENTE arith_exp
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_DIFERENTE;
@@ -269,13 +237,13 @@ rel_exp     : arith_exp T_MENOR arith_exp
             ;
 
 arith_exp   : arith_exp T_SOMA term 
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_SOMA;
                  }
             | arith_exp T_SUB term
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_SUB;
@@ -284,13 +252,13 @@ arith_exp   : arith_exp T_SOMA term
             ;
 
 term        : term T_MULT factor 
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_MULT;
                  }
             | term T_DIV factor
-                 { $$ = new_expression_node(OPERATION_EXPRESSION);
+                 { $$ = NEW_EXPRESSION(OPERATION_EXPRESSION);
                    $$->child[0] = $1;
                    $$->child[1] = $3;
                    $$->attribute.op = T_DIV;
@@ -301,65 +269,117 @@ term        : term T_MULT factor
 factor      : T_ABRE_PARENTESES exp T_FECHA_PARENTESES
                  { $$ = $2; }
             | T_NUMERO_INT
-                 { $$ = new_expression_node(CONSTANT_EXPRESSION);
-                   $$->attribute.int_value = atoi(token_string);
+                 { $$ = NEW_EXPRESSION(CONSTANT_EXPRESSION);
+                   $$->attribute.int_value = atoi(context->token_string);
                    $$->type = INTEGER;
                  }
             | T_NUMERO_REAL
-                 { $$ = new_expression_node(CONSTANT_EXPRESSION);
-                   $$->attribute.real_value = atof(token_string);
+                 { $$ = NEW_EXPRESSION(CONSTANT_EXPRESSION);
+                   $$->attribute.real_value = atof(context->token_string);
                    $$->type = REAL;
                  }
             | T_ID 
-                 { $$ = new_expression_node(IDENTIFIER_EXPRESSION);
-                   $$->attribute.name = strdup(token_string);
+                 { $$ = NEW_EXPRESSION(IDENTIFIER_EXPRESSION);
+                   $$->attribute.name = arena_strdup(context->arena, context->token_string);
                  }
             | T_ERRO { $$ = NULL; }
             ;
 
 %% /* --- Funcoes Auxiliares --- */
 
-int yyerror(char * message)
+/* As listas em construcao sao circulares e representadas pelo ultimo no, cujo irmao e o primeiro:
+   assim, acrescentar ao fim nao percorre a lista e a construcao e linear no tamanho do programa.
+   NULL e a lista vazia. */
+
+/* Uma lista com um so no (ou a lista vazia, se o no e NULL) */
+static tree_node *list_of(tree_node *node)
+{
+  if (node != NULL)
+    node->sibling = node;
+  return node;
+}
+
+/* Acrescenta os nos de items ao fim de list, em tempo constante */
+static tree_node *list_append(tree_node *list, tree_node *items)
+{
+  if (list == NULL)
+    return items;
+  if (items == NULL)
+    return list;
+  tree_node *first = list->sibling;
+  list->sibling = items->sibling;
+  items->sibling = first;
+  return items;
+}
+
+/* Termina a lista: devolve o primeiro no, com o ultimo sem irmao, como na arvore sintatica */
+static tree_node *list_close(tree_node *list)
+{
+  if (list == NULL)
+    return NULL;
+  tree_node *first = list->sibling;
+  list->sibling = NULL;
+  return first;
+}
+
+/* Guarda um erro léxico ou sintático no contexto da compilação */
+static void record_error(parse_context *context, int is_lexical, const char *format, const char *detail)
+{
+  if (context->error_count >= MAX_SYNTAX_ERRORS)
+    return;
+
+  syntax_error *error = &context->errors[context->error_count++];
+  error->line = context->line_number;
+  error->is_lexical = is_lexical;
+  snprintf(error->message, sizeof(error->message), format, detail);
+}
+
+static void yyerror(parse_context *context, const char *message)
 { 
-  fprintf(stderr,"Syntax error at line %d: %s\n", line_number, message);
-  fprintf(stderr,"Current token: %s\n", token_string);
-  is_error = 1;
-  return 0;
+  if (context->print_errors)
+  {
+    fprintf(stderr,"Syntax error at line %d: %s\n", context->line_number, message);
+    fprintf(stderr,"Current token: %s\n", context->token_string);
+  }
+  record_error(context, 0, "%s", message);
+  context->is_error = 1;
 }
 
 /*
- * Chama get_token() do analisador léxico, copia os dados
- * para as variáveis globais que o analisador sintático espera (line_number, token_string)
+ * Chama get_token() do analisador léxico da compilação, copia os dados
+ * para o contexto que o analisador sintático usa (line_number, token_string)
  * e retorna apenas o tipo do token, como o Bison espera.
+ * O lexema não é copiado: as acoes que precisam guardar um nome o copiam para a arena.
  */
-static int yylex(void)
+static int yylex(YYSTYPE *lvalp, parse_context *context)
 {
-  /* Variavel estatica para nao perder o ponteiro entre chamadas */
-  static char* lexeme_to_free = NULL;
+  token current_token = get_token(context->scanner);
+  
+  /* Copia as informacoes do token para o contexto do parser */
+  context->line_number = current_token.line;
+  context->token_string = current_token.lexeme;
+  *lvalp = NULL;
 
-  /* Libera a memoria do lexema anterior, se houver */
-  if (lexeme_to_free != NULL)
+  if (current_token.type == T_ERRO)
   {
-      free(lexeme_to_free);
-      lexeme_to_free = NULL;
+    if (context->print_errors)
+      fprintf(stderr, "Erro lexico na linha %d: Caractere inesperado '%s'\n", current_token.line, current_token.lexeme);
+    record_error(context, 1, "Caractere inesperado '%s'", current_token.lexeme);
   }
-  
-  token current_token = get_token();
-  
-  /* Guarda o ponteiro do lexema para liberar na proxima chamada */
-  lexeme_to_free = current_token.lexeme;
-  
-  /* Copia as informacoes do token para as variaveis globais do parser */
-  line_number = current_token.line;
-  token_string = current_token.lexeme;
 
   /* Retorna o tipo do token para o parser */
   return (int)current_token.type;
 }
 
 // Retorna a árvore sintática.
-tree_node * parse(void)
+tree_node * parse(parse_context *context)
 { 
-  yyparse();
-  return savedTree;
+  context->syntax_tree = NULL;
+  context->is_error = 0;
+  context->error_count = 0;
+  context->line_number = 0;
+  context->token_string = "";
+
+  yyparse(context);
+  return context->syntax_tree;
 }
\ No newline at end of file
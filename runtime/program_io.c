@@ -0,0 +1,204 @@
+#include <errno.h>  // errno, EINTR
+#include <stdio.h>  // snprintf()
+#include <stdlib.h> // malloc(), free(), strtod()
+#include <string.h> // memcpy(), memmove()
+#include <unistd.h> // read(), write()
+#include "program_io.h"
+
+/// @brief Maior quantidade de caracteres de um número lido como real.
+#define MAX_NUMBER_LENGTH 128
+
+program_io *create_program_io(int input_fd, int output_fd)
+{
+    program_io *io = (program_io *)malloc(sizeof(program_io));
+    if (io == NULL)
+        return NULL;
+
+    io->input_fd = input_fd;
+    io->output_fd = output_fd;
+    io->input_position = 0;
+    io->input_length = 0;
+    io->input_finished = 0;
+    io->output_length = 0;
+    return io;
+}
+
+/// @brief Move os bytes ainda não consumidos para o início do buffer e lê mais um bloco da entrada.
+/// @note Depois da chamada, os bytes não consumidos começam na posição 0, mesmo que nada tenha sido lido.
+/// @return 1 se novos bytes foram lidos, 0 no fim da entrada ou com o buffer cheio.
+static int fill_input(program_io *io)
+{
+    size_t pending = io->input_length - io->input_position;
+    memmove(io->input, io->input + io->input_position, pending);
+    io->input_position = 0;
+    io->input_length = pending;
+
+    if (io->input_finished || pending == PROGRAM_IO_BUFFER_SIZE)
+        return 0;
+
+    ssize_t received;
+    do
+        received = read(io->input_fd, io->input + pending, PROGRAM_IO_BUFFER_SIZE - pending);
+    while (received < 0 && errno == EINTR);
+
+    if (received <= 0)
+    {
+        io->input_finished = 1;
+        return 0;
+    }
+    io->input_length += (size_t)received;
+    return 1;
+}
+
+static int is_space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/// @brief Encontra a próxima palavra da entrada e a consome.
+/// @param word Recebe o início da palavra, que só é válido até a próxima leitura.
+/// @param length Recebe o tamanho da palavra.
+/// @return 1 se uma palavra foi encontrada, 0 no fim da entrada.
+static int next_word(program_io *io, const char **word, size_t *length)
+{
+    for (;;)
+    {
+        while (io->input_position < io->input_length && is_space(io->input[io->input_position]))
+            io->input_position++;
+        if (io->input_position < io->input_length)
+            break;
+        if (!fill_input(io))
+            return 0;
+    }
+
+    // Uma palavra cortada pelo fim do buffer é completada com o próximo bloco
+    size_t end = io->input_position;
+    for (;;)
+    {
+        while (end < io->input_length && !is_space(io->input[end]))
+            end++;
+        if (end < io->input_length || io->input_finished)
+            break;
+
+        size_t consumed = io->input_position;
+        int filled = fill_input(io);
+        end -= consumed;
+        if (!filled)
+            break;
+    }
+
+    *word = io->input + io->input_position;
+    *length = end - io->input_position;
+    io->input_position = end;
+    return 1;
+}
+
+int read_integer(program_io *io, int *value)
+{
+    const char *word;
+    size_t length;
+    if (!next_word(io, &word, &length))
+        return 0;
+
+    size_t i = 0;
+    int negative = 0;
+    if (word[0] == '-' || word[0] == '+')
+    {
+        negative = (word[0] == '-');
+        i = 1;
+    }
+    if (i == length)
+        return 0;
+
+    // A soma sem sinal dá ao estouro o mesmo comportamento das operações inteiras do programa
+    unsigned int result = 0;
+    for (; i < length; i++)
+    {
+        if (word[i] < '0' || word[i] > '9')
+            return 0;
+        result = result * 10u + (unsigned int)(word[i] - '0');
+    }
+
+    *value = (int)(negative ? 0u - result : result);
+    return 1;
+}
+
+int read_real(program_io *io, double *value)
+{
+    const char *word;
+    size_t length;
+    if (!next_word(io, &word, &length) || length >= MAX_NUMBER_LENGTH)
+        return 0;
+
+    char number[MAX_NUMBER_LENGTH];
+    memcpy(number, word, length);
+    number[length] = '\0';
+
+    char *end;
+    *value = strtod(number, &end);
+    return end == number + length;
+}
+
+void flush_program_output(program_io *io)
+{
+    size_t written = 0;
+    while (written < io->output_length)
+    {
+        ssize_t result = write(io->output_fd, io->output + written, io->output_length - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            break; // Saída fechada: o restante é descartado
+        written += (size_t)result;
+    }
+    io->output_length = 0;
+}
+
+void write_integer(program_io *io, int value)
+{
+    if (io->output_length + 16 > PROGRAM_IO_BUFFER_SIZE)
+        flush_program_output(io);
+
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    char *out = io->output + io->output_length;
+    if (value < 0)
+        *out++ = '-';
+    while (count > 0)
+        *out++ = digits[--count];
+    *out++ = '\n';
+    io->output_length = (size_t)(out - io->output);
+}
+
+void write_real(program_io *io, double value)
+{
+    if (io->output_length + 64 > PROGRAM_IO_BUFFER_SIZE)
+        flush_program_output(io);
+
+    // A menor precisão que lê de volta o mesmo valor: 0.1 continua "0.1" e 1234567.5 não é arredondado
+    char *out = io->output + io->output_length;
+    int length = 0;
+    for (int precision = 15; precision <= 17; precision++)
+    {
+        length = snprintf(out, 64, "%.*g", precision, value);
+        if (value != value || strtod(out, NULL) == value)
+            break;
+    }
+    out[length] = '\n';
+    io->output_length += (size_t)length + 1;
+}
+
+void destroy_program_io(program_io *io)
+{
+    if (io == NULL)
+        return;
+    flush_program_output(io);
+    free(io);
+}
@@ -0,0 +1,61 @@
+#ifndef PROGRAM_IO_H
+#define PROGRAM_IO_H
+
+#include <stddef.h>
+
+/// @brief Tamanho de cada buffer de entrada e de saída (64 KiB).
+#define PROGRAM_IO_BUFFER_SIZE (64 * 1024)
+
+/// @brief A entrada e a saída de um programa P- em execução.
+/// @note ler() e mostrar() passam por estes buffers: a entrada é lida e a saída é escrita em blocos
+///       de PROGRAM_IO_BUFFER_SIZE bytes, e não um número por chamada ao sistema.
+typedef struct program_io
+{
+    int input_fd;
+    int output_fd;
+    size_t input_position; // Próximo byte a ser consumido em input.
+    size_t input_length;   // Quantidade de bytes válidos em input.
+    int input_finished;    // 1 quando read() indicou o fim da entrada.
+    size_t output_length;  // Quantidade de bytes pendentes em output.
+    char input[PROGRAM_IO_BUFFER_SIZE];
+    char output[PROGRAM_IO_BUFFER_SIZE];
+} program_io;
+
+/// @brief Cria os buffers de entrada e saída de um programa.
+/// @param input_fd O descritor de onde ler() lê.
+/// @param output_fd O descritor onde mostrar() escreve.
+/// @return Os buffers, ou NULL se não houver memória.
+program_io *create_program_io(int input_fd, int output_fd);
+
+/// @brief Lê um número inteiro da entrada, ignorando espaços e quebras de linha antes dele.
+/// @param io Os buffers do programa.
+/// @param value Recebe o número lido.
+/// @return 1 em caso de sucesso, 0 no fim da entrada ou se o texto lido não é um número inteiro.
+int read_integer(program_io *io, int *value);
+
+/// @brief Lê um número real da entrada, ignorando espaços e quebras de linha antes dele.
+/// @param io Os buffers do programa.
+/// @param value Recebe o número lido.
+/// @return 1 em caso de sucesso, 0 no fim da entrada ou se o texto lido não é um número.
+int read_real(program_io *io, double *value);
+
+/// @brief Escreve um número inteiro seguido de uma quebra de linha.
+/// @param io Os buffers do programa.
+/// @param value O número.
+void write_integer(program_io *io, int value);
+
+/// @brief Escreve um número real seguido de uma quebra de linha, no formato "%g" com a menor precisão
+///        (de 15 a 17 algarismos) que lê de volta o mesmo valor.
+/// @param io Os buffers do programa.
+/// @param value O número.
+void write_real(program_io *io, double value);
+
+/// @brief Envia ao descritor de saída tudo o que está pendente no buffer.
+/// @param io Os buffers do programa.
+void flush_program_output(program_io *io);
+
+/// @brief Envia a saída pendente e libera os buffers.
+/// @param io Os buffers do programa.
+void destroy_program_io(program_io *io);
+
+#endif // PROGRAM_IO_H
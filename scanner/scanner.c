@@ -1,5 +1,4 @@
 #include <stdio.h>           // printf(), fprintf(), fopen(), fclose()
-#include <stdlib.h>          // free()
 #include "scanner.h" // token_type, token, get_token()
 
 void print_token(token *token)
@@ -2,6 +2,7 @@
 #define SCANNER_H
 
 #include <stdio.h>
+#include <stddef.h>
 
 /// @brief Representa todos os possíveis tipos de tokens da linguagem P-
 typedef enum token_type
@@ -52,20 +53,66 @@ typedef enum token_type
 } token_type;
 
 /// @brief Armazena as informações completas de um token.
+/// @note O lexema não é copiado. Em palavras-chave, operadores e separadores ele aponta para a
+///       grafia fixa do token; em identificadores e números aponta para o buffer do Flex e só
+///       é válido até a próxima chamada de get_token(). Quem precisar guardá-lo deve copiá-lo.
 typedef struct token
 {
     token_type type;    // O tipo do token.
-    char *lexeme;       // O lexema.
+    const char *lexeme; // O lexema, terminado em '\0'.
+    int length;         // O tamanho do lexema, em bytes.
+    long offset;        // A posição do lexema na entrada, em bytes.
     int line;           // A linha onde o lexema foi encontrado.
 } token;
 
-/// @brief Variável global do Flex para o arquivo de entrada.
-extern FILE *yyin;
+/// @brief Uma instância do analisador léxico gerado pelo Flex (reentrante).
+/// @note Todo o estado da análise fica na instância: instâncias diferentes podem ser usadas
+///       ao mesmo tempo em threads diferentes.
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+/// @brief Cria uma instância do analisador léxico, sem entrada associada.
+/// @attention O corpo desta função está em "lex.yy.c", que é gerado pelo Flex como definido em "scanner.l".
+/// @return A instância criada, ou NULL se não houver memória.
+extern yyscan_t create_scanner(void);
+
+/// @brief Fecha a entrada e libera uma instância do analisador léxico.
+/// @attention O corpo desta função está em "lex.yy.c", que é gerado pelo Flex como definido em "scanner.l".
+/// @param scanner A instância.
+extern void destroy_scanner(yyscan_t scanner);
 
 /// @brief Função de processamento gerado pelo Flex.
 /// @attention O corpo desta função está em "lex.yy.c", que é gerado pelo Flex como definido em "scanner.l".
+/// @param scanner A instância do analisador léxico.
 /// @return O token atual a ser processado.
-extern token get_token(void);
+extern token get_token(yyscan_t scanner);
+
+/// @brief Abre um arquivo P- como entrada de uma instância do analisador léxico.
+/// @note Arquivos regulares são mapeados em memória e analisados no próprio lugar com yy_scan_buffer(),
+///       sem cópias nem chamadas a read(). Pipes e outras entradas que não podem ser mapeadas são lidos
+///       por streaming. A entrada anterior da instância, se houver, é fechada.
+/// @attention O corpo desta função está em "lex.yy.c", que é gerado pelo Flex como definido em "scanner.l".
+/// @param scanner A instância do analisador léxico.
+/// @param path O caminho do arquivo, ou "-" para a entrada padrão.
+/// @return 1 se a entrada foi aberta, 0 caso contrário.
+extern int open_source_file(yyscan_t scanner, const char *path);
+
+/// @brief Usa um texto em memória como entrada de uma instância do analisador léxico.
+/// @note O texto é analisado no próprio lugar, sem cópias. A entrada anterior da instância, se houver, é fechada.
+/// @attention O corpo desta função está em "lex.yy.c", que é gerado pelo Flex como definido em "scanner.l".
+/// @param scanner A instância do analisador léxico.
+/// @param text O texto. Precisa ter dois bytes graváveis após o fim, que recebem '\0' (exigência do Flex),
+///             e continuar válido enquanto a análise durar.
+/// @param length O tamanho do texto, sem os dois bytes extras.
+/// @return 1 se a entrada foi aberta, 0 caso contrário.
+extern int open_source_buffer(yyscan_t scanner, char *text, size_t length);
+
+/// @brief Fecha a entrada aberta por open_source_file() ou open_source_buffer().
+/// @attention O corpo desta função está em "lex.yy.c", que é gerado pelo Flex como definido em "scanner.l".
+/// @param scanner A instância do analisador léxico.
+extern void close_source_file(yyscan_t scanner);
 
 /// @brief Imprime as informações de um token de forma organizada.
 /// @param token O token a ser impresso.
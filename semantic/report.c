@@ -0,0 +1,1227 @@
+#include <stdio.h>  // fwrite(), fflush(), fopen(), fclose(), fprintf(), snprintf(), vsnprintf()
+#include <stdlib.h> // calloc(), realloc(), free()
+#include <string.h> // memcpy(), memset(), memchr(), strlen(), strncmp(), strcspn(), strpbrk()
+#include <stdarg.h> // va_list, va_start(), va_end()
+#include <stdint.h> // uint32_t, uint64_t
+#include <stddef.h> // offsetof()
+#include <math.h>   // isfinite()
+#include "report.h"
+#include "../optimizer/optimizer.h"
+#include "../ir/ir.h"
+
+/// @brief A capacidade inicial do buffer do relatório.
+#define REPORT_INITIAL_CAPACITY (64 * 1024)
+
+/// @brief Os primeiros bytes do relatório binário.
+#define REPORT_BINARY_MAGIC "PMREPORT"
+
+/// @brief A linha que separa o título de cada seção do relatório em texto.
+#define REPORT_RULE "----------------------------------------\n"
+
+// ============================================================================
+// BUFFER
+// ============================================================================
+
+/// @brief Garante espaço para mais bytes no buffer, dobrando a capacidade.
+/// @return 1 se há espaço, 0 se faltou memória (e o buffer fica marcado como falho).
+static int reserve_report(report_buffer *buffer, size_t extra)
+{
+    if (buffer->failed)
+        return 0;
+    if (buffer->length + extra <= buffer->capacity)
+        return 1;
+    size_t capacity = (buffer->capacity > 0) ? buffer->capacity : REPORT_INITIAL_CAPACITY;
+    while (capacity < buffer->length + extra)
+        capacity *= 2;
+    char *grown = (char *)realloc(buffer->data, capacity);
+    if (grown == NULL)
+    {
+        buffer->failed = 1;
+        return 0;
+    }
+    buffer->data = grown;
+    buffer->capacity = capacity;
+    return 1;
+}
+
+static void append_bytes(report_buffer *buffer, const void *data, size_t size)
+{
+    if (size == 0 || !reserve_report(buffer, size))
+        return;
+    memcpy(buffer->data + buffer->length, data, size);
+    buffer->length += size;
+}
+
+static void append_text(report_buffer *buffer, const char *text)
+{
+    append_bytes(buffer, text, strlen(text));
+}
+
+static void append_char(report_buffer *buffer, char c)
+{
+    if (reserve_report(buffer, 1))
+        buffer->data[buffer->length++] = c;
+}
+
+static void append_spaces(report_buffer *buffer, int count)
+{
+    if (count <= 0 || !reserve_report(buffer, (size_t)count))
+        return;
+    memset(buffer->data + buffer->length, ' ', (size_t)count);
+    buffer->length += (size_t)count;
+}
+
+/// @brief Acrescenta um inteiro em decimal, sem passar por printf().
+static void append_int(report_buffer *buffer, long value)
+{
+    char digits[24];
+    int position = sizeof(digits);
+    unsigned long magnitude = (value < 0) ? 0UL - (unsigned long)value : (unsigned long)value;
+    do
+    {
+        digits[--position] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+        digits[--position] = '-';
+    append_bytes(buffer, digits + position, sizeof(digits) - (size_t)position);
+}
+
+/// @brief Acrescenta um texto formatado, para as linhas com colunas e números reais.
+static void append_format(report_buffer *buffer, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (needed < 0 || !reserve_report(buffer, (size_t)needed + 1))
+        return;
+    va_start(args, format);
+    vsnprintf(buffer->data + buffer->length, (size_t)needed + 1, format, args);
+    va_end(args);
+    buffer->length += (size_t)needed;
+}
+
+/// @brief Completa o buffer com zeros até um múltiplo de 8 bytes.
+static void append_padding(report_buffer *buffer)
+{
+    static const char zeros[8] = {0};
+    append_bytes(buffer, zeros, (8 - buffer->length % 8) % 8);
+}
+
+int write_report_buffer(FILE *file, const report_buffer *buffer)
+{
+    if (buffer->length > 0 && fwrite(buffer->data, 1, buffer->length, file) != buffer->length)
+        return 0;
+    return fflush(file) == 0;
+}
+
+void release_report_buffer(report_buffer *buffer)
+{
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+// ============================================================================
+// OPÇÕES
+// ============================================================================
+
+report_options default_report_options(void)
+{
+    report_options options = {REPORT_TEXT, REPORT_ALL_SECTIONS, 1};
+    return options;
+}
+
+int parse_report_format(const char *name, report_format *format)
+{
+    if (strcmp(name, "texto") == 0)
+        *format = REPORT_TEXT;
+    else if (strcmp(name, "json") == 0)
+        *format = REPORT_JSON;
+    else if (strcmp(name, "binario") == 0)
+        *format = REPORT_BINARY;
+    else
+        return 0;
+    return 1;
+}
+
+int skip_report_sections(const char *list, unsigned int *sections)
+{
+    static const struct
+    {
+        const char *name;
+        unsigned int bits;
+    } names[] = {{"arvores", REPORT_TREES},         {"original", REPORT_ORIGINAL_TREE},
+                 {"ajustada", REPORT_ADJUSTED_TREE}, {"simbolos", REPORT_SYMBOLS},
+                 {"erros", REPORT_ERRORS},           {"otimizacoes", REPORT_OPTIMIZATIONS},
+                 {"ri", REPORT_INTERMEDIATE}};
+
+    while (*list != '\0')
+    {
+        size_t length = strcspn(list, ",");
+        size_t i = 0;
+        while (i < sizeof(names) / sizeof(names[0]) &&
+               !(strlen(names[i].name) == length && strncmp(names[i].name, list, length) == 0))
+            i++;
+        if (i == sizeof(names) / sizeof(names[0]))
+            return 0;
+        *sections &= ~names[i].bits;
+        list += length;
+        if (*list == ',')
+            list++;
+    }
+    return 1;
+}
+
+const char *report_file_suffix(report_format format)
+{
+    switch (format)
+    {
+    case REPORT_JSON:
+        return "_semantic_report.json";
+    case REPORT_BINARY:
+        return "_semantic_report.bin";
+    default:
+        return "_semantic_report.txt";
+    }
+}
+
+// ============================================================================
+// TEXTO
+// ============================================================================
+
+/// @brief O texto de um operador da árvore.
+static const char *operator_text(token_type op)
+{
+    switch (op)
+    {
+    case T_E:
+        return "&&";
+    case T_OU:
+        return "||";
+    case T_MENOR:
+        return "<";
+    case T_MAIOR:
+        return ">";
+    case T_IGUAL:
+        return "==";
+    case T_DIFERENTE:
+        return "!=";
+    case T_MENOR_IGUAL:
+        return "<=";
+    case T_MAIOR_IGUAL:
+        return ">=";
+    case T_SOMA:
+        return "+";
+    case T_SUB:
+        return "-";
+    case T_MULT:
+        return "*";
+    case T_DIV:
+        return "/";
+    default:
+        return "unknown";
+    }
+}
+
+/// @brief Acrescenta uma lista da árvore compacta, um nó por linha, indentada pela profundidade.
+static void append_text_tree(report_buffer *buffer, const flat_tree *flat, node_id node, int indentation_level)
+{
+    for (; node != FLAT_NONE; node = flat->next[node])
+    {
+        append_spaces(buffer, indentation_level);
+        append_char(buffer, 'L');
+        append_int(buffer, flat->lines[node]);
+        append_bytes(buffer, ": ", 2);
+
+        switch ((flat_kind)flat->kinds[node])
+        {
+        case FLAT_IF:
+            append_text(buffer, "If\n");
+            break;
+        case FLAT_REPEAT:
+            append_text(buffer, "Repeat\n");
+            break;
+        case FLAT_WHILE:
+            append_text(buffer, "While\n");
+            break;
+        case FLAT_ASSIGNMENT:
+            append_text(buffer, "Assign to: ");
+            append_text(buffer, flat_name(flat, node));
+            append_char(buffer, '\n');
+            break;
+        case FLAT_READ:
+            append_text(buffer, "Read: ");
+            append_text(buffer, flat_name(flat, node));
+            append_char(buffer, '\n');
+            break;
+        case FLAT_WRITE:
+            append_text(buffer, "Write\n");
+            break;
+        case FLAT_DECLARATION:
+            append_text(buffer, "Decl: ");
+            append_text(buffer, flat_name(flat, node));
+            append_char(buffer, '\n');
+            break;
+        case FLAT_OPERATION:
+            append_text(buffer, "Op: ");
+            append_text(buffer, operator_text((token_type)flat->ops[node]));
+            append_char(buffer, '\n');
+            break;
+        case FLAT_CONSTANT:
+            if (flat->types[node] == INTEGER)
+            {
+                append_text(buffer, "Const: ");
+                append_int(buffer, flat->values[node]);
+                append_char(buffer, '\n');
+            }
+            else if (flat->types[node] == REAL)
+                append_format(buffer, "Const: %f\n", flat_real(flat, node));
+            else if (flat->types[node] == BOOLEAN)
+                append_text(buffer, flat->values[node] ? "Const: true\n" : "Const: false\n");
+            else
+                append_text(buffer, "Const (Unknown Type)\n");
+            break;
+        case FLAT_IDENTIFIER:
+            append_text(buffer, "Id: ");
+            append_text(buffer, flat_name(flat, node));
+            append_char(buffer, '\n');
+            break;
+        case FLAT_CONVERSION:
+            append_text(buffer, "Conversion: integer to real\n");
+            break;
+        default:
+            append_text(buffer, "Unknown node\n");
+            break;
+        }
+
+        for (int i = 0; i < flat->child_counts[node]; i++)
+            append_text_tree(buffer, flat, flat_child(flat, node, i), indentation_level + 2);
+    }
+}
+
+/// @brief O endereço de um símbolo para o relatório: "-" se a variável perdeu o espaço no quadro.
+static const char *address_text(const symbol *sym, char *buffer, size_t size)
+{
+    if (sym->memory_address < 0)
+        return "-";
+    snprintf(buffer, size, "%d", sym->memory_address);
+    return buffer;
+}
+
+static void append_text_section(report_buffer *buffer, const char *title, const flat_tree *flat)
+{
+    append_text(buffer, title);
+    append_text(buffer, REPORT_RULE);
+    if (flat == NULL)
+        append_text(buffer, "Memoria insuficiente para imprimir a arvore\n");
+    else
+        append_text_tree(buffer, flat, flat->root, 0);
+}
+
+/// @brief Os contadores de optimization_stats, na ordem da estrutura, com o nome de cada um em JSON.
+static const struct
+{
+    const char *key;
+    size_t offset;
+} optimization_fields[] = {
+    {"folded_operations", offsetof(optimization_stats, folded_operations)},
+    {"folded_conversions", offsetof(optimization_stats, folded_conversions)},
+    {"folded_conditions", offsetof(optimization_stats, folded_conditions)},
+    {"simplified_operations", offsetof(optimization_stats, simplified_operations)},
+    {"pruned_branches", offsetof(optimization_stats, pruned_branches)},
+    {"unreachable_statements", offsetof(optimization_stats, unreachable_statements)},
+    {"dead_assignments", offsetof(optimization_stats, dead_assignments)},
+    {"propagated_constants", offsetof(optimization_stats, propagated_constants)},
+    {"removed_variables", offsetof(optimization_stats, removed_variables)},
+    {"strength_reductions", offsetof(optimization_stats, strength_reductions)},
+    {"hoisted_expressions", offsetof(optimization_stats, hoisted_expressions)},
+    {"unrolled_loops", offsetof(optimization_stats, unrolled_loops)},
+    {"common_subexpressions", offsetof(optimization_stats, common_subexpressions)},
+    {"reused_expressions", offsetof(optimization_stats, reused_expressions)},
+    {"shared_nodes", offsetof(optimization_stats, shared_nodes)},
+    {"node_count_before", offsetof(optimization_stats, node_count_before)},
+    {"node_count", offsetof(optimization_stats, node_count)},
+    {"node_limit", offsetof(optimization_stats, node_limit)},
+    {"frame_size_before", offsetof(optimization_stats, frame_size_before)}};
+
+_Static_assert(sizeof(optimization_fields) / sizeof(optimization_fields[0]) == sizeof(optimization_stats) / sizeof(int),
+               "optimization_fields deve listar todos os contadores de optimization_stats");
+
+/// @brief O valor de um contador de optimization_fields.
+static int optimization_field(const optimization_stats *stats, size_t i)
+{
+    int value;
+    memcpy(&value, (const char *)stats + optimization_fields[i].offset, sizeof(value));
+    return value;
+}
+
+/// @brief Acrescenta os laços registrados pela análise das variáveis de indução.
+static void append_text_loops(report_buffer *buffer, const report_details *details)
+{
+    append_format(buffer, "Lacos analisados:                 %d\n", details->loop_count);
+    for (int i = 0; i < details->loop_count; i++)
+    {
+        const report_loop *loop = &details->loops[i];
+        append_format(buffer, "  %s (linha %d): ", (loop->kind == WHILE_STATEMENT) ? "enquanto" : "repita",
+                      loop->line);
+        if (loop->induction_variable == NULL)
+            append_text(buffer, "sem variavel de inducao");
+        else
+        {
+            append_format(buffer, "%s (passo %d), ", loop->induction_variable, loop->step);
+            if (loop->trip_count < 0)
+                append_text(buffer, "voltas desconhecidas");
+            else
+                append_format(buffer, "%d volta%s", loop->trip_count, (loop->trip_count == 1) ? "" : "s");
+        }
+        append_format(buffer, ", %d derivada%s", loop->derived_variables, (loop->derived_variables == 1) ? "" : "s");
+        if (loop->unroll_factor == 0)
+            append_text(buffer, ", desenrolado por completo");
+        else if (loop->unroll_factor > 1)
+            append_format(buffer, ", desenrolado %dx", loop->unroll_factor);
+        append_char(buffer, '\n');
+    }
+}
+
+/// @brief Acrescenta a seção 5: o que as otimizações removeram da árvore ajustada.
+static void append_text_optimizations(report_buffer *buffer, const report_contents *contents)
+{
+    const report_details *details = contents->details;
+    const optimization_stats *stats = &details->optimizations;
+    append_text(buffer, "\n5. OTIMIZACOES:\n" REPORT_RULE);
+    if (contents->error_count > 0)
+    {
+        append_text(buffer, "Nenhuma otimizacao: o programa tem erros semanticos.\n");
+        return;
+    }
+    append_format(buffer, "Operacoes constantes avaliadas:   %d\n", stats->folded_operations);
+    append_format(buffer, "Conversoes de constantes:         %d\n", stats->folded_conversions);
+    append_format(buffer, "Condicoes constantes avaliadas:   %d\n", stats->folded_conditions);
+    append_format(buffer, "Identidades algebricas aplicadas: %d\n", stats->simplified_operations);
+    append_format(buffer, "Desvios removidos:                %d\n", stats->pruned_branches);
+    append_format(buffer, "Comandos inalcancaveis removidos: %d\n", stats->unreachable_statements);
+    append_format(buffer, "Atribuicoes sem uso removidas:    %d\n", stats->dead_assignments);
+    append_format(buffer, "Constantes propagadas (SSA):      %d\n", stats->propagated_constants);
+    append_format(buffer, "Variaveis sem uso removidas:      %d\n", stats->removed_variables);
+    append_format(buffer, "Multiplicacoes reduzidas a somas: %d\n", stats->strength_reductions);
+    append_format(buffer, "Expressoes invariantes movidas:   %d\n", stats->hoisted_expressions);
+    append_format(buffer, "Lacos desenrolados:               %d\n", stats->unrolled_loops);
+    append_format(buffer, "Subexpressoes comuns reusadas:    %d (em %d temporarias)\n", stats->reused_expressions,
+                  stats->common_subexpressions);
+    append_format(buffer, "Nos de expressao compartilhados:  %d\n", stats->shared_nodes);
+    append_format(buffer, "Nos da arvore:                    %d (antes %d, limite %d)\n", stats->node_count,
+                  stats->node_count_before, stats->node_limit);
+    append_format(buffer, "Quadro de variaveis:              %d bytes (antes %d)\n", details->frame_size,
+                  stats->frame_size_before);
+    append_text_loops(buffer, details);
+}
+
+/// @brief Acrescenta a seção 6: a representação intermediária da árvore ajustada, depois da propagação de
+///        constantes e da numeração de valores.
+static void append_text_intermediate(report_buffer *buffer, const report_details *details)
+{
+    append_text(buffer, "\n6. REPRESENTACAO INTERMEDIARIA (SSA):\n" REPORT_RULE);
+    if (details->ir_status == REPORT_IR_SEMANTIC_ERRORS)
+    {
+        append_text(buffer, "Nao gerada: o programa tem erros semanticos.\n");
+        return;
+    }
+    if (details->ir_status == REPORT_IR_OUT_OF_MEMORY)
+    {
+        append_text(buffer, "Nao gerada: memoria insuficiente.\n");
+        return;
+    }
+    append_bytes(buffer, details->listing, details->listing_length);
+    append_text(buffer, REPORT_RULE);
+    append_format(buffer, "Blocos: %d (%d inalcancaveis), constantes: %d, valores redundantes: %d%s\n",
+                  details->block_count, details->unreachable_blocks, details->constant_values,
+                  details->redundant_values, details->complete ? "" : " (numeracao incompleta)");
+}
+
+static void render_text(const report_contents *contents, unsigned int sections, report_buffer *buffer)
+{
+    append_text(buffer, "=== RELATORIO DE ANALISE SEMANTICA ===\n\n");
+    if (sections & REPORT_ORIGINAL_TREE)
+        append_text_section(buffer, "1. ARVORE SINTATICA ORIGINAL:\n", contents->original_tree);
+    if (sections & REPORT_ADJUSTED_TREE)
+        append_text_section(buffer, "\n2. ARVORE APOS AJUSTES SEMANTICOS:\n", contents->adjusted_tree);
+
+    if (sections & REPORT_SYMBOLS)
+    {
+        append_text(buffer, "\n3. TABELA DE SIMBOLOS:\n" REPORT_RULE);
+        append_format(buffer, "%-15s %-10s %-10s %-10s\n", "Nome", "Tipo", "Endereco", "Tamanho");
+        append_text(buffer, REPORT_RULE);
+        for (int i = 0; i < contents->symbol_count; i++)
+        {
+            const symbol *sym = &contents->symbols[i];
+            char address[16];
+            append_format(buffer, "%-15s %-10s %-10s %-10d\n", sym->name,
+                          (sym->type == DT_INTEGER) ? "inteiro" : "real", address_text(sym, address, sizeof(address)),
+                          sym->size);
+        }
+    }
+
+    if (sections & REPORT_ERRORS)
+    {
+        append_text(buffer, "\n4. ERROS SEMANTICOS:\n" REPORT_RULE);
+        if (contents->error_count == 0)
+            append_text(buffer, "Nenhum erro semantico encontrado.\n");
+        for (int i = 0; i < contents->error_count; i++)
+        {
+            append_text(buffer, "Linha ");
+            append_int(buffer, contents->errors[i].line);
+            append_bytes(buffer, ": ", 2);
+            append_text(buffer, contents->errors[i].message);
+            append_char(buffer, '\n');
+        }
+    }
+
+    if (contents->details == NULL)
+        return;
+    if (sections & REPORT_OPTIMIZATIONS)
+        append_text_optimizations(buffer, contents);
+    if (sections & REPORT_INTERMEDIATE)
+        append_text_intermediate(buffer, contents->details);
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+static void append_json_string(report_buffer *buffer, const char *text, size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+    append_char(buffer, '"');
+    size_t run = 0; // Os bytes que não precisam de escape são copiados em blocos
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        append_bytes(buffer, text + run, i - run);
+        run = i + 1;
+        if (c == '"' || c == '\\')
+        {
+            char escaped[2] = {'\\', (char)c};
+            append_bytes(buffer, escaped, 2);
+        }
+        else if (c == '\n')
+            append_bytes(buffer, "\\n", 2);
+        else if (c == '\t')
+            append_bytes(buffer, "\\t", 2);
+        else
+        {
+            char escaped[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+            append_bytes(buffer, escaped, 6);
+        }
+    }
+    append_bytes(buffer, text + run, length - run);
+    append_char(buffer, '"');
+}
+
+static void append_json_name(report_buffer *buffer, const char *key, const char *name)
+{
+    append_text(buffer, key);
+    append_json_string(buffer, name, strlen(name));
+}
+
+/// @brief O nome de um tipo da árvore, ou NULL para VOID.
+static const char *json_type_name(exp_type type)
+{
+    switch (type)
+    {
+    case INTEGER:
+        return "integer";
+    case REAL:
+        return "real";
+    case BOOLEAN:
+        return "boolean";
+    default:
+        return NULL;
+    }
+}
+
+/// @brief Acrescenta uma lista da árvore compacta como um vetor JSON de nós.
+static void append_json_tree(report_buffer *buffer, const flat_tree *flat, node_id node)
+{
+    static const char *node_names[] = {"If",        "Repeat", "While", "Assign", "Read", "Write",
+                                       "Decl",      "Op",     "Const", "Id",     "Conversion"};
+    append_char(buffer, '[');
+    for (int first = 1; node != FLAT_NONE; node = flat->next[node], first = 0)
+    {
+        flat_kind kind = (flat_kind)flat->kinds[node];
+        if (!first)
+            append_char(buffer, ',');
+        append_text(buffer, "{\"line\":");
+        append_int(buffer, flat->lines[node]);
+        append_text(buffer, ",\"node\":\"");
+        append_text(buffer, (kind <= FLAT_CONVERSION) ? node_names[kind] : "Unknown");
+        append_char(buffer, '"');
+
+        if (kind == FLAT_ASSIGNMENT || kind == FLAT_READ || kind == FLAT_DECLARATION || kind == FLAT_IDENTIFIER)
+            append_json_name(buffer, ",\"name\":", flat_name(flat, node));
+        if (kind == FLAT_OPERATION)
+        {
+            append_text(buffer, ",\"op\":\"");
+            append_text(buffer, operator_text((token_type)flat->ops[node]));
+            append_char(buffer, '"');
+        }
+        const char *type = (kind >= FLAT_OPERATION) ? json_type_name((exp_type)flat->types[node]) : NULL;
+        if (type != NULL)
+        {
+            append_text(buffer, ",\"type\":\"");
+            append_text(buffer, type);
+            append_char(buffer, '"');
+        }
+        if (kind == FLAT_CONSTANT)
+        {
+            append_text(buffer, ",\"value\":");
+            if (flat->types[node] == REAL)
+            {
+                double value = flat_real(flat, node);
+                if (isfinite(value))
+                    append_format(buffer, "%.17g", value);
+                else
+                    append_text(buffer, "null");
+            }
+            else if (flat->types[node] == BOOLEAN)
+                append_text(buffer, flat->values[node] ? "true" : "false");
+            else
+                append_int(buffer, flat->values[node]);
+        }
+
+        if (flat->child_counts[node] > 0)
+        {
+            append_text(buffer, ",\"children\":[");
+            for (int i = 0; i < flat->child_counts[node]; i++)
+            {
+                if (i > 0)
+                    append_char(buffer, ',');
+                append_json_tree(buffer, flat, flat_child(flat, node, i));
+            }
+            append_char(buffer, ']');
+        }
+        append_char(buffer, '}');
+    }
+    append_char(buffer, ']');
+}
+
+/// @brief Acrescenta a chave de uma seção, com a vírgula que a separa da anterior.
+static void append_json_key(report_buffer *buffer, int *members, const char *key)
+{
+    if ((*members)++ > 0)
+        append_char(buffer, ',');
+    append_char(buffer, '"');
+    append_text(buffer, key);
+    append_text(buffer, "\":");
+}
+
+static void append_json_section_tree(report_buffer *buffer, int *members, const char *key, const flat_tree *flat)
+{
+    append_json_key(buffer, members, key);
+    if (flat == NULL)
+        append_text(buffer, "null");
+    else
+        append_json_tree(buffer, flat, flat->root);
+}
+
+/// @brief Acrescenta um campo inteiro de um objeto JSON, com a vírgula que o separa do anterior.
+static void append_json_int(report_buffer *buffer, int *members, const char *key, long value)
+{
+    append_json_key(buffer, members, key);
+    append_int(buffer, value);
+}
+
+/// @brief Acrescenta a seção 5 como um objeto com os contadores e os laços, ou null se não houve otimizações.
+static void append_json_optimizations(report_buffer *buffer, const report_contents *contents)
+{
+    const report_details *details = contents->details;
+    if (contents->error_count > 0)
+    {
+        append_text(buffer, "null");
+        return;
+    }
+    int members = 0;
+    append_char(buffer, '{');
+    for (size_t i = 0; i < sizeof(optimization_fields) / sizeof(optimization_fields[0]); i++)
+        append_json_int(buffer, &members, optimization_fields[i].key, optimization_field(&details->optimizations, i));
+    append_json_int(buffer, &members, "frame_size", details->frame_size);
+    append_json_key(buffer, &members, "loops");
+    append_char(buffer, '[');
+    for (int i = 0; i < details->loop_count; i++)
+    {
+        const report_loop *loop = &details->loops[i];
+        if (i > 0)
+            append_char(buffer, ',');
+        append_text(buffer, (loop->kind == WHILE_STATEMENT) ? "{\"kind\":\"enquanto\"" : "{\"kind\":\"repita\"");
+        append_text(buffer, ",\"line\":");
+        append_int(buffer, loop->line);
+        if (loop->induction_variable == NULL)
+            append_text(buffer, ",\"induction_variable\":null");
+        else
+            append_json_name(buffer, ",\"induction_variable\":", loop->induction_variable);
+        append_text(buffer, ",\"step\":");
+        append_int(buffer, loop->step);
+        append_text(buffer, ",\"trip_count\":");
+        if (loop->trip_count < 0)
+            append_text(buffer, "null");
+        else
+            append_int(buffer, loop->trip_count);
+        append_text(buffer, ",\"derived_variables\":");
+        append_int(buffer, loop->derived_variables);
+        append_text(buffer, ",\"unroll_factor\":");
+        append_int(buffer, loop->unroll_factor);
+        append_char(buffer, '}');
+    }
+    append_text(buffer, "]}");
+}
+
+/// @brief Acrescenta a seção 6 como um objeto com o estado, os contadores e as linhas da listagem.
+static void append_json_intermediate(report_buffer *buffer, const report_details *details)
+{
+    static const char *statuses[] = {"built", "semantic_errors", "out_of_memory"};
+    int members = 0;
+    append_char(buffer, '{');
+    append_json_key(buffer, &members, "status");
+    append_char(buffer, '"');
+    append_text(buffer, statuses[details->ir_status]);
+    append_char(buffer, '"');
+    if (details->ir_status == REPORT_IR_BUILT)
+    {
+        append_json_int(buffer, &members, "block_count", details->block_count);
+        append_json_int(buffer, &members, "unreachable_blocks", details->unreachable_blocks);
+        append_json_int(buffer, &members, "constant_values", details->constant_values);
+        append_json_int(buffer, &members, "redundant_values", details->redundant_values);
+        append_json_key(buffer, &members, "complete");
+        append_text(buffer, details->complete ? "true" : "false");
+
+        append_json_key(buffer, &members, "listing");
+        append_char(buffer, '[');
+        const char *line = details->listing;
+        const char *end = details->listing + details->listing_length;
+        while (line < end)
+        {
+            const char *newline = (const char *)memchr(line, '\n', (size_t)(end - line));
+            size_t length = (newline != NULL) ? (size_t)(newline - line) : (size_t)(end - line);
+            if (line != details->listing)
+                append_char(buffer, ',');
+            append_json_string(buffer, line, length);
+            line += length + 1;
+        }
+        append_char(buffer, ']');
+    }
+    append_char(buffer, '}');
+}
+
+static void render_json(const report_contents *contents, unsigned int sections, report_buffer *buffer)
+{
+    int members = 0;
+    append_char(buffer, '{');
+    if (sections & REPORT_ORIGINAL_TREE)
+        append_json_section_tree(buffer, &members, "original_tree", contents->original_tree);
+    if (sections & REPORT_ADJUSTED_TREE)
+        append_json_section_tree(buffer, &members, "adjusted_tree", contents->adjusted_tree);
+
+    if (sections & REPORT_SYMBOLS)
+    {
+        append_json_key(buffer, &members, "symbols");
+        append_char(buffer, '[');
+        for (int i = 0; i < contents->symbol_count; i++)
+        {
+            const symbol *sym = &contents->symbols[i];
+            if (i > 0)
+                append_char(buffer, ',');
+            append_json_name(buffer, "{\"name\":", sym->name);
+            append_text(buffer, (sym->type == DT_INTEGER) ? ",\"type\":\"inteiro\"" : ",\"type\":\"real\"");
+            append_text(buffer, ",\"declared_line\":");
+            append_int(buffer, sym->declared_line);
+            append_text(buffer, ",\"address\":");
+            if (sym->memory_address < 0)
+                append_text(buffer, "null");
+            else
+                append_int(buffer, sym->memory_address);
+            append_text(buffer, ",\"size\":");
+            append_int(buffer, sym->size);
+            append_text(buffer, sym->is_initialized ? ",\"initialized\":true}" : ",\"initialized\":false}");
+        }
+        append_char(buffer, ']');
+    }
+
+    if (sections & REPORT_ERRORS)
+    {
+        append_json_key(buffer, &members, "errors");
+        append_char(buffer, '[');
+        for (int i = 0; i < contents->error_count; i++)
+        {
+            if (i > 0)
+                append_char(buffer, ',');
+            append_text(buffer, "{\"line\":");
+            append_int(buffer, contents->errors[i].line);
+            append_json_name(buffer, ",\"message\":", contents->errors[i].message);
+            append_char(buffer, '}');
+        }
+        append_char(buffer, ']');
+    }
+
+    if (contents->details != NULL && (sections & REPORT_OPTIMIZATIONS))
+    {
+        append_json_key(buffer, &members, "optimizations");
+        append_json_optimizations(buffer, contents);
+    }
+    if (contents->details != NULL && (sections & REPORT_INTERMEDIATE))
+    {
+        append_json_key(buffer, &members, "intermediate_representation");
+        append_json_intermediate(buffer, contents->details);
+    }
+    append_text(buffer, "}\n");
+}
+
+// ============================================================================
+// BINÁRIO
+// ============================================================================
+
+/// @brief Começa uma seção do relatório binário; o tamanho é preenchido por end_binary_section().
+/// @return A posição do cabeçalho da seção no buffer.
+static size_t begin_binary_section(report_buffer *buffer, unsigned int section, uint32_t items)
+{
+    size_t position = buffer->length;
+    uint32_t header[4] = {section, items, 0, 0};
+    append_bytes(buffer, header, sizeof(header));
+    return position;
+}
+
+static void end_binary_section(report_buffer *buffer, size_t position)
+{
+    if (buffer->failed)
+        return;
+    uint64_t size = buffer->length - position - 4 * sizeof(uint32_t);
+    memcpy(buffer->data + position + 2 * sizeof(uint32_t), &size, sizeof(size));
+    append_padding(buffer);
+}
+
+static void append_binary_tree(report_buffer *buffer, unsigned int section, const flat_tree *flat)
+{
+    if (flat == NULL)
+    {
+        buffer->failed = 1;
+        return;
+    }
+    size_t position = begin_binary_section(buffer, section, flat->count);
+    uint32_t sizes[6] = {flat->count, flat->child_total, flat->name_count, flat->real_count, flat->root, 0};
+    append_bytes(buffer, sizes, sizeof(sizes));
+    // Dos vetores de elementos maiores para os menores, para que nenhum precise de alinhamento
+    append_bytes(buffer, flat->reals, flat->real_count * sizeof(double));
+    append_bytes(buffer, flat->lines, flat->count * sizeof(int32_t));
+    append_bytes(buffer, flat->values, flat->count * sizeof(int32_t));
+    append_bytes(buffer, flat->next, flat->count * sizeof(node_id));
+    append_bytes(buffer, flat->children, flat->child_total * sizeof(node_id));
+    append_bytes(buffer, flat->ops, flat->count * sizeof(uint16_t));
+    append_bytes(buffer, flat->kinds, flat->count * sizeof(uint8_t));
+    append_bytes(buffer, flat->types, flat->count * sizeof(uint8_t));
+    append_bytes(buffer, flat->child_counts, flat->count * sizeof(uint8_t));
+    for (uint32_t i = 0; i < flat->name_count; i++)
+        append_bytes(buffer, flat->names[i], strlen(flat->names[i]) + 1);
+    end_binary_section(buffer, position);
+}
+
+static void append_binary_optimizations(report_buffer *buffer, const report_contents *contents)
+{
+    const report_details *details = contents->details;
+    if (contents->error_count > 0)
+    {
+        end_binary_section(buffer, begin_binary_section(buffer, REPORT_OPTIMIZATIONS, 0));
+        return;
+    }
+    size_t position = begin_binary_section(buffer, REPORT_OPTIMIZATIONS, (uint32_t)details->loop_count);
+    int32_t frame_size = details->frame_size;
+    append_bytes(buffer, &details->optimizations, sizeof(details->optimizations));
+    append_bytes(buffer, &frame_size, sizeof(frame_size));
+    uint32_t offset = 0;
+    for (int i = 0; i < details->loop_count; i++)
+    {
+        const report_loop *loop = &details->loops[i];
+        int32_t name = (loop->induction_variable != NULL) ? (int32_t)offset : -1;
+        int32_t record[7] = {loop->kind, loop->line, name, loop->step, loop->trip_count, loop->derived_variables,
+                             loop->unroll_factor};
+        append_bytes(buffer, record, sizeof(record));
+        if (loop->induction_variable != NULL)
+            offset += (uint32_t)strlen(loop->induction_variable) + 1;
+    }
+    for (int i = 0; i < details->loop_count; i++)
+    {
+        const char *name = details->loops[i].induction_variable;
+        if (name != NULL)
+            append_bytes(buffer, name, strlen(name) + 1);
+    }
+    end_binary_section(buffer, position);
+}
+
+static void append_binary_intermediate(report_buffer *buffer, const report_details *details)
+{
+    size_t position = begin_binary_section(buffer, REPORT_INTERMEDIATE, 0);
+    int32_t record[6] = {details->ir_status,     details->block_count,      details->unreachable_blocks,
+                         details->constant_values, details->redundant_values, details->complete};
+    append_bytes(buffer, record, sizeof(record));
+    append_bytes(buffer, details->listing, details->listing_length);
+    end_binary_section(buffer, position);
+}
+
+/// @brief As seções que o relatório de fato contém: as seções 5 e 6 só existem se foram calculadas.
+static unsigned int present_sections(const report_contents *contents, unsigned int sections)
+{
+    if (contents->details == NULL)
+        sections &= ~(REPORT_OPTIMIZATIONS | REPORT_INTERMEDIATE);
+    return sections & REPORT_ALL_SECTIONS;
+}
+
+static void render_binary(const report_contents *contents, unsigned int sections, report_buffer *buffer)
+{
+    sections = present_sections(contents, sections);
+    uint32_t header[2] = {REPORT_BINARY_VERSION, sections};
+    append_bytes(buffer, REPORT_BINARY_MAGIC, 8);
+    append_bytes(buffer, header, sizeof(header));
+
+    if (sections & REPORT_ORIGINAL_TREE)
+        append_binary_tree(buffer, REPORT_ORIGINAL_TREE, contents->original_tree);
+    if (sections & REPORT_ADJUSTED_TREE)
+        append_binary_tree(buffer, REPORT_ADJUSTED_TREE, contents->adjusted_tree);
+
+    if (sections & REPORT_SYMBOLS)
+    {
+        size_t position = begin_binary_section(buffer, REPORT_SYMBOLS, (uint32_t)contents->symbol_count);
+        uint32_t offset = 0;
+        for (int i = 0; i < contents->symbol_count; i++)
+        {
+            const symbol *sym = &contents->symbols[i];
+            int32_t record[6] = {(int32_t)offset, sym->type, sym->declared_line, sym->memory_address, sym->size,
+                                 sym->is_initialized};
+            append_bytes(buffer, record, sizeof(record));
+            offset += (uint32_t)strlen(sym->name) + 1;
+        }
+        for (int i = 0; i < contents->symbol_count; i++)
+            append_bytes(buffer, contents->symbols[i].name, strlen(contents->symbols[i].name) + 1);
+        end_binary_section(buffer, position);
+    }
+
+    if (sections & REPORT_ERRORS)
+    {
+        size_t position = begin_binary_section(buffer, REPORT_ERRORS, (uint32_t)contents->error_count);
+        uint32_t offset = 0;
+        for (int i = 0; i < contents->error_count; i++)
+        {
+            int32_t record[2] = {contents->errors[i].line, (int32_t)offset};
+            append_bytes(buffer, record, sizeof(record));
+            offset += (uint32_t)strlen(contents->errors[i].message) + 1;
+        }
+        for (int i = 0; i < contents->error_count; i++)
+            append_bytes(buffer, contents->errors[i].message, strlen(contents->errors[i].message) + 1);
+        end_binary_section(buffer, position);
+    }
+
+    if (sections & REPORT_OPTIMIZATIONS)
+        append_binary_optimizations(buffer, contents);
+    if (sections & REPORT_INTERMEDIATE)
+        append_binary_intermediate(buffer, contents->details);
+}
+
+int render_report(const report_contents *contents, const report_options *options, report_buffer *buffer)
+{
+    buffer->length = 0;
+    buffer->failed = 0;
+    switch (options->format)
+    {
+    case REPORT_JSON:
+        render_json(contents, options->sections, buffer);
+        break;
+    case REPORT_BINARY:
+        render_binary(contents, options->sections, buffer);
+        break;
+    default:
+        render_text(contents, options->sections, buffer);
+        break;
+    }
+    return !buffer->failed;
+}
+
+// ============================================================================
+// RELATÓRIO DE UMA ANÁLISE
+// ============================================================================
+
+/// @brief Os nomes das instruções da representação intermediária.
+static const char *ir_opcode_names[] = {
+#define IR_OPCODE_NAME(name, text) text,
+    IR_OPCODE_LIST(IR_OPCODE_NAME)
+#undef IR_OPCODE_NAME
+};
+
+static const char *ir_type_suffix(exp_type type)
+{
+    return (type == REAL) ? ".r" : ".i";
+}
+
+static void append_ir_operand(report_buffer *buffer, const ir_program *program, int operand)
+{
+    operand = resolve_ir_value(program, operand);
+    const ir_value *value = &program->values[operand];
+    if (value->opcode != IR_CONSTANT)
+    {
+        append_char(buffer, 'v');
+        append_int(buffer, operand);
+        return;
+    }
+    if (value->type == BOOLEAN)
+        append_text(buffer, value->constant.int_value ? "true" : "false");
+    else if (value->type == INTEGER)
+        append_int(buffer, value->constant.int_value);
+    else
+    {
+        // Um real sempre aparece com ponto, para não ser confundido com um inteiro
+        char text[64];
+        snprintf(text, sizeof(text), "%g", value->constant.real_value);
+        append_text(buffer, text);
+        if (strpbrk(text, ".eni") == NULL)
+            append_text(buffer, ".0");
+    }
+}
+
+static const char *ir_variable_name(const ir_program *program, int variable)
+{
+    return (variable >= 0) ? program->symbols->symbols[variable].name : "";
+}
+
+static void append_ir_instruction(report_buffer *buffer, const ir_program *program, int index)
+{
+    const ir_value *value = &program->values[index];
+    const ir_block *block = &program->blocks[value->block];
+
+    append_spaces(buffer, 4);
+    if (value->opcode != IR_WRITE)
+    {
+        append_char(buffer, 'v');
+        append_int(buffer, index);
+        append_text(buffer, " = ");
+    }
+
+    switch (value->opcode)
+    {
+    case IR_PHI:
+        append_format(buffer, "phi%s %s [B%d: ", ir_type_suffix(value->type),
+                      ir_variable_name(program, value->variable), block->predecessors[0]);
+        append_ir_operand(buffer, program, value->operands[0]);
+        append_format(buffer, ", B%d: ", block->predecessors[1]);
+        append_ir_operand(buffer, program, value->operands[1]);
+        append_text(buffer, "]\n");
+        return;
+    case IR_READ:
+        append_format(buffer, "read%s %s\n", ir_type_suffix(value->type), ir_variable_name(program, value->variable));
+        return;
+    case IR_WRITE:
+    case IR_TO_REAL:
+        append_text(buffer, ir_opcode_names[value->opcode]);
+        append_char(buffer, ' ');
+        append_ir_operand(buffer, program, value->operands[0]);
+        append_char(buffer, '\n');
+        return;
+    default:
+    {
+        // As comparações levam o tipo dos operandos; as operações aritméticas, o do resultado
+        exp_type type = value->type;
+        if (type == BOOLEAN)
+        {
+            int left = resolve_ir_value(program, value->operands[0]);
+            int right = resolve_ir_value(program, value->operands[1]);
+            type = (program->values[left].type == REAL || program->values[right].type == REAL) ? REAL : INTEGER;
+        }
+        append_text(buffer, ir_opcode_names[value->opcode]);
+        append_text(buffer, ir_type_suffix(type));
+        append_char(buffer, ' ');
+        append_ir_operand(buffer, program, value->operands[0]);
+        append_text(buffer, ", ");
+        append_ir_operand(buffer, program, value->operands[1]);
+        append_char(buffer, '\n');
+        return;
+    }
+    }
+}
+
+/// @brief Acrescenta a listagem da representação intermediária, bloco a bloco, só com os blocos alcançáveis.
+static void append_ir_listing(report_buffer *buffer, const ir_program *program)
+{
+    for (int b = 0; b < program->block_count; b++)
+    {
+        const ir_block *block = &program->blocks[b];
+        if (!block->reachable)
+            continue;
+
+        append_char(buffer, 'B');
+        append_int(buffer, b);
+        append_char(buffer, ':');
+        for (int p = 0; p < block->predecessor_count; p++)
+        {
+            append_text(buffer, (p == 0) ? " <- B" : ", B");
+            append_int(buffer, block->predecessors[p]);
+        }
+        append_char(buffer, '\n');
+
+        for (int i = 0; i < block->instruction_count; i++)
+        {
+            if (program->values[block->instructions[i]].replacement < 0)
+                append_ir_instruction(buffer, program, block->instructions[i]);
+        }
+
+        switch (block->terminator)
+        {
+        case IR_JUMP:
+            append_format(buffer, "    jump B%d\n", block->successors[0]);
+            break;
+        case IR_BRANCH:
+            append_text(buffer, "    branch ");
+            append_ir_operand(buffer, program, block->condition);
+            append_format(buffer, ", B%d, B%d\n", block->successors[0], block->successors[1]);
+            break;
+        default:
+            append_text(buffer, "    return\n");
+            break;
+        }
+    }
+}
+
+int collect_report_details(semantic_analyzer *analyzer, unsigned int sections, report_details *details)
+{
+    memset(details, 0, sizeof(*details));
+    details->optimizations = analyzer->optimizations;
+    details->frame_size = analyzer->table.next_address;
+    details->ir_status = (analyzer->error_count > 0) ? REPORT_IR_SEMANTIC_ERRORS : REPORT_IR_BUILT;
+
+    if (analyzer->loop_count > 0)
+    {
+        report_loop *loops = (report_loop *)calloc((size_t)analyzer->loop_count, sizeof(report_loop));
+        if (loops == NULL)
+            return 0;
+        for (int i = 0; i < analyzer->loop_count; i++)
+        {
+            const loop_info *info = &analyzer->loops[i];
+            loops[i].kind = info->kind;
+            loops[i].line = info->line;
+            loops[i].induction_variable = info->induction_variable;
+            loops[i].step = info->step;
+            loops[i].trip_count = info->trip_count;
+            loops[i].derived_variables = info->derived_variables;
+            loops[i].unroll_factor = (info->loop == NULL) ? 0 : info->unroll_factor;
+        }
+        details->loops = loops;
+        details->loop_count = analyzer->loop_count;
+    }
+
+    if (!(sections & REPORT_INTERMEDIATE) || details->ir_status != REPORT_IR_BUILT)
+        return 1;
+    ir_program *program = build_ir(analyzer, analyzer->adjusted_tree);
+    if (program == NULL || !propagate_ir_constants(program))
+    {
+        details->ir_status = REPORT_IR_OUT_OF_MEMORY;
+        destroy_ir(program);
+        return 1;
+    }
+    apply_ir_constants(program);
+    details->complete = number_ir_values(program);
+    details->block_count = program->block_count;
+    details->unreachable_blocks = program->unreachable_blocks;
+    details->constant_values = program->constant_values;
+    details->redundant_values = program->redundant_values;
+
+    report_buffer listing;
+    memset(&listing, 0, sizeof(listing));
+    append_ir_listing(&listing, program);
+    destroy_ir(program);
+    details->listing = listing.data;
+    details->listing_length = listing.length;
+    if (listing.failed)
+    {
+        release_report_details(details);
+        return 0;
+    }
+    return 1;
+}
+
+void release_report_details(report_details *details)
+{
+    // Os laços e a listagem só são constantes para quem lê o relatório
+    free((report_loop *)details->loops);
+    free((char *)details->listing);
+    memset(details, 0, sizeof(*details));
+}
+
+/// @brief Monta o relatório de uma análise: converte só as árvores pedidas e escreve só as seções finais
+///        pedidas, antes de passar o conteúdo ao formato escolhido.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+static int build_report(semantic_analyzer *analyzer, const report_options *options, report_buffer *buffer)
+{
+    report_contents contents;
+    memset(&contents, 0, sizeof(contents));
+    if (options->sections & REPORT_ORIGINAL_TREE)
+        contents.original_tree = get_flat_tree(analyzer, analyzer->original_tree);
+    if (options->sections & REPORT_ADJUSTED_TREE)
+        contents.adjusted_tree = get_flat_tree(analyzer, analyzer->adjusted_tree);
+    contents.symbols = analyzer->table.symbols;
+    contents.symbol_count = analyzer->table.count;
+    contents.errors = analyzer->errors;
+    contents.error_count = analyzer->error_count;
+
+    report_details details;
+    unsigned int detail_sections = options->sections & (REPORT_OPTIMIZATIONS | REPORT_INTERMEDIATE);
+    if (detail_sections != 0)
+    {
+        if (!collect_report_details(analyzer, detail_sections, &details))
+            return 0;
+        contents.details = &details;
+    }
+
+    int ok = render_report(&contents, options, buffer);
+    if (contents.details != NULL)
+        release_report_details(&details);
+    return ok;
+}
+
+void generate_report(semantic_analyzer *analyzer, const char *filename, const report_options *options)
+{
+    report_options defaults = default_report_options();
+    if (options == NULL)
+        options = &defaults;
+
+    report_buffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    if (!build_report(analyzer, options, &buffer))
+    {
+        fprintf(stderr, "Memoria insuficiente para montar o relatorio\n");
+        release_report_buffer(&buffer);
+        return;
+    }
+
+    // O console e o arquivo recebem os mesmos bytes, montados uma única vez
+    if (options->console)
+        write_report_buffer(stdout, &buffer);
+
+    FILE *report = fopen(filename, "wb");
+    if (!report)
+        fprintf(stderr, "Erro ao criar arquivo de relatorio: %s\n", filename);
+    else
+    {
+        if (!write_report_buffer(report, &buffer))
+            fprintf(stderr, "Erro ao escrever o relatorio: %s\n", filename);
+        fclose(report);
+    }
+    release_report_buffer(&buffer);
+}
+
+void write_report(semantic_analyzer *analyzer, FILE *report)
+{
+    report_options options = default_report_options();
+    report_buffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    if (build_report(analyzer, &options, &buffer))
+        write_report_buffer(report, &buffer);
+    else
+        fprintf(report, "Memoria insuficiente para montar o relatorio\n");
+    release_report_buffer(&buffer);
+}
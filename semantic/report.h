@@ -0,0 +1,195 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stdio.h>  // FILE
+#include <stddef.h> // size_t
+#include "semantic.h"
+
+/*
+ * O relatório da análise semântica é montado uma única vez em um buffer e escrito com uma única
+ * chamada em cada destino (o console e o arquivo recebem os mesmos bytes). Há três formatos:
+ *
+ * - Texto: as seções numeradas, como no arquivo de relatório.
+ * - JSON: um objeto com as chaves original_tree, adjusted_tree, symbols, errors, optimizations e
+ *   intermediate_representation, só das seções escolhidas. Cada árvore é uma lista de nós, e cada nó
+ *   tem line, node ("If", "Assign", "Op", ...), os campos do seu tipo (name, op, type, value) e, se
+ *   tiver filhos, children: uma lista de nós para cada filho. optimizations é null se o programa tem
+ *   erros semânticos; senão, tem um campo por contador de optimization_stats, frame_size e loops, com
+ *   kind, line, induction_variable, step, trip_count (null se desconhecido), derived_variables e
+ *   unroll_factor (0 se o laço foi trocado pelas cópias do corpo) de cada laço.
+ *   intermediate_representation tem status ("built", "semantic_errors" ou "out_of_memory") e, se
+ *   construída, os contadores block_count, unreachable_blocks, constant_values e redundant_values,
+ *   complete e listing, as linhas da listagem.
+ * - Binário: o cabeçalho "PMREPORT", a versão (u32) e os bits das seções presentes (u32); depois,
+ *   para cada seção presente, na ordem dos bits: o bit da seção (u32), a quantidade de itens (u32), o
+ *   tamanho do conteúdo em bytes (u64) e o conteúdo, completado com zeros até um múltiplo de 8. Os
+ *   números estão na ordem de bytes da máquina.
+ *   - Árvore: count, child_total, name_count, real_count, root e um u32 reservado; os vetores reals
+ *     (f64), lines e values (i32), next e children (u32), ops (u16), kinds, types e child_counts (u8),
+ *     como em flat_tree; e os nomes, cada um terminado em '\0'. first_child não é gravado: os filhos
+ *     estão em children na ordem dos nós, então ele é a soma de child_counts dos nós anteriores.
+ *   - Símbolos: um registro por símbolo (a posição do nome no bloco de textos, tipo, linha da
+ *     declaração, endereço, tamanho e inicializada, seis u32/i32) e o bloco de textos.
+ *   - Erros: um registro por erro (linha e posição da mensagem no bloco de textos, i32 e u32) e o
+ *     bloco de textos.
+ *   - Otimizações: vazia se o programa tem erros semânticos; senão, os contadores de optimization_stats
+ *     e o tamanho do quadro (REPORT_OPTIMIZATION_FIELDS i32), um registro por laço (kind, line,
+ *     posição do nome da variável de indução no bloco de textos ou -1, step, trip_count,
+ *     derived_variables e unroll_factor, sete i32) e o bloco de textos. A quantidade de itens é a de laços.
+ *   - Representação intermediária: status, block_count, unreachable_blocks, constant_values,
+ *     redundant_values e complete (seis i32) e o texto da listagem, uma linha por instrução.
+ */
+
+/// @brief O formato do relatório.
+typedef enum report_format
+{
+    REPORT_TEXT,
+    REPORT_JSON,
+    REPORT_BINARY
+} report_format;
+
+/// @brief Seção 1 do relatório: a árvore sintática original.
+#define REPORT_ORIGINAL_TREE (1u << 0)
+
+/// @brief Seção 2 do relatório: a árvore depois dos ajustes semânticos e das otimizações.
+#define REPORT_ADJUSTED_TREE (1u << 1)
+
+/// @brief Seção 3 do relatório: a tabela de símbolos.
+#define REPORT_SYMBOLS (1u << 2)
+
+/// @brief Seção 4 do relatório: os erros semânticos.
+#define REPORT_ERRORS (1u << 3)
+
+/// @brief Seção 5 do relatório: o que as otimizações fizeram.
+#define REPORT_OPTIMIZATIONS (1u << 4)
+
+/// @brief Seção 6 do relatório: a representação intermediária.
+#define REPORT_INTERMEDIATE (1u << 5)
+
+/// @brief As duas árvores, as seções mais longas do relatório.
+#define REPORT_TREES (REPORT_ORIGINAL_TREE | REPORT_ADJUSTED_TREE)
+
+/// @brief Todas as seções do relatório.
+#define REPORT_ALL_SECTIONS (REPORT_TREES | REPORT_SYMBOLS | REPORT_ERRORS | REPORT_OPTIMIZATIONS | REPORT_INTERMEDIATE)
+
+/// @brief A versão do formato binário.
+#define REPORT_BINARY_VERSION 2
+
+/// @brief Quantos i32 abrem a seção de otimizações do relatório binário: os contadores de
+///        optimization_stats e o tamanho do quadro.
+#define REPORT_OPTIMIZATION_FIELDS ((int)(sizeof(optimization_stats) / sizeof(int)) + 1)
+
+/// @brief Como o relatório é escrito.
+typedef struct report_options
+{
+    report_format format;
+    unsigned int sections; // As seções escritas, em bits REPORT_*
+    int console;           // 1 para escrever o relatório também na saída padrão
+} report_options;
+
+/// @brief Um laço na seção 5 do relatório, como em loop_info, mas sem apontar para a árvore.
+typedef struct report_loop
+{
+    int kind;                       // WHILE_STATEMENT ou REPEAT_STATEMENT
+    int line;
+    const char *induction_variable; // NULL se o laço não tem variável de indução
+    int step;
+    int trip_count;                 // -1 se desconhecido
+    int derived_variables;
+    int unroll_factor;              // Cópias do corpo por volta; 0 se o laço foi trocado pelas cópias do corpo
+} report_loop;
+
+/// @brief Se a representação intermediária da seção 6 foi construída.
+typedef enum report_ir_status
+{
+    REPORT_IR_BUILT,
+    REPORT_IR_SEMANTIC_ERRORS,
+    REPORT_IR_OUT_OF_MEMORY
+} report_ir_status;
+
+/// @brief As seções 5 e 6 do relatório, já calculadas.
+typedef struct report_details
+{
+    optimization_stats optimizations;
+    int frame_size; // O tamanho do quadro depois das otimizações, em bytes
+    const report_loop *loops;
+    int loop_count;
+    report_ir_status ir_status;
+    int block_count;
+    int unreachable_blocks;
+    int constant_values;
+    int redundant_values;
+    int complete;        // 0 se a numeração de valores não terminou por falta de memória
+    const char *listing; // A representação intermediária, uma instrução por linha
+    size_t listing_length;
+} report_details;
+
+/// @brief O que as seções do relatório mostram, já calculado: as árvores na forma compacta, a tabela de
+///        símbolos, os erros e, opcionalmente, as seções de otimizações e da representação intermediária.
+///        Permite escrever o relatório sem o analisador, como a partir do cache.
+typedef struct report_contents
+{
+    const flat_tree *original_tree; // NULL se faltou memória para a conversão
+    const flat_tree *adjusted_tree;
+    const symbol *symbols;
+    int symbol_count;
+    const semantic_error *errors;
+    int error_count;
+    const report_details *details; // As seções 5 e 6, ou NULL para não escrevê-las
+} report_contents;
+
+/// @brief Um relatório montado em memória.
+typedef struct report_buffer
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+    int failed; // 1 se faltou memória em algum acréscimo
+} report_buffer;
+
+/// @brief As opções padrão: texto, todas as seções, no console e no arquivo.
+report_options default_report_options(void);
+
+/// @brief Converte o nome de um formato ("texto", "json" ou "binario").
+/// @return 1 se o nome é conhecido, 0 caso contrário.
+int parse_report_format(const char *name, report_format *format);
+
+/// @brief Retira seções de uma lista separada por vírgulas: "arvores", "original", "ajustada", "simbolos",
+///        "erros", "otimizacoes" e "ri".
+/// @param sections Os bits das seções, dos quais as seções da lista são retiradas.
+/// @return 1 se todos os nomes são conhecidos, 0 caso contrário.
+int skip_report_sections(const char *list, unsigned int *sections);
+
+/// @brief A terminação do nome do arquivo de relatório em cada formato, como "_semantic_report.txt".
+const char *report_file_suffix(report_format format);
+
+/// @brief Monta o relatório no buffer, no formato e com as seções das opções.
+/// @param buffer O buffer, zerado ou reaproveitado; o conteúdo anterior é descartado.
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+int render_report(const report_contents *contents, const report_options *options, report_buffer *buffer);
+
+/// @brief Escreve o relatório montado com uma única escrita.
+/// @return 1 se todos os bytes foram escritos, 0 caso contrário.
+int write_report_buffer(FILE *file, const report_buffer *buffer);
+
+/// @brief Libera o conteúdo do buffer.
+void release_report_buffer(report_buffer *buffer);
+
+/// @brief Calcula as seções 5 e 6 do relatório (otimizações e representação intermediária).
+/// @param sections Os bits REPORT_OPTIMIZATIONS e REPORT_INTERMEDIATE das seções desejadas: a
+///        representação intermediária só é construída se for pedida.
+/// @param details Recebe as seções, a liberar com release_report_details().
+/// @return 1 em caso de sucesso, 0 se faltou memória.
+int collect_report_details(semantic_analyzer *analyzer, unsigned int sections, report_details *details);
+
+/// @brief Libera os laços e a listagem de collect_report_details().
+void release_report_details(report_details *details);
+
+/// @brief Escreve o relatório da análise na saída padrão, se as opções pedirem, e no arquivo.
+/// @param options As opções, ou NULL para as padrão.
+void generate_report(semantic_analyzer *analyzer, const char *filename, const report_options *options);
+
+/// @brief Escreve o relatório da análise em texto, com todas as seções, em um arquivo já aberto.
+void write_report(semantic_analyzer *analyzer, FILE *file);
+
+#endif // REPORT_H
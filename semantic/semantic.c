@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include "semantic.h"
+#include "../optimizer/optimizer.h"
 
 static void check_boolean_condition(semantic_analyzer *analyzer, tree_node *condition_node, int line_number, const char *statement_type)
 {
@@ -21,295 +22,258 @@ static void check_boolean_condition(semantic_analyzer *analyzer, tree_node *cond
     }
 }
 
-static void print_tree_to_file(FILE *file, tree_node *tree, int indentation_level)
+semantic_analyzer *create_semantic_analyzer(tree_node *syntax_tree, arena *arena)
 {
-    while (tree != NULL)
-    {
-        for (int i = 0; i < indentation_level; i++)
-            fprintf(file, " ");
-        fprintf(file, "L%d: ", tree->line_number);
-
-        if (tree->node_kind == STATEMENT_KIND)
-        {
-            switch (tree->kind.stmt)
-            {
-            case IF_STATEMENT:
-                fprintf(file, "If\n");
-                break;
-            case REPEAT_STATEMENT:
-                fprintf(file, "Repeat\n");
-                break;
-            case WHILE_STATEMENT:
-                fprintf(file, "While\n");
-                break;
-            case ASSIGNMENT_STATEMENT:
-                fprintf(file, "Assign to: %s\n", tree->attribute.name);
-                break;
-            case READ_STATEMENT:
-                fprintf(file, "Read: %s\n", tree->attribute.name);
-                break;
-            case WRITE_STATEMENT:
-                fprintf(file, "Write\n");
-                break;
-            case DECLARATION_STATEMENT:
-                fprintf(file, "Decl: %s\n", tree->attribute.name);
-                break;
-            default:
-                fprintf(file, "Unknown statement node\n");
-                break;
-            }
-        }
-        else if (tree->node_kind == EXPRESSION_KIND)
-        {
-            switch (tree->kind.exp)
-            {
-            case OPERATION_EXPRESSION:
-                fprintf(file, "Op: ");
-                switch (tree->attribute.op)
-                {
-                case T_E:
-                    fprintf(file, "&&\n");
-                    break;
-                case T_OU:
-                    fprintf(file, "||\n");
-                    break;
-                case T_MENOR:
-                    fprintf(file, "<\n");
-                    break;
-                case T_MAIOR:
-                    fprintf(file, ">\n");
-                    break;
-                case T_IGUAL:
-                    fprintf(file, "==\n");
-                    break;
-                case T_DIFERENTE:
-                    fprintf(file, "!=\n");
-                    break;
-                case T_MENOR_IGUAL:
-                    fprintf(file, "<=\n");
-                    break;
-                case T_MAIOR_IGUAL:
-                    fprintf(file, ">=\n");
-                    break;
-                case T_SOMA:
-                    fprintf(file, "+\n");
-                    break;
-                case T_SUB:
-                    fprintf(file, "-\n");
-                    break;
-                case T_MULT:
-                    fprintf(file, "*\n");
-                    break;
-                case T_DIV:
-                    fprintf(file, "/\n");
-                    break;
-                default:
-                    fprintf(file, "unknown\n");
-                    break;
-                }
-                break;
-            case CONSTANT_EXPRESSION:
-                if (tree->type == INTEGER)
-                {
-                    fprintf(file, "Const: %d\n", tree->attribute.int_value);
-                }
-                else if (tree->type == REAL)
-                {
-                    fprintf(file, "Const: %f\n", tree->attribute.real_value);
-                }
-                else
-                {
-                    fprintf(file, "Const (Unknown Type)\n");
-                }
-                break;
-            case IDENTIFIER_EXPRESSION:
-                fprintf(file, "Id: %s\n", tree->attribute.name);
-                break;
-            case CONVERSION_EXPRESSION:
-                fprintf(file, "Conversion: integer to real\n");
-                break;
-            default:
-                fprintf(file, "Unknown expression node\n");
-                break;
-            }
-        }
-        else
-        {
-            fprintf(file, "Unknown node\n");
-        }
-
-        for (int i = 0; i < MAXCHILDREN; i++)
-        {
-            print_tree_to_file(file, tree->child[i], indentation_level + 2);
-        }
-
-        tree = tree->sibling;
-    }
+    semantic_analyzer *analyzer = (semantic_analyzer *)malloc(sizeof(semantic_analyzer));
+    if (analyzer == NULL)
+        return NULL;
+    analyzer->table.symbols = NULL;
+    analyzer->table.count = 0;
+    analyzer->table.capacity = 0;
+    analyzer->table.slots = NULL;
+    analyzer->table.slot_count = 0;
+    analyzer->table.next_address = 0;
+    analyzer->error_count = 0;
+    analyzer->original_tree = syntax_tree;
+    analyzer->adjusted_tree = NULL;
+    memset(&analyzer->optimizations, 0, sizeof(analyzer->optimizations));
+    analyzer->loops = NULL;
+    analyzer->loop_count = 0;
+    analyzer->loop_capacity = 0;
+    analyzer->arena = arena;
+    memset(&analyzer->original_flat, 0, sizeof(analyzer->original_flat));
+    memset(&analyzer->adjusted_flat, 0, sizeof(analyzer->adjusted_flat));
+    return analyzer;
 }
 
-semantic_analyzer *create_semantic_analyzer(tree_node *syntax_tree)
+void reset_semantic_analyzer(semantic_analyzer *analyzer, tree_node *syntax_tree, arena *arena)
 {
-    semantic_analyzer *analyzer = (semantic_analyzer *)malloc(sizeof(semantic_analyzer));
+    // Os vetores da tabela são mantidos: a próxima análise reaproveita a capacidade já alocada
+    if (analyzer->table.slots != NULL)
+        memset(analyzer->table.slots, 0, (size_t)analyzer->table.slot_count * sizeof(int));
     analyzer->table.count = 0;
     analyzer->table.next_address = 0;
     analyzer->error_count = 0;
     analyzer->original_tree = syntax_tree;
     analyzer->adjusted_tree = NULL;
-    return analyzer;
+    memset(&analyzer->optimizations, 0, sizeof(analyzer->optimizations));
+    analyzer->loop_count = 0;
+    analyzer->arena = arena;
+    analyzer->original_flat.source = NULL;
+    analyzer->adjusted_flat.source = NULL;
 }
 
-data_type get_expression_type(semantic_analyzer *analyzer, tree_node *node)
+void destroy_semantic_analyzer(semantic_analyzer *analyzer)
 {
-    if (node == NULL)
+    if (analyzer == NULL)
+        return;
+
+    // Os nomes dos símbolos e os nós criados pela análise pertencem à arena da compilação
+    free(analyzer->table.symbols);
+    free(analyzer->table.slots);
+    free(analyzer->loops);
+    release_flat_tree(&analyzer->original_flat);
+    release_flat_tree(&analyzer->adjusted_flat);
+    free(analyzer);
+}
+
+/// @brief Converte o tipo dos nós da árvore para o tipo dos símbolos.
+static data_type node_data_type(exp_type type)
+{
+    return (type == INTEGER) ? DT_INTEGER : (type == REAL) ? DT_REAL : (type == BOOLEAN) ? DT_BOOLEAN : DT_VOID;
+}
+
+/// @brief Converte o tipo dos símbolos para o tipo dos nós da árvore.
+static exp_type data_node_type(data_type type)
+{
+    return (type == DT_INTEGER) ? INTEGER : (type == DT_REAL) ? REAL : (type == DT_BOOLEAN) ? BOOLEAN : VOID;
+}
+
+/// @brief Calcula o tipo de uma expressão de baixo para cima, visitando cada nó uma única vez: o tipo
+///        fica em node->type, marcado com NODE_TYPED, e as consultas seguintes o leem do nó. Assim, os
+///        ajustes de uma expressão custam tempo linear, e não proporcional ao tamanho vezes a altura.
+/// @param report 1 para informar as variáveis não declaradas e os operandos de tipo errado.
+static data_type annotate_type(semantic_analyzer *analyzer, tree_node *node, int report)
+{
+    if (node == NULL || node->node_kind != EXPRESSION_KIND)
         return DT_VOID;
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+        return (node->type == INTEGER) ? DT_INTEGER : DT_REAL; // O tipo da constante é do analisador sintático
+    if (node->processed & NODE_TYPED)
+        return node_data_type(node->type);
 
-    if (node->node_kind == EXPRESSION_KIND)
+    data_type type = DT_VOID;
+    switch (node->kind.exp)
     {
-        switch (node->kind.exp)
-        {
-        case IDENTIFIER_EXPRESSION:
+    case IDENTIFIER_EXPRESSION:
+    {
+        symbol *sym = find_symbol(analyzer, node->attribute.name);
+        if (sym != NULL)
+            type = sym->type;
+        else if (report)
+            report_error(analyzer, node->line_number, "Variavel '%s' nao declarada", node->attribute.name);
+        break;
+    }
+    case OPERATION_EXPRESSION:
+    {
+        data_type left_type = annotate_type(analyzer, node->child[0], report);
+        data_type right_type = annotate_type(analyzer, node->child[1], report);
+        token_type op = node->attribute.op;
+
+        // Para operadores booleanos
+        if (op == T_E || op == T_OU)
         {
-            symbol *sym = find_symbol(analyzer, node->attribute.name);
-            if (sym == NULL)
+            if (report && (left_type != DT_BOOLEAN || right_type != DT_BOOLEAN))
             {
-                report_error(analyzer, node->line_number, "Variavel '%s' nao declarada", node->attribute.name);
-                return DT_VOID;
+                report_error(analyzer, node->line_number,
+                             "Operador logico requer operandos booleanos");
             }
-            return sym->type;
+            type = DT_BOOLEAN;
         }
-        case CONSTANT_EXPRESSION:
-            return (node->type == INTEGER) ? DT_INTEGER : DT_REAL;
-        case OPERATION_EXPRESSION:
+        // Para operadores relacionais
+        else if (op == T_MENOR || op == T_MAIOR || op == T_IGUAL || op == T_DIFERENTE ||
+                 op == T_MENOR_IGUAL || op == T_MAIOR_IGUAL)
         {
-            data_type left_type = get_expression_type(analyzer, node->child[0]);
-            data_type right_type = get_expression_type(analyzer, node->child[1]);
-
-            // Para operadores booleanos
-            if (node->attribute.op == T_E || node->attribute.op == T_OU)
-            {
-                if (left_type != DT_BOOLEAN || right_type != DT_BOOLEAN)
-                {
-                    report_error(analyzer, node->line_number,
-                                 "Operador logico requer operandos booleanos");
-                }
-                return DT_BOOLEAN;
-            }
-
-            // Para operadores relacionais
-            if (node->attribute.op == T_MENOR || node->attribute.op == T_MAIOR ||
-                node->attribute.op == T_IGUAL || node->attribute.op == T_DIFERENTE ||
-                node->attribute.op == T_MENOR_IGUAL || node->attribute.op == T_MAIOR_IGUAL)
-            {
-
-                if ((left_type != DT_INTEGER && left_type != DT_REAL) ||
-                    (right_type != DT_INTEGER && right_type != DT_REAL))
-                {
-                    report_error(analyzer, node->line_number,
-                                 "Operador relacional requer operandos numericos");
-                }
-                return DT_BOOLEAN;
-            }
-
-            // Para operadores aritméticos
-            if (left_type == DT_REAL || right_type == DT_REAL)
+            if (report && ((left_type != DT_INTEGER && left_type != DT_REAL) ||
+                           (right_type != DT_INTEGER && right_type != DT_REAL)))
             {
-                return DT_REAL;
+                report_error(analyzer, node->line_number,
+                             "Operador relacional requer operandos numericos");
             }
-            return DT_INTEGER;
-        }
+            type = DT_BOOLEAN;
         }
+        // Para operadores aritméticos
+        else
+            type = (left_type == DT_REAL || right_type == DT_REAL) ? DT_REAL : DT_INTEGER;
+        break;
     }
-    return DT_VOID;
+    case CONVERSION_EXPRESSION:
+        type = DT_REAL;
+        break;
+    default:
+        break;
+    }
+
+    node->type = data_node_type(type);
+    node->processed |= NODE_TYPED;
+    return type;
+}
+
+data_type get_expression_type(semantic_analyzer *analyzer, tree_node *node)
+{
+    return annotate_type(analyzer, node, 1);
 }
 
 data_type get_expression_type_without_init_check(semantic_analyzer *analyzer, tree_node *node)
 {
-    if (node == NULL)
-        return DT_VOID;
+    return annotate_type(analyzer, node, 0);
+}
 
-    if (node->node_kind == EXPRESSION_KIND)
+/// @brief Calcula o hash FNV-1a de um nome.
+static unsigned int hash_name(const char *name)
+{
+    unsigned int hash = 2166136261u;
+    while (*name != '\0')
     {
-        switch (node->kind.exp)
-        {
-        case IDENTIFIER_EXPRESSION:
-        {
-            symbol *sym = find_symbol(analyzer, node->attribute.name);
-            if (sym == NULL)
-            {
-                return DT_VOID;
-            }
-            return sym->type;
-        }
-        case CONSTANT_EXPRESSION:
-            return (node->type == INTEGER) ? DT_INTEGER : DT_REAL;
-        case OPERATION_EXPRESSION:
-        {
-            data_type left_type = get_expression_type_without_init_check(analyzer, node->child[0]);
-            data_type right_type = get_expression_type_without_init_check(analyzer, node->child[1]);
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-            // Para operadores booleanos
-            if (node->attribute.op == T_E || node->attribute.op == T_OU)
-            {
-                return DT_BOOLEAN;
-            }
+/// @brief Procura a posição de um nome no índice de hash.
+/// @return A posição do slot que contém o nome, ou a do slot vazio onde ele seria inserido.
+static int find_slot(symbol_table *table, const char *name, unsigned int hash)
+{
+    int mask = table->slot_count - 1;
+    int slot = (int)(hash & (unsigned int)mask);
+    while (table->slots[slot] != 0)
+    {
+        symbol *sym = &table->symbols[table->slots[slot] - 1];
+        if (sym->hash == hash && strcmp(sym->name, name) == 0)
+            break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
 
-            // Para operadores relacionais
-            if (node->attribute.op == T_MENOR || node->attribute.op == T_MAIOR ||
-                node->attribute.op == T_IGUAL || node->attribute.op == T_DIFERENTE ||
-                node->attribute.op == T_MENOR_IGUAL || node->attribute.op == T_MAIOR_IGUAL)
-            {
-                return DT_BOOLEAN;
-            }
+/// @brief Dobra a capacidade da tabela, reconstruindo o índice de hash.
+/// @return 1 em caso de sucesso, 0 se não houver memória.
+static int grow_symbol_table(symbol_table *table)
+{
+    int capacity = (table->capacity == 0) ? SYMBOL_TABLE_INITIAL_CAPACITY : table->capacity * 2;
 
-            // Para operadores aritméticos
-            if (left_type == DT_REAL || right_type == DT_REAL)
-            {
-                return DT_REAL;
-            }
-            return DT_INTEGER;
-        }
-        case CONVERSION_EXPRESSION:
-            return DT_REAL;
-        }
+    // O índice é mantido com ocupação máxima de 50%
+    int *slots = (int *)calloc((size_t)capacity * 2, sizeof(int));
+    if (slots == NULL)
+        return 0;
+
+    symbol *symbols = (symbol *)realloc(table->symbols, (size_t)capacity * sizeof(symbol));
+    if (symbols == NULL)
+    {
+        free(slots);
+        return 0;
     }
-    return DT_VOID;
+    table->symbols = symbols;
+    table->capacity = capacity;
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = capacity * 2;
+
+    for (int i = 0; i < table->count; i++)
+    {
+        int slot = find_slot(table, table->symbols[i].name, table->symbols[i].hash);
+        table->slots[slot] = i + 1;
+    }
+    return 1;
 }
 
 void add_symbol(semantic_analyzer *analyzer, const char *name, data_type type, int line)
 {
-    if (find_symbol(analyzer, name) != NULL)
+    symbol_table *table = &analyzer->table;
+    unsigned int hash = hash_name(name);
+
+    if (table->slot_count > 0 && table->slots[find_slot(table, name, hash)] != 0)
     {
         report_error(analyzer, line, "Variavel '%s' ja declarada", name);
         return;
     }
 
-    if (analyzer->table.count >= MAX_SYMBOLS)
+    if (table->count == table->capacity && !grow_symbol_table(table))
     {
-        report_error(analyzer, line, "Tabela de simbolos cheia");
+        report_error(analyzer, line, "Memoria insuficiente para a tabela de simbolos");
         return;
     }
 
-    symbol *sym = &analyzer->table.symbols[analyzer->table.count++];
-    sym->name = strdup(name);
+    symbol *sym = &table->symbols[table->count++];
+    sym->name = arena_strdup(analyzer->arena, name);
+    sym->hash = hash;
     sym->type = type;
     sym->declared_line = line;
     sym->is_initialized = 0; // Inicialmente não inicializada
 
-    sym->memory_address = analyzer->table.next_address;
+    sym->memory_address = table->next_address;
     sym->size = (type == DT_INTEGER) ? 4 : 8;
-    analyzer->table.next_address += sym->size;
+    table->next_address += sym->size;
+
+    table->slots[find_slot(table, name, hash)] = table->count;
 }
 
 symbol *find_symbol(semantic_analyzer *analyzer, const char *name)
 {
-    for (int i = 0; i < analyzer->table.count; i++)
-    {
-        if (strcmp(analyzer->table.symbols[i].name, name) == 0)
-        {
-            return &analyzer->table.symbols[i];
-        }
-    }
-    return NULL;
+    symbol_table *table = &analyzer->table;
+    if (table->slot_count == 0)
+        return NULL;
+
+    int index = table->slots[find_slot(table, name, hash_name(name))];
+    return (index != 0) ? &table->symbols[index - 1] : NULL;
+}
+
+int symbol_index(semantic_analyzer *analyzer, const char *name)
+{
+    symbol *sym = find_symbol(analyzer, name);
+    return (sym != NULL) ? (int)(sym - analyzer->table.symbols) : -1;
 }
 
 void report_error(semantic_analyzer *analyzer, int line, const char *format, ...)
@@ -325,12 +289,12 @@ void report_error(semantic_analyzer *analyzer, int line, const char *format, ...
     va_end(args);
 }
 
-tree_node *create_conversion_node(tree_node *expr_node)
+tree_node *create_conversion_node(semantic_analyzer *analyzer, tree_node *expr_node)
 {
-    tree_node *convert_node = new_expression_node(CONVERSION_EXPRESSION);
+    tree_node *convert_node = new_expression_node(analyzer->arena, CONVERSION_EXPRESSION, expr_node->line_number);
     convert_node->child[0] = expr_node;
     convert_node->type = REAL;
-    convert_node->line_number = expr_node->line_number;
+    convert_node->processed = NODE_TYPED;
     return convert_node;
 }
 
@@ -357,7 +321,7 @@ tree_node *adjust_assignment(semantic_analyzer *analyzer, tree_node *node)
         if (sym->type == DT_REAL && expr_type == DT_INTEGER)
         {
             // Criar nó de conversão explícita
-            tree_node *convert_node = create_conversion_node(node->child[0]);
+            tree_node *convert_node = create_conversion_node(analyzer, node->child[0]);
             node->child[0] = convert_node;
         }
         else if (sym->type == DT_INTEGER && expr_type == DT_REAL)
@@ -389,9 +353,7 @@ tree_node *adjust_assignment(semantic_analyzer *analyzer, tree_node *node)
 
 tree_node *adjust_operation(semantic_analyzer *analyzer, tree_node *node)
 {
-    // Não chamar get_expression_type aqui - isso causa processamento duplicado
-    // A verificação de tipos já foi feita em adjust_expression
-
+    // Os tipos dos operandos já foram calculados para a expressão inteira e são lidos dos nós
     // Apenas ajustar conversões de tipo se necessário
     data_type left_type = get_expression_type_without_init_check(analyzer, node->child[0]);
     data_type right_type = get_expression_type_without_init_check(analyzer, node->child[1]);
@@ -401,9 +363,12 @@ tree_node *adjust_operation(semantic_analyzer *analyzer, tree_node *node)
         return node; // Já reportou erro
     }
 
-    // Para operadores aritméticos, ajustar tipos mistos
+    // Para operadores aritméticos e relacionais, ajustar tipos mistos
     if (node->attribute.op == T_SOMA || node->attribute.op == T_SUB ||
-        node->attribute.op == T_MULT || node->attribute.op == T_DIV)
+        node->attribute.op == T_MULT || node->attribute.op == T_DIV ||
+        node->attribute.op == T_MENOR || node->attribute.op == T_MENOR_IGUAL ||
+        node->attribute.op == T_MAIOR || node->attribute.op == T_MAIOR_IGUAL ||
+        node->attribute.op == T_IGUAL || node->attribute.op == T_DIFERENTE)
     {
 
         if (left_type != right_type)
@@ -411,13 +376,13 @@ tree_node *adjust_operation(semantic_analyzer *analyzer, tree_node *node)
             if (left_type == DT_INTEGER && right_type == DT_REAL)
             {
                 // Converter left para real
-                tree_node *convert_node = create_conversion_node(node->child[0]);
+                tree_node *convert_node = create_conversion_node(analyzer, node->child[0]);
                 node->child[0] = convert_node;
             }
             else if (left_type == DT_REAL && right_type == DT_INTEGER)
             {
                 // Converter right para real
-                tree_node *convert_node = create_conversion_node(node->child[1]);
+                tree_node *convert_node = create_conversion_node(analyzer, node->child[1]);
                 node->child[1] = convert_node;
             }
         }
@@ -432,7 +397,7 @@ tree_node *adjust_expression(semantic_analyzer *analyzer, tree_node *node)
         return NULL;
 
     // Se este nó já foi processado, retornar imediatamente
-    if (node->processed)
+    if (node->processed & NODE_ADJUSTED)
         return node;
 
     if (node->node_kind == EXPRESSION_KIND)
@@ -458,7 +423,7 @@ tree_node *adjust_expression(semantic_analyzer *analyzer, tree_node *node)
     }
 
     // Marcar como processado antes de processar os filhos
-    node->processed = 1;
+    node->processed |= NODE_ADJUSTED;
 
     for (int i = 0; i < MAXCHILDREN; i++)
     {
@@ -473,32 +438,24 @@ tree_node *adjust_expression(semantic_analyzer *analyzer, tree_node *node)
 
 void process_declarations(semantic_analyzer *analyzer, tree_node *node)
 {
-    while (node != NULL)
+    // A gramática põe todas as declarações no início do programa: os comandos não precisam ser percorridos
+    while (node != NULL && node->node_kind == STATEMENT_KIND && node->kind.stmt == DECLARATION_STATEMENT)
     {
-        if (node->node_kind == STATEMENT_KIND &&
-            node->kind.stmt == DECLARATION_STATEMENT)
+        // Converter exp_type para data_type
+        data_type type;
+        if (node->type == INTEGER)
         {
-            // Converter exp_type para data_type
-            data_type type;
-            if (node->type == INTEGER)
-            {
-                type = DT_INTEGER;
-            }
-            else if (node->type == REAL)
-            {
-                type = DT_REAL;
-            }
-            else
-            {
-                type = DT_VOID;
-            }
-            add_symbol(analyzer, node->attribute.name, type, node->line_number);
+            type = DT_INTEGER;
         }
-
-        for (int i = 0; i < MAXCHILDREN; i++)
+        else if (node->type == REAL)
+        {
+            type = DT_REAL;
+        }
+        else
         {
-            process_declarations(analyzer, node->child[i]);
+            type = DT_VOID;
         }
+        add_symbol(analyzer, node->attribute.name, type, node->line_number);
         node = node->sibling;
     }
 }
@@ -579,6 +536,10 @@ void analyze_semantics(semantic_analyzer *analyzer)
 
     // Depois ajustar a árvore com verificações semânticas - usando processamento sequencial
     analyzer->adjusted_tree = adjust_tree_sequential(analyzer, analyzer->original_tree);
+
+    // Por fim, otimizar a árvore de programas corretos
+    if (analyzer->error_count == 0)
+        optimize_tree(analyzer);
 }
 
 tree_node *adjust_tree_sequential(semantic_analyzer *analyzer, tree_node *node)
@@ -646,13 +607,17 @@ tree_node *adjust_tree_sequential(semantic_analyzer *analyzer, tree_node *node)
             }
         }
 
-        // Processar os filhos (expressões) do nó atual - APENAS UMA VEZ
+        // Processar os filhos do nó atual - APENAS UMA VEZ
+        // Os corpos de se, enquanto e repita são listas de comandos e seguem a mesma ordem sequencial
         for (int i = 0; i < MAXCHILDREN; i++)
         {
-            if (current->child[i] != NULL)
-            {
+            if (current->child[i] == NULL)
+                continue;
+
+            if (current->child[i]->node_kind == STATEMENT_KIND)
+                adjust_tree_sequential(analyzer, current->child[i]);
+            else
                 adjust_expression(analyzer, current->child[i]);
-            }
         }
 
         // Processar o próximo irmão
@@ -661,97 +626,97 @@ tree_node *adjust_tree_sequential(semantic_analyzer *analyzer, tree_node *node)
     return node;
 }
 
-void generate_report(semantic_analyzer *analyzer, const char *filename)
+/// @brief Converte o tipo de um símbolo para o tipo dos nós da árvore.
+static exp_type symbol_node_type(const symbol *sym)
 {
-    // Imprimir no console
-    printf("=== RELATORIO DE ANALISE SEMANTICA ===\n\n");
-
-    printf("1. ARVORE SINTATICA ORIGINAL:\n");
-    printf("----------------------------------------\n");
-    print_tree(analyzer->original_tree, 0);
-
-    printf("\n2. ARVORE APOS AJUSTES SEMANTICOS:\n");
-    printf("----------------------------------------\n");
-    print_tree(analyzer->adjusted_tree, 0);
-
-    printf("\n3. TABELA DE SIMBOLOS:\n");
-    printf("----------------------------------------\n");
-    printf("%-15s %-10s %-10s %-10s %-12s\n", "Nome", "Tipo", "Endereco", "Tamanho", "Inicializada");
-    printf("----------------------------------------\n");
-    for (int i = 0; i < analyzer->table.count; i++)
-    {
-        symbol *sym = &analyzer->table.symbols[i];
-        printf("%-15s %-10s %-10d %-10d %-12s\n",
-               sym->name,
-               (sym->type == DT_INTEGER) ? "inteiro" : "real",
-               sym->memory_address,
-               sym->size,
-               sym->is_initialized ? "sim" : "nao");
-    }
+    return data_node_type(sym->type);
+}
 
-    printf("\n4. ERROS SEMANTICOS:\n");
-    printf("----------------------------------------\n");
-    if (analyzer->error_count == 0)
+/// @brief Resolve os identificadores e os tipos de uma expressão.
+/// @return O tipo da expressão.
+static exp_type resolve_expression(semantic_analyzer *analyzer, tree_node *node)
+{
+    if (node == NULL)
+        return VOID;
+
+    switch (node->kind.exp)
     {
-        printf("Nenhum erro semantico encontrado.\n");
-    }
-    else
+    case IDENTIFIER_EXPRESSION:
     {
-        for (int i = 0; i < analyzer->error_count; i++)
+        symbol *sym = find_symbol(analyzer, node->attribute.name);
+        if (sym != NULL)
         {
-            printf("Linha %d: %s\n",
-                   analyzer->errors[i].line,
-                   analyzer->errors[i].message);
+            node->memory_address = sym->memory_address;
+            node->type = symbol_node_type(sym);
         }
+        break;
     }
-
-    // Também salvar em arquivo
-    FILE *report = fopen(filename, "w");
-    if (!report)
+    case CONSTANT_EXPRESSION:
+        break; // O tipo da constante é definido pelo analisador sintático
+    case CONVERSION_EXPRESSION:
+        resolve_expression(analyzer, node->child[0]);
+        node->type = REAL;
+        break;
+    case OPERATION_EXPRESSION:
     {
-        fprintf(stderr, "Erro ao criar arquivo de relatorio: %s\n", filename);
-        return;
+        exp_type left_type = resolve_expression(analyzer, node->child[0]);
+        exp_type right_type = resolve_expression(analyzer, node->child[1]);
+        switch (node->attribute.op)
+        {
+        case T_SOMA:
+        case T_SUB:
+        case T_MULT:
+        case T_DIV:
+            node->type = (left_type == REAL || right_type == REAL) ? REAL : INTEGER;
+            break;
+        default:
+            node->type = BOOLEAN;
+            break;
+        }
+        break;
     }
-
-    fprintf(report, "=== RELATORIO DE ANALISE SEMANTICA ===\n\n");
-
-    fprintf(report, "1. ARVORE SINTATICA ORIGINAL:\n");
-    fprintf(report, "----------------------------------------\n");
-    print_tree_to_file(report, analyzer->original_tree, 0);
-
-    fprintf(report, "\n2. ARVORE APOS AJUSTES SEMANTICOS:\n");
-    fprintf(report, "----------------------------------------\n");
-    print_tree_to_file(report, analyzer->adjusted_tree, 0);
-
-    fprintf(report, "\n3. TABELA DE SIMBOLOS:\n");
-    fprintf(report, "----------------------------------------\n");
-    fprintf(report, "%-15s %-10s %-10s %-10s\n", "Nome", "Tipo", "Endereco", "Tamanho");
-    fprintf(report, "----------------------------------------\n");
-    for (int i = 0; i < analyzer->table.count; i++)
-    {
-        symbol *sym = &analyzer->table.symbols[i];
-        fprintf(report, "%-15s %-10s %-10d %-10d\n",
-                sym->name,
-                (sym->type == DT_INTEGER) ? "inteiro" : "real",
-                sym->memory_address,
-                sym->size);
     }
+    return node->type;
+}
 
-    fprintf(report, "\n4. ERROS SEMANTICOS:\n");
-    fprintf(report, "----------------------------------------\n");
-    if (analyzer->error_count == 0)
-    {
-        fprintf(report, "Nenhum erro semantico encontrado.\n");
-    }
-    else
+/// @brief Resolve uma lista de comandos, incluindo os corpos de se, enquanto e repita.
+static void resolve_statements(semantic_analyzer *analyzer, tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
     {
-        for (int i = 0; i < analyzer->error_count; i++)
+        if (node->node_kind == STATEMENT_KIND &&
+            (node->kind.stmt == ASSIGNMENT_STATEMENT || node->kind.stmt == READ_STATEMENT ||
+             node->kind.stmt == DECLARATION_STATEMENT))
+        {
+            symbol *sym = find_symbol(analyzer, node->attribute.name);
+            if (sym != NULL)
+            {
+                node->memory_address = sym->memory_address;
+                node->type = symbol_node_type(sym);
+            }
+        }
+
+        for (int i = 0; i < MAXCHILDREN; i++)
         {
-            fprintf(report, "Linha %d: %s\n",
-                    analyzer->errors[i].line,
-                    analyzer->errors[i].message);
+            if (node->child[i] == NULL)
+                continue;
+            if (node->child[i]->node_kind == STATEMENT_KIND)
+                resolve_statements(analyzer, node->child[i]);
+            else
+                resolve_expression(analyzer, node->child[i]);
         }
     }
+}
 
-    fclose(report);
-}
\ No newline at end of file
+void resolve_tree(semantic_analyzer *analyzer)
+{
+    resolve_statements(analyzer, analyzer->adjusted_tree);
+}
+
+const flat_tree *get_flat_tree(semantic_analyzer *analyzer, const tree_node *tree)
+{
+    flat_tree *flat = (tree == analyzer->original_tree) ? &analyzer->original_flat : &analyzer->adjusted_flat;
+    if ((flat->source != tree || tree == NULL) && !flatten_tree(flat, tree))
+        return NULL;
+    return flat;
+}
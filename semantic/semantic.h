@@ -2,9 +2,10 @@
 #define SEMANTIC_H
 
 #include "../parser/parser.h"
+#include "../parser/flat_tree.h"
 
-#define MAX_SYMBOLS 1000
 #define MAX_ERRORS 100
+#define SYMBOL_TABLE_INITIAL_CAPACITY 64
 
 typedef enum data_type
 {
@@ -17,6 +18,7 @@ typedef enum data_type
 typedef struct symbol
 {
     char *name;
+    unsigned int hash; // Hash do nome, calculado uma única vez na declaração
     data_type type;
     int declared_line;
     int memory_address;
@@ -24,10 +26,17 @@ typedef struct symbol
     int is_initialized; // 0 = não inicializada, 1 = inicializada
 } symbol;
 
+/// @brief Tabela de símbolos com endereçamento aberto.
+/// @note Os símbolos ficam em ordem de declaração no vetor symbols. O vetor slots é o índice
+///       de hash (sondagem linear) e guarda a posição do símbolo em symbols mais um; 0 indica vazio.
+///       Ponteiros obtidos por find_symbol() deixam de ser válidos após uma nova declaração.
 typedef struct symbol_table
 {
-    symbol symbols[MAX_SYMBOLS];
+    symbol *symbols;
     int count;
+    int capacity;
+    int *slots;
+    int slot_count; // Sempre uma potência de 2
     int next_address;
 } symbol_table;
 
@@ -37,33 +46,94 @@ typedef struct semantic_error
     char message[256];
 } semantic_error;
 
+/// @brief O que as otimizações fizeram com a árvore ajustada e com o quadro de variáveis.
+typedef struct optimization_stats
+{
+    int folded_operations;      // Operações aritméticas com operandos constantes
+    int folded_conversions;     // Conversões de constantes inteiras
+    int folded_conditions;      // Comparações e operadores lógicos com resultado conhecido
+    int simplified_operations;  // Identidades algébricas aplicadas, como x * 1 e x - x
+    int pruned_branches;        // se, enquanto e repita com condição constante
+    int unreachable_statements; // Comandos depois de um laço que nunca termina
+    int dead_assignments;       // Atribuições a variáveis que nunca são lidas
+    int propagated_constants;   // Leituras de variáveis trocadas pela constante que elas sempre leem
+    int removed_variables;      // Variáveis que perderam o espaço no quadro
+    int strength_reductions;    // Multiplicações de uma variável de indução trocadas por uma temporária somada a cada volta
+    int hoisted_expressions;    // Expressões invariantes movidas para antes de um laço, cada uma numa temporária
+    int unrolled_loops;         // Laços com o corpo repetido, ou trocados pelas cópias do corpo
+    int common_subexpressions;  // Expressões repetidas calculadas uma vez, cada uma numa temporária
+    int reused_expressions;     // Repetições trocadas pela leitura da temporária
+    int shared_nodes;           // Nós de expressão trocados por um nó igual, compartilhado
+    int node_count_before;      // O tamanho da árvore ajustada antes do desenrolamento, em nós
+    int node_count;             // O tamanho da árvore ajustada depois do desenrolamento
+    int node_limit;             // O tamanho máximo que o desenrolamento pode atingir
+    int frame_size_before;      // O tamanho do quadro antes da remoção das variáveis, em bytes
+} optimization_stats;
+
+/// @brief O que a análise das variáveis de indução descobriu sobre um enquanto ou repita da árvore ajustada.
+typedef struct loop_info
+{
+    tree_node *loop;                // NULL se o laço foi trocado pelas cópias do corpo
+    statement_kind kind;            // WHILE_STATEMENT ou REPEAT_STATEMENT
+    int line;                       // A linha da condição
+    const char *induction_variable; // A variável de indução da condição (ou a primeira do laço), ou NULL
+    int step;                       // O quanto a variável de indução muda a cada volta
+    int trip_count;                 // Quantas vezes o corpo executa, ou -1 se desconhecido
+    int derived_variables;          // Variáveis atribuídas uma vez por volta a partir de uma variável de indução
+    int unroll_factor;              // Cópias do corpo por volta depois do desenrolamento; 1 se não foi desenrolado
+} loop_info;
+
 typedef struct semantic_analyzer
 {
     symbol_table table;
     semantic_error errors[MAX_ERRORS];
     int error_count;
     tree_node *original_tree;
-    tree_node *adjusted_tree;
+    tree_node *adjusted_tree; // Após os ajustes e as otimizações; só difere de original_tree se algo foi otimizado
+    optimization_stats optimizations;
+    loop_info *loops; // Os laços da árvore ajustada, em ordem de fora para dentro
+    int loop_count;
+    int loop_capacity;
+    arena *arena; // Arena da compilação, onde ficam os nós criados pela análise e os nomes dos símbolos
+    flat_tree original_flat; // A árvore original na forma compacta, montada pelo relatório
+    flat_tree adjusted_flat; // A árvore ajustada na forma compacta, montada pelo relatório
 } semantic_analyzer;
 
 // Funções principais
-semantic_analyzer *create_semantic_analyzer(tree_node *syntax_tree);
+semantic_analyzer *create_semantic_analyzer(tree_node *syntax_tree, arena *arena);
+void reset_semantic_analyzer(semantic_analyzer *analyzer, tree_node *syntax_tree, arena *arena);
+void destroy_semantic_analyzer(semantic_analyzer *analyzer);
 void analyze_semantics(semantic_analyzer *analyzer);
-void generate_report(semantic_analyzer *analyzer, const char *filename);
+
+/// @brief A árvore original ou a ajustada do analisador na forma compacta, convertida só uma vez, na
+///        primeira consulta depois da análise, quando os ajustes já acrescentaram as conversões.
+/// @return A árvore compacta, ou NULL se faltou memória.
+const flat_tree *get_flat_tree(semantic_analyzer *analyzer, const tree_node *tree);
 
 // Funções auxiliares
 data_type get_expression_type(semantic_analyzer *analyzer, tree_node *node);
 data_type get_expression_type_without_init_check(semantic_analyzer *analyzer, tree_node *node);
 void add_symbol(semantic_analyzer *analyzer, const char *name, data_type type, int line);
 symbol *find_symbol(semantic_analyzer *analyzer, const char *name);
+/// @brief A posição do símbolo na tabela, ou -1 se o nome não foi declarado.
+int symbol_index(semantic_analyzer *analyzer, const char *name);
 void report_error(semantic_analyzer *analyzer, int line, const char *format, ...);
 
 // Funções de ajuste da árvore
-tree_node *create_conversion_node(tree_node *expr_node);
+void process_declarations(semantic_analyzer *analyzer, tree_node *node);
+
+tree_node *create_conversion_node(semantic_analyzer *analyzer, tree_node *expr_node);
 tree_node *adjust_assignment(semantic_analyzer *analyzer, tree_node *node);
 tree_node *adjust_operation(semantic_analyzer *analyzer, tree_node *node);
 tree_node *adjust_expression(semantic_analyzer *analyzer, tree_node *node);
 tree_node *adjust_tree(semantic_analyzer *analyzer, tree_node *node);
 tree_node *adjust_tree_sequential(semantic_analyzer *analyzer, tree_node *node);
 
+/// @brief Prepara a árvore ajustada para execução: cada identificador, atribuição e leitura recebe
+///        o endereço da sua variável no quadro (memory_address) e cada expressão recebe o seu tipo.
+/// @note Depois desta chamada, quem executa o programa não precisa consultar a tabela de símbolos.
+///       Só deve ser chamada para programas sem erros semânticos.
+/// @param analyzer O analisador, após analyze_semantics().
+void resolve_tree(semantic_analyzer *analyzer);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <stdlib.h> // calloc(), malloc(), free(), qsort()
+#include <string.h> // memcpy()
+#include "latency.h"
+
+latency_recorder *create_latency_recorder(void)
+{
+    latency_recorder *recorder = (latency_recorder *)calloc(1, sizeof(latency_recorder));
+    if (recorder == NULL)
+        return NULL;
+    pthread_mutex_init(&recorder->lock, NULL);
+    return recorder;
+}
+
+void record_latency(latency_recorder *recorder, double microseconds)
+{
+    pthread_mutex_lock(&recorder->lock);
+    recorder->samples[recorder->count % LATENCY_WINDOW] = microseconds;
+    recorder->count++;
+    recorder->total += microseconds;
+    if (microseconds > recorder->max)
+        recorder->max = microseconds;
+    pthread_mutex_unlock(&recorder->lock);
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/// @brief O percentil p (0 a 100) de um vetor já ordenado, pelo método do posto mais próximo.
+static double percentile(const double *sorted, int count, double p)
+{
+    int rank = (int)((p / 100.0) * count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    return sorted[rank - 1];
+}
+
+latency_summary summarize_latencies(latency_recorder *recorder)
+{
+    latency_summary summary = {0, 0, 0, 0, 0, 0};
+
+    // A janela é copiada para que a ordenação não segure a trava enquanto outras threads registram
+    double *sorted = (double *)malloc(sizeof(recorder->samples));
+    if (sorted == NULL)
+        return summary;
+
+    pthread_mutex_lock(&recorder->lock);
+    int window = (recorder->count < LATENCY_WINDOW) ? (int)recorder->count : LATENCY_WINDOW;
+    memcpy(sorted, recorder->samples, (size_t)window * sizeof(double));
+    summary.count = recorder->count;
+    summary.mean = (recorder->count > 0) ? recorder->total / recorder->count : 0;
+    summary.max = recorder->max;
+    pthread_mutex_unlock(&recorder->lock);
+
+    if (window > 0)
+    {
+        qsort(sorted, (size_t)window, sizeof(double), compare_samples);
+        summary.p50 = percentile(sorted, window, 50);
+        summary.p90 = percentile(sorted, window, 90);
+        summary.p99 = percentile(sorted, window, 99);
+    }
+
+    free(sorted);
+    return summary;
+}
+
+void destroy_latency_recorder(latency_recorder *recorder)
+{
+    if (recorder == NULL)
+        return;
+    pthread_mutex_destroy(&recorder->lock);
+    free(recorder);
+}
@@ -0,0 +1,50 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <pthread.h>
+
+/// @brief Quantidade de medições mais recentes usadas no cálculo dos percentis.
+#define LATENCY_WINDOW 65536
+
+/// @brief Um registro de latências, seguro para uso por várias threads.
+/// @note As medições formam uma janela circular: os percentis refletem as últimas LATENCY_WINDOW requisições,
+///       enquanto a contagem, a média e o máximo valem para todas as medições desde a criação.
+typedef struct latency_recorder
+{
+    double samples[LATENCY_WINDOW]; // Em microssegundos.
+    long count;                     // Total de medições desde a criação.
+    double total;                   // Soma de todas as medições, em microssegundos.
+    double max;                     // A maior medição desde a criação, em microssegundos.
+    pthread_mutex_t lock;
+} latency_recorder;
+
+/// @brief Um resumo das latências registradas, em microssegundos.
+typedef struct latency_summary
+{
+    long count;  // Desde a criação.
+    double mean; // Desde a criação.
+    double p50;  // Os percentis são os da janela.
+    double p90;
+    double p99;
+    double max; // Desde a criação.
+} latency_summary;
+
+/// @brief Cria um registro vazio.
+/// @return O registro criado, ou NULL se não houver memória.
+latency_recorder *create_latency_recorder(void);
+
+/// @brief Registra uma medição.
+/// @param recorder O registro.
+/// @param microseconds A latência medida.
+void record_latency(latency_recorder *recorder, double microseconds);
+
+/// @brief Calcula a média, os percentis e o máximo das medições registradas.
+/// @param recorder O registro.
+/// @return O resumo; todos os campos valem 0 se não houver medições.
+latency_summary summarize_latencies(latency_recorder *recorder);
+
+/// @brief Libera o registro.
+/// @param recorder O registro.
+void destroy_latency_recorder(latency_recorder *recorder);
+
+#endif // LATENCY_H
@@ -0,0 +1,110 @@
+#include <errno.h>      // errno, EINTR
+#include <stdlib.h>     // realloc()
+#include <string.h>     // memcpy(), strlen()
+#include <unistd.h>     // read(), write(), close()
+#include <arpa/inet.h>  // htonl(), ntohl()
+#include <sys/socket.h> // socket(), connect()
+#include <sys/un.h>     // sockaddr_un
+#include "protocol.h"
+
+/// @brief Escreve todos os bytes, repetindo a escrita quando ela é parcial ou interrompida.
+static int write_all(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return 0;
+        data += written;
+        length -= (size_t)written;
+    }
+    return 1;
+}
+
+/// @brief Lê exatamente length bytes.
+static int read_all(int fd, char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t received = read(fd, data, length);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return 0;
+        data += received;
+        length -= (size_t)received;
+    }
+    return 1;
+}
+
+int send_message(int fd, char type, const char *data, uint32_t length)
+{
+    // O cabeçalho e um conteúdo pequeno vão em uma única escrita
+    char header[5 + 4096];
+    uint32_t network_length = htonl(length);
+    header[0] = type;
+    memcpy(header + 1, &network_length, sizeof(network_length));
+
+    if (length <= sizeof(header) - 5)
+    {
+        if (length > 0)
+            memcpy(header + 5, data, length);
+        return write_all(fd, header, 5 + length);
+    }
+    return write_all(fd, header, 5) && write_all(fd, data, length);
+}
+
+int receive_message(int fd, char *type, message_buffer *buffer)
+{
+    char header[5];
+    uint32_t network_length;
+    if (!read_all(fd, header, sizeof(header)))
+        return 0;
+
+    *type = header[0];
+    memcpy(&network_length, header + 1, sizeof(network_length));
+    uint32_t length = ntohl(network_length);
+    if (length > MAX_MESSAGE_LENGTH)
+        return 0;
+
+    if ((size_t)length + 1 > buffer->capacity)
+    {
+        size_t capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity;
+        while (capacity < (size_t)length + 1)
+            capacity *= 2;
+        char *data = (char *)realloc(buffer->data, capacity);
+        if (data == NULL)
+            return 0;
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    if (!read_all(fd, buffer->data, length))
+        return 0;
+    buffer->data[length] = '\0';
+    buffer->length = length;
+    return 1;
+}
+
+int connect_to_server(const char *path)
+{
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path, strlen(path) + 1);
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
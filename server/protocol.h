@@ -0,0 +1,55 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief O caminho padrão do socket do servidor de compilação.
+#define DEFAULT_SOCKET_PATH "/tmp/pminus-compiler.sock"
+
+/// @brief O maior conteúdo aceito em uma mensagem (64 MiB).
+#define MAX_MESSAGE_LENGTH (64u * 1024u * 1024u)
+
+/// @brief Os tipos de mensagem trocados entre o cliente e o servidor.
+/// @note Cada mensagem é um byte de tipo, o tamanho do conteúdo em 4 bytes (ordem de rede) e o conteúdo.
+typedef enum message_type
+{
+    REQUEST_COMPILE = 'C',     // Conteúdo: o programa. Resposta: os erros seguidos do relatório.
+    REQUEST_DIAGNOSTICS = 'D', // Conteúdo: o programa. Resposta: apenas os erros.
+    REQUEST_STATS = 'S',       // Sem conteúdo. Resposta: as estatísticas de latência do servidor.
+    REQUEST_SHUTDOWN = 'Q',    // Sem conteúdo. O servidor responde e encerra.
+    RESPONSE_OK = 'R',         // O programa foi compilado sem erros.
+    RESPONSE_ERRORS = 'E',     // O programa foi compilado com erros.
+    RESPONSE_FAILURE = 'X'     // A requisição não pôde ser atendida; o conteúdo explica o motivo.
+} message_type;
+
+/// @brief O buffer onde as mensagens recebidas são guardadas, reaproveitado entre mensagens.
+typedef struct message_buffer
+{
+    char *data;
+    uint32_t length;
+    size_t capacity;
+} message_buffer;
+
+/// @brief Envia uma mensagem completa.
+/// @param fd O socket.
+/// @param type O tipo da mensagem.
+/// @param data O conteúdo.
+/// @param length O tamanho do conteúdo.
+/// @return 1 em caso de sucesso, 0 se a conexão foi perdida.
+int send_message(int fd, char type, const char *data, uint32_t length);
+
+/// @brief Recebe uma mensagem completa.
+/// @note O conteúdo recebido é terminado em '\0', que não entra em buffer->length.
+/// @param fd O socket.
+/// @param type Recebe o tipo da mensagem.
+/// @param buffer O buffer que recebe o conteúdo, ampliado se necessário.
+/// @return 1 em caso de sucesso, 0 se a conexão foi fechada ou a mensagem é inválida.
+int receive_message(int fd, char *type, message_buffer *buffer);
+
+/// @brief Conecta-se ao servidor.
+/// @param path O caminho do socket.
+/// @return O socket conectado, ou -1 em caso de erro.
+int connect_to_server(const char *path);
+
+#endif // PROTOCOL_H
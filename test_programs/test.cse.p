@@ -0,0 +1,25 @@
+/*
+  Eliminacao de subexpressoes comuns (optimizer/cse.c) com temporarias
+  aninhadas: a * b + c repete dentro de (a * b + c) * d, que tambem repete,
+  e a temporaria de dentro precisa ser calculada antes da de fora.
+  Entrada: quatro inteiros a, b, c e d. Com 2, 3, 4 e 5, deve exibir
+  50, 10, 50 e 6.
+*/
+{
+    inteiro a, b, c, d, y, z, w, v;
+
+    ler(a);
+    ler(b);
+    ler(c);
+    ler(d);
+
+    y = (a * b + c) * d;
+    z = a * b + c;
+    w = (a * b + c) * d;
+    v = a * b;
+
+    mostrar(y);
+    mostrar(z);
+    mostrar(w);
+    mostrar(v);
+}
@@ -0,0 +1,47 @@
+/*
+  Eliminacao de codigo morto (optimizer/dce.c).
+  Entrada: um inteiro n, nao negativo. Com n = 4, deve exibir 1, 2 e 4.
+  Com n = 0, deve exibir 1 e 2 e terminar com o erro de divisao por zero
+  da linha 36: a atribuicao nunca lida e mantida porque pode falhar.
+*/
+{
+    inteiro a, b, i, n, morta, quociente;
+
+    ler(n);
+    a = 1;
+
+    /* Condicao constante: fica so o ramo tomado */
+    se (a == 1) entao
+        mostrar(1);
+    senao
+        mostrar(2);
+
+    /* Um enquanto com condicao falsa desaparece */
+    enquanto (a > 5) {
+        mostrar(99);
+        a = a - 1;
+    }
+
+    /* Um repita com condicao verdadeira vira o seu corpo */
+    repita {
+        b = 2;
+        mostrar(b);
+    } ate (a == 1);
+
+    /* Atribuicoes a uma variavel que nunca e lida sao removidas */
+    morta = n * 3;
+    morta = morta + 1;
+
+    /* Mas nao as que podem dividir por zero */
+    quociente = 10 / n;
+
+    /* Os comandos depois de um laco que nunca termina sao removidos */
+    se (n < 0) entao {
+        i = 0;
+        enquanto (1 < 2)
+            i = i + 1;
+        mostrar(i);
+    }
+
+    mostrar(n);
+}
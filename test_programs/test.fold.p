@@ -0,0 +1,41 @@
+/*
+  Avaliacao das expressoes constantes (optimizer/fold.c).
+  Entrada: um inteiro n. Com n = 5, deve exibir 10, 1.5, -2147483648, -7,
+  -2147483648, 1 e 5. Com n negativo, deve exibir 10, 1.5, -2147483648, -7,
+  -2147483648 e 0 e terminar com o erro de divisao por zero da linha 38.
+*/
+{
+    inteiro a, b, c, d, n;
+    real x;
+
+    ler(n);
+
+    a = 2 * 3 + 4;
+    mostrar(a);
+
+    /* Conversao de uma constante inteira para real */
+    x = 1 + 0.5;
+    mostrar(x);
+
+    /* A mesma aritmetica de 32 bits da execucao */
+    b = 2147483647 + 1;
+    mostrar(b);
+
+    /* Dividir por -1 nega, inclusive o menor inteiro */
+    c = 7 / (0 - 1);
+    mostrar(c);
+    d = (0 - 2147483647 - 1) / (0 - 1);
+    mostrar(d);
+
+    /* A condicao vira (n > 3) */
+    se (1 < 2 && n > 3) entao
+        mostrar(1);
+    senao
+        mostrar(0);
+
+    /* A divisao por uma constante zero fica no lugar e so falha se for executada */
+    se (n < 0) entao
+        mostrar(7 / 0);
+
+    mostrar(n);
+}
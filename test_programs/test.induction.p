@@ -0,0 +1,46 @@
+/*
+  Variaveis de inducao (optimizer/induction.c).
+  Entrada: um inteiro n. Com n = 6, deve exibir 325, 385, 6 e 2115098217.
+*/
+{
+    inteiro i, j, k, n, soma;
+
+    ler(n);
+
+    /* j e derivada de i; o laco tem 10 voltas */
+    i = 0;
+    soma = 0;
+    enquanto (i < 10) {
+        j = i * 4 + 1;
+        soma = soma + j + i * 3;
+        i = i + 1;
+    }
+    mostrar(soma);
+
+    /* Passo negativo */
+    i = 20;
+    soma = 0;
+    enquanto (i > 0) {
+        soma = soma + i * 5;
+        i = i - 3;
+    }
+    mostrar(soma);
+
+    /* Voltas desconhecidas */
+    i = 0;
+    k = 0;
+    repita {
+        k = k + 1;
+        i = i + 1;
+    } ate (i >= n);
+    mostrar(k);
+
+    /* A multiplicacao transborda; a soma que a substitui transborda igual */
+    i = 0;
+    soma = 0;
+    enquanto (i < n) {
+        soma = soma + i * 1000000007;
+        i = i + 1;
+    }
+    mostrar(soma);
+}
@@ -0,0 +1,43 @@
+/*
+  Movimento das expressoes invariantes para fora dos lacos (optimizer/licm.c).
+  Entrada: os inteiros n, d, base e limite.
+  Com 3 5 7 2, deve exibir 102, 4, 4, 4, 20, 12 e 12.
+  Com 0 0 7 2, deve exibir 0 e 7 e terminar com o erro de divisao por zero
+  da linha 30: o enquanto nao executa e a divisao nao pode ser calculada antes
+  dele, e o repita mostra base + 1 antes de chegar a divisao.
+*/
+{
+    inteiro i, n, d, base, limite, soma, quociente;
+
+    ler(n);
+    ler(d);
+    ler(base);
+    ler(limite);
+
+    /* base * 2 sai do laco; 100 / d pode falhar e fica */
+    i = 0;
+    soma = 0;
+    enquanto (i < n) {
+        soma = soma + base * 2 + 100 / d;
+        i = i + 1;
+    }
+    mostrar(soma);
+
+    /* O corpo do repita executa outros comandos antes da divisao */
+    i = 0;
+    repita {
+        mostrar(base - n);
+        quociente = 100 / d;
+        i = i + 1;
+    } ate (i >= n);
+    mostrar(quociente);
+
+    /* Uma condicao invariante */
+    i = 0;
+    enquanto (i < limite * 2 + base) {
+        i = i + 3;
+    }
+    mostrar(i);
+
+    mostrar(n * 4);
+}
@@ -0,0 +1,35 @@
+/*
+  Propagacao de constantes pela representacao intermediaria (ir/sccp.c) e
+  numeracao global de valores (ir/gvn.c).
+  Entrada: um inteiro c. Com c = 3, deve exibir 4, 1, 3, 10 e 10.
+  Com c = 0, deve exibir 4, 1, 0, 1 e 1.
+*/
+{
+    inteiro a, b, c, i, n;
+
+    ler(c);
+
+    /* b vale 4 pelos dois caminhos */
+    se (c > 2) entao
+        b = 4;
+    senao
+        b = 2 * 2;
+    mostrar(b);
+
+    /* a nunca muda no laco: o se interno nunca e tomado */
+    a = 1;
+    i = 0;
+    n = 0;
+    enquanto (i < c) {
+        se (a != 1) entao
+            a = a + 100;
+        n = n + a;
+        i = i + 1;
+    }
+    mostrar(a);
+    mostrar(n);
+
+    /* A mesma operacao escrita de duas formas */
+    mostrar(c * 3 + 1);
+    mostrar(3 * c + 1);
+}
@@ -0,0 +1,44 @@
+/*
+  Identidades algebricas (optimizer/simplify.c) e reducao de forca das
+  multiplicacoes e divisoes no JIT e na compilacao nativa (optimizer/strength.c).
+  Entrada: um inteiro n. Com n = -7, deve exibir -7, 0, -7, -14, 7, -0, 0, 0,
+  -56, -1, 1, -1, 1, -2 e 2. Com n = 2147483647, deve exibir 2147483647, 0,
+  2147483647, -2, -2147483647, -0, 0, 0, -8, 536870911, -536870911,
+  306783378, -306783378, 715827882 e -715827882.
+*/
+{
+    inteiro a, b, n;
+    real z, infinito;
+
+    ler(n);
+
+    /* Entre inteiros: n * 1 + 0 e n, n - n e 0 */
+    a = n * 1 + 0;
+    b = n - n;
+    mostrar(a);
+    mostrar(b);
+    mostrar(0 - (0 - n));
+    mostrar(a - (0 - n));
+    mostrar(n * (0 - 1));
+
+    /* Entre reais: -0.0 + 0.0 e 0.0, e nao -0.0 */
+    z = (0.0 - 1.0) * 0.0;
+    mostrar(z);
+    mostrar(z + 0.0);
+
+    /* Entre reais: infinito - infinito nao e 0 */
+    infinito = 1.0 / 0.0;
+    se (infinito - infinito == 0.0) entao
+        mostrar(1);
+    senao
+        mostrar(0);
+
+    /* Multiplicacao por potencia de 2 e divisoes por constantes */
+    mostrar(n * 8);
+    mostrar(n / 4);
+    mostrar(n / (0 - 4));
+    mostrar(n / 7);
+    mostrar(n / (0 - 7));
+    mostrar(n / 3);
+    mostrar(n / (0 - 3));
+}
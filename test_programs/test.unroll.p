@@ -0,0 +1,57 @@
+/*
+  Desenrolamento dos lacos (optimizer/unroll.c).
+  Entrada: os inteiros n e m. Com 10 5, deve exibir 3, 328350, 45, 20 e 1.
+  Com -2147483647 -2147483647, deve exibir 3, 328350, 0, 2 e 1: m - 7
+  transbordaria, e o laco desenrolado nao e executado.
+*/
+{
+    inteiro i, m, n, soma;
+
+    ler(n);
+    ler(m);
+
+    /* Poucas voltas: o laco vira as copias do corpo */
+    i = 0;
+    soma = 0;
+    enquanto (i < 3) {
+        soma = soma + i;
+        i = i + 1;
+    }
+    mostrar(soma);
+
+    /* 100 voltas: as que sobram da divisao pelo fator vao antes do laco */
+    i = 0;
+    soma = 0;
+    enquanto (i < 100) {
+        soma = soma + i * i;
+        i = i + 1;
+    }
+    mostrar(soma);
+
+    /* Voltas desconhecidas */
+    i = 0;
+    soma = 0;
+    enquanto (i < n) {
+        soma = soma + i;
+        i = i + 1;
+    }
+    mostrar(soma);
+
+    /* O repita executa o primeiro corpo antes e vira um enquanto */
+    i = 0;
+    soma = 0;
+    repita {
+        soma = soma + 2;
+        i = i + 1;
+    } ate (i >= n);
+    mostrar(soma);
+
+    /* Com m perto do menor inteiro, m - 7 transbordaria */
+    i = m - 1;
+    soma = 0;
+    enquanto (i < m) {
+        soma = soma + 1;
+        i = i + 1;
+    }
+    mostrar(soma);
+}
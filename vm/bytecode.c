@@ -0,0 +1,493 @@
+#include <stdlib.h> // malloc(), calloc(), realloc(), free()
+#include <string.h> // memcmp()
+#include "bytecode.h"
+
+/// @brief A descrição de uma instrução, usada na geração de código e na listagem.
+typedef struct opcode_info
+{
+    const char *name;
+    int operands;
+    int stack_effect;
+} opcode_info;
+
+#define OPCODE_INFO(name, operands, effect) {#name, operands, effect},
+static const opcode_info opcodes[OPCODE_COUNT] = {OPCODE_LIST(OPCODE_INFO)};
+#undef OPCODE_INFO
+
+/// @brief Um destino de salto.
+/// @note Enquanto a posição não é conhecida, os operandos dos saltos para o rótulo formam uma lista
+///       encadeada dentro do próprio código: cada um guarda a posição do anterior (-1 encerra a lista).
+typedef struct label
+{
+    int position; // -1 até bind_label()
+    int pending;  // O último operando que espera a posição
+} label;
+
+/// @brief O estado da tradução de uma árvore para bytecode.
+typedef struct code_generator
+{
+    bytecode *program;
+    int depth; // A profundidade da pilha após a última instrução emitida.
+    int use_superinstructions;
+    int failed; // 1 se faltou memória.
+} code_generator;
+
+static void emit_word(code_generator *generator, int32_t word)
+{
+    bytecode *program = generator->program;
+    if (program->length == program->capacity)
+    {
+        int capacity = (program->capacity == 0) ? 256 : program->capacity * 2;
+        int32_t *code = (int32_t *)realloc(program->code, (size_t)capacity * sizeof(int32_t));
+        if (code == NULL)
+        {
+            generator->failed = 1;
+            return;
+        }
+        program->code = code;
+        program->capacity = capacity;
+    }
+    program->code[program->length++] = word;
+}
+
+static void emit(code_generator *generator, opcode op)
+{
+    emit_word(generator, op);
+    generator->depth += opcodes[op].stack_effect;
+    if (generator->depth > generator->program->max_stack)
+        generator->program->max_stack = generator->depth;
+}
+
+static void emit_target(code_generator *generator, label *target)
+{
+    if (target->position >= 0)
+    {
+        emit_word(generator, target->position);
+        return;
+    }
+    int slot = generator->program->length;
+    emit_word(generator, target->pending);
+    target->pending = slot;
+}
+
+static void bind_label(code_generator *generator, label *target)
+{
+    int32_t *code = generator->program->code;
+    target->position = generator->program->length;
+    while (target->pending >= 0 && !generator->failed)
+    {
+        int next = code[target->pending];
+        code[target->pending] = target->position;
+        target->pending = next;
+    }
+}
+
+static int add_constant(code_generator *generator, double value)
+{
+    bytecode *program = generator->program;
+    for (int i = 0; i < program->constant_count; i++)
+    {
+        // Compara os bits: -0.0 == 0.0, mas as duas constantes se escrevem de forma diferente
+        if (memcmp(&program->constants[i], &value, sizeof(double)) == 0)
+            return i;
+    }
+
+    if (program->constant_count == program->constant_capacity)
+    {
+        int capacity = (program->constant_capacity == 0) ? 16 : program->constant_capacity * 2;
+        double *constants = (double *)realloc(program->constants, (size_t)capacity * sizeof(double));
+        if (constants == NULL)
+        {
+            generator->failed = 1;
+            return 0;
+        }
+        program->constants = constants;
+        program->constant_capacity = capacity;
+    }
+    program->constants[program->constant_count] = value;
+    return program->constant_count++;
+}
+
+static int is_integer_variable(const tree_node *node)
+{
+    return node->kind.exp == IDENTIFIER_EXPRESSION && node->type == INTEGER;
+}
+
+static int is_integer_constant(const tree_node *node)
+{
+    return node->kind.exp == CONSTANT_EXPRESSION && node->type == INTEGER;
+}
+
+static int is_comparison(token_type op)
+{
+    return op == T_MENOR || op == T_MENOR_IGUAL || op == T_MAIOR ||
+           op == T_MAIOR_IGUAL || op == T_IGUAL || op == T_DIFERENTE;
+}
+
+/// @brief A posição de uma comparação na ordem LT, LE, GT, GE, EQ, NE das instruções.
+static int comparison_index(token_type op)
+{
+    switch (op)
+    {
+    case T_MENOR:
+        return 0;
+    case T_MENOR_IGUAL:
+        return 1;
+    case T_MAIOR:
+        return 2;
+    case T_MAIOR_IGUAL:
+        return 3;
+    case T_IGUAL:
+        return 4;
+    default:
+        return 5;
+    }
+}
+
+/// @brief A comparação oposta (a < b é falsa exatamente quando a >= b), válida para inteiros.
+static int negate_comparison(int index)
+{
+    static const int negated[] = {3, 2, 1, 0, 5, 4};
+    return negated[index];
+}
+
+/// @brief A comparação com os operandos trocados (k < x equivale a x > k).
+static int mirror_comparison(int index)
+{
+    static const int mirrored[] = {2, 3, 0, 1, 4, 5};
+    return mirrored[index];
+}
+
+static void compile_expression(code_generator *generator, const tree_node *node);
+static void compile_branch(code_generator *generator, const tree_node *node, int jump_when, label *target);
+
+/// @brief Compila uma expressão e, se ela for inteira e o contexto pedir um real, a converte.
+static void compile_operand(code_generator *generator, const tree_node *node, int as_real)
+{
+    compile_expression(generator, node);
+    if (as_real && node->type == INTEGER)
+        emit(generator, OP_INT_TO_REAL);
+}
+
+static void compile_expression(code_generator *generator, const tree_node *node)
+{
+    switch (node->kind.exp)
+    {
+    case CONSTANT_EXPRESSION:
+        if (node->type == REAL)
+        {
+            emit(generator, OP_PUSH_REAL);
+            emit_word(generator, add_constant(generator, node->attribute.real_value));
+        }
+        else
+        {
+            emit(generator, OP_PUSH_INT);
+            emit_word(generator, node->attribute.int_value);
+        }
+        return;
+    case IDENTIFIER_EXPRESSION:
+        emit(generator, node->type == REAL ? OP_LOAD_REAL : OP_LOAD_INT);
+        emit_word(generator, node->memory_address);
+        return;
+    case CONVERSION_EXPRESSION:
+        compile_expression(generator, node->child[0]);
+        emit(generator, OP_INT_TO_REAL);
+        return;
+    case OPERATION_EXPRESSION:
+        break;
+    }
+
+    const tree_node *left = node->child[0];
+    const tree_node *right = node->child[1];
+    token_type op = node->attribute.op;
+
+    if (node->type == BOOLEAN)
+    {
+        // Um valor lógico fora de uma condição: 1 se verdadeiro, 0 se falso
+        label is_false = {-1, -1}, end = {-1, -1};
+        compile_branch(generator, node, 0, &is_false);
+        emit(generator, OP_PUSH_INT);
+        emit_word(generator, 1);
+        emit(generator, OP_JUMP);
+        emit_target(generator, &end);
+        generator->depth--; // O caminho falso chega aqui sem o valor empilhado acima
+        bind_label(generator, &is_false);
+        emit(generator, OP_PUSH_INT);
+        emit_word(generator, 0);
+        bind_label(generator, &end);
+        return;
+    }
+
+    if (node->type == INTEGER && generator->use_superinstructions)
+    {
+        // x + k e k + x
+        const tree_node *variable = is_integer_variable(left) ? left : right;
+        const tree_node *constant = (variable == left) ? right : left;
+        if (op == T_SOMA && is_integer_variable(variable) && is_integer_constant(constant))
+        {
+            emit(generator, OP_ADD_INT_VK);
+            emit_word(generator, variable->memory_address);
+            emit_word(generator, constant->attribute.int_value);
+            return;
+        }
+        if (is_integer_variable(left) && is_integer_variable(right))
+        {
+            emit(generator, OP_LOAD_LOAD_INT);
+            emit_word(generator, left->memory_address);
+            emit_word(generator, right->memory_address);
+            left = right = NULL;
+        }
+    }
+
+    int as_real = (node->type == REAL);
+    if (left != NULL)
+    {
+        compile_operand(generator, left, as_real);
+        compile_operand(generator, right, as_real);
+    }
+
+    switch (op)
+    {
+    case T_SOMA:
+        emit(generator, as_real ? OP_ADD_REAL : OP_ADD_INT);
+        break;
+    case T_SUB:
+        emit(generator, as_real ? OP_SUB_REAL : OP_SUB_INT);
+        break;
+    case T_MULT:
+        emit(generator, as_real ? OP_MUL_REAL : OP_MUL_INT);
+        break;
+    case T_DIV:
+        if (as_real)
+            emit(generator, OP_DIV_REAL);
+        else
+        {
+            emit(generator, OP_DIV_INT);
+            emit_word(generator, node->line_number);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/// @brief Compila uma condição como um salto para target quando o seu valor for jump_when.
+/// @note e/ou são compilados em curto-circuito, sem nunca empilhar um valor lógico.
+static void compile_branch(code_generator *generator, const tree_node *node, int jump_when, label *target)
+{
+    // Condição avaliada pelo compilador: o salto é incondicional ou desaparece
+    if (node->kind.exp == CONSTANT_EXPRESSION)
+    {
+        if ((node->attribute.int_value != 0) == jump_when)
+        {
+            emit(generator, OP_JUMP);
+            emit_target(generator, target);
+        }
+        return;
+    }
+
+    if (node->kind.exp == OPERATION_EXPRESSION && (node->attribute.op == T_E || node->attribute.op == T_OU))
+    {
+        // e salta quando ambos são verdadeiros ou quando um é falso; ou é o caso simétrico
+        int shortcut = (node->attribute.op == T_OU);
+        if (jump_when == shortcut)
+        {
+            compile_branch(generator, node->child[0], jump_when, target);
+            compile_branch(generator, node->child[1], jump_when, target);
+        }
+        else
+        {
+            label skip = {-1, -1};
+            compile_branch(generator, node->child[0], shortcut, &skip);
+            compile_branch(generator, node->child[1], jump_when, target);
+            bind_label(generator, &skip);
+        }
+        return;
+    }
+
+    if (node->kind.exp == OPERATION_EXPRESSION && is_comparison(node->attribute.op))
+    {
+        const tree_node *left = node->child[0];
+        const tree_node *right = node->child[1];
+        int integer = (left->type == INTEGER && right->type == INTEGER);
+
+        if (integer && generator->use_superinstructions)
+        {
+            // JUMP_UNLESS_<cmp> salta quando a comparação é falsa; para saltar quando ela é
+            // verdadeira, usa-se a comparação oposta
+            int index = comparison_index(node->attribute.op);
+            if (jump_when)
+                index = negate_comparison(index);
+
+            if (is_integer_constant(left) && is_integer_variable(right))
+            {
+                const tree_node *swap = left;
+                left = right;
+                right = swap;
+                index = mirror_comparison(index);
+            }
+
+            if (is_integer_variable(left) && (is_integer_variable(right) || is_integer_constant(right)))
+            {
+                int variable_pair = is_integer_variable(right);
+                emit(generator, (opcode)((variable_pair ? OP_JUMP_UNLESS_LT_INT_VV : OP_JUMP_UNLESS_LT_INT_VK) + index));
+                emit_word(generator, left->memory_address);
+                emit_word(generator, variable_pair ? right->memory_address : right->attribute.int_value);
+                emit_target(generator, target);
+                return;
+            }
+
+            compile_expression(generator, left);
+            compile_expression(generator, right);
+            emit(generator, (opcode)(OP_JUMP_UNLESS_LT_INT + index));
+            emit_target(generator, target);
+            return;
+        }
+
+        int as_real = !integer;
+        compile_operand(generator, left, as_real);
+        compile_operand(generator, right, as_real);
+        emit(generator, (opcode)((as_real ? OP_LT_REAL : OP_LT_INT) + comparison_index(node->attribute.op)));
+    }
+    else
+    {
+        compile_expression(generator, node);
+    }
+
+    emit(generator, jump_when ? OP_JUMP_IF_TRUE : OP_JUMP_IF_FALSE);
+    emit_target(generator, target);
+}
+
+/// @brief Reconhece x = x + k e x = x - k, compilados como uma única instrução INC_INT.
+static int compile_increment(code_generator *generator, const tree_node *node)
+{
+    const tree_node *value = node->child[0];
+    if (!generator->use_superinstructions || node->type != INTEGER ||
+        value->kind.exp != OPERATION_EXPRESSION || (value->attribute.op != T_SOMA && value->attribute.op != T_SUB))
+        return 0;
+
+    const tree_node *left = value->child[0];
+    const tree_node *right = value->child[1];
+    if (value->attribute.op == T_SOMA && is_integer_constant(left))
+    {
+        left = value->child[1];
+        right = value->child[0];
+    }
+    if (!is_integer_variable(left) || left->memory_address != node->memory_address || !is_integer_constant(right))
+        return 0;
+
+    unsigned int step = (unsigned int)right->attribute.int_value;
+    emit(generator, OP_INC_INT);
+    emit_word(generator, node->memory_address);
+    emit_word(generator, (int32_t)(value->attribute.op == T_SOMA ? step : 0u - step));
+    return 1;
+}
+
+static void compile_statements(code_generator *generator, const tree_node *node)
+{
+    for (; node != NULL; node = node->sibling)
+    {
+        if (node->node_kind != STATEMENT_KIND)
+            continue;
+
+        switch (node->kind.stmt)
+        {
+        case ASSIGNMENT_STATEMENT:
+            if (compile_increment(generator, node))
+                break;
+            compile_operand(generator, node->child[0], node->type == REAL);
+            emit(generator, node->type == REAL ? OP_STORE_REAL : OP_STORE_INT);
+            emit_word(generator, node->memory_address);
+            break;
+        case READ_STATEMENT:
+            emit(generator, node->type == REAL ? OP_READ_REAL : OP_READ_INT);
+            emit_word(generator, node->memory_address);
+            emit_word(generator, node->line_number);
+            break;
+        case WRITE_STATEMENT:
+            compile_expression(generator, node->child[0]);
+            emit(generator, node->child[0]->type == REAL ? OP_WRITE_REAL : OP_WRITE_INT);
+            break;
+        case IF_STATEMENT:
+        {
+            label otherwise = {-1, -1}, end = {-1, -1};
+            compile_branch(generator, node->child[0], 0, &otherwise);
+            compile_statements(generator, node->child[1]);
+            if (node->child[2] != NULL)
+            {
+                emit(generator, OP_JUMP);
+                emit_target(generator, &end);
+            }
+            bind_label(generator, &otherwise);
+            compile_statements(generator, node->child[2]);
+            bind_label(generator, &end);
+            break;
+        }
+        case WHILE_STATEMENT:
+        {
+            // A condição fica depois do corpo: cada volta do laço executa um único salto
+            label condition = {-1, -1}, body = {-1, -1};
+            emit(generator, OP_JUMP);
+            emit_target(generator, &condition);
+            bind_label(generator, &body);
+            compile_statements(generator, node->child[1]);
+            bind_label(generator, &condition);
+            compile_branch(generator, node->child[0], 1, &body);
+            break;
+        }
+        case REPEAT_STATEMENT:
+        {
+            label body = {-1, -1};
+            bind_label(generator, &body);
+            compile_statements(generator, node->child[0]);
+            compile_branch(generator, node->child[1], 0, &body);
+            break;
+        }
+        case DECLARATION_STATEMENT:
+            break;
+        }
+    }
+}
+
+bytecode *compile_bytecode(tree_node *tree, int frame_size, int use_superinstructions)
+{
+    bytecode *program = (bytecode *)calloc(1, sizeof(bytecode));
+    if (program == NULL)
+        return NULL;
+    program->frame_size = frame_size;
+
+    code_generator generator = {program, 0, use_superinstructions, 0};
+    compile_statements(&generator, tree);
+    emit(&generator, OP_HALT);
+
+    if (generator.failed)
+    {
+        destroy_bytecode(program);
+        return NULL;
+    }
+    return program;
+}
+
+void disassemble_bytecode(const bytecode *program, FILE *file)
+{
+    for (int pc = 0; pc < program->length;)
+    {
+        opcode op = (opcode)program->code[pc];
+        fprintf(file, "%5d  %-24s", pc, opcodes[op].name);
+        for (int i = 1; i <= opcodes[op].operands; i++)
+            fprintf(file, " %d", program->code[pc + i]);
+        if (op == OP_PUSH_REAL)
+            fprintf(file, "  ; %g", program->constants[program->code[pc + 1]]);
+        fprintf(file, "\n");
+        pc += 1 + opcodes[op].operands;
+    }
+}
+
+void destroy_bytecode(bytecode *program)
+{
+    if (program == NULL)
+        return;
+    free(program->code);
+    free(program->constants);
+    free(program);
+}
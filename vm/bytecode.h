@@ -0,0 +1,118 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../parser/parser.h"
+
+/*
+ * As instruções da máquina virtual: nome, quantidade de operandos e efeito na pilha.
+ * Cada instrução ocupa uma palavra de 32 bits, seguida dos seus operandos, também de 32 bits.
+ * Endereços são posições no quadro de variáveis (os mesmos da tabela de símbolos) e destinos
+ * de saltos são posições no vetor de código. Comparações deixam 0 ou 1 (inteiro) na pilha.
+ *
+ * As instruções do final da lista são superinstruções: sequências comuns das instruções básicas
+ * fundidas em uma só, para reduzir a quantidade de despachos.
+ *   VV: os dois operandos são variáveis inteiras; VK: uma variável e uma constante.
+ *   JUMP_UNLESS_<cmp>: salta para o destino se a comparação for falsa.
+ */
+#define OPCODE_LIST(X)                 \
+    X(HALT, 0, 0)                      \
+    X(PUSH_INT, 1, 1)                  \
+    X(PUSH_REAL, 1, 1) /* constante */ \
+    X(LOAD_INT, 1, 1)                  \
+    X(LOAD_REAL, 1, 1)                 \
+    X(STORE_INT, 1, -1)                \
+    X(STORE_REAL, 1, -1)               \
+    X(ADD_INT, 0, -1)                  \
+    X(SUB_INT, 0, -1)                  \
+    X(MUL_INT, 0, -1)                  \
+    X(DIV_INT, 1, -1) /* linha */      \
+    X(ADD_REAL, 0, -1)                 \
+    X(SUB_REAL, 0, -1)                 \
+    X(MUL_REAL, 0, -1)                 \
+    X(DIV_REAL, 0, -1)                 \
+    X(INT_TO_REAL, 0, 0)               \
+    X(LT_INT, 0, -1)                   \
+    X(LE_INT, 0, -1)                   \
+    X(GT_INT, 0, -1)                   \
+    X(GE_INT, 0, -1)                   \
+    X(EQ_INT, 0, -1)                   \
+    X(NE_INT, 0, -1)                   \
+    X(LT_REAL, 0, -1)                  \
+    X(LE_REAL, 0, -1)                  \
+    X(GT_REAL, 0, -1)                  \
+    X(GE_REAL, 0, -1)                  \
+    X(EQ_REAL, 0, -1)                  \
+    X(NE_REAL, 0, -1)                  \
+    X(JUMP, 1, 0)                      \
+    X(JUMP_IF_FALSE, 1, -1)            \
+    X(JUMP_IF_TRUE, 1, -1)             \
+    X(READ_INT, 2, 0) /* endereço, linha */ \
+    X(READ_REAL, 2, 0)                 \
+    X(WRITE_INT, 0, -1)                \
+    X(WRITE_REAL, 0, -1)               \
+    X(LOAD_LOAD_INT, 2, 2)             \
+    X(ADD_INT_VK, 2, 1)                \
+    X(INC_INT, 2, 0) /* x = x + k */   \
+    X(JUMP_UNLESS_LT_INT, 1, -2)       \
+    X(JUMP_UNLESS_LE_INT, 1, -2)       \
+    X(JUMP_UNLESS_GT_INT, 1, -2)       \
+    X(JUMP_UNLESS_GE_INT, 1, -2)       \
+    X(JUMP_UNLESS_EQ_INT, 1, -2)       \
+    X(JUMP_UNLESS_NE_INT, 1, -2)       \
+    X(JUMP_UNLESS_LT_INT_VV, 3, 0)     \
+    X(JUMP_UNLESS_LE_INT_VV, 3, 0)     \
+    X(JUMP_UNLESS_GT_INT_VV, 3, 0)     \
+    X(JUMP_UNLESS_GE_INT_VV, 3, 0)     \
+    X(JUMP_UNLESS_EQ_INT_VV, 3, 0)     \
+    X(JUMP_UNLESS_NE_INT_VV, 3, 0)     \
+    X(JUMP_UNLESS_LT_INT_VK, 3, 0)     \
+    X(JUMP_UNLESS_LE_INT_VK, 3, 0)     \
+    X(JUMP_UNLESS_GT_INT_VK, 3, 0)     \
+    X(JUMP_UNLESS_GE_INT_VK, 3, 0)     \
+    X(JUMP_UNLESS_EQ_INT_VK, 3, 0)     \
+    X(JUMP_UNLESS_NE_INT_VK, 3, 0)
+
+#define OPCODE_ENUM(name, operands, effect) OP_##name,
+
+/// @brief O código de cada instrução.
+typedef enum opcode
+{
+    OPCODE_LIST(OPCODE_ENUM)
+    OPCODE_COUNT
+} opcode;
+
+#undef OPCODE_ENUM
+
+/// @brief Um programa compilado para a máquina virtual.
+typedef struct bytecode
+{
+    int32_t *code;
+    int length;
+    int capacity;
+    double *constants; // As constantes reais, referenciadas por PUSH_REAL.
+    int constant_count;
+    int constant_capacity;
+    int frame_size; // O tamanho do quadro de variáveis, em bytes.
+    int max_stack;  // A maior profundidade da pilha durante a execução.
+} bytecode;
+
+/// @brief Compila a árvore ajustada de um programa para bytecode.
+/// @note A árvore precisa ter passado por resolve_tree().
+/// @param tree A árvore ajustada e resolvida.
+/// @param frame_size O tamanho do quadro, em bytes (o próximo endereço livre da tabela de símbolos).
+/// @param use_superinstructions 1 para fundir as sequências comuns em superinstruções, 0 para usar só as básicas.
+/// @return O programa compilado, ou NULL se não houver memória.
+bytecode *compile_bytecode(tree_node *tree, int frame_size, int use_superinstructions);
+
+/// @brief Escreve uma listagem legível das instruções de um programa.
+/// @param program O programa.
+/// @param file O arquivo de destino.
+void disassemble_bytecode(const bytecode *program, FILE *file);
+
+/// @brief Libera um programa compilado.
+/// @param program O programa.
+void destroy_bytecode(bytecode *program);
+
+#endif // BYTECODE_H
@@ -0,0 +1,114 @@
+#include <stdio.h>  // snprintf()
+#include <stdlib.h> // calloc(), malloc(), free()
+#include <string.h> // memcpy()
+#include "vm.h"
+
+/// @brief Um valor da pilha: as instruções tipadas sabem qual campo usar.
+typedef union vm_value
+{
+    int32_t i;
+    double r;
+} vm_value;
+
+// O quadro segue o leiaute da tabela de símbolos, em que um real pode começar em um endereço
+// que não é múltiplo de 8; memcpy() faz o acesso sem exigir alinhamento.
+static inline int32_t load_integer(const unsigned char *frame, int32_t address)
+{
+    int32_t value;
+    memcpy(&value, frame + address, sizeof(value));
+    return value;
+}
+
+static inline double load_real(const unsigned char *frame, int32_t address)
+{
+    double value;
+    memcpy(&value, frame + address, sizeof(value));
+    return value;
+}
+
+static inline void store_integer(unsigned char *frame, int32_t address, int32_t value)
+{
+    memcpy(frame + address, &value, sizeof(value));
+}
+
+static inline void store_real(unsigned char *frame, int32_t address, double value)
+{
+    memcpy(frame + address, &value, sizeof(value));
+}
+
+static void set_error(execution_error *error, int line, const char *message)
+{
+    error->line = line;
+    snprintf(error->message, sizeof(error->message), "%s", message);
+}
+
+/// @brief Despacho por switch: a cada instrução o laço volta ao mesmo desvio indireto.
+static int run_switch(const bytecode *program, unsigned char *frame, vm_value *stack, program_io *io, execution_error *error)
+{
+    const int32_t *code = program->code;
+    const int32_t *pc = code;
+    const double *constants = program->constants;
+    vm_value *sp = stack;
+
+#define VM_CASE(name) case OP_##name:
+#define VM_NEXT() continue
+
+    for (;;)
+    {
+        switch (*pc++)
+        {
+#include "vm_loop.inc"
+        default:
+            set_error(error, 0, "instrucao invalida");
+            return 0;
+        }
+    }
+
+#undef VM_CASE
+#undef VM_NEXT
+}
+
+#if defined(__GNUC__)
+/// @brief Despacho por goto calculado: cada instrução termina com o seu próprio desvio indireto para a
+///        próxima, o que dá ao preditor de desvios do processador um histórico por instrução.
+static int run_threaded(const bytecode *program, unsigned char *frame, vm_value *stack, program_io *io, execution_error *error)
+{
+#define OPCODE_LABEL(name, operands, effect) &&label_##name,
+    static void *const dispatch_table[OPCODE_COUNT] = {OPCODE_LIST(OPCODE_LABEL)};
+#undef OPCODE_LABEL
+
+    const int32_t *code = program->code;
+    const int32_t *pc = code;
+    const double *constants = program->constants;
+    vm_value *sp = stack;
+
+#define VM_CASE(name) label_##name:
+#define VM_NEXT() goto *dispatch_table[*pc++]
+
+    VM_NEXT();
+#include "vm_loop.inc"
+
+#undef VM_CASE
+#undef VM_NEXT
+}
+#endif
+
+int run_bytecode(const bytecode *program, dispatch_mode mode, program_io *io, execution_error *error)
+{
+    unsigned char *frame = (unsigned char *)calloc(1, (size_t)program->frame_size + 8);
+    vm_value *stack = (vm_value *)malloc((size_t)(program->max_stack + 1) * sizeof(vm_value));
+    int finished = 0;
+
+    if (frame == NULL || stack == NULL)
+        set_error(error, 0, "memoria insuficiente");
+#if defined(__GNUC__)
+    else if (mode == THREADED_DISPATCH)
+        finished = run_threaded(program, frame, stack, io, error);
+#endif
+    else
+        finished = run_switch(program, frame, stack, io, error);
+
+    free(frame);
+    free(stack);
+    return finished;
+}
@@ -0,0 +1,24 @@
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include "../interpreter/interpreter.h"
+#include "../runtime/program_io.h"
+
+/// @brief A forma como a máquina virtual escolhe o código de cada instrução.
+typedef enum dispatch_mode
+{
+    THREADED_DISPATCH, // goto calculado: cada instrução salta direto para a próxima (extensão do GCC/Clang).
+    SWITCH_DISPATCH    // Um laço com switch: todas as instruções passam pelo mesmo desvio indireto.
+} dispatch_mode;
+
+/// @brief Executa um programa compilado para bytecode.
+/// @note Sem suporte a goto calculado no compilador C, THREADED_DISPATCH usa o switch.
+/// @param program O programa.
+/// @param mode A forma de despacho das instruções.
+/// @param io A entrada de ler() e a saída de mostrar().
+/// @param error Recebe a descrição do erro, se a execução for interrompida.
+/// @return 1 se o programa terminou normalmente, 0 se foi interrompido por um erro de execução.
+int run_bytecode(const bytecode *program, dispatch_mode mode, program_io *io, execution_error *error);
+
+#endif // VM_H